@@ -0,0 +1,378 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file forced_detection.cc
+
+  \brief Projection of a water box on a flat panel by analog detection or by forced detection. Run with --forced 0 then with --forced 1 to compare the simulation time and the noise (SNR in a central region of the projection) of projections
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <vector>
+#include <cmath>
+
+#include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/materials/GGEMSMaterialsDatabaseManager.hh"
+#include "GGEMS/navigators/GGEMSCTSystem.hh"
+#include "GGEMS/navigators/GGEMSVoxelizedPhantom.hh"
+#include "GGEMS/navigators/GGEMSForcedDetection.hh"
+#include "GGEMS/physics/GGEMSProcessesManager.hh"
+#include "GGEMS/physics/GGEMSRangeCutsManager.hh"
+#include "GGEMS/sources/GGEMSXRaySource.hh"
+#include "GGEMS/global/GGEMS.hh"
+#include "GGEMS/tools/GGEMSPrint.hh"
+#include "GGEMS/geometries/GGEMSVolumeCreatorManager.hh"
+
+#ifdef _WIN32
+#include "GGEMS/tools/GGEMSWinGetOpt.hh"
+#else
+#include <getopt.h>
+#endif
+
+/*!
+  \fn void PrintHelpAndQuit(std::string const& message, char const *p_executable)
+  \param message - error message
+  \param p_executable - name of the executable
+  \brief print the help or the error of the program
+*/
+void PrintHelpAndQuit(std::string const& message, char const* exec)
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << message << std::endl;
+  oss << std::endl;
+  oss << "-->> 10 - Forced Detection Example <<--\n" << std::endl;
+  oss << "Usage: " << exec << " [OPTIONS...]\n" << std::endl;
+  oss << "[--help]                   Print the help to the terminal" << std::endl;
+  oss << "[--verbose X]              Verbosity level" << std::endl;
+  oss << "                           (X=0, default)" << std::endl;
+  oss << std::endl;
+  oss << "Benchmark parameters:" << std::endl;
+  oss << "---------------------" << std::endl;
+  oss << "[--device X]               Device(s) to activate: index, list of indices separated by ';', gpu, cpu or all" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--n-particles X]          Number of particles" << std::endl;
+  oss << "                           (X=1000000 with analog detection, X=10000 with forced detection, by default)" << std::endl;
+  oss << "[--forced X]               Forced detection of primary and Compton scatter (1) or analog detection only (0)" << std::endl;
+  oss << "                           (X=1, by default)" << std::endl;
+  oss << "[--seed X]                 Seed of random" << std::endl;
+  oss << "                           (X=777, by default)" << std::endl;
+  throw std::invalid_argument(oss.str());
+}
+
+/*!
+  \fn void ParseCommandLine(std::string const& line_option, T* p_buffer)
+  \tparam T - type of the array storing the option
+  \param line_option - string from the command line
+  \param p_buffer - buffer storing the commands
+  \brief parse the command with comma
+*/
+template<typename T>
+void ParseCommandLine(std::string const& line_option, T* p_buffer)
+{
+  std::istringstream iss(line_option);
+  T* p = &p_buffer[0];
+  while (iss >> *p++) if (iss.peek() == ',') iss.ignore();
+}
+
+/*!
+  \fn template<typename T> void ReadRaw(std::string const& raw_filename, std::vector<GGdouble>& projection)
+  \tparam T - type of data in raw file
+  \param raw_filename - raw file of projection
+  \param projection - values of projection
+  \brief read the values of a raw file
+*/
+template<typename T>
+void ReadRaw(std::string const& raw_filename, std::vector<GGdouble>& projection)
+{
+  std::ifstream in_raw_stream(raw_filename, std::ios::in | std::ios::binary);
+  if (!in_raw_stream) throw std::runtime_error("Error opening " + raw_filename);
+
+  std::vector<T> data(projection.size());
+  in_raw_stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()*sizeof(T)));
+  for (GGsize i = 0; i < projection.size(); ++i) projection[i] = static_cast<GGdouble>(data[i]);
+}
+
+/*!
+  \fn std::vector<GGdouble> ReadProjection(std::string const& mhd_filename, GGsize& width)
+  \param mhd_filename - MHD header of projection written by GGEMS
+  \param width - number of pixels in X of projection
+  \return values of projection
+  \brief read a projection in MET_INT, MET_FLOAT or MET_DOUBLE
+*/
+std::vector<GGdouble> ReadProjection(std::string const& mhd_filename, GGsize& width)
+{
+  std::ifstream in_header_stream(mhd_filename, std::ios::in);
+  if (!in_header_stream) throw std::runtime_error("Error opening " + mhd_filename);
+
+  std::string line, key, element_type, raw_filename;
+  GGsize number_of_pixels = 0;
+  while (std::getline(in_header_stream, line)) {
+    std::istringstream iss(line);
+    iss >> key;
+    iss.ignore(3); // " = "
+    if (key == "DimSize") {
+      GGsize height = 0, depth = 0;
+      iss >> width >> height >> depth;
+      number_of_pixels = width*height*depth;
+    }
+    else if (key == "ElementType") iss >> element_type;
+    else if (key == "ElementDataFile") iss >> raw_filename;
+  }
+
+  // Raw file is in the directory of header
+  GGsize found_dir = mhd_filename.find_last_of("/\\");
+  if (found_dir != std::string::npos) raw_filename = mhd_filename.substr(0, found_dir+1) + raw_filename;
+
+  std::vector<GGdouble> projection(number_of_pixels, 0.0);
+  if (element_type == "MET_INT") ReadRaw<GGint>(raw_filename, projection);
+  else if (element_type == "MET_FLOAT") ReadRaw<GGfloat>(raw_filename, projection);
+  else if (element_type == "MET_DOUBLE") ReadRaw<GGdouble>(raw_filename, projection);
+  else throw std::runtime_error("Type " + element_type + " of " + mhd_filename + " is not read by this example");
+
+  return projection;
+}
+
+/*!
+  \fn void PrintNoise(std::vector<GGdouble> const& projection, GGsize const& width, GGdouble const& elapsed_time)
+  \param projection - values of projection
+  \param width - number of pixels in X of projection
+  \param elapsed_time - simulation time in ms
+  \brief print mean, variance and SNR of pixels in the central region of 20x20 pixels of projection, behind the water box. SNR^2/time measures the efficiency of a detection mode, it does not depend on number of particles
+*/
+void PrintNoise(std::vector<GGdouble> const& projection, GGsize const& width, GGdouble const& elapsed_time)
+{
+  GGsize height = projection.size() / width;
+  GGsize roi_size = 20;
+
+  GGdouble sum = 0.0, sum_squared = 0.0;
+  for (GGsize j = (height-roi_size)/2; j < (height+roi_size)/2; ++j) {
+    for (GGsize i = (width-roi_size)/2; i < (width+roi_size)/2; ++i) {
+      GGdouble value = projection[i+j*width];
+      sum += value;
+      sum_squared += value*value;
+    }
+  }
+
+  GGdouble number_of_roi_pixels = static_cast<GGdouble>(roi_size*roi_size);
+  GGdouble mean = sum / number_of_roi_pixels;
+  GGdouble variance = (sum_squared - sum*sum/number_of_roi_pixels) / (number_of_roi_pixels-1.0);
+  GGdouble snr = variance > 0.0 ? mean / std::sqrt(variance) : 0.0;
+
+  std::cout << "Central region of 20x20 pixels: mean " << mean << ", variance " << variance << ", SNR " << snr << ", SNR^2/s " << snr*snr / (elapsed_time*1.0e-3) << std::endl;
+}
+
+/*!
+  \fn int main(int argc, char** argv)
+  \param argc - number of arguments
+  \param argv - list of arguments
+  \return status of program
+  \brief main function of program
+*/
+int main(int argc, char** argv)
+{
+  try {
+    // List of parameters
+    GGint verbosity_level = 0;
+    std::string device = "0";
+    GGsize number_of_particles = 0;
+    GGint is_forced_detection = 1;
+    GGuint seed = 777;
+
+    // Loop while there is an argument
+    GGint counter(0);
+    while (1) {
+      // Declaring a structure of the options
+      GGint option_index = 0;
+      static struct option sLongOptions[] = {
+        {"verbose", required_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {"device", required_argument, 0, 'd'},
+        {"n-particles", required_argument, 0, 'p'},
+        {"forced", required_argument, 0, 'f'},
+        {"seed", required_argument, 0, 's'}
+      };
+
+      // Getting the options
+      counter = getopt_long(argc, argv, "hv:d:p:f:s:", sLongOptions, &option_index);
+
+      // Exit the loop if -1
+      if (counter == -1) break;
+
+      // Analyzing each option
+      switch (counter) {
+        case 0: {
+          // If this option set a flag, do nothing else now
+          if (sLongOptions[option_index].flag != 0) break;
+          break;
+        }
+        case 'v': {
+          ParseCommandLine(optarg, &verbosity_level);
+          break;
+        }
+        case 'h': {
+          PrintHelpAndQuit("Printing the help", argv[0]);
+          break;
+        }
+        case 'd': {
+          device = optarg;
+          break;
+        }
+        case 'p': {
+          ParseCommandLine(optarg, &number_of_particles);
+          break;
+        }
+        case 'f': {
+          ParseCommandLine(optarg, &is_forced_detection);
+          break;
+        }
+        case 's': {
+          ParseCommandLine(optarg, &seed);
+          break;
+        }
+        default: {
+          PrintHelpAndQuit("Out of switch options!!!", argv[0]);
+          break;
+        }
+      }
+    }
+
+    // Each Compton event in phantom is projected to all detection elements with forced detection, far less particles are needed
+    if (number_of_particles == 0) number_of_particles = is_forced_detection ? 10000 : 1000000;
+
+    // Setting verbosity
+    GGcout.SetVerbosity(verbosity_level);
+    GGcerr.SetVerbosity(verbosity_level);
+    GGwarn.SetVerbosity(verbosity_level);
+
+    // Initialization of singletons
+    GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+    GGEMSMaterialsDatabaseManager& material_manager = GGEMSMaterialsDatabaseManager::GetInstance();
+    GGEMSVolumeCreatorManager& volume_creator_manager = GGEMSVolumeCreatorManager::GetInstance();
+    GGEMSProcessesManager& processes_manager = GGEMSProcessesManager::GetInstance();
+    GGEMSRangeCutsManager& range_cuts_manager = GGEMSRangeCutsManager::GetInstance();
+
+    // Activating device
+    opencl_manager.DeviceToActivate(device);
+
+    // Enter material database
+    material_manager.SetMaterialsDatabase("data/materials.txt");
+
+    // Water box of 20 cm, 2 mm voxels
+    volume_creator_manager.SetVolumeDimensions(100, 100, 100);
+    volume_creator_manager.SetElementSizes(2.0f, 2.0f, 2.0f, "mm");
+    volume_creator_manager.SetOutputImageFilename("data/phantom.mhd");
+    volume_creator_manager.SetRangeToMaterialDataFilename("data/range_phantom.txt");
+    volume_creator_manager.SetMaterial("Water");
+    volume_creator_manager.SetDataType("MET_INT");
+    volume_creator_manager.Initialize();
+    volume_creator_manager.Write();
+
+    // Phantom
+    GGEMSVoxelizedPhantom phantom("phantom");
+    phantom.SetPhantomFile("data/phantom.mhd", "data/range_phantom.txt");
+    phantom.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    phantom.SetPosition(0.0f, 0.0f, 0.0f, "mm");
+
+    // Flat panel of 1 module of 200x200 elements of 2 mm
+    GGEMSCTSystem flat_panel("flat_panel");
+    flat_panel.SetCTSystemType("flat");
+    flat_panel.SetNumberOfModules(1, 1);
+    flat_panel.SetNumberOfDetectionElementsInsideModule(200, 200, 1);
+    flat_panel.SetSizeOfDetectionElements(2.0f, 2.0f, 0.6f, "mm");
+    flat_panel.SetMaterialName("CsI");
+    flat_panel.SetSourceDetectorDistance(1000.0f, "mm");
+    flat_panel.SetSourceIsocenterDistance(500.0f, "mm");
+    flat_panel.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    flat_panel.SetThreshold(10.0f, "keV");
+    flat_panel.StoreOutput("data/projection");
+    flat_panel.StoreScatter(true);
+
+    // Expected primary and scatter projections of flat panel
+    GGEMSForcedDetection forced_detection;
+    if (is_forced_detection) {
+      forced_detection.AttachToNavigator("phantom");
+      forced_detection.SetDetector("flat_panel");
+      forced_detection.SetSource("point_source");
+      forced_detection.SetOutputForcedDetectionBasename("data/forced_detection");
+    }
+
+    // Physics
+    processes_manager.AddProcess("Compton", "gamma", "all");
+    processes_manager.AddProcess("Photoelectric", "gamma", "all");
+    processes_manager.AddProcess("Rayleigh", "gamma", "all");
+
+    // Cuts
+    range_cuts_manager.SetLengthCut("all", "gamma", 0.1f, "mm");
+
+    // X-ray source covering the flat panel
+    GGEMSXRaySource point_source("point_source");
+    point_source.SetSourceParticleType("gamma");
+    point_source.SetNumberOfParticles(number_of_particles);
+    point_source.SetPosition(-500.0f, 0.0f, 0.0f, "mm");
+    point_source.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    point_source.SetBeamAperture(11.5f, "deg");
+    point_source.SetFocalSpotSize(0.0f, 0.0f, 0.0f, "mm");
+    point_source.SetPolyenergy("data/spectrum_120kVp_2mmAl.dat");
+
+    // GGEMS simulation
+    GGEMS ggems;
+    ggems.SetProfilingVerbose(verbosity_level > 0);
+    ggems.Initialize(seed);
+
+    auto start = std::chrono::steady_clock::now();
+    ggems.Run();
+    std::chrono::duration<GGdouble, std::milli> elapsed_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Water box on flat panel, " << number_of_particles << " particles, " << (is_forced_detection ? "forced" : "analog") << " detection: " << elapsed_time.count() << " ms" << std::endl;
+
+    // Noise of projection, primary and scatter are added with forced detection
+    GGsize width = 0;
+    std::vector<GGdouble> projection;
+    if (is_forced_detection) {
+      projection = ReadProjection("data/forced_detection_primary.mhd", width);
+      std::vector<GGdouble> scatter = ReadProjection("data/forced_detection_scatter.mhd", width);
+      for (GGsize i = 0; i < projection.size(); ++i) projection[i] += scatter[i];
+    }
+    else {
+      projection = ReadProjection("data/projection.mhd", width);
+    }
+    PrintNoise(projection, width, elapsed_time.count());
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+  catch (...) {
+    std::cerr << "Unknown exception!!!" << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+
+  // Exit safely
+  GGEMSOpenCLManager::GetInstance().Clean();
+  exit(EXIT_SUCCESS);
+}
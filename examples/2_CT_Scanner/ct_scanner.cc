@@ -87,6 +87,8 @@ void PrintHelpAndQuit(std::string const& message, char const* exec)
   oss << "                          (X=1000000, default)" << std::endl;
   oss << "[--seed X]                Seed of pseudo generator number" << std::endl;
   oss << "                          (X=777, default)" << std::endl;
+  oss << "[--views X]               Number of views of gantry over 360 deg, views are simulated in a single session" << std::endl;
+  oss << "                          (X=1, default)" << std::endl;
   throw std::invalid_argument(oss.str());
 }
 
@@ -123,6 +125,7 @@ int main(int argc, char** argv)
     std::string device = "all";
     std::string device_balance = "";
     GGuint seed = 777;
+    GGsize number_of_views = 1;
 
     // Loop while there is an argument
     GGint counter(0);
@@ -135,11 +138,12 @@ int main(int argc, char** argv)
         {"n-particles", required_argument, 0, 'p'},
         {"device", required_argument, 0, 'd'},
         {"balance", required_argument, 0, 'b'},
-        {"seed", required_argument, 0, 's'}
+        {"seed", required_argument, 0, 's'},
+        {"views", required_argument, 0, 'w'}
       };
 
       // Getting the options
-      counter = getopt_long(argc, argv, "hv:p:d:b:s:", sLongOptions, &option_index);
+      counter = getopt_long(argc, argv, "hv:p:d:b:s:w:", sLongOptions, &option_index);
 
       // Exit the loop if -1
       if (counter == -1) break;
@@ -175,6 +179,10 @@ int main(int argc, char** argv)
           ParseCommandLine(optarg, &seed);
           break;
         }
+        case 'w': {
+          ParseCommandLine(optarg, &number_of_views);
+          break;
+        }
         default: {
           PrintHelpAndQuit("Out of switch options!!!", argv[0]);
           break;
@@ -286,7 +294,15 @@ int main(int argc, char** argv)
     ggems.Initialize(seed);
 
     // Start GGEMS simulation
-    ggems.Run();
+    if (number_of_views > 1) {
+      // Projections of all views are stacked in a single volume
+      std::vector<GGfloat> gantry_angles;
+      for (GGsize i = 0; i < number_of_views; ++i) gantry_angles.push_back(360.0f * static_cast<GGfloat>(i) / static_cast<GGfloat>(number_of_views));
+      ggems.RunGantryScan(gantry_angles, "deg");
+    }
+    else {
+      ggems.Run();
+    }
   }
   catch (std::exception& e) {
     std::cerr << e.what() << std::endl;
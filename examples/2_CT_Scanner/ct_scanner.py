@@ -26,6 +26,8 @@ parser.add_argument('-d', '--device', required=False, type=str, default='all', h
 parser.add_argument('-b', '--balance', required=False, type=str, help="X;Y;Z... Balance computation for device if many devices are selected")
 parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000000, help="Number of particles")
 parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
+parser.add_argument('-w', '--views', required=False, type=int, default=1, help="Number of views of gantry over 360 deg")
+parser.add_argument('-r', '--response', required=False, type=str, default='counts', help="Detector response (counts, energy)")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
 
 args = parser.parse_args()
@@ -36,6 +38,8 @@ verbosity_level = args.verbose
 number_of_particles = args.nparticles
 device_balancing = args.balance
 seed = args.seed
+number_of_views = args.views
+detector_response = args.response
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during computation
@@ -107,6 +111,7 @@ ct_detector.set_rotation(0.0, 0.0, 0.0, 'deg')
 ct_detector.set_threshold(10.0, 'keV')
 ct_detector.save('data/projection')
 ct_detector.store_scatter(True)
+ct_detector.set_detector_response(detector_response)
 
 # ------------------------------------------------------------------------------
 # STEP 5: Physics
@@ -151,8 +156,11 @@ ggems.tracking_verbose(False, 0)
 # Initializing the GGEMS simulation
 ggems.initialize(seed)
 
-# Start GGEMS simulation
-ggems.run()
+# Start GGEMS simulation, projections of all views are stacked in a single volume
+if number_of_views > 1:
+    ggems.run_gantry_scan([360.0 * i / number_of_views for i in range(number_of_views)], 'deg')
+else:
+    ggems.run()
 
 # ------------------------------------------------------------------------------
 # STEP 10: Exit safely
@@ -27,6 +27,7 @@ parser.add_argument('-b', '--balance', required=False, type=str, help="X;Y;Z...
 parser.add_argument('-n', '--nparticles', required=False, type=int, default=1000000, help="Number of particles")
 parser.add_argument('-s', '--seed', required=False, type=int, default=777, help="Seed of pseudo generator number")
 parser.add_argument('-v', '--verbose', required=False, type=int, default=0, help="Set level of verbosity")
+parser.add_argument('-i', '--importance', required=False, type=float, help="Importance of phantom, photons are split in phantom with weight 1/importance")
 
 args = parser.parse_args()
 
@@ -36,6 +37,7 @@ verbosity_level = args.verbose
 number_of_particles = args.nparticles
 device_balancing = args.balance
 seed = args.seed
+importance = args.importance
 
 # ------------------------------------------------------------------------------
 # STEP 0: Level of verbosity during computation
@@ -94,6 +96,8 @@ phantom = GGEMSVoxelizedPhantom('phantom')
 phantom.set_phantom('data/phantom.mhd', 'data/range_phantom.txt')
 phantom.set_rotation(0.0, 0.0, 0.0, 'deg')
 phantom.set_position(0.0, 0.0, 0.0, 'mm')
+if importance:
+  phantom.set_importance(importance)
 
 # ------------------------------------------------------------------------------
 # STEP 5: Dosimetry
@@ -0,0 +1,199 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file energy_bin_lookup.cc
+
+  \brief Benchmark of energy bin lookup in cross section tables, binary search versus direct log-uniform index
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "GGEMS/maths/GGEMSMathAlgorithms.hh"
+#include "GGEMS/physics/GGEMSProcessConstants.hh"
+
+#ifdef _WIN32
+#include "GGEMS/tools/GGEMSWinGetOpt.hh"
+#else
+#include <getopt.h>
+#endif
+
+/*!
+  \fn void PrintHelpAndQuit(std::string const& message, char const *p_executable)
+  \param message - error message
+  \param p_executable - name of the executable
+  \brief print the help or the error of the program
+*/
+void PrintHelpAndQuit(std::string const& message, char const* exec)
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << message << std::endl;
+  oss << std::endl;
+  oss << "-->> 6 - Energy Bin Lookup Example <<--\n" << std::endl;
+  oss << "Usage: " << exec << " [OPTIONS...]\n" << std::endl;
+  oss << "[--help]                   Print the help to the terminal" << std::endl;
+  oss << std::endl;
+  oss << "Benchmark parameters:" << std::endl;
+  oss << "---------------------" << std::endl;
+  oss << "[--bins X]                 Number of bins in cross section table" << std::endl;
+  oss << "                           (X=220, by default)" << std::endl;
+  oss << "[--lookups X]              Number of energy lookups" << std::endl;
+  oss << "                           (X=10000000, by default)" << std::endl;
+  throw std::invalid_argument(oss.str());
+}
+
+/*!
+  \fn void ParseCommandLine(std::string const& line_option, T* p_buffer)
+  \tparam T - type of the array storing the option
+  \param line_option - string from the command line
+  \param p_buffer - buffer storing the commands
+  \brief parse the command with comma
+*/
+template<typename T>
+void ParseCommandLine(std::string const& line_option, T* p_buffer)
+{
+  std::istringstream iss(line_option);
+  T* p = &p_buffer[0];
+  while (iss >> *p++) if (iss.peek() == ',') iss.ignore();
+}
+
+/*!
+  \fn int main(int argc, char** argv)
+  \param argc - number of arguments
+  \param argv - list of arguments
+  \return status of program
+  \brief main function of program
+*/
+int main(int argc, char** argv)
+{
+  try {
+    // List of parameters
+    GGint number_of_bins = 220;
+    GGsize number_of_lookups = 10000000;
+
+    // Loop while there is an argument
+    GGint counter(0);
+    while (1) {
+      // Declaring a structure of the options
+      GGint option_index = 0;
+      static struct option sLongOptions[] = {
+        {"help", no_argument, 0, 'h'},
+        {"bins", required_argument, 0, 'b'},
+        {"lookups", required_argument, 0, 'l'}
+      };
+
+      // Getting the options
+      counter = getopt_long(argc, argv, "hb:l:", sLongOptions, &option_index);
+
+      // Exit the loop if -1
+      if (counter == -1) break;
+
+      // Analyzing each option
+      switch (counter) {
+        case 0: {
+          // If this option set a flag, do nothing else now
+          if (sLongOptions[option_index].flag != 0) break;
+          break;
+        }
+        case 'h': {
+          PrintHelpAndQuit("Printing the help", argv[0]);
+          break;
+        }
+        case 'b': {
+          ParseCommandLine(optarg, &number_of_bins);
+          break;
+        }
+        case 'l': {
+          ParseCommandLine(optarg, &number_of_lookups);
+          break;
+        }
+        default: {
+          PrintHelpAndQuit("Out of switch options!!!", argv[0]);
+          break;
+        }
+      }
+    }
+
+    // Checking parameters
+    if (number_of_bins < 2 || number_of_bins > MAX_CROSS_SECTION_TABLE_NUMBER_BINS) {
+      PrintHelpAndQuit("Number of bins has to be in [2, 2048]!!!", argv[0]);
+    }
+
+    // Energy table built as in GGEMSCrossSections
+    GGfloat min_energy = 1.0f*keV;
+    GGfloat max_energy = 10.0f*MeV;
+    GGfloat slope = logf(max_energy/min_energy);
+    GGfloat inverse_log_energy_range = 1.0f / slope;
+    std::vector<GGfloat> energy_bins(static_cast<GGsize>(number_of_bins));
+    for (GGint i = 0; i < number_of_bins; ++i) {
+      energy_bins[static_cast<GGsize>(i)] = min_energy * expf(slope * (static_cast<GGfloat>(i) / (static_cast<GGfloat>(number_of_bins)-1.0f)));
+    }
+
+    // Energies of photons, log-uniform as in a polychromatic spectrum spanning the table
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<GGfloat> distribution(0.0f, 1.0f);
+    std::vector<GGfloat> energies(number_of_lookups);
+    for (auto&& e : energies) e = min_energy * expf(slope * distribution(generator));
+
+    std::vector<GGint> binary_search_index(number_of_lookups);
+    std::vector<GGint> log_uniform_index(number_of_lookups);
+
+    // Binary search, previous lookup in GetPhotonNextInteraction
+    auto binary_search_start = std::chrono::steady_clock::now();
+    for (GGsize i = 0; i < number_of_lookups; ++i) {
+      binary_search_index[i] = BinarySearchLeft(energies[i], energy_bins.data(), number_of_bins, 0, 0);
+    }
+    std::chrono::duration<GGdouble, std::nano> binary_search_time = std::chrono::steady_clock::now() - binary_search_start;
+
+    // Direct index from log scale
+    auto log_uniform_start = std::chrono::steady_clock::now();
+    for (GGsize i = 0; i < number_of_lookups; ++i) {
+      log_uniform_index[i] = LogUniformBinIndex(energies[i], energy_bins.data(), number_of_bins, inverse_log_energy_range);
+    }
+    std::chrono::duration<GGdouble, std::nano> log_uniform_time = std::chrono::steady_clock::now() - log_uniform_start;
+
+    // Both lookups have to find the same bin
+    GGsize number_of_mismatches = 0;
+    for (GGsize i = 0; i < number_of_lookups; ++i) {
+      if (binary_search_index[i] != log_uniform_index[i]) ++number_of_mismatches;
+    }
+
+    std::cout << "Energy bin lookup, " << number_of_bins << " bins, " << number_of_lookups << " lookups" << std::endl;
+    std::cout << "    Binary search: " << binary_search_time.count()/static_cast<GGdouble>(number_of_lookups) << " ns per lookup" << std::endl;
+    std::cout << "    Log-uniform index: " << log_uniform_time.count()/static_cast<GGdouble>(number_of_lookups) << " ns per lookup" << std::endl;
+    std::cout << "    Speed-up: " << binary_search_time.count()/log_uniform_time.count() << std::endl;
+    std::cout << "    Mismatches: " << number_of_mismatches << std::endl;
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+  }
+  catch (...) {
+    std::cerr << "Unknown exception!!!" << std::endl;
+  }
+
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,224 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file random_seeding.cc
+
+  \brief Benchmark of JKISS seeding at initialization, Mersenne Twister on host versus seeding kernel on OpenCL devices
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include <cstdlib>
+#include <chrono>
+
+#include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
+
+#ifdef _WIN32
+#include "GGEMS/tools/GGEMSWinGetOpt.hh"
+#else
+#include <getopt.h>
+#endif
+
+/*!
+  \fn void PrintHelpAndQuit(std::string const& message, char const *p_executable)
+  \param message - error message
+  \param p_executable - name of the executable
+  \brief print the help or the error of the program
+*/
+void PrintHelpAndQuit(std::string const& message, char const* exec)
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << message << std::endl;
+  oss << std::endl;
+  oss << "-->> 7 - Random Seeding Example <<--\n" << std::endl;
+  oss << "Usage: " << exec << " [OPTIONS...]\n" << std::endl;
+  oss << "[--help]                   Print the help to the terminal" << std::endl;
+  oss << "[--verbose X]              Verbosity level" << std::endl;
+  oss << "                           (X=0, default)" << std::endl;
+  oss << std::endl;
+  oss << "Benchmark parameters:" << std::endl;
+  oss << "---------------------" << std::endl;
+  oss << "[--device X]               Device(s) to activate: index, list of indices separated by ';', gpu, cpu or all" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--batch X]                Number of particles in batch, 0 for automatic sizing" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--seed X]                 Seed of random" << std::endl;
+  oss << "                           (X=777, by default)" << std::endl;
+  throw std::invalid_argument(oss.str());
+}
+
+/*!
+  \fn void ParseCommandLine(std::string const& line_option, T* p_buffer)
+  \tparam T - type of the array storing the option
+  \param line_option - string from the command line
+  \param p_buffer - buffer storing the commands
+  \brief parse the command with comma
+*/
+template<typename T>
+void ParseCommandLine(std::string const& line_option, T* p_buffer)
+{
+  std::istringstream iss(line_option);
+  T* p = &p_buffer[0];
+  while (iss >> *p++) if (iss.peek() == ',') iss.ignore();
+}
+
+/*!
+  \fn GGdouble SeedingTime(bool const& is_host_seeding, GGuint const& seed)
+  \param is_host_seeding - true for Mersenne Twister on host, false for seeding kernel
+  \param seed - seed of random
+  \return time in ms spent to allocate and seed random buffers of all activated devices
+  \brief initialize a random generator and wait for all devices
+*/
+GGdouble SeedingTime(bool const& is_host_seeding, GGuint const& seed)
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGEMSPseudoRandomGenerator random;
+  random.SetHostSeeding(is_host_seeding);
+
+  auto start = std::chrono::steady_clock::now();
+  random.Initialize(seed);
+  for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) opencl_manager.GetCommandQueue(i)->finish();
+  std::chrono::duration<GGdouble, std::milli> elapsed_time = std::chrono::steady_clock::now() - start;
+
+  return elapsed_time.count();
+}
+
+/*!
+  \fn int main(int argc, char** argv)
+  \param argc - number of arguments
+  \param argv - list of arguments
+  \return status of program
+  \brief main function of program
+*/
+int main(int argc, char** argv)
+{
+  try {
+    // List of parameters
+    GGint verbosity_level = 0;
+    std::string device = "0";
+    GGsize particle_batch_size = 0;
+    GGuint seed = 777;
+
+    // Loop while there is an argument
+    GGint counter(0);
+    while (1) {
+      // Declaring a structure of the options
+      GGint option_index = 0;
+      static struct option sLongOptions[] = {
+        {"verbose", required_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {"device", required_argument, 0, 'd'},
+        {"batch", required_argument, 0, 'b'},
+        {"seed", required_argument, 0, 's'}
+      };
+
+      // Getting the options
+      counter = getopt_long(argc, argv, "hv:d:b:s:", sLongOptions, &option_index);
+
+      // Exit the loop if -1
+      if (counter == -1) break;
+
+      // Analyzing each option
+      switch (counter) {
+        case 0: {
+          // If this option set a flag, do nothing else now
+          if (sLongOptions[option_index].flag != 0) break;
+          break;
+        }
+        case 'v': {
+          ParseCommandLine(optarg, &verbosity_level);
+          break;
+        }
+        case 'h': {
+          PrintHelpAndQuit("Printing the help", argv[0]);
+          break;
+        }
+        case 'd': {
+          device = optarg;
+          break;
+        }
+        case 'b': {
+          ParseCommandLine(optarg, &particle_batch_size);
+          break;
+        }
+        case 's': {
+          ParseCommandLine(optarg, &seed);
+          break;
+        }
+        default: {
+          PrintHelpAndQuit("Out of switch options!!!", argv[0]);
+          break;
+        }
+      }
+    }
+
+    // Setting verbosity
+    GGcout.SetVerbosity(verbosity_level);
+    GGcerr.SetVerbosity(verbosity_level);
+    GGwarn.SetVerbosity(verbosity_level);
+
+    // Activating devices
+    GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+    opencl_manager.DeviceToActivate(device);
+    if (particle_batch_size > 0) opencl_manager.SetParticleBatchSize(particle_batch_size);
+
+    GGsize number_of_particles = 0;
+    for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) {
+      std::cout << "Device " << opencl_manager.GetDeviceName(opencl_manager.GetIndexOfActivatedDevice(i)) << ": " << opencl_manager.GetParticleBatchSize(i) << " particles" << std::endl;
+      number_of_particles += opencl_manager.GetParticleBatchSize(i);
+    }
+
+    #ifdef PHILOX_RANDOM
+    std::cout << "GGEMS is compiled with PHILOX_RANDOM, counter-based engine has no state to seed" << std::endl;
+    #else
+    // Previous path, states from a Mersenne Twister written in mapped buffers
+    GGdouble host_time = SeedingTime(true, seed);
+
+    // First seeding on device includes the kernel build (or load from kernel cache)
+    GGdouble first_device_time = SeedingTime(false, seed);
+    GGdouble device_time = SeedingTime(false, seed);
+
+    std::cout << "JKISS seeding of " << number_of_particles << " particle slots" << std::endl;
+    std::cout << "    Host (Mersenne Twister): " << host_time << " ms" << std::endl;
+    std::cout << "    Device kernel (first call, with kernel build): " << first_device_time << " ms" << std::endl;
+    std::cout << "    Device kernel: " << device_time << " ms" << std::endl;
+    std::cout << "    Speed-up: " << host_time/device_time << std::endl;
+    #endif
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+  catch (...) {
+    std::cerr << "Unknown exception!!!" << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+
+  // Exit safely
+  GGEMSOpenCLManager::GetInstance().Clean();
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,259 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file dose_accumulation.cc
+
+  \brief Benchmark of dose accumulation for a pencil beam in water, deposits of all photons collide on the same dosels. Run with --replicas 1 then with more replicas to compare the simulation time
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include <cstdlib>
+#include <chrono>
+
+#include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/materials/GGEMSMaterialsDatabaseManager.hh"
+#include "GGEMS/navigators/GGEMSVoxelizedPhantom.hh"
+#include "GGEMS/navigators/GGEMSDosimetryCalculator.hh"
+#include "GGEMS/physics/GGEMSProcessesManager.hh"
+#include "GGEMS/physics/GGEMSRangeCutsManager.hh"
+#include "GGEMS/sources/GGEMSXRaySource.hh"
+#include "GGEMS/global/GGEMS.hh"
+#include "GGEMS/tools/GGEMSPrint.hh"
+#include "GGEMS/geometries/GGEMSVolumeCreatorManager.hh"
+#include "GGEMS/geometries/GGEMSBox.hh"
+
+#ifdef _WIN32
+#include "GGEMS/tools/GGEMSWinGetOpt.hh"
+#else
+#include <getopt.h>
+#endif
+
+/*!
+  \fn void PrintHelpAndQuit(std::string const& message, char const *p_executable)
+  \param message - error message
+  \param p_executable - name of the executable
+  \brief print the help or the error of the program
+*/
+void PrintHelpAndQuit(std::string const& message, char const* exec)
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << message << std::endl;
+  oss << std::endl;
+  oss << "-->> 8 - Dose Accumulation Example <<--\n" << std::endl;
+  oss << "Usage: " << exec << " [OPTIONS...]\n" << std::endl;
+  oss << "[--help]                   Print the help to the terminal" << std::endl;
+  oss << "[--verbose X]              Verbosity level" << std::endl;
+  oss << "                           (X=0, default)" << std::endl;
+  oss << std::endl;
+  oss << "Benchmark parameters:" << std::endl;
+  oss << "---------------------" << std::endl;
+  oss << "[--device X]               Device(s) to activate: index, list of indices separated by ';', gpu, cpu or all" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--n-particles X]          Number of particles" << std::endl;
+  oss << "                           (X=10000000, by default)" << std::endl;
+  oss << "[--replicas X]             Number of replicated dose maps" << std::endl;
+  oss << "                           (X=1, by default)" << std::endl;
+  oss << "[--seed X]                 Seed of random" << std::endl;
+  oss << "                           (X=777, by default)" << std::endl;
+  throw std::invalid_argument(oss.str());
+}
+
+/*!
+  \fn void ParseCommandLine(std::string const& line_option, T* p_buffer)
+  \tparam T - type of the array storing the option
+  \param line_option - string from the command line
+  \param p_buffer - buffer storing the commands
+  \brief parse the command with comma
+*/
+template<typename T>
+void ParseCommandLine(std::string const& line_option, T* p_buffer)
+{
+  std::istringstream iss(line_option);
+  T* p = &p_buffer[0];
+  while (iss >> *p++) if (iss.peek() == ',') iss.ignore();
+}
+
+/*!
+  \fn int main(int argc, char** argv)
+  \param argc - number of arguments
+  \param argv - list of arguments
+  \return status of program
+  \brief main function of program
+*/
+int main(int argc, char** argv)
+{
+  try {
+    // List of parameters
+    GGint verbosity_level = 0;
+    std::string device = "0";
+    GGsize number_of_particles = 10000000;
+    GGsize number_of_replicas = 1;
+    GGuint seed = 777;
+
+    // Loop while there is an argument
+    GGint counter(0);
+    while (1) {
+      // Declaring a structure of the options
+      GGint option_index = 0;
+      static struct option sLongOptions[] = {
+        {"verbose", required_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {"device", required_argument, 0, 'd'},
+        {"n-particles", required_argument, 0, 'p'},
+        {"replicas", required_argument, 0, 'r'},
+        {"seed", required_argument, 0, 's'}
+      };
+
+      // Getting the options
+      counter = getopt_long(argc, argv, "hv:d:p:r:s:", sLongOptions, &option_index);
+
+      // Exit the loop if -1
+      if (counter == -1) break;
+
+      // Analyzing each option
+      switch (counter) {
+        case 0: {
+          // If this option set a flag, do nothing else now
+          if (sLongOptions[option_index].flag != 0) break;
+          break;
+        }
+        case 'v': {
+          ParseCommandLine(optarg, &verbosity_level);
+          break;
+        }
+        case 'h': {
+          PrintHelpAndQuit("Printing the help", argv[0]);
+          break;
+        }
+        case 'd': {
+          device = optarg;
+          break;
+        }
+        case 'p': {
+          ParseCommandLine(optarg, &number_of_particles);
+          break;
+        }
+        case 'r': {
+          ParseCommandLine(optarg, &number_of_replicas);
+          break;
+        }
+        case 's': {
+          ParseCommandLine(optarg, &seed);
+          break;
+        }
+        default: {
+          PrintHelpAndQuit("Out of switch options!!!", argv[0]);
+          break;
+        }
+      }
+    }
+
+    // Setting verbosity
+    GGcout.SetVerbosity(verbosity_level);
+    GGcerr.SetVerbosity(verbosity_level);
+    GGwarn.SetVerbosity(verbosity_level);
+
+    // Initialization of singletons
+    GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+    GGEMSMaterialsDatabaseManager& material_manager = GGEMSMaterialsDatabaseManager::GetInstance();
+    GGEMSVolumeCreatorManager& volume_creator_manager = GGEMSVolumeCreatorManager::GetInstance();
+    GGEMSProcessesManager& processes_manager = GGEMSProcessesManager::GetInstance();
+    GGEMSRangeCutsManager& range_cuts_manager = GGEMSRangeCutsManager::GetInstance();
+
+    // Activating device
+    opencl_manager.DeviceToActivate(device);
+
+    // Enter material database
+    material_manager.SetMaterialsDatabase("data/materials.txt");
+
+    // Water cube of 10 cm, 1 mm voxels
+    volume_creator_manager.SetVolumeDimensions(100, 100, 100);
+    volume_creator_manager.SetElementSizes(1.0f, 1.0f, 1.0f, "mm");
+    volume_creator_manager.SetOutputImageFilename("data/phantom.mhd");
+    volume_creator_manager.SetRangeToMaterialDataFilename("data/range_phantom.txt");
+    volume_creator_manager.SetMaterial("Water");
+    volume_creator_manager.SetDataType("MET_INT");
+    volume_creator_manager.Initialize();
+    volume_creator_manager.Write();
+
+    // Phantom
+    GGEMSVoxelizedPhantom phantom("phantom");
+    phantom.SetPhantomFile("data/phantom.mhd", "data/range_phantom.txt");
+    phantom.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    phantom.SetPosition(0.0f, 0.0f, 0.0f, "mm");
+
+    // Dosimetry, dosels of voxel size
+    GGEMSDosimetryCalculator dosimetry;
+    dosimetry.AttachToNavigator("phantom");
+    dosimetry.SetOutputDosimetryBasename("data/dosimetry");
+    dosimetry.SetEdep(true);
+    dosimetry.SetEdepSquared(true);
+    dosimetry.SetHitTracking(true);
+    dosimetry.SetUncertainty(true);
+    dosimetry.SetNumberOfDoseReplicas(number_of_replicas);
+
+    // Physics
+    processes_manager.AddProcess("Compton", "gamma", "all");
+    processes_manager.AddProcess("Photoelectric", "gamma", "all");
+    processes_manager.AddProcess("Rayleigh", "gamma", "all");
+
+    // Cuts
+    range_cuts_manager.SetLengthCut("all", "gamma", 0.1f, "mm");
+
+    // Pencil beam along X axis, all photons enter the phantom in the same dosel
+    GGEMSXRaySource pencil_beam("pencil_beam");
+    pencil_beam.SetSourceParticleType("gamma");
+    pencil_beam.SetNumberOfParticles(number_of_particles);
+    pencil_beam.SetPosition(-100.0f, 0.0f, 0.0f, "mm");
+    pencil_beam.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    pencil_beam.SetBeamAperture(0.0f, "deg");
+    pencil_beam.SetFocalSpotSize(0.0f, 0.0f, 0.0f, "mm");
+    pencil_beam.SetMonoenergy(60.0f, "keV");
+
+    // GGEMS simulation
+    GGEMS ggems;
+    ggems.SetProfilingVerbose(verbosity_level > 0);
+    ggems.Initialize(seed);
+
+    auto start = std::chrono::steady_clock::now();
+    ggems.Run();
+    std::chrono::duration<GGdouble, std::milli> elapsed_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Pencil beam, " << number_of_particles << " particles, " << number_of_replicas << " dose replica(s): " << elapsed_time.count() << " ms" << std::endl;
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+  catch (...) {
+    std::cerr << "Unknown exception!!!" << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+
+  // Exit safely
+  GGEMSOpenCLManager::GetInstance().Clean();
+  exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,262 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file detector_histogram.cc
+
+  \brief Benchmark of histogram accumulation in the 46 modules of the Stellar CT detector, all photons of the X-ray beam are counted by the detector. Run with --local-histogram 0 then with --local-histogram 1 to compare the simulation time
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include <cstdlib>
+#include <chrono>
+
+#include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/materials/GGEMSMaterialsDatabaseManager.hh"
+#include "GGEMS/navigators/GGEMSCTSystem.hh"
+#include "GGEMS/physics/GGEMSProcessesManager.hh"
+#include "GGEMS/physics/GGEMSRangeCutsManager.hh"
+#include "GGEMS/sources/GGEMSXRaySource.hh"
+#include "GGEMS/global/GGEMS.hh"
+#include "GGEMS/tools/GGEMSPrint.hh"
+
+#ifdef _WIN32
+#include "GGEMS/tools/GGEMSWinGetOpt.hh"
+#else
+#include <getopt.h>
+#endif
+
+/*!
+  \fn void PrintHelpAndQuit(std::string const& message, char const *p_executable)
+  \param message - error message
+  \param p_executable - name of the executable
+  \brief print the help or the error of the program
+*/
+void PrintHelpAndQuit(std::string const& message, char const* exec)
+{
+  std::ostringstream oss(std::ostringstream::out);
+  oss << message << std::endl;
+  oss << std::endl;
+  oss << "-->> 9 - Detector Histogram Example <<--\n" << std::endl;
+  oss << "Usage: " << exec << " [OPTIONS...]\n" << std::endl;
+  oss << "[--help]                   Print the help to the terminal" << std::endl;
+  oss << "[--verbose X]              Verbosity level" << std::endl;
+  oss << "                           (X=0, default)" << std::endl;
+  oss << std::endl;
+  oss << "Benchmark parameters:" << std::endl;
+  oss << "---------------------" << std::endl;
+  oss << "[--device X]               Device(s) to activate: index, list of indices separated by ';', gpu, cpu or all" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--n-particles X]          Number of particles" << std::endl;
+  oss << "                           (X=10000000, by default)" << std::endl;
+  oss << "[--local-histogram X]      Histograms in local memory of work-groups (1) or in global memory (0)" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--fused X]                Fused navigation in all modules (1) or navigation module by module (0)" << std::endl;
+  oss << "                           (X=0, by default)" << std::endl;
+  oss << "[--response X]             Detector response: counts or energy" << std::endl;
+  oss << "                           (X=counts, by default)" << std::endl;
+  oss << "[--seed X]                 Seed of random" << std::endl;
+  oss << "                           (X=777, by default)" << std::endl;
+  throw std::invalid_argument(oss.str());
+}
+
+/*!
+  \fn void ParseCommandLine(std::string const& line_option, T* p_buffer)
+  \tparam T - type of the array storing the option
+  \param line_option - string from the command line
+  \param p_buffer - buffer storing the commands
+  \brief parse the command with comma
+*/
+template<typename T>
+void ParseCommandLine(std::string const& line_option, T* p_buffer)
+{
+  std::istringstream iss(line_option);
+  T* p = &p_buffer[0];
+  while (iss >> *p++) if (iss.peek() == ',') iss.ignore();
+}
+
+/*!
+  \fn int main(int argc, char** argv)
+  \param argc - number of arguments
+  \param argv - list of arguments
+  \return status of program
+  \brief main function of program
+*/
+int main(int argc, char** argv)
+{
+  try {
+    // List of parameters
+    GGint verbosity_level = 0;
+    std::string device = "0";
+    GGsize number_of_particles = 10000000;
+    GGint is_local_histogram = 0;
+    GGint is_fused_navigation = 0;
+    std::string detector_response = "counts";
+    GGuint seed = 777;
+
+    // Loop while there is an argument
+    GGint counter(0);
+    while (1) {
+      // Declaring a structure of the options
+      GGint option_index = 0;
+      static struct option sLongOptions[] = {
+        {"verbose", required_argument, 0, 'v'},
+        {"help", no_argument, 0, 'h'},
+        {"device", required_argument, 0, 'd'},
+        {"n-particles", required_argument, 0, 'p'},
+        {"local-histogram", required_argument, 0, 'l'},
+        {"fused", required_argument, 0, 'f'},
+        {"response", required_argument, 0, 'r'},
+        {"seed", required_argument, 0, 's'}
+      };
+
+      // Getting the options
+      counter = getopt_long(argc, argv, "hv:d:p:l:f:r:s:", sLongOptions, &option_index);
+
+      // Exit the loop if -1
+      if (counter == -1) break;
+
+      // Analyzing each option
+      switch (counter) {
+        case 0: {
+          // If this option set a flag, do nothing else now
+          if (sLongOptions[option_index].flag != 0) break;
+          break;
+        }
+        case 'v': {
+          ParseCommandLine(optarg, &verbosity_level);
+          break;
+        }
+        case 'h': {
+          PrintHelpAndQuit("Printing the help", argv[0]);
+          break;
+        }
+        case 'd': {
+          device = optarg;
+          break;
+        }
+        case 'p': {
+          ParseCommandLine(optarg, &number_of_particles);
+          break;
+        }
+        case 'l': {
+          ParseCommandLine(optarg, &is_local_histogram);
+          break;
+        }
+        case 'f': {
+          ParseCommandLine(optarg, &is_fused_navigation);
+          break;
+        }
+        case 'r': {
+          detector_response = optarg;
+          break;
+        }
+        case 's': {
+          ParseCommandLine(optarg, &seed);
+          break;
+        }
+        default: {
+          PrintHelpAndQuit("Out of switch options!!!", argv[0]);
+          break;
+        }
+      }
+    }
+
+    // Setting verbosity
+    GGcout.SetVerbosity(verbosity_level);
+    GGcerr.SetVerbosity(verbosity_level);
+    GGwarn.SetVerbosity(verbosity_level);
+
+    // Initialization of singletons
+    GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+    GGEMSMaterialsDatabaseManager& material_manager = GGEMSMaterialsDatabaseManager::GetInstance();
+    GGEMSProcessesManager& processes_manager = GGEMSProcessesManager::GetInstance();
+    GGEMSRangeCutsManager& range_cuts_manager = GGEMSRangeCutsManager::GetInstance();
+
+    // Activating device
+    opencl_manager.DeviceToActivate(device);
+
+    // Enter material database
+    material_manager.SetMaterialsDatabase("data/materials.txt");
+
+    // Stellar CT detector of example 2, 46 modules of 64x16 elements, no phantom so all photons reach the detector
+    GGEMSCTSystem ct_detector("Stellar");
+    ct_detector.SetCTSystemType("curved");
+    ct_detector.SetNumberOfModules(1, 46);
+    ct_detector.SetNumberOfDetectionElementsInsideModule(64, 16, 1);
+    ct_detector.SetSizeOfDetectionElements(0.6f, 0.6f, 0.6f, "mm");
+    ct_detector.SetMaterialName("GOS");
+    ct_detector.SetSourceDetectorDistance(1085.6f, "mm");
+    ct_detector.SetSourceIsocenterDistance(595.0f, "mm");
+    ct_detector.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    ct_detector.SetThreshold(10.0f, "keV");
+    ct_detector.StoreOutput("data/projection");
+    ct_detector.StoreScatter(true);
+    ct_detector.SetLocalHistogram(is_local_histogram != 0);
+    ct_detector.SetFusedNavigation(is_fused_navigation != 0);
+    ct_detector.SetDetectorResponse(detector_response);
+
+    // Physics
+    processes_manager.AddProcess("Compton", "gamma", "all");
+    processes_manager.AddProcess("Photoelectric", "gamma", "all");
+    processes_manager.AddProcess("Rayleigh", "gamma", "all");
+
+    // Cuts
+    range_cuts_manager.SetLengthCut("all", "gamma", 0.1f, "mm");
+
+    // X-ray source of example 2
+    GGEMSXRaySource point_source("point_source");
+    point_source.SetSourceParticleType("gamma");
+    point_source.SetNumberOfParticles(number_of_particles);
+    point_source.SetPosition(-595.0f, 0.0f, 0.0f, "mm");
+    point_source.SetRotation(0.0f, 0.0f, 0.0f, "deg");
+    point_source.SetBeamAperture(12.5f, "deg");
+    point_source.SetFocalSpotSize(0.0f, 0.0f, 0.0f, "mm");
+    point_source.SetPolyenergy("data/spectrum_120kVp_2mmAl.dat");
+
+    // GGEMS simulation
+    GGEMS ggems;
+    ggems.SetProfilingVerbose(verbosity_level > 0);
+    ggems.Initialize(seed);
+
+    auto start = std::chrono::steady_clock::now();
+    ggems.Run();
+    std::chrono::duration<GGdouble, std::milli> elapsed_time = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Stellar detector, " << number_of_particles << " particles, " << (is_fused_navigation ? "fused" : "module by module") << " navigation, " << detector_response << " histograms in " << (is_local_histogram ? "local" : "global") << " memory: " << elapsed_time.count() << " ms" << std::endl;
+  }
+  catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+  catch (...) {
+    std::cerr << "Unknown exception!!!" << std::endl;
+    // Exit safely
+    GGEMSOpenCLManager::GetInstance().Clean();
+  }
+
+  // Exit safely
+  GGEMSOpenCLManager::GetInstance().Clean();
+  exit(EXIT_SUCCESS);
+}
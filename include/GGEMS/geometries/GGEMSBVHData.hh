@@ -0,0 +1,52 @@
+#ifndef GUARD_GGEMS_GEOMETRIES_GGEMSBVHDATA_HH
+#define GUARD_GGEMS_GEOMETRIES_GGEMSBVHDATA_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSBVHData.hh
+
+  \brief Structure storing a node of bounding volume hierarchy (BVH) built over the OBBs of solids in a navigator
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/tools/GGEMSTypes.hh"
+
+#define BVH_MAXIMUM_SOLIDS_PER_LEAF 4 /*!< Maximum number of solids stored in a leaf of BVH */
+#define BVH_MAXIMUM_DEPTH 32 /*!< Maximum depth of BVH, size of traversal stack in kernel */
+
+/*!
+  \struct GGEMSBVHNode_t
+  \brief Structure storing a node of BVH, the box is an AABB in global frame enclosing OBB of solids
+*/
+typedef struct GGEMSBVHNode_t
+{
+  GGfloat3 border_min_xyz_; /*!< Min. of border in X, Y and Z in global frame */
+  GGfloat3 border_max_xyz_; /*!< Max. of border in X, Y and Z in global frame */
+  GGint child_index_[2]; /*!< Index of left and right children, -1 for a leaf */
+  GGint number_of_solids_; /*!< Number of solids in leaf, 0 for internal node */
+  GGint solid_index_[BVH_MAXIMUM_SOLIDS_PER_LEAF]; /*!< Index of solids (in navigator) stored in leaf */
+} GGEMSBVHNode; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+#endif // GUARD_GGEMS_GEOMETRIES_GGEMSBVHDATA_HH
@@ -325,6 +325,69 @@ inline GGfloat ComputeDistanceToOBB(GGfloat3 const* position, GGfloat3 const* di
   );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar ClipRayToSlab(GGfloat const position, GGfloat const direction, GGfloat const border_min, GGfloat const border_max, GGfloat* tmin, GGfloat* tmax)
+  \param position - position of particle on the axis
+  \param direction - direction of particle on the axis
+  \param border_min - min. border of slab
+  \param border_max - max. border of slab
+  \param tmin - entry distance, updated by the slab
+  \param tmax - exit distance, updated by the slab
+  \return false if the ray misses the slab interval, true otherwise
+  \brief Clip the interval [tmin, tmax] of a ray by a slab on one axis
+*/
+inline GGchar ClipRayToSlab(GGfloat const position, GGfloat const direction, GGfloat const border_min, GGfloat const border_max, GGfloat* tmin, GGfloat* tmax)
+{
+  // Ray parallel to slab
+  if (fabs(direction) < EPSILON6) {
+    if (position < border_min || position > border_max) return FALSE;
+    return TRUE;
+  }
+
+  GGfloat inverse_direction = 1.0f / direction;
+  GGfloat t_near = (border_min - position) * inverse_direction;
+  GGfloat t_far = (border_max - position) * inverse_direction;
+  if (t_near > t_far) {
+    GGfloat tmp = t_near;
+    t_near = t_far;
+    t_far = tmp;
+  }
+
+  if (t_near > *tmin) *tmin = t_near;
+  if (t_far < *tmax) *tmax = t_far;
+
+  return (*tmin <= *tmax) ? TRUE : FALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat ComputeEntryDistanceToAABB(GGfloat3 const* position, GGfloat3 const* direction, GGfloat3 const border_min, GGfloat3 const border_max)
+  \param position - pointer on primary particle position
+  \param direction - pointer on primary particle direction
+  \param border_min - min. border of AABB
+  \param border_max - max. border of AABB
+  \return entry distance to AABB, 0 if particle is inside and OUT_OF_WORLD if AABB is not crossed
+  \brief Conservative entry distance to an AABB, used to cull bounding volumes (no tolerance applied)
+*/
+inline GGfloat ComputeEntryDistanceToAABB(GGfloat3 const* position, GGfloat3 const* direction, GGfloat3 const border_min, GGfloat3 const border_max)
+{
+  GGfloat tmin = 0.0f;
+  GGfloat tmax = OUT_OF_WORLD;
+
+  if (!ClipRayToSlab(position->x, direction->x, border_min.x, border_max.x, &tmin, &tmax)) return OUT_OF_WORLD;
+  if (!ClipRayToSlab(position->y, direction->y, border_min.y, border_max.y, &tmin, &tmax)) return OUT_OF_WORLD;
+  if (!ClipRayToSlab(position->z, direction->z, border_min.z, border_max.z, &tmin, &tmax)) return OUT_OF_WORLD;
+
+  return tmin;
+}
+
 #endif
 
 #endif // End of GUARD_GGEMS_GEOMETRIES_GGEMSRAYTRACING_HH
@@ -107,6 +107,14 @@ class GGEMS_EXPORT GGEMSSolid
     */
     inline cl::Buffer* GetLabelData(GGsize const& thread_index) const {return label_data_[thread_index];};
 
+    /*!
+      \fn inline cl::Buffer* GetImportanceMap(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \brief get buffer to importance map
+      \return importance of each voxel, nullptr if no map
+    */
+    inline cl::Buffer* GetImportanceMap(GGsize const& thread_index) const {return importance_map_ ? importance_map_[thread_index] : nullptr;};
+
     /*!
       \fn void SetRotation(GGfloat3 const& rotation_xyz)
       \param rotation_xyz - rotation in X, Y and Z
@@ -121,6 +129,13 @@ class GGEMS_EXPORT GGEMSSolid
     */
     void SetPosition(GGfloat3 const& position_xyz);
 
+    /*!
+      \fn void SetViewTransformation(GGfloat44 const& matrix_view)
+      \param matrix_view - rigid transformation of the view in global frame
+      \brief move the solid for a view of a scan and update its transformation matrix on each device
+    */
+    void SetViewTransformation(GGfloat44 const& matrix_view);
+
     /*!
       \fn void SetSolidID(GGsize const& solid_id, GGsize const& thread_index)
       \param solid_id - index of the solid
@@ -203,6 +218,13 @@ class GGEMS_EXPORT GGEMSSolid
     */
     inline cl::Buffer* GetScatterHistogram(GGsize const& thread_index) const {return histogram_.scatter_[thread_index];}
 
+    /*!
+      \fn inline GGsize GetLocalHistogramSize(void) const
+      \return size in bytes of histograms in local memory, 0 if histograms are accumulated in global memory
+      \brief get the local memory size of histograms for each work-group
+    */
+    inline GGsize GetLocalHistogramSize(void) const {return local_histogram_size_;}
+
   protected:
     /*!
       \fn void InitializeKernel(void)
@@ -214,6 +236,7 @@ class GGEMS_EXPORT GGEMSSolid
     // Solid data infos and label (for voxelized solid)
     cl::Buffer** solid_data_; /*!< Data about solid */
     cl::Buffer** label_data_; /*!< Pointer storing the buffer about label data, useful for voxelized solid only */
+    cl::Buffer** importance_map_; /*!< Pointer storing the buffer about importance of voxels, useful for voxelized solid only, nullptr if no map */
     std::size_t number_of_voxels_; /*!< Number of voxel 1 for GGEMSSolidBox */
     GGsize number_activated_devices_; /*!< Number of activated device */
 
@@ -230,6 +253,7 @@ class GGEMS_EXPORT GGEMSSolid
     std::string data_reg_type_; /*!< Type of registering data */
     GGEMSHistogramMode histogram_; /*!< Storing histogram useful for GGEMSSystem only */
     bool is_scatter_; /*!< boolean storing scatter in solid */
+    GGsize local_histogram_size_; /*!< Size in bytes of histograms in local memory of each work-group, 0 for histograms in global memory */
 };
 
 ////////////////////////////////////////////////////////////////////////////////
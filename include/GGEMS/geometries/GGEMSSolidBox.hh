@@ -47,7 +47,7 @@ class GGEMS_EXPORT GGEMSSolidBox : public GGEMSSolid
       \param element_size_x - element size along X
       \param element_size_y - element size along Y
       \param element_size_z - element size along Z
-      \param data_reg_type - type of registration "HIT", "SINGLE", "DOSE"
+      \param data_reg_type - type of registration "HISTOGRAM" (counts) or "ENERGY_HISTOGRAM" (deposited energy)
       \brief GGEMSSolidBox constructor
     */
     GGEMSSolidBox(GGsize const& virtual_element_number_x, GGsize const& virtual_element_number_y, GGsize const& virtual_element_number_z, GGfloat const& element_size_x, GGfloat const& element_size_y, GGfloat const& element_size_z, std::string const& data_reg_type);
@@ -98,6 +98,12 @@ class GGEMS_EXPORT GGEMSSolidBox : public GGEMSSolid
     */
     void EnableScatter(void) override;
 
+    /*!
+      \fn void EnableLocalHistogram(void)
+      \brief Accumulate histograms in local memory of each work-group and flush them once per work-group, histograms stay in global memory if they do not fit in local memory of a device with the local memory used by tracking kernel. Has to be called after EnableScatter
+    */
+    void EnableLocalHistogram(void);
+
     /*!
       \fn void PrintInfos(void) const
       \brief printing infos about voxelized solid
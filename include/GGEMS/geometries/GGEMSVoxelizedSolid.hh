@@ -95,6 +95,30 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
     */
     void EnableScatter(void) override {;};
 
+    /*!
+      \fn void EnableWoodcockTracking(void)
+      \brief Tracking particles with Woodcock (delta) tracking instead of voxel by voxel
+    */
+    void EnableWoodcockTracking(void);
+
+    /*!
+      \fn void EnableDDATracking(void)
+      \brief Tracking particles voxel by voxel with an incremental 3D-DDA, free path is carried across voxels as an optical depth
+    */
+    void EnableDDATracking(void);
+
+    /*!
+      \fn void EnableForcedDetection(void)
+      \brief Adding the expected contribution of each Compton scattering to the detection elements of a system
+    */
+    void EnableForcedDetection(void);
+
+    /*!
+      \fn void EnableParticleSplitting(void)
+      \brief Keeping the weight of particles in a window given by the importance, with geometric splitting and Russian roulette
+    */
+    void EnableParticleSplitting(void);
+
     /*!
       \fn void PrintInfos(void) const
       \brief printing infos about voxelized solid
@@ -108,6 +132,13 @@ class GGEMS_EXPORT GGEMSVoxelizedSolid : public GGEMSSolid
     */
     void LoadVolumeImage(GGEMSMaterials* materials);
 
+    /*!
+      \fn void LoadImportanceMap(std::string const& importance_map_filename)
+      \param importance_map_filename - MHD filename for importance map, in MET_FLOAT with the dimensions of volume image
+      \brief load importance of each voxel relative to navigator, volume image has to be loaded before
+    */
+    void LoadImportanceMap(std::string const& importance_map_filename);
+
     /*!
       \fn void UpdateTransformationMatrix(GGsize const& thread_index)
       \param thread_index - index of the thread (= activated device index)
@@ -167,6 +198,12 @@ void GGEMSVoxelizedSolid::ConvertImageToLabel(std::string const& raw_data_filena
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    // Label data are shared by devices of the same context, converted only once
+    if (!opencl_manager.IsContextOwner(d)) {
+      label_data_[d] = label_data_[opencl_manager.GetContextOwner(d)];
+      continue;
+    }
+
     // Get pointer on OpenCL device
     GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[d], sizeof(GGEMSVoxelizedSolidData), d);
 
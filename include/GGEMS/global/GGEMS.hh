@@ -42,6 +42,10 @@
 #include "GGEMS/global/GGEMSExport.hh"
 
 #include "GGEMS/tools/GGEMSTypes.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
+#include "GGEMS/maths/GGEMSMatrixTypes.hh"
+
+class GGEMSProgressBar;
 
 /*!
   \class GGEMS
@@ -101,6 +105,21 @@ class GGEMS_EXPORT GGEMS
     */
     void Run(void);
 
+    /*!
+      \fn void RunScan(std::vector<GGfloat44> const& view_transformations)
+      \param view_transformations - rigid transformation of each view in global frame
+      \brief run a scan in the initialized session, sources and systems are moved by the transformation of the view on top of their initial geometry. The projections of all views are stored in a single volume per system, views stacked along Z
+    */
+    void RunScan(std::vector<GGfloat44> const& view_transformations);
+
+    /*!
+      \fn void RunGantryScan(std::vector<GGfloat> const& gantry_angles, std::string const& unit = "deg")
+      \param gantry_angles - angles of the gantry for each view
+      \param unit - unit of the angles
+      \brief run a scan with the gantry (sources and systems) rotated around the Z axis of the global frame
+    */
+    void RunGantryScan(std::vector<GGfloat> const& gantry_angles, std::string const& unit = "deg");
+
     /*!
       \fn void SetOpenCLVerbose(bool const& is_opencl_verbose)
       \param is_opencl_verbose - flag for opencl verbosity
@@ -193,6 +212,50 @@ class GGEMS_EXPORT GGEMS
     */
     inline GGint GetParticleTrackingID(void) const {return particle_tracking_id_;};
 
+    /*!
+      \fn void SetAsynchronousMode(bool const& is_asynchronous_mode)
+      \param is_asynchronous_mode - flag for asynchronous mode
+      \brief set the asynchronous mode: tracking kernels are chained on device and status of particles is read back by host one loop later, without synchronization
+    */
+    void SetAsynchronousMode(bool const& is_asynchronous_mode);
+
+    /*!
+      \fn void SetStreamCompaction(bool const& is_stream_compaction)
+      \param is_stream_compaction - flag for stream compaction
+      \brief set the stream compaction: list of alive particles is rebuilt at each loop, and tracking kernels are launched only over alive particles
+    */
+    void SetStreamCompaction(bool const& is_stream_compaction);
+
+    /*!
+      \fn void SetPersistentPool(bool const& is_persistent_pool)
+      \param is_persistent_pool - flag for persistent particle pool
+      \brief set the persistent particle pool: batches are not run one after the other, dead particles are replaced by new primaries until all particles of device are generated
+    */
+    void SetPersistentPool(bool const& is_persistent_pool);
+
+    /*!
+      \fn void SetDynamicBalancing(bool const& is_dynamic_balancing)
+      \param is_dynamic_balancing - flag for dynamic balancing
+      \brief set the dynamic balancing between devices: batchs are claimed by devices in a shared counter, with a size computed from the measured throughput of devices. Static device balancing is ignored
+    */
+    void SetDynamicBalancing(bool const& is_dynamic_balancing);
+
+    /*!
+      \fn void SetMaximumSimulationTime(GGfloat const& time, std::string const& unit = "s")
+      \param time - wall-clock budget of simulation
+      \param unit - unit of time
+      \brief set a wall-clock budget, devices stop after their current batch when it expires. With a target of uncertainty in dosimetry, devices stop when the target is reached. Dose is scaled by the number of planned particles divided by the number of simulated particles. Only available with one source and not in scan
+    */
+    void SetMaximumSimulationTime(GGfloat const& time, std::string const& unit = "s");
+
+    /*!
+      \fn void SetUncertaintyCheckPeriod(GGfloat const& time, std::string const& unit = "s")
+      \param time - minimum time between two measurements of uncertainty on a device
+      \param unit - unit of time
+      \brief set the period of measurement of uncertainty, a measurement computes the dose and reduces it on device. 1 s by default
+    */
+    void SetUncertaintyCheckPeriod(GGfloat const& time, std::string const& unit = "s");
+
   private:
     /*!
       \fn void PrintBanner(void) const
@@ -207,6 +270,44 @@ class GGEMS_EXPORT GGEMS
     */
     void RunOnDevice(GGsize const& thread_index);
 
+    /*!
+      \fn void RunView(void)
+      \brief simulate all particles of sources on all devices, without saving results
+    */
+    void RunView(void);
+
+    /*!
+      \fn void TrackParticles(GGsize const& thread_index)
+      \param thread_index - index of the thread
+      \brief track particles of a batch on device until all particles are dead
+    */
+    void TrackParticles(GGsize const& thread_index);
+
+    /*!
+      \fn GGsize ComputeDynamicBatchSize(GGsize const& source_index, GGsize const& thread_index) const
+      \param source_index - index of the source
+      \param thread_index - index of the thread
+      \return number of particles to claim for the next batch of device
+      \brief compute the size of the next batch of device from its share of measured throughput
+    */
+    GGsize ComputeDynamicBatchSize(GGsize const& source_index, GGsize const& thread_index) const;
+
+    /*!
+      \fn bool CheckStoppingCriteria(GGsize const& thread_index, GGsize const& number_of_particles)
+      \param thread_index - index of the thread
+      \param number_of_particles - number of particles simulated in the last batch of device
+      \return true if simulation has to be stopped on all devices
+      \brief counting simulated particles and checking wall-clock budget and target of uncertainty after a batch, the mean uncertainties of devices are combined as independent estimates
+    */
+    bool CheckStoppingCriteria(GGsize const& thread_index, GGsize const& number_of_particles);
+
+    /*!
+      \fn bool IsStopRequested(void) const
+      \return true if a device stopped the simulation
+      \brief checking if simulation is stopped
+    */
+    bool IsStopRequested(void) const;
+
   private: // Global simulation parameters
     bool is_opencl_verbose_; /*!< Flag for OpenCL verbosity */
     bool is_material_database_verbose_; /*!< Flag for material database verbosity */
@@ -218,7 +319,22 @@ class GGEMS_EXPORT GGEMS
     bool is_random_verbose_; /*!< Flag for random verbosity */
     bool is_tracking_verbose_; /*!< Flag for tracking verbosity */
     bool is_profiling_verbose_; /*!< Flag for kernel time verbosity */
+    bool is_asynchronous_mode_; /*!< Flag for asynchronous tracking loop */
+    bool is_stream_compaction_; /*!< Flag for compaction of alive particles */
+    bool is_persistent_pool_; /*!< Flag for refill of dead particles by new primaries */
+    bool is_dynamic_balancing_; /*!< Flag for dynamic balancing between devices */
+    std::vector<GGdouble> device_throughputs_; /*!< Measured throughput of each device in particles per nanosecond */
+    GGdouble maximum_simulation_time_; /*!< Wall-clock budget of simulation in ns, 0 if not used */
+    bool is_adaptive_stopping_; /*!< Flag for stopping criteria checked after each batch */
+    bool is_stop_requested_; /*!< Flag set by the device reaching a stopping criterion */
+    ChronoTime run_start_time_; /*!< Start time of simulation */
+    GGsize number_of_simulated_particles_; /*!< Number of particles simulated on all devices */
+    std::vector<GGdouble> device_uncertainty_ratios_; /*!< Last ratio between mean uncertainty and target of each device, 0 if not measured */
+    GGdouble uncertainty_check_period_; /*!< Minimum time between two measurements of uncertainty on a device in ns */
+    std::vector<ChronoTime> device_uncertainty_check_times_; /*!< Time of last measurement of uncertainty of each device */
     GGint particle_tracking_id_; /*!< Particle if for tracking */
+    GGsize view_index_; /*!< Index of the view in a scan, random streams of particles continue from a view to the next */
+    GGEMSProgressBar* progress_bar_; /*!< Progress bar shared by devices during a run */
 };
 
 /*!
@@ -324,6 +440,56 @@ extern "C" GGEMS_EXPORT void set_profiling_ggems(GGEMS* ggems, bool const is_pro
 */
 extern "C" GGEMS_EXPORT void set_tracking_ggems(GGEMS* ggems, bool const is_tracking_verbose, GGint const particle_id_tracking);
 
+/*!
+  \fn void set_asynchronous_mode_ggems(GGEMS* ggems, bool const is_asynchronous_mode)
+  \param ggems - pointer to GGEMS
+  \param is_asynchronous_mode - flag on asynchronous mode
+  \brief Set the asynchronous mode for tracking loop
+*/
+extern "C" GGEMS_EXPORT void set_asynchronous_mode_ggems(GGEMS* ggems, bool const is_asynchronous_mode);
+
+/*!
+  \fn void set_stream_compaction_ggems(GGEMS* ggems, bool const is_stream_compaction)
+  \param ggems - pointer to GGEMS
+  \param is_stream_compaction - flag on stream compaction
+  \brief Set the compaction of alive particles
+*/
+extern "C" GGEMS_EXPORT void set_stream_compaction_ggems(GGEMS* ggems, bool const is_stream_compaction);
+
+/*!
+  \fn void set_persistent_pool_ggems(GGEMS* ggems, bool const is_persistent_pool)
+  \param ggems - pointer to GGEMS
+  \param is_persistent_pool - flag on persistent particle pool
+  \brief Set the persistent particle pool
+*/
+extern "C" GGEMS_EXPORT void set_persistent_pool_ggems(GGEMS* ggems, bool const is_persistent_pool);
+
+/*!
+  \fn void set_dynamic_balancing_ggems(GGEMS* ggems, bool const is_dynamic_balancing)
+  \param ggems - pointer to GGEMS
+  \param is_dynamic_balancing - flag on dynamic balancing
+  \brief Set the dynamic balancing between devices
+*/
+extern "C" GGEMS_EXPORT void set_dynamic_balancing_ggems(GGEMS* ggems, bool const is_dynamic_balancing);
+
+/*!
+  \fn void set_maximum_simulation_time_ggems(GGEMS* ggems, GGfloat const time, char const* unit)
+  \param ggems - pointer to GGEMS
+  \param time - wall-clock budget of simulation
+  \param unit - unit of time
+  \brief Set the wall-clock budget of simulation
+*/
+extern "C" GGEMS_EXPORT void set_maximum_simulation_time_ggems(GGEMS* ggems, GGfloat const time, char const* unit);
+
+/*!
+  \fn void set_uncertainty_check_period_ggems(GGEMS* ggems, GGfloat const time, char const* unit)
+  \param ggems - pointer to GGEMS
+  \param time - minimum time between two measurements of uncertainty on a device
+  \param unit - unit of time
+  \brief Set the period of measurement of uncertainty
+*/
+extern "C" GGEMS_EXPORT void set_uncertainty_check_period_ggems(GGEMS* ggems, GGfloat const time, char const* unit);
+
 /*!
   \fn void run_ggems(GGEMS* ggems)
   \param ggems - pointer to GGEMS
@@ -331,4 +497,23 @@ extern "C" GGEMS_EXPORT void set_tracking_ggems(GGEMS* ggems, bool const is_trac
 */
 extern "C" GGEMS_EXPORT void run_ggems(GGEMS* ggems);
 
+/*!
+  \fn void run_scan_ggems(GGEMS* ggems, GGfloat const* view_transformations, GGsize const number_of_views)
+  \param ggems - pointer to GGEMS
+  \param view_transformations - 4x4 matrices of views, row major, one after the other
+  \param number_of_views - number of views
+  \brief Run a scan with arbitrary transformations of views
+*/
+extern "C" GGEMS_EXPORT void run_scan_ggems(GGEMS* ggems, GGfloat const* view_transformations, GGsize const number_of_views);
+
+/*!
+  \fn void run_gantry_scan_ggems(GGEMS* ggems, GGfloat const* gantry_angles, GGsize const number_of_views, char const* unit)
+  \param ggems - pointer to GGEMS
+  \param gantry_angles - angles of the gantry for each view
+  \param number_of_views - number of views
+  \param unit - unit of the angles
+  \brief Run a scan with the gantry rotated around Z axis
+*/
+extern "C" GGEMS_EXPORT void run_gantry_scan_ggems(GGEMS* ggems, GGfloat const* gantry_angles, GGsize const number_of_views, char const* unit);
+
 #endif // End of GUARD_GGEMS_GLOBAL_GGEMS_HH
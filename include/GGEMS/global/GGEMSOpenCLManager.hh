@@ -22,7 +22,7 @@
 /*!
   \file GGEMSOpenCLManager.hh
 
-  \brief Singleton class storing all informations about OpenCL and managing GPU/CPU devices, contexts, kernels, command queues and events. In GGEMS the strategy is 1 context = 1 device.
+  \brief Singleton class storing all informations about OpenCL and managing GPU/CPU devices, contexts, kernels, command queues and events. In GGEMS the default strategy is 1 context = 1 device, a context can be shared by all activated devices of a platform.
 
   \author Julien BERT <julien.bert@univ-brest.fr>
   \author Didier BENOIT <didier.benoit@inserm.fr>
@@ -32,7 +32,9 @@
 */
 
 #include <unordered_map>
+#include <unordered_set>
 #include "GGEMS/tools/GGEMSPrint.hh"
+#include "GGEMS/tools/GGEMSChrono.hh"
 
 #ifdef _MSC_VER
 #pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
@@ -48,7 +50,7 @@ typedef std::unordered_map<std::string, std::string> VendorUMap; /*!< Alias to O
 
 /*!
   \class GGEMSOpenCLManager
-  \brief Singleton class storing all informations about OpenCL and managing GPU/CPU devices, contexts, kernels, command queues and events. In GGEMS the strategy is 1 context = 1 device.
+  \brief Singleton class storing all informations about OpenCL and managing GPU/CPU devices, contexts, kernels, command queues and events. In GGEMS the default strategy is 1 context = 1 device, a context can be shared by all activated devices of a platform.
 */
 class GGEMS_EXPORT GGEMSOpenCLManager
 {
@@ -136,6 +138,12 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void PrintActivatedDevices(void) const;
 
+    /*!
+      \fn void PrintKernelCacheInfos(void) const
+      \brief print infos about kernel binary cache, time spent to build kernels is displayed at the end of GGEMS initialization
+    */
+    void PrintKernelCacheInfos(void) const;
+
     /*!
       \fn std::string GetDeviceName(GGsize const& device_index) const
       \param device_index - index of device
@@ -190,6 +198,23 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline GGsize GetRAMMemory(GGsize const& device_index) const {return static_cast<GGsize>(device_global_mem_size_[device_index]);}
 
+    /*!
+      \fn inline GGsize GetLocalMemorySize(GGsize const& device_index) const
+      \param device_index - index of activated devices
+      \return local memory size on a specific device
+      \brief Get the local memory of a work-group in bytes on OpenCL device
+    */
+    inline GGsize GetLocalMemorySize(GGsize const& device_index) const {return static_cast<GGsize>(device_local_mem_size_[device_index]);}
+
+    /*!
+      \fn GGsize GetKernelLocalMemorySize(cl::Kernel* kernel, GGsize const& thread_index) const
+      \param kernel - compiled kernel
+      \param thread_index - index of activated device (thread index)
+      \return local memory used by kernel in bytes
+      \brief Get the local memory used by a kernel on an activated device, local arguments are counted only once they are set
+    */
+    GGsize GetKernelLocalMemorySize(cl::Kernel* kernel, GGsize const& thread_index) const;
+
     /*!
       \fn inline GGsize GetWorkGroupSize(void) const
       \return Work group size
@@ -205,6 +230,21 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     GGsize GetBestWorkItem(GGsize const& number_of_elements) const;
 
+    /*!
+      \fn void SetParticleBatchSize(GGsize const& particle_batch_size)
+      \param particle_batch_size - number of particles in OpenCL buffers, 0 for automatic sizing
+      \brief set the same particle batch size for all devices, must be set before GGEMS initialization
+    */
+    void SetParticleBatchSize(GGsize const& particle_batch_size);
+
+    /*!
+      \fn inline GGsize GetParticleBatchSize(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return number of particles in OpenCL buffers of device
+      \brief get the particle batch size of device, kernels are compiled with this value
+    */
+    inline GGsize GetParticleBatchSize(GGsize const& thread_index) const {return particle_batch_sizes_[thread_index];}
+
     /*!
       \fn cl::Context* GetContext(GGsize const& thread_index) const
       \param thread_index - index of the thread (= activated device index)
@@ -213,6 +253,22 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     inline cl::Context* GetContext(GGsize const& thread_index) const {return contexts_[thread_index];}
 
+    /*!
+      \fn GGsize GetContextOwner(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return the index of the first activated device using the same context
+      \brief return the owner of context, buffers shared by a context are allocated and filled by the owner only
+    */
+    inline GGsize GetContextOwner(GGsize const& thread_index) const {return context_owners_[thread_index];}
+
+    /*!
+      \fn bool IsContextOwner(GGsize const& thread_index) const
+      \param thread_index - index of the thread (= activated device index)
+      \return true if the device owns its context, always true without shared context
+      \brief check if the device owns its context
+    */
+    inline bool IsContextOwner(GGsize const& thread_index) const {return context_owners_[thread_index] == thread_index;}
+
     /*!
       \fn cl::CommandQueue* GetCommandQueue(GGsize const& thread_index) const
       \param thread_index - index of the thread (= activated device index)
@@ -291,6 +347,40 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     void CompileKernel(std::string const& kernel_filename, std::string const& kernel_name, cl::Kernel** kernel_list, char* const custom_options = nullptr, char* const additional_options = nullptr);
 
+    /*!
+      \fn void SetKernelCache(bool const& is_kernel_cache)
+      \param is_kernel_cache - true to store/load compiled OpenCL program binaries on disk
+      \brief activate or deactivate the kernel binary cache
+    */
+    void SetKernelCache(bool const& is_kernel_cache);
+
+    /*!
+      \fn void SetSharedContext(bool const& is_shared_context)
+      \param is_shared_context - true to use one context for all activated devices of a platform
+      \brief activate or deactivate the shared context, read-only tables are then allocated and filled once by platform. Must be set before device activation
+    */
+    void SetSharedContext(bool const& is_shared_context);
+
+    /*!
+      \fn void SetKernelCacheDirectory(std::string const& directory)
+      \param directory - directory storing the OpenCL program binaries
+      \brief set the directory of the kernel binary cache
+    */
+    void SetKernelCacheDirectory(std::string const& directory);
+
+    /*!
+      \fn void CleanKernelCache(void)
+      \brief delete all OpenCL program binaries stored in the kernel cache directory
+    */
+    void CleanKernelCache(void);
+
+    /*!
+      \fn inline DurationNano GetKernelBuildTime(void) const
+      \return time spent to build (or load) OpenCL kernels
+      \brief get the time spent to build (or load) OpenCL kernels
+    */
+    inline DurationNano GetKernelBuildTime(void) const {return kernel_build_time_;}
+
     /*!
       \return the pointer on host memory on write/read mode
       \brief Get the device pointer on host to write on it. ReleaseDeviceBuffer must be used after this method!!!
@@ -377,6 +467,53 @@ class GGEMS_EXPORT GGEMSOpenCLManager
     */
     bool IsDoublePrecision(GGsize const& device_index) const;
 
+    /*!
+      \fn GGsize ComputeParticleBatchSize(GGsize const& device_index) const
+      \param device_index - index of the device
+      \return number of particles in OpenCL buffers
+      \brief compute the particle batch size from compute units and global memory of device
+    */
+    GGsize ComputeParticleBatchSize(GGsize const& device_index) const;
+
+    /*!
+      \fn void ReadKernelSourceTree(std::string const& filename, std::string& source_tree, std::unordered_set<std::string>& visited_files) const
+      \param filename - name of the file (kernel or header) to read
+      \param source_tree - buffer storing the file and all GGEMS headers it includes
+      \param visited_files - files already read, avoiding infinite recursion
+      \brief read a kernel file and all GGEMS headers included by it, used to compute the key of the kernel cache
+    */
+    void ReadKernelSourceTree(std::string const& filename, std::string& source_tree, std::unordered_set<std::string>& visited_files) const;
+
+    /*!
+      \fn std::string GetKernelCacheFilename(std::string const& kernel_name, std::string const& source_tree, std::string const& compilation_options, GGsize const& thread_index) const
+      \param kernel_name - name of the kernel
+      \param source_tree - kernel source and included headers
+      \param compilation_options - arguments of compilation
+      \param thread_index - index of the thread (= activated device index)
+      \return name of the binary file in the kernel cache
+      \brief compute the cache filename from source, compilation options, and device name and driver version
+    */
+    std::string GetKernelCacheFilename(std::string const& kernel_name, std::string const& source_tree, std::string const& compilation_options, GGsize const& thread_index) const;
+
+    /*!
+      \fn bool LoadKernelBinary(std::string const& cache_filename, cl::Program& program, GGsize const& thread_index) const
+      \param cache_filename - name of the binary file in the kernel cache
+      \param program - OpenCL program created from binary
+      \param thread_index - index of the thread (= activated device index)
+      \return true if the program has been created from binary
+      \brief create an OpenCL program from a binary stored in the kernel cache
+    */
+    bool LoadKernelBinary(std::string const& cache_filename, cl::Program& program, GGsize const& thread_index) const;
+
+    /*!
+      \fn void SaveKernelBinary(std::string const& cache_filename, cl::Program const& program, GGsize const& thread_index) const
+      \param cache_filename - name of the binary file in the kernel cache
+      \param program - OpenCL program compiled on device
+      \param thread_index - index of activated device
+      \brief store the binary of a compiled OpenCL program in the kernel cache
+    */
+    void SaveKernelBinary(std::string const& cache_filename, cl::Program const& program, GGsize const& thread_index) const;
+
   private:
     // OpenCL platform
     std::vector<cl::Platform> platforms_; /*!< List of detected platform */
@@ -389,9 +526,12 @@ class GGEMS_EXPORT GGEMSOpenCLManager
 
     // OpenCL device
     std::vector<cl::Device*> devices_; /*!< List of detected device */
+    std::vector<GGsize> device_platform_indices_; /*!< Index of platform for each detected device */
     std::vector<GGsize> device_indices_; /*!< Index of the activated device */
     GGsize work_group_size_; /*!< Work group size by GGEMS, here 64 */
     VendorUMap vendors_; /*!< UMap storing vendor name and an alias */
+    GGsize particle_batch_size_; /*!< Particle batch size set by user, 0 for automatic sizing */
+    std::vector<GGsize> particle_batch_sizes_; /*!< Particle batch size of each activated device */
 
     std::vector<cl_device_type> device_type_; /*!< Type of device */
     std::vector<std::string> device_name_; /*!< Name of the device */
@@ -464,12 +604,21 @@ class GGEMS_EXPORT GGEMSOpenCLManager
 
     // OpenCL context + command queue + event
     std::vector<cl::Context*> contexts_; /*!< OpenCL contexts */
+    bool is_shared_context_; /*!< Flag using one context for all activated devices of a platform */
+    std::vector<GGsize> context_owners_; /*!< Index of activated device owning the context of each activated device */
     std::vector<cl::CommandQueue*> queues_; /*!< OpenCL command queues */
     std::vector<cl::Event*> events_; /*!< OpenCL events */
 
     // OpenCL kernels
     std::vector<cl::Kernel*> kernels_; /*!< List of kernels for each device */
     std::vector<std::string> kernel_compilation_options_; /*!< List of compilation options for kernel */
+
+    // OpenCL kernel binary cache
+    bool is_kernel_cache_; /*!< Flag storing/loading program binaries on disk */
+    std::string kernel_cache_directory_; /*!< Directory of the kernel binary cache */
+    GGsize kernel_cache_hits_; /*!< Number of programs loaded from kernel cache */
+    GGsize kernel_cache_misses_; /*!< Number of programs built from source */
+    DurationNano kernel_build_time_; /*!< Time spent to build or load kernels */
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -546,4 +695,43 @@ extern "C" GGEMS_EXPORT void clean_opencl_manager(GGEMSOpenCLManager* opencl_man
 */
 extern "C" GGEMS_EXPORT void set_device_balancing_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* device_balancing);
 
+/*!
+  \fn void set_kernel_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_kernel_cache)
+  \param opencl_manager - pointer on the singleton
+  \param is_kernel_cache - true to activate kernel binary cache
+  \brief activate or deactivate the kernel binary cache
+*/
+extern "C" GGEMS_EXPORT void set_kernel_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_kernel_cache);
+
+/*!
+  \fn void set_shared_context_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_shared_context)
+  \param opencl_manager - pointer on the singleton
+  \param is_shared_context - true to use one context by platform
+  \brief activate or deactivate the shared context between devices of a platform
+*/
+extern "C" GGEMS_EXPORT void set_shared_context_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_shared_context);
+
+/*!
+  \fn void set_kernel_cache_directory_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* directory)
+  \param opencl_manager - pointer on the singleton
+  \param directory - directory storing the OpenCL program binaries
+  \brief set the directory of the kernel binary cache
+*/
+extern "C" GGEMS_EXPORT void set_kernel_cache_directory_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* directory);
+
+/*!
+  \fn void clean_kernel_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager)
+  \param opencl_manager - pointer on the singleton
+  \brief delete all OpenCL program binaries in the kernel cache directory
+*/
+extern "C" GGEMS_EXPORT void clean_kernel_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager);
+
+/*!
+  \fn void set_particle_batch_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, GGsize const particle_batch_size)
+  \param opencl_manager - pointer on the singleton
+  \param particle_batch_size - number of particles in OpenCL buffers, 0 for automatic sizing
+  \brief set the particle batch size for all devices
+*/
+extern "C" GGEMS_EXPORT void set_particle_batch_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, GGsize const particle_batch_size);
+
 #endif // GUARD_GGEMS_GLOBAL_GGEMSOpenCLManager_HH
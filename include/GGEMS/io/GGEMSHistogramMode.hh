@@ -44,6 +44,7 @@ typedef struct GGEMSHistogramMode_t
   cl::Buffer** histogram_; /*!< Buffer storing histogram counting */
   cl::Buffer** scatter_; /*!< Buffer storing scattered photon */
   GGsize number_of_elements_; /*!< Number of elements in hit buffer */
+  GGsize element_size_; /*!< Size in bytes of an element, integer for counts and 64-bit integer for energy */
 } GGEMSHistogramMode; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 #endif // End of GUARD_GGEMS_IO_GGEMSHISTOGRAMMODE_HH
@@ -177,6 +177,13 @@ class GGEMS_EXPORT GGEMSGeometryTransformation
     */
     inline cl::Buffer* GetTransformationMatrix(GGsize const& index) const {return matrix_transformation_[index];}
 
+    /*!
+      \fn void SetViewTransformation(GGfloat44 const& matrix_view)
+      \param matrix_view - rigid transformation of the view in global frame
+      \brief apply a view transformation on top of the reference transformation, the transformation matrix at the first call is the reference
+    */
+    void SetViewTransformation(GGfloat44 const& matrix_view);
+
   private:
     GGfloat3 position_; /*!< Position of the source/detector */
     GGfloat3 rotation_; /*!< Rotation of the source/detector */
@@ -185,6 +192,8 @@ class GGEMS_EXPORT GGEMSGeometryTransformation
     GGfloat44 matrix_rotation_; /*!< Matrix of rotation */
     GGfloat44 matrix_orthographic_projection_; /*!< Matrix of orthographic projection */
     cl::Buffer** matrix_transformation_; /*!< OpenCL buffer storing the matrix transformation */
+    GGfloat44 matrix_reference_; /*!< Transformation matrix before the first view transformation */
+    bool is_reference_; /*!< True if the reference transformation matrix is stored */
     GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
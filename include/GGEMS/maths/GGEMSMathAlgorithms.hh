@@ -73,6 +73,39 @@ inline GGint BinarySearchLeft(GGfloat const key, GGfloat const* array, GGint con
   return min;
 }
 
+/*!
+  \fn inline GGint LogUniformBinIndex(GGfloat const key, GGfloat const* array, GGint const size, GGfloat const inverse_log_range)
+  \param key - value in array to find
+  \param array - array of log-uniform values from array[0] to array[size-1]
+  \param size - size of array, number of elements
+  \param inverse_log_range - 1/log(array[size-1]/array[0])
+  \return index of key value in array buffer
+  \brief Find the index of the key value in a log-uniform array in constant time, same index as BinarySearchLeft
+*/
+#ifdef __OPENCL_C_VERSION__
+inline GGint LogUniformBinIndex(GGfloat const key, global GGfloat const* array, GGint const size, GGfloat const inverse_log_range)
+#else
+inline GGint LogUniformBinIndex(GGfloat const key, GGfloat const* array, GGint const size, GGfloat const inverse_log_range)
+#endif
+{
+  if (key <= array[0]) return 0;
+
+  // Direct index from log scale, clamped to the last interval
+  #ifdef __OPENCL_C_VERSION__
+  GGint index = (GGint)(log(key/array[0])*inverse_log_range*(GGfloat)(size-1));
+  index = clamp(index, 0, size-2);
+  #else
+  GGint index = static_cast<GGint>(std::log(key/array[0])*inverse_log_range*static_cast<GGfloat>(size-1));
+  index = std::min(std::max(index, 0), size-2);
+  #endif
+
+  // Values of array are rounded in single precision, correcting index near interval borders
+  if (index > 0 && key < array[index]) --index;
+  else if (index < size-2 && key >= array[index+1]) ++index;
+
+  return index;
+}
+
 /*!
   \fn inline GGfloat LinearInterpolation(GGfloat xa, GGfloat ya, GGfloat xb, GGfloat yb, GGfloat x)
   \param xa - Coordinate x of point A
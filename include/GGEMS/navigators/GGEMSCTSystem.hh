@@ -240,4 +240,28 @@ extern "C" GGEMS_EXPORT void set_save_ggems_ct_system(GGEMSCTSystem* ct_system,
 */
 extern "C" GGEMS_EXPORT void store_scatter_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_scatter);
 
+/*!
+  \fn void set_fused_navigation_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_fused_navigation)
+  \param ct_system - pointer on ct system
+  \param is_fused_navigation - flag activating fused navigation
+  \brief Navigate in all modules with one kernel per step and a BVH over modules
+*/
+extern "C" GGEMS_EXPORT void set_fused_navigation_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_fused_navigation);
+
+/*!
+  \fn void set_local_histogram_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_local_histogram)
+  \param ct_system - pointer on ct system
+  \param is_local_histogram - flag activating histograms in local memory
+  \brief Accumulate histograms in local memory of work-groups when they fit
+*/
+extern "C" GGEMS_EXPORT void set_local_histogram_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_local_histogram);
+
+/*!
+  \fn void set_detector_response_ggems_ct_system(GGEMSCTSystem* ct_system, char const* detector_response)
+  \param ct_system - pointer on ct system
+  \param detector_response - response of detection elements, 'counts' or 'energy'
+  \brief set the response of detection elements, number of interactions or deposited energy
+*/
+extern "C" GGEMS_EXPORT void set_detector_response_ggems_ct_system(GGEMSCTSystem* ct_system, char const* detector_response);
+
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSSYSTEM_HH
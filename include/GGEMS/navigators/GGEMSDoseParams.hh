@@ -46,6 +46,9 @@ typedef struct GGEMSDoseParams_t
   GGint3 number_of_dosels_; /*!< Number of dosels per dimension */
   GGint total_number_of_dosels_; /*!< Total number of dosels */
   GGint slice_number_of_dosels_; /*!< Number of dosels per slice */
+  GGint number_of_replicas_; /*!< Number of replicated maps of edep, edep squared and hit, merged in the first map before dose computation */
+  GGint3 roi_min_; /*!< First dosel of region where mean uncertainty is computed */
+  GGint3 roi_max_; /*!< Last dosel of region where mean uncertainty is computed */
 } GGEMSDoseParams; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSDOSEPARAMS_HH
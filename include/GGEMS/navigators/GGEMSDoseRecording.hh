@@ -84,12 +84,16 @@ inline void dose_photon_tracking(global GGEMSDoseParams* dose_params, global GGi
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn void dose_record_standard(global GGEMSDoseParams* dose_params, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
+  \fn void dose_record_standard(global GGEMSDoseParams* dose_params, global GGEdepType* edep_tracking, global GGEdepType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
   \param dose_params - params associated to dosemap
-  \param
+  \param edep_tracking - buffer storing energy deposit, one map per replica
+  \param edep_squared_tracking - buffer storing energy squared deposit, one map per replica
+  \param hit_tracking - buffer storing hits, one map per replica
+  \param edep - energy deposit, multiplied by the statistical weight of particle
+  \param position - position of deposit in local coordinate
   \brief Recording data for dosimetry
 */
-inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGDosiType* edep_tracking, global GGDosiType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
+inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGEdepType* edep_tracking, global GGEdepType* edep_squared_tracking, global GGint* hit_tracking, GGfloat edep, GGfloat3 const* position)
 {
   // Check position of photon inside dosemap limits
   if (position->x < dose_params->border_min_xyz_.x + EPSILON6 || position->x > dose_params->border_max_xyz_.x - EPSILON6) return;
@@ -105,14 +109,12 @@ inline void dose_record_standard(global GGEMSDoseParams* dose_params, global GGD
   if (dosel_id.y < 0 || dosel_id.y >= dose_params->number_of_dosels_.y) return;
   if (dosel_id.z < 0 || dosel_id.z >= dose_params->number_of_dosels_.z) return;
 
-  if (hit_tracking) atomic_add(&hit_tracking[global_dosel_id], 1);
-  #ifdef DOSIMETRY_DOUBLE_PRECISION
-  AtomicAddDouble(&edep_tracking[global_dosel_id], (GGDosiType)edep);
-  if (edep_squared_tracking) AtomicAddDouble(&edep_squared_tracking[global_dosel_id], (GGDosiType)edep*(GGDosiType)edep);
-  #else
-  AtomicAddFloat(&edep_tracking[global_dosel_id], (GGDosiType)edep);
-  if (edep_squared_tracking) AtomicAddFloat(&edep_squared_tracking[global_dosel_id], (GGDosiType)edep*(GGDosiType)edep);
-  #endif
+  // Consecutive work-items record in different replicated maps, a narrow beam collides less on the same dosels. Offset of replicas may exceed 32 bits
+  GGsize replica_dosel_id = (GGsize)global_dosel_id + (GGsize)(get_global_id(0) % dose_params->number_of_replicas_) * (GGsize)dose_params->total_number_of_dosels_;
+
+  if (hit_tracking) atomic_add(&hit_tracking[replica_dosel_id], 1);
+  AtomicAddEdep(&edep_tracking[replica_dosel_id], (GGDosiType)edep);
+  if (edep_squared_tracking) AtomicAddEdep(&edep_squared_tracking[replica_dosel_id], (GGDosiType)edep*(GGDosiType)edep);
 }
 
 #endif
@@ -172,6 +172,55 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void SetMinimumDensity(GGfloat const& minimum_density, std::string const& unit = "g/cm3");
 
+    /*!
+      \fn void SetNumberOfDoseReplicas(GGsize const& number_of_replicas)
+      \param number_of_replicas - number of replicated maps of energy deposit, energy squared deposit and hit
+      \brief deposits of work-items are spread over replicated maps merged before dose computation, atomic operations of a narrow beam collide less on the same dosels. Memory of these maps is multiplied by the number of replicas
+    */
+    void SetNumberOfDoseReplicas(GGsize const& number_of_replicas);
+
+    /*!
+      \fn void SetUncertaintyTarget(GGfloat const& uncertainty, GGfloat const& dose_threshold = 0.5f)
+      \param uncertainty - target of mean relative uncertainty (e.g. 0.02 for 2%)
+      \param dose_threshold - only dosels with a dose above this fraction of the maximum dose in region are used for mean uncertainty
+      \brief simulation is stopped when the mean relative uncertainty of dose reaches the target, uncertainty output is activated. Only available with one source and not in scan
+    */
+    void SetUncertaintyTarget(GGfloat const& uncertainty, GGfloat const& dose_threshold = 0.5f);
+
+    /*!
+      \fn void SetUncertaintyROI(GGint const& x_min, GGint const& y_min, GGint const& z_min, GGint const& x_max, GGint const& y_max, GGint const& z_max)
+      \param x_min - first dosel of region in X
+      \param y_min - first dosel of region in Y
+      \param z_min - first dosel of region in Z
+      \param x_max - last dosel of region in X
+      \param y_max - last dosel of region in Y
+      \param z_max - last dosel of region in Z
+      \brief set the region (in dosel index, bounds included) where mean uncertainty is computed, whole dose map by default
+    */
+    void SetUncertaintyROI(GGint const& x_min, GGint const& y_min, GGint const& z_min, GGint const& x_max, GGint const& y_max, GGint const& z_max);
+
+    /*!
+      \fn inline bool IsUncertaintyTarget(void) const
+      \return true if a target of uncertainty is set
+      \brief checking if simulation can be stopped on target of uncertainty
+    */
+    inline bool IsUncertaintyTarget(void) const {return uncertainty_target_ > 0.0f;}
+
+    /*!
+      \fn GGfloat ComputeUncertaintyRatio(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \return mean relative uncertainty of device divided by target, target is reached below 1
+      \brief computing dose from deposits recorded so far and reducing mean uncertainty on device
+    */
+    GGfloat ComputeUncertaintyRatio(GGsize const& thread_index);
+
+    /*!
+      \fn void SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+      \param particle_scale_factor - number of planned particles divided by number of simulated particles
+      \brief set the scale factor of a simulation stopped before all particles are simulated, applied to dose, hit, edep and edep squared maps
+    */
+    void SetParticleScaleFactor(GGfloat const& particle_scale_factor);
+
     /*!
       \fn inline cl::Buffer* GetPhotonTrackingBuffer(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
@@ -238,6 +287,13 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     */
     void InitializeKernel(void);
 
+    /*!
+      \fn void MergeDoseReplicas(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief summing replicated maps in the first map
+    */
+    void MergeDoseReplicas(GGsize const& thread_index);
+
     /*!
       \fn void SavePhotonTracking(void) const
       \brief save photon tracking
@@ -291,8 +347,21 @@ class GGEMS_EXPORT GGEMSDosimetryCalculator
     GGfloat scale_factor_; /*!< Scale factor */
     GGchar is_water_reference_; /*!< Water reference for dose computation */
     GGfloat minimum_density_; /*!< Minimum density value for dose computation */
+    GGsize number_of_dose_replicas_; /*!< Number of replicated maps of edep, edep squared and hit */
+    GGfloat uncertainty_target_; /*!< Target of mean relative uncertainty, 0 if not used */
+    GGfloat uncertainty_dose_threshold_; /*!< Fraction of maximum dose selecting dosels for mean uncertainty */
+    GGint3 uncertainty_roi_min_; /*!< First dosel of region for mean uncertainty */
+    GGint3 uncertainty_roi_max_; /*!< Last dosel of region for mean uncertainty, negative for whole map */
+    GGfloat particle_scale_factor_; /*!< Number of planned particles divided by number of simulated particles */
+    GGsize number_of_uncertainty_groups_; /*!< Number of work-groups reducing mean uncertainty */
+    cl::Buffer** uncertainty_group_maximum_; /*!< Maximum dose by work-group on OpenCL device */
+    cl::Buffer** uncertainty_group_sum_; /*!< Sum of uncertainties by work-group on OpenCL device */
+    cl::Buffer** uncertainty_group_count_; /*!< Number of selected dosels by work-group on OpenCL device */
 
     cl::Kernel** kernel_compute_dose_; /*!< OpenCL kernel computing dose in voxelized solid */
+    cl::Kernel** kernel_merge_dose_replicas_; /*!< OpenCL kernel summing replicated maps */
+    cl::Kernel** kernel_reduce_maximum_dose_; /*!< OpenCL kernel reducing maximum dose in region */
+    cl::Kernel** kernel_reduce_uncertainty_; /*!< OpenCL kernel reducing uncertainty in region */
     GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
@@ -335,6 +404,36 @@ extern "C" GGEMS_EXPORT void water_reference_dosimetry_calculator(GGEMSDosimetry
 */
 extern "C" GGEMS_EXPORT void minimum_density_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGfloat const minimum_density, char const* unit);
 
+/*!
+  \fn void set_dose_replicas_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGsize const number_of_replicas)
+  \param dose_calculator - pointer on dose calculator
+  \param number_of_replicas - number of replicated maps of energy deposit, energy squared deposit and hit
+  \brief set the number of replicated dose maps
+*/
+extern "C" GGEMS_EXPORT void set_dose_replicas_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGsize const number_of_replicas);
+
+/*!
+  \fn void set_uncertainty_target_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGfloat const uncertainty, GGfloat const dose_threshold)
+  \param dose_calculator - pointer on dose calculator
+  \param uncertainty - target of mean relative uncertainty
+  \param dose_threshold - fraction of the maximum dose selecting dosels for mean uncertainty
+  \brief set the target of uncertainty stopping the simulation
+*/
+extern "C" GGEMS_EXPORT void set_uncertainty_target_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGfloat const uncertainty, GGfloat const dose_threshold);
+
+/*!
+  \fn void set_uncertainty_roi_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGint const x_min, GGint const y_min, GGint const z_min, GGint const x_max, GGint const y_max, GGint const z_max)
+  \param dose_calculator - pointer on dose calculator
+  \param x_min - first dosel of region in X
+  \param y_min - first dosel of region in Y
+  \param z_min - first dosel of region in Z
+  \param x_max - last dosel of region in X
+  \param y_max - last dosel of region in Y
+  \param z_max - last dosel of region in Z
+  \brief set the region where mean uncertainty is computed
+*/
+extern "C" GGEMS_EXPORT void set_uncertainty_roi_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGint const x_min, GGint const y_min, GGint const z_min, GGint const x_max, GGint const y_max, GGint const z_max);
+
 /*!
   \fn void set_dosel_size_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGfloat const dose_x, GGfloat const dose_y, GGfloat const dose_z, char const* unit)
   \param dose_calculator - pointer on dose calculator
@@ -0,0 +1,328 @@
+#ifndef GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTION_HH
+#define GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTION_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSForcedDetection.hh
+
+  \brief Class computing the expected projections of a system by forced detection, primary projection by ray tracing and scatter projection at each Compton scattering in phantom
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#ifdef _MSC_VER
+#pragma warning(disable: 4251) // Deleting warning exporting STL members!!!
+#endif
+
+#include "GGEMS/global/GGEMSExport.hh"
+#include "GGEMS/tools/GGEMSTypes.hh"
+
+class GGEMSNavigator;
+class GGEMSSystem;
+class GGEMSXRaySource;
+
+/*!
+  \class GGEMSForcedDetection
+  \brief Class computing the expected projections of a system by forced detection. The primary projection is computed once by ray tracing from the X-ray source through the phantom, and each Compton scattering in phantom adds its probability to be detected to the scatter projection
+*/
+class GGEMS_EXPORT GGEMSForcedDetection
+{
+  public:
+    /*!
+      \brief GGEMSForcedDetection constructor
+    */
+    GGEMSForcedDetection(void);
+
+    /*!
+      \brief GGEMSForcedDetection destructor
+    */
+    ~GGEMSForcedDetection(void);
+
+    /*!
+      \fn GGEMSForcedDetection(GGEMSForcedDetection const& forced_detection) = delete
+      \param forced_detection - reference on the GGEMS forced detection
+      \brief Avoid copy by reference
+    */
+    GGEMSForcedDetection(GGEMSForcedDetection const& forced_detection) = delete;
+
+    /*!
+      \fn GGEMSForcedDetection& operator=(GGEMSForcedDetection const& forced_detection) = delete
+      \param forced_detection - reference on the GGEMS forced detection
+      \brief Avoid assignement by reference
+    */
+    GGEMSForcedDetection& operator=(GGEMSForcedDetection const& forced_detection) = delete;
+
+    /*!
+      \fn GGEMSForcedDetection(GGEMSForcedDetection const&& forced_detection) = delete
+      \param forced_detection - rvalue reference on the GGEMS forced detection
+      \brief Avoid copy by rvalue reference
+    */
+    GGEMSForcedDetection(GGEMSForcedDetection const&& forced_detection) = delete;
+
+    /*!
+      \fn GGEMSForcedDetection& operator=(GGEMSForcedDetection const&& forced_detection) = delete
+      \param forced_detection - rvalue reference on the GGEMS forced detection
+      \brief Avoid copy by rvalue reference
+    */
+    GGEMSForcedDetection& operator=(GGEMSForcedDetection const&& forced_detection) = delete;
+
+    /*!
+      \fn void AttachToNavigator(std::string const& navigator_name)
+      \param navigator_name - name of the voxelized phantom to attach
+      \brief attach a voxelized phantom to forced detection, Compton scatterings in this phantom are forced to the detector
+    */
+    void AttachToNavigator(std::string const& navigator_name);
+
+    /*!
+      \fn void SetDetector(std::string const& system_name)
+      \param system_name - name of the system
+      \brief set the system receiving the forced detection
+    */
+    void SetDetector(std::string const& system_name);
+
+    /*!
+      \fn void SetSource(std::string const& source_name)
+      \param source_name - name of the X-ray source
+      \brief set the X-ray source used for the primary projection, a point source (focal spot size of 0) with a beam aperture > 0
+    */
+    void SetSource(std::string const& source_name);
+
+    /*!
+      \fn void SetOutputForcedDetectionBasename(std::string const& output_filename)
+      \param output_filename - basename of output projections
+      \brief set output basename storing forced detection projections
+    */
+    void SetOutputForcedDetectionBasename(std::string const& output_filename);
+
+    /*!
+      \fn void SetPrimaryProjection(bool const& is_activated)
+      \param is_activated - boolean activating primary projection
+      \brief activating primary projection computed by ray tracing
+    */
+    void SetPrimaryProjection(bool const& is_activated);
+
+    /*!
+      \fn void SetScatterProjection(bool const& is_activated)
+      \param is_activated - boolean activating scatter projection
+      \brief activating scatter projection computed at each Compton scattering in phantom
+    */
+    void SetScatterProjection(bool const& is_activated);
+
+    /*!
+      \fn inline bool IsScatterProjection(void) const
+      \return true if scatter projection is activated
+      \brief checking if Compton scatterings of phantom are forced to the detector
+    */
+    inline bool IsScatterProjection(void) const {return is_scatter_projection_;}
+
+    /*!
+      \fn void SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+      \param particle_scale_factor - number of planned particles divided by number of simulated particles
+      \brief set the scale factor of a simulation stopped before all particles are simulated, applied to scatter projection
+    */
+    void SetParticleScaleFactor(GGfloat const& particle_scale_factor);
+
+    /*!
+      \fn void Initialize(void)
+      \brief Initialize forced detection, called when phantom, system and source are initialized
+    */
+    void Initialize(void);
+
+    /*!
+      \fn inline cl::Buffer* GetForcedDetectionParams(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing layout of detection elements
+      \brief get the buffer storing forced detection params
+    */
+    inline cl::Buffer* GetForcedDetectionParams(GGsize const& thread_index) const {return forced_detection_params_[thread_index];}
+
+    /*!
+      \fn inline cl::Buffer* GetDetectorData(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing data of all modules of system
+      \brief get the buffer storing data of all modules of system
+    */
+    inline cl::Buffer* GetDetectorData(GGsize const& thread_index) const {return detector_data_[thread_index];}
+
+    /*!
+      \fn cl::Buffer* GetDetectorCrossSections(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing cross sections of system
+      \brief get the buffer storing cross sections of system
+    */
+    cl::Buffer* GetDetectorCrossSections(GGsize const& thread_index) const;
+
+    /*!
+      \fn cl::Buffer* GetDetectorPhotonCrossSections(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing packed photon cross sections of system
+      \brief get the buffer storing packed photon cross sections of system
+    */
+    cl::Buffer* GetDetectorPhotonCrossSections(GGsize const& thread_index) const;
+
+    /*!
+      \fn inline cl::Buffer* GetScatterProjection(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing scatter projection
+      \brief get the buffer storing scatter projection
+    */
+    inline cl::Buffer* GetScatterProjection(GGsize const& thread_index) const {return scatter_projection_[thread_index];}
+
+    /*!
+      \fn void SaveResults(void)
+      \brief compute primary projection and save projections
+    */
+    void SaveResults(void);
+
+  private:
+    /*!
+      \fn void CheckParameters(void) const
+      \return no returned value
+    */
+    void CheckParameters(void) const;
+
+    /*!
+      \fn void InitializeDetectorAndSource(void)
+      \brief get the system and the X-ray source from their names, they are declared in any order before initialization
+    */
+    void InitializeDetectorAndSource(void);
+
+    /*!
+      \fn void InitializeKernel(void)
+      \brief Initialize kernel computing primary projection
+    */
+    void InitializeKernel(void);
+
+    /*!
+      \fn void ComputePrimaryProjection(void)
+      \brief compute primary projection on first device
+    */
+    void ComputePrimaryProjection(void);
+
+    /*!
+      \fn void SaveProjection(std::string const& suffix, GGDosiType* projection) const
+      \param suffix - suffix added to output basename
+      \param projection - projection on host
+      \brief write a projection in MHD format
+    */
+    void SaveProjection(std::string const& suffix, GGDosiType* projection) const;
+
+    /*!
+      \fn void SavePrimaryProjection(void) const
+      \brief save primary projection
+    */
+    void SavePrimaryProjection(void) const;
+
+    /*!
+      \fn void SaveScatterProjection(void) const
+      \brief save scatter projection, sum of all devices
+    */
+    void SaveScatterProjection(void) const;
+
+  private:
+    std::string forced_detection_output_filename_; /*!< Output basename for forced detection projections */
+    GGEMSNavigator* navigator_; /*!< Voxelized phantom associated to forced detection */
+    std::string detector_name_; /*!< Name of system receiving forced detection */
+    GGEMSSystem* detector_; /*!< System receiving forced detection */
+    std::string source_name_; /*!< Name of X-ray source of primary projection */
+    GGEMSXRaySource* source_; /*!< X-ray source of primary projection */
+    bool is_primary_projection_; /*!< Boolean for primary projection */
+    bool is_scatter_projection_; /*!< Boolean for scatter projection */
+    GGfloat particle_scale_factor_; /*!< Number of planned particles divided by number of simulated particles */
+    GGsize number_of_modules_; /*!< Number of modules of system */
+    GGsize number_of_pixels_; /*!< Number of detection elements in projection */
+
+    // Buffers on OpenCL device
+    cl::Buffer** forced_detection_params_; /*!< Buffer storing layout of detection elements */
+    cl::Buffer** detector_data_; /*!< Buffer storing data of all modules */
+    cl::Buffer** scatter_projection_; /*!< Buffer storing scatter projection */
+    cl::Buffer* primary_projection_; /*!< Buffer storing primary projection, on first device only */
+
+    cl::Kernel** kernel_project_primary_; /*!< OpenCL kernel computing primary projection */
+    GGsize number_activated_devices_; /*!< Number of activated device */
+};
+
+/*!
+  \fn GGEMSForcedDetection* create_ggems_forced_detection(void)
+  \return the pointer on the forced detection
+  \brief Get the GGEMSForcedDetection pointer for python user.
+*/
+extern "C" GGEMS_EXPORT GGEMSForcedDetection* create_ggems_forced_detection(void);
+
+/*!
+  \fn void delete_ggems_forced_detection(GGEMSForcedDetection* forced_detection)
+  \param forced_detection - pointer on forced detection
+  \brief Delete instance of GGEMSForcedDetection
+*/
+extern "C" GGEMS_EXPORT void delete_ggems_forced_detection(GGEMSForcedDetection* forced_detection);
+
+/*!
+  \fn void attach_to_navigator_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* navigator)
+  \param forced_detection - pointer on forced detection
+  \param navigator - name of the voxelized phantom to attach
+  \brief attach forced detection to a voxelized phantom
+*/
+extern "C" GGEMS_EXPORT void attach_to_navigator_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* navigator);
+
+/*!
+  \fn void set_detector_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* system)
+  \param forced_detection - pointer on forced detection
+  \param system - name of the system
+  \brief set the system receiving the forced detection
+*/
+extern "C" GGEMS_EXPORT void set_detector_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* system);
+
+/*!
+  \fn void set_source_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* source)
+  \param forced_detection - pointer on forced detection
+  \param source - name of the X-ray source
+  \brief set the X-ray source used for the primary projection
+*/
+extern "C" GGEMS_EXPORT void set_source_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* source);
+
+/*!
+  \fn void set_output_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* output_filename)
+  \param forced_detection - pointer on forced detection
+  \param output_filename - basename of output projections
+  \brief set output basename storing forced detection projections
+*/
+extern "C" GGEMS_EXPORT void set_output_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* output_filename);
+
+/*!
+  \fn void set_primary_projection_ggems_forced_detection(GGEMSForcedDetection* forced_detection, bool const is_activated)
+  \param forced_detection - pointer on forced detection
+  \param is_activated - boolean activating primary projection
+  \brief activating primary projection
+*/
+extern "C" GGEMS_EXPORT void set_primary_projection_ggems_forced_detection(GGEMSForcedDetection* forced_detection, bool const is_activated);
+
+/*!
+  \fn void set_scatter_projection_ggems_forced_detection(GGEMSForcedDetection* forced_detection, bool const is_activated)
+  \param forced_detection - pointer on forced detection
+  \param is_activated - boolean activating scatter projection
+  \brief activating scatter projection
+*/
+extern "C" GGEMS_EXPORT void set_scatter_projection_ggems_forced_detection(GGEMSForcedDetection* forced_detection, bool const is_activated);
+
+#endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTION_HH
@@ -0,0 +1,50 @@
+#ifndef GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTIONPARAMS_HH
+#define GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTIONPARAMS_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSForcedDetectionParams.hh
+
+  \brief Structure storing forced detection infos
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/tools/GGEMSTypes.hh"
+
+/*!
+  \struct GGEMSForcedDetectionParams_t
+  \brief Structure storing the layout of detection elements for forced detection, modules are side by side in projection as in system output
+*/
+typedef struct GGEMSForcedDetectionParams_t
+{
+  GGint number_of_modules_; /*!< Number of modules of detector */
+  GGint number_of_modules_x_; /*!< Number of modules in X of projection */
+  GGint number_of_elements_x_; /*!< Number of detection elements in X inside a module */
+  GGint number_of_elements_y_; /*!< Number of detection elements in Y inside a module */
+  GGint projection_dimension_x_; /*!< Number of detection elements in X of projection */
+  GGint number_of_pixels_; /*!< Total number of detection elements in projection */
+} GGEMSForcedDetectionParams; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+#endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTIONPARAMS_HH
@@ -0,0 +1,393 @@
+#ifndef GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTIONRECORDING_HH
+#define GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTIONRECORDING_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSForcedDetectionRecording.hh
+
+  \brief Functions computing the expected contribution of a photon to each detection element of a system (forced detection), only for OpenCL kernel usage
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+
+#include "GGEMS/geometries/GGEMSSolidBoxData.hh"
+#include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
+#include "GGEMS/geometries/GGEMSRayTracing.hh"
+
+#include "GGEMS/materials/GGEMSMaterialTables.hh"
+
+#include "GGEMS/physics/GGEMSParticleCrossSections.hh"
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+#include "GGEMS/maths/GGEMSMatrixOperations.hh"
+#include "GGEMS/maths/GGEMSReferentialTransformation.hh"
+#include "GGEMS/navigators/GGEMSPhotonNavigator.hh"
+#include "GGEMS/navigators/GGEMSForcedDetectionParams.hh"
+
+/*!
+  \fn inline void AtomicAddProjection(volatile global GGDosiType* address, GGfloat val)
+  \param address - address of pixel in projection
+  \param val - expected number of counts added
+  \brief atomic addition in a forced detection projection, in double precision with DOSIMETRY_DOUBLE_PRECISION
+*/
+inline void AtomicAddProjection(volatile global GGDosiType* address, GGfloat val)
+{
+  #ifdef DOSIMETRY_DOUBLE_PRECISION
+  AtomicAddDouble(address, (GGdouble)val);
+  #else
+  AtomicAddFloat(address, val);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat ComputeOpticalDepthInVoxelizedSolid(global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGfloat const energy, GGfloat3 const* start, GGfloat3 const* end)
+  \param voxelized_solid_data - pointer to voxelized solid data
+  \param label_data - pointer storing label of material
+  \param particle_cross_sections - pointer to cross sections activated in voxelized solid
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param energy - energy of photon
+  \param start - start of segment in local coordinate of voxelized solid
+  \param end - end of segment in local coordinate of voxelized solid
+  \return sum of total cross section times length over voxels crossed by the segment
+  \brief Optical depth of a segment in voxelized solid, the segment is clipped by the solid and voxels are stepped as in DDA tracking
+*/
+inline GGfloat ComputeOpticalDepthInVoxelizedSolid(
+  global GGEMSVoxelizedSolidData const* voxelized_solid_data,
+  global GGuchar const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  GGfloat const energy,
+  GGfloat3 const* start,
+  GGfloat3 const* end
+)
+{
+  GGfloat3 border_min = voxelized_solid_data->obb_geometry_.border_min_xyz_;
+  GGfloat3 border_max = voxelized_solid_data->obb_geometry_.border_max_xyz_;
+  GGfloat3 voxel_size = voxelized_solid_data->voxel_sizes_xyz_;
+  GGint3 number_of_voxels = voxelized_solid_data->number_of_voxels_xyz_;
+
+  GGfloat3 segment = *end - *start;
+  GGfloat segment_length = length(segment);
+  if (segment_length < EPSILON6) return 0.0f;
+  GGfloat3 direction = segment / segment_length;
+
+  // Part of segment inside solid
+  GGfloat t_entry = 0.0f;
+  GGfloat t_exit = segment_length;
+  if (!ClipRayToSlab(start->x, direction.x, border_min.x, border_max.x, &t_entry, &t_exit)) return 0.0f;
+  if (!ClipRayToSlab(start->y, direction.y, border_min.y, border_max.y, &t_entry, &t_exit)) return 0.0f;
+  if (!ClipRayToSlab(start->z, direction.z, border_min.z, border_max.z, &t_entry, &t_exit)) return 0.0f;
+
+  // Energy bin is the same along the segment
+  GGfloat weight = 0.0f;
+  GGint energy_id = GetPhotonEnergyBin(particle_cross_sections, energy, &weight);
+
+  // First voxel, then distances along segment to next voxel border on each axis
+  GGfloat3 entry_position = *start + direction*t_entry;
+  GGint3 voxel_id = clamp(convert_int3((entry_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - 1);
+
+  GGint3 step = (GGint3)(direction.x > 0.0f ? 1 : -1, direction.y > 0.0f ? 1 : -1, direction.z > 0.0f ? 1 : -1);
+  GGfloat3 next_border = border_min + convert_float3(voxel_id + (GGint3)(step.x > 0, step.y > 0, step.z > 0))*voxel_size;
+
+  GGfloat3 t_delta;
+  t_delta.x = direction.x != 0.0f ? voxel_size.x/fabs(direction.x) : FLT_MAX;
+  t_delta.y = direction.y != 0.0f ? voxel_size.y/fabs(direction.y) : FLT_MAX;
+  t_delta.z = direction.z != 0.0f ? voxel_size.z/fabs(direction.z) : FLT_MAX;
+
+  GGfloat3 t_max;
+  t_max.x = direction.x != 0.0f ? (next_border.x - start->x)/direction.x : FLT_MAX;
+  t_max.y = direction.y != 0.0f ? (next_border.y - start->y)/direction.y : FLT_MAX;
+  t_max.z = direction.z != 0.0f ? (next_border.z - start->z)/direction.z : FLT_MAX;
+
+  GGfloat optical_depth = 0.0f;
+  GGfloat t_current = t_entry;
+  while (t_current < t_exit) {
+    GGuchar material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
+    GGfloat t_next = fmin(fmin(t_max.x, t_max.y), fmin(t_max.z, t_exit));
+
+    optical_depth += GetPhotonTotalCrossSection(particle_cross_sections, photon_cross_sections, energy_id, weight, material_id)*fmax(t_next - t_current, 0.0f);
+    t_current = t_next;
+
+    // Crossing the nearest voxel border
+    if (t_max.x < t_max.y && t_max.x < t_max.z) {
+      t_max.x += t_delta.x;
+      voxel_id.x += step.x;
+    }
+    else if (t_max.y < t_max.z) {
+      t_max.y += t_delta.y;
+      voxel_id.y += step.y;
+    }
+    else {
+      t_max.z += t_delta.z;
+      voxel_id.z += step.z;
+    }
+
+    if (voxel_id.x < 0 || voxel_id.x >= number_of_voxels.x || voxel_id.y < 0 || voxel_id.y >= number_of_voxels.y || voxel_id.z < 0 || voxel_id.z >= number_of_voxels.z) break;
+  }
+
+  return optical_depth;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat ComputeDetectionProbability(global GGEMSParticleCrossSections const* detector_particle_cross_sections, global GGfloat const* detector_photon_cross_sections, GGfloat const energy, GGfloat const chord_length)
+  \param detector_particle_cross_sections - pointer to cross sections activated in system
+  \param detector_photon_cross_sections - pointer to packed photon cross sections of system
+  \param energy - energy of photon
+  \param chord_length - length of photon path in detection element
+  \return probability of a first interaction recorded by the histogram of system
+  \brief Probability of a first photoelectric effect or Compton scattering in the detection element, the material of all modules of a system is the first material
+*/
+inline GGfloat ComputeDetectionProbability(
+  global GGEMSParticleCrossSections const* detector_particle_cross_sections,
+  global GGfloat const* detector_photon_cross_sections,
+  GGfloat const energy,
+  GGfloat const chord_length
+)
+{
+  GGfloat weight = 0.0f;
+  GGint energy_id = GetPhotonEnergyBin(detector_particle_cross_sections, energy, &weight);
+
+  global GGfloat const* photon_cross_sections_a = detector_photon_cross_sections + PHOTON_CROSS_SECTION_INDEX(0, energy_id, 0, detector_particle_cross_sections->number_of_bins_);
+  global GGfloat const* photon_cross_sections_b = photon_cross_sections_a + PHOTON_CROSS_SECTION_STRIDE;
+
+  GGfloat total_cross_section = mad(weight, photon_cross_sections_b[PHOTON_TOTAL_CROSS_SECTION]-photon_cross_sections_a[PHOTON_TOTAL_CROSS_SECTION], photon_cross_sections_a[PHOTON_TOTAL_CROSS_SECTION]);
+  if (total_cross_section <= 0.0f) return 0.0f;
+
+  // Rayleigh scattering is not recorded by system
+  GGfloat recorded_cross_section = 0.0f;
+  for (GGsize i = 0; i < detector_particle_cross_sections->number_of_activated_photon_processes_; ++i) {
+    GGchar process_id = detector_particle_cross_sections->photon_cs_id_[i];
+    if (process_id == RAYLEIGH_SCATTERING) continue;
+    recorded_cross_section += mad(weight, photon_cross_sections_b[process_id]-photon_cross_sections_a[process_id], photon_cross_sections_a[process_id]);
+  }
+
+  return (1.0f - exp(-total_cross_section*chord_length))*recorded_cross_section/total_cross_section;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void GetDetectionElementBorders(global GGEMSSolidBoxData const* module_data, GGint const element_x, GGint const element_y, GGfloat3* element_border_min, GGfloat3* element_border_max)
+  \param module_data - pointer to data of module
+  \param element_x - index of detection element in X of module
+  \param element_y - index of detection element in Y of module
+  \param element_border_min - min. borders of detection element in local coordinate of module
+  \param element_border_max - max. borders of detection element in local coordinate of module
+  \brief Borders of a detection element, elements are columns along local Z of module as in histogram of system
+*/
+inline void GetDetectionElementBorders(
+  global GGEMSSolidBoxData const* module_data,
+  GGint const element_x,
+  GGint const element_y,
+  GGfloat3* element_border_min,
+  GGfloat3* element_border_max
+)
+{
+  GGfloat element_size_x = module_data->box_size_xyz_[0] / (GGfloat)module_data->virtual_element_number_xyz_[0];
+  GGfloat element_size_y = module_data->box_size_xyz_[1] / (GGfloat)module_data->virtual_element_number_xyz_[1];
+
+  element_border_min->x = module_data->obb_geometry_.border_min_xyz_.x + element_x*element_size_x;
+  element_border_min->y = module_data->obb_geometry_.border_min_xyz_.y + element_y*element_size_y;
+  element_border_min->z = module_data->obb_geometry_.border_min_xyz_.z;
+
+  element_border_max->x = element_border_min->x + element_size_x;
+  element_border_max->y = element_border_min->y + element_size_y;
+  element_border_max->z = module_data->obb_geometry_.border_max_xyz_.z;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat ComputeDetectionElementContribution(global GGEMSParticleCrossSections const* detector_particle_cross_sections, global GGfloat const* detector_photon_cross_sections, GGfloat const energy, GGfloat3 const* position, GGfloat3 const* element_border_min, GGfloat3 const* element_border_max)
+  \param detector_particle_cross_sections - pointer to cross sections activated in system
+  \param detector_photon_cross_sections - pointer to packed photon cross sections of system
+  \param energy - energy of photon
+  \param position - position of emission in local coordinate of module
+  \param element_border_min - min. borders of detection element in local coordinate of module
+  \param element_border_max - max. borders of detection element in local coordinate of module
+  \return solid angle of detection element times detection probability
+  \brief Contribution of a detection element seen from a point, the photon is aimed at the center of element and the solid angle is its projected area divided by distance squared
+*/
+inline GGfloat ComputeDetectionElementContribution(
+  global GGEMSParticleCrossSections const* detector_particle_cross_sections,
+  global GGfloat const* detector_photon_cross_sections,
+  GGfloat const energy,
+  GGfloat3 const* position,
+  GGfloat3 const* element_border_min,
+  GGfloat3 const* element_border_max
+)
+{
+  GGfloat3 element_center = 0.5f*(*element_border_min + *element_border_max);
+  GGfloat3 to_center = element_center - *position;
+  GGfloat distance_squared = dot(to_center, to_center);
+  if (distance_squared < EPSILON6) return 0.0f;
+
+  GGfloat3 direction = to_center / sqrt(distance_squared);
+
+  // Photon path in element
+  GGfloat t_entry = 0.0f;
+  GGfloat t_exit = FLT_MAX;
+  if (!ClipRayToSlab(position->x, direction.x, element_border_min->x, element_border_max->x, &t_entry, &t_exit)) return 0.0f;
+  if (!ClipRayToSlab(position->y, direction.y, element_border_min->y, element_border_max->y, &t_entry, &t_exit)) return 0.0f;
+  if (!ClipRayToSlab(position->z, direction.z, element_border_min->z, element_border_max->z, &t_entry, &t_exit)) return 0.0f;
+
+  GGfloat element_area = (element_border_max->x - element_border_min->x)*(element_border_max->y - element_border_min->y);
+  GGfloat solid_angle = element_area*fabs(direction.z)/distance_squared;
+
+  return solid_angle*ComputeDetectionProbability(detector_particle_cross_sections, detector_photon_cross_sections, energy, t_exit - t_entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat KleinNishinaAngularProbability(GGfloat const energy, GGfloat const cos_theta, GGfloat* scattered_energy)
+  \param energy - energy of incident photon
+  \param cos_theta - cosine of scattering angle
+  \param scattered_energy - energy of scattered photon
+  \return probability density per steradian of scattering angle
+  \brief Klein-Nishina differential cross section divided by total cross section, same model as KleinNishinaComptonSampleSecondaries
+*/
+inline GGfloat KleinNishinaAngularProbability(GGfloat const energy, GGfloat const cos_theta, GGfloat* scattered_energy)
+{
+  GGfloat k = energy / ELECTRON_MASS_C2;
+  GGfloat epsilon = 1.0f / (1.0f + k*(1.0f - cos_theta));
+  GGfloat sin_theta_squared = 1.0f - cos_theta*cos_theta;
+
+  *scattered_energy = energy*epsilon;
+
+  // Differential and total cross sections in classical electron radius squared
+  GGfloat differential_cross_section = 0.5f*epsilon*epsilon*(epsilon + 1.0f/epsilon - sin_theta_squared);
+
+  GGfloat total_cross_section = 0.0f;
+  if (k < 0.01f) { // Expansion around Thomson cross section, exact formula loses precision in float
+    total_cross_section = (8.0f*PI/3.0f)*(1.0f - 2.0f*k + 5.2f*k*k);
+  }
+  else {
+    GGfloat one_two_k = 1.0f + 2.0f*k;
+    GGfloat log_one_two_k = log(one_two_k);
+    total_cross_section = TWO_PI*(
+      (1.0f + k)/(k*k)*(2.0f*(1.0f + k)/one_two_k - log_one_two_k/k) +
+      log_one_two_k/(2.0f*k) -
+      (1.0f + 3.0f*k)/(one_two_k*one_two_k)
+    );
+  }
+
+  return differential_cross_section / total_cross_section;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void ForceComptonDetection(global GGEMSForcedDetectionParams const* forced_detection_params, global GGEMSSolidBoxData const* detector_data, global GGEMSParticleCrossSections const* detector_particle_cross_sections, global GGfloat const* detector_photon_cross_sections, global GGDosiType* forced_scatter_projection, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGfloat3 const* local_position, GGEMSPhotonState const* photon)
+  \param forced_detection_params - layout of detection elements in projection
+  \param detector_data - data of all modules of system
+  \param detector_particle_cross_sections - pointer to cross sections activated in system
+  \param detector_photon_cross_sections - pointer to packed photon cross sections of system
+  \param forced_scatter_projection - expected counts of scattered photons in each detection element
+  \param voxelized_solid_data - pointer to voxelized solid data
+  \param label_data - pointer storing label of material
+  \param particle_cross_sections - pointer to cross sections activated in voxelized solid
+  \param photon_cross_sections - pointer to packed photon cross sections of voxelized solid
+  \param local_position - position of Compton scattering in local coordinate of voxelized solid
+  \param photon - photon before scattering, direction in local coordinate of voxelized solid
+  \brief At a Compton scattering, adds to each detection element the probability that the scattered photon is emitted toward it, crosses the phantom and is detected, multiplied by the statistical weight of photon
+*/
+inline void ForceComptonDetection(
+  global GGEMSForcedDetectionParams const* forced_detection_params,
+  global GGEMSSolidBoxData const* detector_data,
+  global GGEMSParticleCrossSections const* detector_particle_cross_sections,
+  global GGfloat const* detector_photon_cross_sections,
+  global GGDosiType* forced_scatter_projection,
+  global GGEMSVoxelizedSolidData const* voxelized_solid_data,
+  global GGuchar const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  GGfloat3 const* local_position,
+  GGEMSPhotonState const* photon
+)
+{
+  GGfloat3 global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, local_position);
+
+  for (GGint m = 0; m < forced_detection_params->number_of_modules_; ++m) {
+    global GGEMSSolidBoxData const* module_data = detector_data + m;
+    GGfloat3 module_position = GlobalToLocalPosition(&module_data->obb_geometry_.matrix_transformation_, &global_position);
+
+    GGint pixel_offset_x = (m % forced_detection_params->number_of_modules_x_)*forced_detection_params->number_of_elements_x_;
+    GGint pixel_offset_y = (m / forced_detection_params->number_of_modules_x_)*forced_detection_params->number_of_elements_y_;
+
+    for (GGint j = 0; j < forced_detection_params->number_of_elements_y_; ++j) {
+      for (GGint i = 0; i < forced_detection_params->number_of_elements_x_; ++i) {
+        GGfloat3 element_border_min, element_border_max;
+        GetDetectionElementBorders(module_data, i, j, &element_border_min, &element_border_max);
+
+        // Scattering angle toward center of element, in frame of voxelized solid
+        GGfloat3 element_center = 0.5f*(element_border_min + element_border_max);
+        GGfloat3 global_element_center = LocalToGlobalPosition(&module_data->obb_geometry_.matrix_transformation_, &element_center);
+        GGfloat3 local_element_center = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_element_center);
+
+        GGfloat3 scattered_direction = normalize(local_element_center - *local_position);
+        GGfloat scattered_energy = 0.0f;
+        GGfloat angular_probability = KleinNishinaAngularProbability(photon->E_, dot(scattered_direction, photon->direction_), &scattered_energy);
+
+        // Detection first, ray tracing in phantom only if element can record the photon
+        GGfloat contribution = photon->weight_*angular_probability*ComputeDetectionElementContribution(
+          detector_particle_cross_sections, detector_photon_cross_sections, scattered_energy,
+          &module_position, &element_border_min, &element_border_max
+        );
+        if (contribution <= 0.0f) continue;
+
+        contribution *= exp(-ComputeOpticalDepthInVoxelizedSolid(
+          voxelized_solid_data, label_data, particle_cross_sections, photon_cross_sections,
+          scattered_energy, local_position, &local_element_center
+        ));
+
+        AtomicAddProjection(&forced_scatter_projection[(i + pixel_offset_x) + (j + pixel_offset_y)*forced_detection_params->projection_dimension_x_], contribution);
+      }
+    }
+  }
+}
+
+#endif
+
+#endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSFORCEDDETECTIONRECORDING_HH
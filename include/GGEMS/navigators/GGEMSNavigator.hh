@@ -46,6 +46,7 @@ class GGEMSSolid;
 class GGEMSMaterials;
 class GGEMSCrossSections;
 class GGEMSDosimetryCalculator;
+class GGEMSForcedDetection;
 
 /*!
   \class GGEMSNavigator
@@ -169,21 +170,21 @@ class GGEMS_EXPORT GGEMSNavigator
       \param thread_index - index of activated device (thread index)
       \brief Compute distance between particle and solid
     */
-    void ParticleSolidDistance(GGsize const& thread_index);
+    virtual void ParticleSolidDistance(GGsize const& thread_index);
 
     /*!
       \fn void ProjectToSolid(GGsize const& thread_index)
       \param thread_index - index of activated device (thread index)
       \brief Project particle to entry of closest solid
     */
-    void ProjectToSolid(GGsize const& thread_index);
+    virtual void ProjectToSolid(GGsize const& thread_index);
 
     /*!
       \fn void TrackThroughSolid(GGsize const& thread_index)
       \param thread_index - index of activated device (thread index)
       \brief Move particle through solid
     */
-    void TrackThroughSolid(GGsize const& thread_index);
+    virtual void TrackThroughSolid(GGsize const& thread_index);
 
     /*!
       \fn void PrintInfos(void) const
@@ -210,6 +211,28 @@ class GGEMS_EXPORT GGEMSNavigator
     */
     void ComputeDose(GGsize const& thread_index);
 
+    /*!
+      \fn bool IsUncertaintyTarget(void) const
+      \return true if dosimetry of navigator has a target of uncertainty
+      \brief checking if simulation can be stopped on uncertainty of navigator
+    */
+    bool IsUncertaintyTarget(void) const;
+
+    /*!
+      \fn GGfloat ComputeUncertaintyRatio(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \return mean uncertainty divided by target on device
+      \brief computing the uncertainty ratio of dosimetry in navigator
+    */
+    GGfloat ComputeUncertaintyRatio(GGsize const& thread_index);
+
+    /*!
+      \fn void SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+      \param particle_scale_factor - number of planned particles divided by number of simulated particles
+      \brief set the scale factor of dose for a simulation stopped before all particles are simulated
+    */
+    void SetParticleScaleFactor(GGfloat const& particle_scale_factor);
+
     /*!
       \fn void StoreOutput(std::string basename)
       \param basename - basename of the output file
@@ -224,6 +247,33 @@ class GGEMS_EXPORT GGEMSNavigator
     */
     void SetDosimetryCalculator(GGEMSDosimetryCalculator* dosimetry_calculator);
 
+    /*!
+      \fn void SetForcedDetection(GGEMSForcedDetection* forced_detection)
+      \param forced_detection - pointer on forced detection
+      \brief give adress of forced detection to navigator
+    */
+    void SetForcedDetection(GGEMSForcedDetection* forced_detection);
+
+    /*!
+      \fn inline bool IsForcedDetection(void) const
+      \return true if forced detection is activated in navigator
+      \brief checking if forced detection is activated in navigator
+    */
+    inline bool IsForcedDetection(void) const {return is_forced_detection_mode_;}
+
+    /*!
+      \fn void InitializeForcedDetection(void)
+      \brief Initialize forced detection of navigator, called when all navigators are initialized
+    */
+    void InitializeForcedDetection(void);
+
+    /*!
+      \fn inline bool IsParticleSplitting(void) const
+      \return true if particles are split or rouletted in navigator
+      \brief checking if particle splitting is activated in navigator
+    */
+    inline bool IsParticleSplitting(void) const {return is_particle_splitting_;}
+
     /*!
       \fn void EnableTracking(void)
       \brief Enable tracking during simulation
@@ -261,6 +311,15 @@ class GGEMS_EXPORT GGEMSNavigator
     GGEMSDosimetryCalculator* dose_calculator_; /*!< Dose calculator pointer */
     bool is_dosimetry_mode_; /*!< Boolean checking if dosimetry mode is activated */
 
+    // Forced detection
+    GGEMSForcedDetection* forced_detection_; /*!< Forced detection pointer */
+    bool is_forced_detection_mode_; /*!< Boolean checking if forced detection mode is activated */
+
+    // Particle splitting
+    GGfloat importance_; /*!< Importance of navigator, weight of particles is kept around its inverse */
+    std::string importance_map_filename_; /*!< MHD file storing importance of each voxel relative to navigator */
+    bool is_particle_splitting_; /*!< Boolean checking if particle splitting is activated */
+
     GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
@@ -166,6 +166,20 @@ class GGEMS_EXPORT GGEMSNavigatorManager
       return number_of_registered_solid;
     }
 
+    /*!
+      \fn inline bool IsParticleSplitting(void) const
+      \return true if particle splitting is activated in a navigator
+      \brief checking if particles are split or rouletted in a navigator
+    */
+    inline bool IsParticleSplitting(void) const
+    {
+      for (GGsize i = 0; i < number_of_navigators_; ++i) {
+        if (navigators_[i]->IsParticleSplitting()) return true;
+      }
+
+      return false;
+    }
+
     /*!
       \fn void FindSolid(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
@@ -183,7 +197,7 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     /*!
       \fn void TrackThroughSolid(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
-      \brief Track particles through selected solid
+      \brief Track particles through selected solid, free slots for split particles are listed before
     */
     void TrackThroughSolid(GGsize const& thread_index) const;
 
@@ -207,6 +221,28 @@ class GGEMS_EXPORT GGEMSNavigatorManager
     */
     void ComputeDose(GGsize const& thread_index);
 
+    /*!
+      \fn bool IsUncertaintyTarget(void) const
+      \return true if at least one navigator has a target of uncertainty
+      \brief checking if simulation can be stopped on uncertainty
+    */
+    bool IsUncertaintyTarget(void) const;
+
+    /*!
+      \fn GGfloat ComputeUncertaintyRatio(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \return largest ratio between mean uncertainty and target of navigators on device
+      \brief computing the uncertainty ratio, all targets are reached below 1
+    */
+    GGfloat ComputeUncertaintyRatio(GGsize const& thread_index);
+
+    /*!
+      \fn void SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+      \param particle_scale_factor - number of planned particles divided by number of simulated particles
+      \brief set the scale factor of dose in all navigators
+    */
+    void SetParticleScaleFactor(GGfloat const& particle_scale_factor);
+
     /*!
       \fn void Clean(void)
       \brief clean OpenCL data if necessary
@@ -0,0 +1,163 @@
+#ifndef GUARD_GGEMS_NAVIGATORS_GGEMSPARTICLESPLITTING_HH
+#define GUARD_GGEMS_NAVIGATORS_GGEMSPARTICLESPLITTING_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSParticleSplitting.hh
+
+  \brief Functions applying a weight window (geometric splitting and Russian roulette) to photons, only for OpenCL kernel usage
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/physics/GGEMSParticleConstants.hh"
+#include "GGEMS/physics/GGEMSProcessConstants.hh"
+#include "GGEMS/physics/GGEMSPhotonState.hh"
+#include "GGEMS/geometries/GGEMSGeometryConstants.hh"
+#include "GGEMS/maths/GGEMSReferentialTransformation.hh"
+
+__constant GGint MAXIMUM_SPLITTING = 64; /*!< Maximum number of particles created by one splitting, particle included */
+
+/*!
+  \fn inline GGfloat GetImportance(GGfloat const importance, global GGfloat const* importance_map, GGint3 const voxel_id, GGint3 const number_of_voxels)
+  \param importance - importance of navigator
+  \param importance_map - importance of each voxel relative to navigator, NULL if no map
+  \param voxel_id - index of voxel in X, Y and Z
+  \param number_of_voxels - number of voxels in X, Y and Z
+  \return importance of voxel
+  \brief Get the importance of a voxel, product of importance of navigator and importance map
+*/
+inline GGfloat GetImportance(GGfloat const importance, global GGfloat const* importance_map, GGint3 const voxel_id, GGint3 const number_of_voxels)
+{
+  if (!importance_map) return importance;
+
+  return importance*importance_map[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
+}
+
+/*!
+  \fn inline void SpawnPhotonCopy(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGint const particle_id, GGint const copy_id, GGint const copy_ordinal, GGEMSPhotonState const* photon, GGfloat3 const* global_position, GGfloat3 const* global_direction)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random buffer on OpenCL device
+  \param particle_id - index of split particle
+  \param copy_id - index of free slot receiving the copy
+  \param copy_ordinal - index of copy in splitting, from 1
+  \param photon - pointer on photon state, weight of one copy
+  \param global_position - position of photon in global coordinate
+  \param global_direction - direction of photon in global coordinate
+  \brief Write a copy of photon in a free slot. Copy is out of solid, it is found again by navigators at next step. Random stream of copy is derived from the stream of split particle
+*/
+inline void SpawnPhotonCopy(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  GGint const particle_id,
+  GGint const copy_id,
+  GGint const copy_ordinal,
+  GGEMSPhotonState const* photon,
+  GGfloat3 const* global_position,
+  GGfloat3 const* global_direction
+)
+{
+  primary_particle->E_[copy_id] = photon->E_;
+  primary_particle->dx_[copy_id] = global_direction->x;
+  primary_particle->dy_[copy_id] = global_direction->y;
+  primary_particle->dz_[copy_id] = global_direction->z;
+  primary_particle->px_[copy_id] = global_position->x;
+  primary_particle->py_[copy_id] = global_position->y;
+  primary_particle->pz_[copy_id] = global_position->z;
+  primary_particle->weight_[copy_id] = photon->weight_;
+  primary_particle->scatter_[copy_id] = photon->scatter_;
+  primary_particle->E_index_[copy_id] = photon->E_index_;
+  primary_particle->solid_id_[copy_id] = -1;
+  primary_particle->particle_solid_distance_[copy_id] = OUT_OF_WORLD;
+  primary_particle->next_interaction_distance_[copy_id] = 0.0f;
+  primary_particle->next_discrete_process_[copy_id] = NO_PROCESS;
+  primary_particle->level_[copy_id] = primary_particle->level_[particle_id];
+  primary_particle->pname_[copy_id] = primary_particle->pname_[particle_id];
+  primary_particle->status_[copy_id] = ALIVE;
+  StartCopyRandomStream(random, copy_id, &photon->random_, copy_ordinal);
+}
+
+/*!
+  \fn inline void ApplyWeightWindow(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGint const particle_id, global GGfloat44 const* matrix_transformation, GGfloat const importance, GGfloat3 const* local_position, GGEMSPhotonState* photon)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random buffer on OpenCL device
+  \param particle_id - index of particle
+  \param matrix_transformation - matrix of transformation of solid
+  \param importance - importance at position of photon
+  \param local_position - position of photon in local coordinate of solid
+  \param photon - pointer on photon state, direction in local coordinate of solid
+  \brief Keep the weight of photon around 1/importance with Russian roulette and splitting
+*/
+inline void ApplyWeightWindow(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  GGint const particle_id,
+  global GGfloat44 const* matrix_transformation,
+  GGfloat const importance,
+  GGfloat3 const* local_position,
+  GGEMSPhotonState* photon
+)
+{
+  GGfloat target_weight = 1.0f / importance;
+
+  // Russian roulette, survival probability is the ratio of weights
+  if (photon->weight_ < 0.5f*target_weight) {
+    if (KissUniformState(&photon->random_) < photon->weight_*importance) photon->weight_ = target_weight;
+    else photon->status_ = DEAD;
+    return;
+  }
+
+  if (photon->weight_ <= 2.0f*target_weight) return;
+
+  // Splitting, each copy has a weight between 1/importance and 2/importance
+  GGint number_of_particles = min((GGint)(photon->weight_*importance), MAXIMUM_SPLITTING);
+  GGfloat copy_weight = photon->weight_ / (GGfloat)number_of_particles;
+
+  GGEMSPhotonState copy = *photon;
+  copy.weight_ = copy_weight;
+  GGfloat3 global_position = LocalToGlobalPosition(matrix_transformation, local_position);
+  GGfloat3 global_direction = LocalToGlobalDirection(matrix_transformation, &photon->direction_);
+
+  GGint number_of_copies = 0;
+  for (GGint i = 1; i < number_of_particles; ++i) {
+    // Claiming a free slot, counter is rebuilt before each tracking step
+    GGint free_id = atomic_dec(&primary_particle->number_of_free_particles_) - 1;
+    if (free_id < 0) break;
+
+    SpawnPhotonCopy(primary_particle, random, particle_id, primary_particle->free_index_[free_id], i, &copy, &global_position, &global_direction);
+    ++number_of_copies;
+  }
+
+  photon->weight_ -= copy_weight*(GGfloat)number_of_copies;
+
+  // One draw per splitting, a next splitting without interaction between gives other streams to copies
+  KissUniformState(&photon->random_);
+}
+
+#endif
+
+#endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSPARTICLESPLITTING_HH
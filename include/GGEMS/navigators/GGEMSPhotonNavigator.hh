@@ -35,7 +35,7 @@
 
 #include "GGEMS/maths/GGEMSMathAlgorithms.hh"
 
-#include "GGEMS/randoms/GGEMSKissEngine.hh"
+#include "GGEMS/physics/GGEMSPhotonState.hh"
 
 #include "GGEMS/physics/GGEMSComptonScatteringModels.hh"
 #include "GGEMS/physics/GGEMSRayleighScatteringModels.hh"
@@ -46,50 +46,193 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void GetPhotonNextInteraction(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const index_material, GGint const index_particle)
-  \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \fn inline GGint GetPhotonEnergyBin(global GGEMSParticleCrossSections const* particle_cross_sections, GGfloat const energy, GGfloat* weight)
   \param particle_cross_sections - buffer of cross sections
+  \param energy - energy of the particle
+  \param weight - weight of linear interpolation between the bin and the next one
+  \return index of energy bin in cross section table
+  \brief Find the energy bin of a particle in cross section tables
+*/
+inline GGint GetPhotonEnergyBin(
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  GGfloat const energy,
+  GGfloat* weight)
+{
+  GGint number_of_bins = (GGint)particle_cross_sections->number_of_bins_;
+  GGint energy_id = particle_cross_sections->is_log_energy_bins_ ?
+    LogUniformBinIndex(energy, particle_cross_sections->energy_bins_, number_of_bins, particle_cross_sections->inverse_log_energy_range_) :
+    BinarySearchLeft(energy, particle_cross_sections->energy_bins_, number_of_bins, 0, 0);
+
+  // Last bin is the upper border of last interval
+  energy_id = min(energy_id, number_of_bins-2);
+
+  // Weight of linear interpolation between energy bins, same for all processes
+  GGfloat energy_a = particle_cross_sections->energy_bins_[energy_id];
+  GGfloat energy_b = particle_cross_sections->energy_bins_[energy_id+1];
+  *weight = clamp((energy-energy_a)/(energy_b-energy_a), 0.0f, 1.0f);
+
+  return energy_id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat GetPhotonTotalCrossSection(global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGint const energy_id, GGfloat const weight, GGuchar const index_material)
+  \param particle_cross_sections - buffer of cross sections
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param energy_id - index of energy bin of the particle
+  \param weight - weight of linear interpolation between energy bins
+  \param index_material - index of the material
+  \return total cross section of activated photon processes
+  \brief Interpolate the total cross section of a material at the energy of the particle
+*/
+inline GGfloat GetPhotonTotalCrossSection(
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  GGint const energy_id,
+  GGfloat const weight,
+  GGuchar const index_material)
+{
+  global GGfloat const* photon_cross_sections_a = photon_cross_sections + PHOTON_CROSS_SECTION_INDEX(index_material, energy_id, 0, particle_cross_sections->number_of_bins_);
+  global GGfloat const* photon_cross_sections_b = photon_cross_sections_a + PHOTON_CROSS_SECTION_STRIDE;
+
+  return mad(weight, photon_cross_sections_b[PHOTON_TOTAL_CROSS_SECTION]-photon_cross_sections_a[PHOTON_TOTAL_CROSS_SECTION], photon_cross_sections_a[PHOTON_TOTAL_CROSS_SECTION]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar SelectPhotonInteraction(GGEMSPhotonState* photon, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGint const energy_id, GGfloat const weight, GGfloat const total_cross_section, GGuchar const index_material)
+  \param photon - pointer on photon state in private memory
+  \param particle_cross_sections - buffer of cross sections
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param energy_id - index of energy bin of the particle
+  \param weight - weight of linear interpolation between energy bins
+  \param total_cross_section - total cross section of the material
   \param index_material - index of the material
-  \param index_particle - index of the particle
-  \brief Determine the next photon interaction
+  \return index of the selected process
+  \brief Select the process of a real interaction in proportion to its fraction of the total, last activated process if sample is above cumulated sum due to rounding
+*/
+inline GGchar SelectPhotonInteraction(
+  GGEMSPhotonState* photon,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  GGint const energy_id,
+  GGfloat const weight,
+  GGfloat const total_cross_section,
+  GGuchar const index_material)
+{
+  global GGfloat const* photon_cross_sections_a = photon_cross_sections + PHOTON_CROSS_SECTION_INDEX(index_material, energy_id, 0, particle_cross_sections->number_of_bins_);
+  global GGfloat const* photon_cross_sections_b = photon_cross_sections_a + PHOTON_CROSS_SECTION_STRIDE;
+
+  GGfloat cross_section_sample = KissUniformState(&photon->random_) * total_cross_section;
+  GGfloat cumulated_cross_section = 0.0f;
+  GGchar photon_process_id = 0;
+  GGchar next_discrete_process = NO_PROCESS;
+
+  for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
+    photon_process_id = particle_cross_sections->photon_cs_id_[i];
+    cumulated_cross_section += mad(weight, photon_cross_sections_b[photon_process_id]-photon_cross_sections_a[photon_process_id], photon_cross_sections_a[photon_process_id]);
+    next_discrete_process = photon_process_id;
+
+    if (cross_section_sample < cumulated_cross_section) break;
+  }
+
+  // Storing results in photon state
+  photon->E_index_ = energy_id;
+  photon->next_discrete_process_ = next_discrete_process;
+
+  return next_discrete_process;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void GetPhotonNextInteraction(GGEMSPhotonState* photon, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGuchar const index_material)
+  \param photon - pointer on photon state in private memory
+  \param particle_cross_sections - buffer of cross sections
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param index_material - index of the material
+  \brief Determine the next photon interaction, free path sampled from the total cross section and process selected by its fraction of the total
 */
 inline void GetPhotonNextInteraction(
-  global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSPhotonState* photon,
   global GGEMSParticleCrossSections const* particle_cross_sections,
-  GGuchar const index_material,
-  GGint const particle_id)
+  global GGfloat const* photon_cross_sections,
+  GGuchar const index_material)
 {
   // Getting energy of the particle and the index of energy in cross section table
-  GGint energy_id = BinarySearchLeft(primary_particle->E_[particle_id], particle_cross_sections->energy_bins_, particle_cross_sections->number_of_bins_, 0, 0);
+  GGfloat weight = 0.0f;
+  GGint energy_id = GetPhotonEnergyBin(particle_cross_sections, photon->E_, &weight);
 
   // Initialization of next interaction distance
-  GGfloat next_interaction_distance = OUT_OF_WORLD;
-  GGchar next_discrete_process = NO_PROCESS;
+  photon->E_index_ = energy_id;
+  photon->next_interaction_distance_ = OUT_OF_WORLD;
+  photon->next_discrete_process_ = NO_PROCESS;
+
+  // One free path sampled from the total cross section
+  GGfloat total_cross_section = GetPhotonTotalCrossSection(particle_cross_sections, photon_cross_sections, energy_id, weight, index_material);
+  if (total_cross_section > 0.0f) {
+    photon->next_interaction_distance_ = -log(KissUniformState(&photon->random_))/total_cross_section;
+    SelectPhotonInteraction(photon, particle_cross_sections, photon_cross_sections, energy_id, weight, total_cross_section, index_material);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGchar SelectPhotonWoodcockInteraction(GGEMSPhotonState* photon, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGint const energy_id, GGfloat const weight, GGfloat const majorant_cross_section, GGuchar const index_material)
+  \param photon - pointer on photon state in private memory
+  \param particle_cross_sections - buffer of cross sections
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param energy_id - index of energy bin of the particle
+  \param weight - weight of linear interpolation between energy bins
+  \param majorant_cross_section - majorant cross section used to sample the step
+  \param index_material - index of the material at the interaction point
+  \return index of the selected process, NO_PROCESS for a virtual interaction
+  \brief Accept or reject a Woodcock interaction, a real interaction selects the process in proportion to its cross section
+*/
+inline GGchar SelectPhotonWoodcockInteraction(
+  GGEMSPhotonState* photon,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  GGint const energy_id,
+  GGfloat const weight,
+  GGfloat const majorant_cross_section,
+  GGuchar const index_material)
+{
+  global GGfloat const* photon_cross_sections_a = photon_cross_sections + PHOTON_CROSS_SECTION_INDEX(index_material, energy_id, 0, particle_cross_sections->number_of_bins_);
+  global GGfloat const* photon_cross_sections_b = photon_cross_sections_a + PHOTON_CROSS_SECTION_STRIDE;
+
+  // Same random number for rejection and for process selection
+  GGfloat cross_section_sample = KissUniformState(&photon->random_) * majorant_cross_section;
+  GGfloat cumulated_cross_section = 0.0f;
   GGchar photon_process_id = 0;
-  GGfloat interaction_distance = 0.0f;
+  GGchar next_discrete_process = NO_PROCESS;
 
-  // Loop over activated processes
   for (GGchar i = 0; i < particle_cross_sections->number_of_activated_photon_processes_; ++i) {
-    // Getting index of process
     photon_process_id = particle_cross_sections->photon_cs_id_[i];
+    cumulated_cross_section += mad(weight, photon_cross_sections_b[photon_process_id]-photon_cross_sections_a[photon_process_id], photon_cross_sections_a[photon_process_id]);
 
-    // Getting the interaction distance
-    interaction_distance =
-      -log(KissUniform(random, particle_id))/
-      particle_cross_sections->photon_cross_sections_[photon_process_id][energy_id + particle_cross_sections->number_of_bins_*index_material];
-
-    if (interaction_distance < next_interaction_distance) {
-      next_interaction_distance = interaction_distance;
+    if (cross_section_sample < cumulated_cross_section) {
       next_discrete_process = photon_process_id;
+      break;
     }
   }
 
-  // Storing results in particle buffer
-  primary_particle->E_index_[particle_id] = energy_id;
-  primary_particle->next_interaction_distance_[particle_id] = next_interaction_distance;
-  primary_particle->next_discrete_process_[particle_id] = next_discrete_process;
+  // Storing results in photon state
+  photon->E_index_ = energy_id;
+  photon->next_discrete_process_ = next_discrete_process;
+
+  return next_discrete_process;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -97,36 +240,34 @@ inline void GetPhotonNextInteraction(
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void PhotonDiscreteProcess(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
-  \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \fn inline void PhotonDiscreteProcess(GGEMSPhotonState* photon, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGuchar const material_id)
+  \param photon - pointer on photon state in private memory
   \param materials - buffer of materials
   \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param photon_cross_sections - pointer to packed photon cross sections
   \param material_id - index of the material
-  \param index_particle - index of the particle
   \brief Launch sampling depending on photon process
 */
 inline void PhotonDiscreteProcess(
-  global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSPhotonState* photon,
   global GGEMSMaterialTables const* materials,
   global GGEMSParticleCrossSections const* particle_cross_sections,
-  GGuchar const material_id,
-  GGint const particle_id
+  global GGfloat const* photon_cross_sections,
+  GGuchar const material_id
 )
 {
   // Get photon process
-  GGchar next_iteraction_process = primary_particle->next_discrete_process_[particle_id];
+  GGchar next_iteraction_process = photon->next_discrete_process_;
 
   // Select process
   if (next_iteraction_process == COMPTON_SCATTERING) {
-    KleinNishinaComptonSampleSecondaries(primary_particle, random, particle_id);
+    KleinNishinaComptonSampleSecondaries(photon);
   }
   else if (next_iteraction_process == PHOTOELECTRIC_EFFECT) {
-    StandardPhotoElectricSampleSecondaries(primary_particle, particle_id);
+    StandardPhotoElectricSampleSecondaries(photon);
   }
   else if (next_iteraction_process == RAYLEIGH_SCATTERING) {
-    LivermoreRayleighSampleSecondaries(primary_particle, random, materials, particle_cross_sections, material_id, particle_id);
+    LivermoreRayleighSampleSecondaries(photon, materials, particle_cross_sections, photon_cross_sections, material_id);
   }
 }
 
@@ -35,6 +35,7 @@
 #endif
 
 #include "GGEMS/navigators/GGEMSNavigator.hh"
+#include "GGEMS/geometries/GGEMSBVHData.hh"
 
 /*!
   \class GGEMSSystem
@@ -133,12 +134,96 @@ class GGEMS_EXPORT GGEMSSystem : public GGEMSNavigator
     */
     void StoreScatter(bool const& is_scatter);
 
+    /*!
+      \fn void SetFusedNavigation(bool const& is_fused_navigation)
+      \param is_fused_navigation - true to navigate in all modules with a single kernel per stage
+      \brief set fused navigation, all modules are stored in one array and a BVH over the modules is used to find the closest one
+    */
+    void SetFusedNavigation(bool const& is_fused_navigation);
+
+    /*!
+      \fn void SetLocalHistogram(bool const& is_local_histogram)
+      \param is_local_histogram - true to accumulate histograms in local memory
+      \brief set local histograms, each work-group accumulates histograms in local memory and adds them to global histograms once, histograms stay in global memory if they do not fit in local memory with the local memory used by tracking kernel. Deactivated by default
+    */
+    void SetLocalHistogram(bool const& is_local_histogram);
+
+    /*!
+      \fn void SetDetectorResponse(std::string const& detector_response)
+      \param detector_response - response of detection elements, 'counts' or 'energy'
+      \brief set the response of detection elements, 'counts' records the number of photoelectric and Compton interactions, 'energy' records the deposited energy in MeV in 64-bit fixed-point tallies (energy-integrating detector). 'counts' by default
+    */
+    void SetDetectorResponse(std::string const& detector_response);
+
+    /*!
+      \fn inline GGsize2 GetNumberOfModules(void) const
+      \return number of modules in X and Y of local axis of detector
+      \brief get the number of modules
+    */
+    inline GGsize2 GetNumberOfModules(void) const {return number_of_modules_xy_;}
+
+    /*!
+      \fn inline GGsize3 GetNumberOfDetectionElementsInsideModule(void) const
+      \return number of detection elements in X, Y and Z inside a module
+      \brief get the number of detection elements inside a module
+    */
+    inline GGsize3 GetNumberOfDetectionElementsInsideModule(void) const {return number_of_detection_elements_inside_module_xyz_;}
+
+    /*!
+      \fn inline GGfloat3 GetSizeOfDetectionElements(void) const
+      \return size of detection elements in X, Y and Z
+      \brief get the size of detection elements
+    */
+    inline GGfloat3 GetSizeOfDetectionElements(void) const {return size_of_detection_elements_xyz_;}
+
     /*!
       \fn void SaveResults(void)
       \brief save all results from solid
     */
     void SaveResults(void);
 
+    /*!
+      \fn void SetViewTransformation(GGfloat44 const& matrix_view)
+      \param matrix_view - rigid transformation of the view in global frame
+      \brief move all modules for a view of a scan, on top of the geometry set at initialization
+    */
+    void SetViewTransformation(GGfloat44 const& matrix_view);
+
+    /*!
+      \fn void StoreView(GGsize const& view_index, GGsize const& number_of_views)
+      \param view_index - index of the view in scan
+      \param number_of_views - number of views in scan
+      \brief copy the projection of a view in the stacked projections on host and clear histograms for the next view
+    */
+    void StoreView(GGsize const& view_index, GGsize const& number_of_views);
+
+    /*!
+      \fn void SaveScanResults(void)
+      \brief save the stacked projections of all views of a scan in a single volume, views are stacked along Z
+    */
+    void SaveScanResults(void);
+
+    /*!
+      \fn void ParticleSolidDistance(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief Compute distance between particle and modules, one kernel for all modules in fused navigation
+    */
+    void ParticleSolidDistance(GGsize const& thread_index) override;
+
+    /*!
+      \fn void ProjectToSolid(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief Project particle to entry of closest module, one kernel for all modules in fused navigation
+    */
+    void ProjectToSolid(GGsize const& thread_index) override;
+
+    /*!
+      \fn void TrackThroughSolid(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief Move particle through module, one kernel for all modules in fused navigation
+    */
+    void TrackThroughSolid(GGsize const& thread_index) override;
+
   protected:
     /*!
       \fn void CheckParameters(void) const
@@ -146,11 +231,108 @@ class GGEMS_EXPORT GGEMSSystem : public GGEMSNavigator
     */
     virtual void CheckParameters(void) const;
 
+    /*!
+      \fn void InitializeFusedNavigation(GGsize const& first_solid_id)
+      \param first_solid_id - solid id of the first module, ids of modules are contiguous
+      \brief Copy data of all modules in a single buffer, build the BVH over modules and compile fused kernels
+    */
+    void InitializeFusedNavigation(GGsize const& first_solid_id);
+
+    /*!
+      \fn void InitializeProjection(void)
+      \brief Allocate the 64-bit projection on each device and compile kernels reducing histograms of modules and devices
+    */
+    void InitializeProjection(void);
+
+    /*!
+      \fn inline std::string GetHistogramType(void) const
+      \return type of registered data for modules
+      \brief get the type of histogram of modules depending on detector response
+    */
+    inline std::string GetHistogramType(void) const {return detector_response_ == "energy" ? "ENERGY_HISTOGRAM" : "HISTOGRAM";}
+
+    /*!
+      \fn inline GGsize GetHistogramElementSize(void) const
+      \return size in bytes of an element of histograms
+      \brief get the size of an element of histograms, deposited energy is stored in 64-bit fixed-point
+    */
+    inline GGsize GetHistogramElementSize(void) const {return detector_response_ == "energy" ? sizeof(GGulong) : sizeof(GGint);}
+
+  private:
+    /*!
+      \fn GGint BuildBVHNode(std::vector<GGEMSBVHNode>& bvh_nodes, GGint* solid_index, GGsize const& first, GGsize const& last, GGfloat3 const* solid_border_min, GGfloat3 const* solid_border_max, GGsize const& depth)
+      \param bvh_nodes - list of BVH nodes, new nodes are added at the end
+      \param solid_index - index of solids, reordered during building
+      \param first - first solid of node in solid_index
+      \param last - last solid (excluded) of node in solid_index
+      \param solid_border_min - min. borders of AABB of each solid in global frame
+      \param solid_border_max - max. borders of AABB of each solid in global frame
+      \param depth - depth of the node
+      \return index of the created node
+      \brief Build recursively a node of BVH, splitting solids at median along the largest axis of centers
+    */
+    GGint BuildBVHNode(std::vector<GGEMSBVHNode>& bvh_nodes, GGint* solid_index, GGsize const& first, GGsize const& last, GGfloat3 const* solid_border_min, GGfloat3 const* solid_border_max, GGsize const& depth);
+
+    /*!
+      \fn void UpdateFusedNavigation(void)
+      \brief Copy data of all modules in a single buffer and build the BVH over modules, called again when modules are moved
+    */
+    void UpdateFusedNavigation(void);
+
+    /*!
+      \fn void ReduceProjection(GGulong* output, bool const& is_scatter)
+      \param output - projection on host
+      \param is_scatter - true to reduce the scatter histograms
+      \brief Gather histograms of all modules in a 64-bit projection on each device, add projections of all devices on the first device and read the result
+    */
+    void ReduceProjection(GGulong* output, bool const& is_scatter);
+
+    /*!
+      \fn void WriteProjections(GGulong const* output, GGulong const* scatter_output, GGsize const& number_of_views) const
+      \param output - projections stacked along Z
+      \param scatter_output - scatter projections stacked along Z, nullptr if scatter is not stored
+      \param number_of_views - number of stacked projections
+      \brief Write projections in MHD format
+    */
+    void WriteProjections(GGulong const* output, GGulong const* scatter_output, GGsize const& number_of_views) const;
+
+    /*!
+      \fn void WriteProjection(std::string const& filename, GGulong const* projection, GGsize3 const& dimensions) const
+      \param filename - name of MHD file
+      \param projection - 64-bit projection
+      \param dimensions - dimensions of projection
+      \brief Write a projection in MHD format, counts as integers (doubles above 32-bit range) or deposited energy in MeV as floats
+    */
+    void WriteProjection(std::string const& filename, GGulong const* projection, GGsize3 const& dimensions) const;
+
   protected:
     GGsize2 number_of_modules_xy_; /*!< Number of the detection modules */
     GGsize3 number_of_detection_elements_inside_module_xyz_; /*!< Number of virtual elements (X,Y,Z) in a module */
     GGfloat3 size_of_detection_elements_xyz_; /*!< Size of pixel in each direction */
     bool is_scatter_; /*!< Boolean storing scatter infos */
+    bool is_local_histogram_; /*!< Boolean activating histograms in local memory */
+    std::string detector_response_; /*!< Response of detection elements, 'counts' or 'energy' */
+    std::vector<GGulong> scan_projections_; /*!< Projections of all views of a scan stacked along Z */
+    std::vector<GGulong> scan_scatter_projections_; /*!< Scatter projections of all views of a scan stacked along Z */
+
+    // Reduction of histograms
+    cl::Buffer** projection_; /*!< 64-bit projection of system for each device */
+    cl::Buffer* device_projection_; /*!< Projection of another device copied on the first device */
+    cl::Kernel** kernel_gather_histograms_; /*!< OpenCL kernel copying histograms of modules in projection */
+    cl::Kernel** kernel_add_projection_; /*!< OpenCL kernel adding projection of another device */
+
+    // Fused navigation
+    bool is_fused_navigation_; /*!< Boolean activating fused navigation */
+    GGint first_solid_id_; /*!< Solid id of the first module */
+    cl::Buffer** fused_solid_data_; /*!< Data of all modules in one buffer for each device */
+    cl::Buffer** bvh_nodes_; /*!< BVH nodes over modules for each device */
+    GGsize number_of_bvh_nodes_; /*!< Number of BVH nodes */
+    cl::Buffer** fused_histogram_; /*!< Histogram of all modules in one buffer for each device */
+    cl::Buffer** fused_scatter_histogram_; /*!< Scatter histogram of all modules in one buffer for each device */
+    GGsize fused_local_histogram_size_; /*!< Size in bytes of histograms of all modules in local memory, 0 for histograms in global memory */
+    cl::Kernel** kernel_fused_particle_solid_distance_; /*!< OpenCL kernel computing distance between particles and all modules */
+    cl::Kernel** kernel_fused_project_to_solid_; /*!< OpenCL kernel moving particles to selected module */
+    cl::Kernel** kernel_fused_track_through_solid_; /*!< OpenCL kernel tracking particles within selected module */
 };
 
 #endif // End of GUARD_GGEMS_SYSTEMS_GGEMSSYSTEM_HH
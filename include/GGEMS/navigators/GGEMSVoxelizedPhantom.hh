@@ -86,6 +86,34 @@ class GGEMS_EXPORT GGEMSVoxelizedPhantom : public GGEMSNavigator
     */
     void SetPhantomFile(std::string const& voxelized_phantom_filename, std::string const& range_data_filename);
 
+    /*!
+      \fn void SetWoodcockTracking(bool const& is_woodcock_tracking)
+      \param is_woodcock_tracking - true to activate Woodcock tracking
+      \brief Sample photon steps with the majorant cross section of the phantom materials and reject virtual interactions, instead of stopping at each voxel border. Photon tracking counts tentative interaction points in this mode
+    */
+    void SetWoodcockTracking(bool const& is_woodcock_tracking);
+
+    /*!
+      \fn void SetDDATracking(bool const& is_dda_tracking)
+      \param is_dda_tracking - true to activate DDA tracking
+      \brief Step photons from voxel to voxel with an incremental 3D-DDA and carry the free path across voxels as an optical depth, instead of computing the voxel index and the distance to its borders at each step. Photon tracking counts crossed voxels at their middle point along the path
+    */
+    void SetDDATracking(bool const& is_dda_tracking);
+
+    /*!
+      \fn void SetImportance(GGfloat const& importance)
+      \param importance - importance of phantom, > 0
+      \brief Set the importance of phantom relative to world (importance 1). The weight of photons in phantom is kept around 1/importance: photons are split when entering a more important region, and Russian roulette is played when entering a less important one
+    */
+    void SetImportance(GGfloat const& importance);
+
+    /*!
+      \fn void SetImportanceMap(std::string const& importance_map_filename)
+      \param importance_map_filename - MHD filename for importance map, in MET_FLOAT with the dimensions of phantom
+      \brief Set the importance of each voxel, multiplied by the importance of phantom. Weight window is applied at each voxel step, or at each interaction with Woodcock tracking
+    */
+    void SetImportanceMap(std::string const& importance_map_filename);
+
     /*!
       \fn void Initialize(void) override
       \brief Initialize the voxelized phantom
@@ -108,6 +136,8 @@ class GGEMS_EXPORT GGEMSVoxelizedPhantom : public GGEMSNavigator
   private:
     std::string voxelized_phantom_filename_; /*!< MHD file storing the voxelized phantom */
     std::string range_data_filename_; /*!< File for label to material matching */
+    bool is_woodcock_tracking_; /*!< Woodcock tracking activated */
+    bool is_dda_tracking_; /*!< DDA tracking activated */
 };
 
 /*!
@@ -149,4 +179,36 @@ extern "C" GGEMS_EXPORT void set_position_ggems_voxelized_phantom(GGEMSVoxelized
 */
 extern "C" GGEMS_EXPORT void set_rotation_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGfloat const rx, GGfloat const ry, GGfloat const rz, char const* unit);
 
+/*!
+  \fn void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_woodcock_tracking)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param is_woodcock_tracking - true to activate Woodcock tracking
+  \brief Activate Woodcock tracking in voxelized phantom
+*/
+extern "C" GGEMS_EXPORT void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_woodcock_tracking);
+
+/*!
+  \fn void set_dda_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_dda_tracking)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param is_dda_tracking - true to activate DDA tracking
+  \brief Activate incremental 3D-DDA tracking in voxelized phantom
+*/
+extern "C" GGEMS_EXPORT void set_dda_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_dda_tracking);
+
+/*!
+  \fn void set_importance_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGfloat const importance)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param importance - importance of phantom
+  \brief Set the importance of voxelized phantom for particle splitting and Russian roulette
+*/
+extern "C" GGEMS_EXPORT void set_importance_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGfloat const importance);
+
+/*!
+  \fn void set_importance_map_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* importance_map_filename)
+  \param voxelized_phantom - pointer on voxelized phantom
+  \param importance_map_filename - filename of importance map
+  \brief Set the importance map of voxelized phantom for particle splitting and Russian roulette
+*/
+extern "C" GGEMS_EXPORT void set_importance_map_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* importance_map_filename);
+
 #endif // End of GUARD_GGEMS_NAVIGATORS_GGEMSVOXELIZEDPHANTOM_HH
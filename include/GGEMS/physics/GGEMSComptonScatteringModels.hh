@@ -33,33 +33,27 @@
 
 #ifdef __OPENCL_C_VERSION__
 
+#include "GGEMS/physics/GGEMSPhotonState.hh"
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void KleinNishinaComptonSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGint const particle_id)
-  \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
-  \param particle_id - index of the particle
+  \fn inline void KleinNishinaComptonSampleSecondaries(GGEMSPhotonState* photon)
+  \param photon - pointer on photon state in private memory
   \brief Klein Nishina Compton model, Effects due to binding of atomic electrons are negliged.
 */
 inline void KleinNishinaComptonSampleSecondaries(
-  global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
-  GGint const particle_id
+  GGEMSPhotonState* photon
 )
 {
   // Energy
-  GGfloat kE0 = primary_particle->E_[particle_id];
+  GGfloat kE0 = photon->E_;
   GGfloat kE0_MeC2 = kE0 / ELECTRON_MASS_C2;
 
   // Direction
-  GGfloat3 kGammaDirection = {
-    primary_particle->dx_[particle_id],
-    primary_particle->dy_[particle_id],
-    primary_particle->dz_[particle_id]
-  };
+  GGfloat3 kGammaDirection = photon->direction_;
 
   // sample the energy rate the scattered gamma
   GGfloat kEps0 = 1.0f / (1.0f + 2.0f*kE0_MeC2);
@@ -68,7 +62,7 @@ inline void KleinNishinaComptonSampleSecondaries(
   GGfloat kAlpha2 = kAlpha1 + 0.5f*(1.0f-kEps0Eps0);
 
   #ifdef GGEMS_TRACKING
-  if (particle_id == primary_particle->particle_tracking_id) {
+  if (photon->is_tracked_) {
     printf("\n");
     printf("[GGEMS OpenCL function KleinNishinaComptonSampleSecondaries]     Photon energy: %e keV\n", kE0/keV);
     printf("[GGEMS OpenCL function KleinNishinaComptonSampleSecondaries]     Photon direction: %e %e %e\n", kGammaDirection.x, kGammaDirection.y, kGammaDirection.z);
@@ -87,9 +81,9 @@ inline void KleinNishinaComptonSampleSecondaries(
     if (nloop > 1000) return;
 
     // Get 3 random numbers
-    rndm.x = KissUniform(random, particle_id);
-    rndm.y = KissUniform(random, particle_id);
-    rndm.z = KissUniform(random, particle_id);
+    rndm.x = KissUniformState(&photon->random_);
+    rndm.y = KissUniformState(&photon->random_);
+    rndm.z = KissUniformState(&photon->random_);
 
     if (kAlpha1 > kAlpha2*rndm.x) {
       epsilon = exp(-kAlpha1*rndm.y);
@@ -109,7 +103,7 @@ inline void KleinNishinaComptonSampleSecondaries(
   if (sint2 < 0.0f) sint2 = 0.0f;
   costheta = 1.0f - onecost;
   sintheta = sqrt(sint2);
-  phi = KissUniform(random, particle_id) * TWO_PI;
+  phi = KissUniformState(&photon->random_) * TWO_PI;
 
   // Update scattered gamma
   GGfloat3 gamma_direction = {sintheta*cos(phi), sintheta*sin(phi), costheta};
@@ -118,17 +112,14 @@ inline void KleinNishinaComptonSampleSecondaries(
   GGfloat kE1 = kE0*epsilon;
 
   #ifdef GGEMS_TRACKING
-  if (particle_id == primary_particle->particle_tracking_id) {
+  if (photon->is_tracked_) {
     printf("[GGEMS OpenCL function KleinNishinaComptonSampleSecondaries]     Scattered photon energy: %e keV\n", kE1/keV);
     printf("[GGEMS OpenCL function KleinNishinaComptonSampleSecondaries]     Scattered photon direction: %e %e %e\n", gamma_direction.x, gamma_direction.y, gamma_direction.z);
   }
   #endif
 
-  primary_particle->E_[particle_id] = kE1;
-
-  primary_particle->dx_[particle_id] = gamma_direction.x;
-  primary_particle->dy_[particle_id] = gamma_direction.y;
-  primary_particle->dz_[particle_id] = gamma_direction.z;
+  photon->E_ = kE1;
+  photon->direction_ = gamma_direction;
 }
 
 #endif
@@ -128,6 +128,14 @@ class GGEMS_EXPORT GGEMSCrossSections
     */
     inline cl::Buffer* GetCrossSections(GGsize const& thread_index) const {return particle_cross_sections_[thread_index];}
 
+    /*!
+      \fn inline cl::Buffer* GetPhotonCrossSections(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return pointer to OpenCL buffer storing packed photon cross section values
+      \brief return the pointer to OpenCL buffer storing packed photon cross section values
+    */
+    inline cl::Buffer* GetPhotonCrossSections(GGsize const& thread_index) const {return photon_cross_sections_[thread_index];}
+
     /*!
       \fn GGfloat GetPhotonCrossSection(std::string const& process_name, std::string const& material_name, GGfloat const& energy, std::string const& unit) const
       \param process_name - name of the process
@@ -158,6 +166,10 @@ class GGEMS_EXPORT GGEMSCrossSections
     std::vector<bool> is_process_activated_; /*!< Boolean checking if the process is already activated */
     cl::Buffer** particle_cross_sections_; /*!< Pointer storing cross sections for each particles on OpenCL device */
     GGEMSParticleCrossSections* particle_cross_sections_host_; /*!< Pointer storing cross sections for each particles on host (RAM memory) */
+    cl::Buffer** photon_cross_sections_; /*!< Packed photon cross sections (materials, then chemical elements) on OpenCL device */
+    GGsize photon_cross_sections_size_; /*!< Size in bytes of packed photon cross sections */
+    std::vector<GGfloat> photon_cross_sections_host_; /*!< Packed photon cross sections on host (RAM memory) */
+    std::vector<std::string> material_names_; /*!< Name of the materials */
     GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
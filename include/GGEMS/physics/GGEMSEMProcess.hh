@@ -39,6 +39,8 @@
 #include "GGEMS/global/GGEMSOpenCLManager.hh"
 #include "GGEMS/physics/GGEMSParticleCrossSections.hh"
 
+class GGEMSMaterials;
+
 /*!
   \class GGEMSEMProcess
   \brief GGEMS mother class for electromagnectic process
@@ -92,25 +94,27 @@ class GGEMS_EXPORT GGEMSEMProcess
     inline std::string GetProcessName(void) const {return process_name_;}
 
     /*!
-      \fn void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index)
-      \param particle_cross_sections - OpenCL buffer storing all the cross section tables for each particles
-      \param material_tables - material tables on OpenCL device
+      \fn void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* photon_cross_sections, GGEMSMaterials const* materials, GGsize const& thread_index)
+      \param particle_cross_sections - OpenCL buffer storing the description of cross section tables
+      \param photon_cross_sections - OpenCL buffer storing the packed photon cross sections
+      \param materials - activated materials for a specific phantom
       \param thread_index - index of activated device (thread index)
-      \brief build cross section tables and storing them in particle_cross_sections
+      \brief build cross section tables and storing them in photon_cross_sections
     */
-    virtual void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index);
+    virtual void BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* photon_cross_sections, GGEMSMaterials const* materials, GGsize const& thread_index);
 
   protected:
     /*!
-      \fn GGfloat ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections* cross_section, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index)
-      \param cross_section - cross section
+      \fn GGfloat ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections const* cross_section, GGfloat* photon_cross_sections, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index)
+      \param cross_section - description of cross section tables
+      \param photon_cross_sections - packed photon cross sections, cross sections per atom are stored here
       \param material_tables - activated material for a phantom
       \param material_index - index of the material
       \param energy_index - index of the energy
       \return cross section for a process for a material
       \brief compute cross section for a process for a material
     */
-    GGfloat ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections* cross_section, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index);
+    GGfloat ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections const* cross_section, GGfloat* photon_cross_sections, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index);
 
     /*!
       \fn GGfloat ComputeCrossSectionPerAtom(GGfloat const& energy, GGuchar const& atomic_number)
@@ -33,9 +33,33 @@
 
 #include "GGEMS/physics/GGEMSProcessConstants.hh"
 
+/*!
+  \def PHOTON_TOTAL_CROSS_SECTION
+  \brief Column of the total cross section (sum of activated processes) in the packed photon table, stored after the processes for material rows only
+*/
+#define PHOTON_TOTAL_CROSS_SECTION NUMBER_PHOTON_PROCESSES
+
+/*!
+  \def PHOTON_CROSS_SECTION_STRIDE
+  \brief Number of values of a (row, energy bin) in the packed photon table, processes and total
+*/
+#define PHOTON_CROSS_SECTION_STRIDE (NUMBER_PHOTON_PROCESSES+1)
+
+/*!
+  \def PHOTON_CROSS_SECTION_INDEX(row, energy_bin, process, number_of_bins)
+  \brief Index in the packed photon cross section table. A row is a material index, or number_of_materials + Z for cross sections per atom. The activated processes and the total of a (row, energy bin) are contiguous
+*/
+#define PHOTON_CROSS_SECTION_INDEX(row, energy_bin, process, number_of_bins) ((((row)*(number_of_bins))+(energy_bin))*PHOTON_CROSS_SECTION_STRIDE+(process))
+
+/*!
+  \def NUMBER_OF_CHEMICAL_ELEMENT_ROWS
+  \brief Number of rows storing cross sections per atom in packed photon table, 100 chemical elements + 1 first empty element
+*/
+#define NUMBER_OF_CHEMICAL_ELEMENT_ROWS 101
+
 /*!
   \struct GGEMSParticleCrossSections_t
-  \brief Structure storing the photon cross sections for OpenCL device
+  \brief Structure storing the description of photon cross section tables for OpenCL device, the values are stored in a packed buffer of number_of_materials_ + NUMBER_OF_CHEMICAL_ELEMENT_ROWS rows
 */
 typedef struct GGEMSParticleCrossSections_t
 {
@@ -44,17 +68,14 @@ typedef struct GGEMSParticleCrossSections_t
   GGsize number_of_materials_; /*!< Number of materials */
   GGfloat min_energy_; /*!< Min energy in the cross section table */
   GGfloat max_energy_; /*!< Max energy in the cross section table */
+  GGfloat inverse_log_energy_range_; /*!< 1/log(max_energy_/min_energy_), direct index of energy for log-uniform bins */
   GGfloat energy_bins_[MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Energy in bin (220 by default) */
+  GGfloat majorant_cross_sections_[MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Max of total photon cross section over materials in mm-1 for each bin, for Woodcock tracking */
 
   // Photon
-  // 256: Max number of materials [0...255]
-  // MAX_CROSS_SECTION_TABLE_NUMBER_BINS: Max number of bins [0...2047]
-  GGfloat photon_cross_sections_[NUMBER_PHOTON_PROCESSES][256*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per material in mm-1 */
-  GGfloat photon_cross_sections_per_atom_[NUMBER_PHOTON_PROCESSES][101*MAX_CROSS_SECTION_TABLE_NUMBER_BINS]; /*!< Photon cross sections per atom in mm-1, 100 chemical elements + 1 first empty element */
   GGsize number_of_activated_photon_processes_; /*!< Number of activated photon processes, 3 processes -> 0: Compton, 1: Photoelectric, 2: Rayleigh */
   GGchar photon_cs_id_[NUMBER_PHOTON_PROCESSES]; /*!< Index of activated photon process, ex: if only Rayleigh activate index_photon_cs[0] = 2 */
-
-  GGchar material_names_[256][64]; /*!< Name of the materials */
+  GGchar is_log_energy_bins_; /*!< Energy bins are log-uniform, if not the energy index is found by binary search */
 } GGEMSParticleCrossSections; /*!< Using C convention name of struct to C++ (_t deletion) */
 
 #endif // GUARD_GGEMS_PHYSICS_GGEMSPARTICLECROSSSECTIONS_HH
@@ -116,12 +116,70 @@ class GGEMS_EXPORT GGEMSParticles
     inline GGsize GetNumberOfParticles(GGsize const& thread_index) const {return number_of_particles_[thread_index];};
 
     /*!
-      \fn bool IsAlive(GGsize const& thread_index) const
+      \fn inline GGsize GetNumberOfActiveParticles(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return upper bound of number of particles in active list
+      \brief Get the number of work-items needed by tracking kernels, exact number is stored on device
+    */
+    inline GGsize GetNumberOfActiveParticles(GGsize const& thread_index) const {return number_of_active_particles_[thread_index];};
+
+    /*!
+      \fn void SetStreamCompaction(bool const& is_stream_compaction)
+      \param is_stream_compaction - true to rebuild the list of alive particles at each alive check
+      \brief Set the stream compaction, tracking kernels are launched only over alive particles
+    */
+    void SetStreamCompaction(bool const& is_stream_compaction);
+
+    /*!
+      \fn void SetPersistentPool(bool const& is_persistent_pool)
+      \param is_persistent_pool - true if dead particles are replaced by new primaries during tracking
+      \brief Set the persistent particle pool, particles can come back to life so tracking kernels are always launched over all slots
+    */
+    void SetPersistentPool(bool const& is_persistent_pool);
+
+    /*!
+      \fn void SetParticleSplitting(bool const& is_particle_splitting)
+      \param is_particle_splitting - true if navigators split particles in free slots of buffer
+      \brief Set the particle splitting, particles can come back to life as copies of split particles so all slots are kept for tracking kernels
+    */
+    void SetParticleSplitting(bool const& is_particle_splitting);
+
+    /*!
+      \fn void ListFreeParticles(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief enqueue the building of the list of dead particles receiving copies of split particles, nothing is done without particle splitting
+    */
+    void ListFreeParticles(GGsize const& thread_index);
+
+    /*!
+      \fn bool IsAlive(GGsize const& thread_index)
       \param thread_index - index of activated device (thread index)
       \return true if source is still alive, otherwize false
       \brief check if some particles are alive in OpenCL particle buffer
     */
-    bool IsAlive(GGsize const& thread_index) const;
+    bool IsAlive(GGsize const& thread_index);
+
+    /*!
+      \fn void EnqueueIsAlive(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief enqueue an alive check and a non-blocking readback of the number of dead particles, without host synchronization
+    */
+    void EnqueueIsAlive(GGsize const& thread_index);
+
+    /*!
+      \fn bool IsAliveDeferred(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \return true if particles were alive at the previous enqueued check (or if there is no previous check), otherwize false
+      \brief get the result of the previous enqueued alive check, the last enqueued check is still running on device
+    */
+    bool IsAliveDeferred(GGsize const& thread_index);
+
+    /*!
+      \fn void ResetAliveChecks(GGsize const& thread_index)
+      \param thread_index - index of activated device (thread index)
+      \brief wait for pending alive checks, and reset them before a new batch
+    */
+    void ResetAliveChecks(GGsize const& thread_index);
 
     /*!
       \fn void Dump(std::string const& message) const
@@ -143,12 +201,30 @@ class GGEMS_EXPORT GGEMSParticles
     */
     void InitializeKernel(void);
 
+    /*!
+      \fn bool ReadAliveCheck(GGsize const& thread_index, GGsize const& check_index)
+      \param thread_index - index of activated device (thread index)
+      \param check_index - index of the enqueued alive check
+      \return true if particles were alive during the check, otherwize false
+      \brief wait for an enqueued alive check and read its result
+    */
+    bool ReadAliveCheck(GGsize const& thread_index, GGsize const& check_index);
+
   private:
     GGsize* number_of_particles_; /*!< Number of activated particles in buffer */
     cl::Buffer** primary_particles_; /*!< Pointer storing info about primary particles in batch on OpenCL device */
     cl::Buffer** status_; /*!< Buffer storing status of particle */
     GGsize number_activated_devices_; /*!< Number of activated device */
     cl::Kernel** kernel_alive_; /*!< Kernel checking if particles are alive */
+    bool is_stream_compaction_; /*!< Flag rebuilding the list of alive particles */
+    cl::Kernel** kernel_compact_; /*!< Kernel building the list of alive particles */
+    bool is_particle_splitting_; /*!< Flag for copies of split particles in free slots */
+    cl::Kernel** kernel_free_; /*!< Kernel building the list of free slots */
+    bool is_persistent_pool_; /*!< Flag for refill of dead particles during tracking */
+    GGsize* number_of_active_particles_; /*!< Upper bound of number of alive particles known by host */
+    GGint* status_host_; /*!< Number of dead particles read back from device, 2 slots by device */
+    cl::Event* status_events_; /*!< Events of the non-blocking status readback, 2 slots by device */
+    GGsize* number_of_alive_checks_; /*!< Number of enqueued alive checks by device in current batch */
 };
 
 #endif // End of GUARD_GGEMS_PHYSICS_GGEMSPARTICLES_HH
@@ -33,23 +33,23 @@
 
 #ifdef __OPENCL_C_VERSION__
 
+#include "GGEMS/physics/GGEMSPhotonState.hh"
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void StandardPhotoElectricSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, GGint const particle_id)
-  \param primary_particle - buffer of particles
-  \param particle_id - index of the particle
+  \fn inline void StandardPhotoElectricSampleSecondaries(GGEMSPhotonState* photon)
+  \param photon - pointer on photon state in private memory
   \brief Standard Photoelectric model
 */
 inline void StandardPhotoElectricSampleSecondaries(
-  global GGEMSPrimaryParticles* primary_particle,
-  GGint const particle_id
+  GGEMSPhotonState* photon
 )
 {
-  primary_particle->status_[particle_id] = DEAD;
-  primary_particle->E_[particle_id] = 0.0f;
+  photon->status_ = DEAD;
+  photon->E_ = 0.0f;
 }
 
 #endif
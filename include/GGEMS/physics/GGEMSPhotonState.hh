@@ -0,0 +1,129 @@
+#ifndef GUARD_GGEMS_PHYSICS_GGEMSPHOTONSTATE_HH
+#define GUARD_GGEMS_PHYSICS_GGEMSPHOTONSTATE_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSPhotonState.hh
+
+  \brief State of a photon in private memory during tracking, only for OpenCL kernel usage
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/randoms/GGEMSKissEngine.hh"
+
+/*!
+  \struct GGEMSPhotonState_t
+  \brief Structure storing the state of a photon read and written at each step of tracking, a tracking kernel loads it once from global memory and stores it back on exit
+*/
+typedef struct GGEMSPhotonState_t
+{
+  GGfloat E_; /*!< Energy of photon */
+  GGfloat3 direction_; /*!< Direction of photon, in local coordinate of solid during tracking */
+  GGfloat weight_; /*!< Statistical weight of photon */
+  GGint E_index_; /*!< Energy index within CS and Mat tables */
+  GGfloat next_interaction_distance_; /*!< Distance to the next interaction */
+  GGchar next_discrete_process_; /*!< Next process */
+  GGchar status_; /*!< Status of photon */
+  GGchar scatter_; /*!< Index of scattered photon */
+  GGEMSRandomState random_; /*!< Random state of photon */
+  #ifdef GGEMS_TRACKING
+  GGchar is_tracked_; /*!< TRUE if photon is the tracked particle */
+  #endif
+} GGEMSPhotonState; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void LoadPhotonState(global GGEMSPrimaryParticles const* primary_particle, global GGEMSRandom const* random, GGint const particle_id, GGEMSPhotonState* photon)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random numbers
+  \param particle_id - index of the particle
+  \param photon - pointer on photon state in private memory
+  \brief copy the state of a photon from global to private memory, direction is in global coordinate
+*/
+inline void LoadPhotonState(
+  global GGEMSPrimaryParticles const* primary_particle,
+  global GGEMSRandom const* random,
+  GGint const particle_id,
+  GGEMSPhotonState* photon
+)
+{
+  photon->E_ = primary_particle->E_[particle_id];
+  photon->direction_ = (GGfloat3)(primary_particle->dx_[particle_id], primary_particle->dy_[particle_id], primary_particle->dz_[particle_id]);
+  photon->weight_ = primary_particle->weight_[particle_id];
+  photon->E_index_ = primary_particle->E_index_[particle_id];
+  photon->next_interaction_distance_ = primary_particle->next_interaction_distance_[particle_id];
+  photon->next_discrete_process_ = primary_particle->next_discrete_process_[particle_id];
+  photon->status_ = primary_particle->status_[particle_id];
+  photon->scatter_ = primary_particle->scatter_[particle_id];
+
+  LoadRandomState(random, particle_id, &photon->random_);
+
+  #ifdef GGEMS_TRACKING
+  photon->is_tracked_ = particle_id == primary_particle->particle_tracking_id ? TRUE : FALSE;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void StorePhotonState(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGint const particle_id, GGEMSPhotonState const* photon)
+  \param primary_particle - buffer of particles
+  \param random - pointer on random numbers
+  \param particle_id - index of the particle
+  \param photon - pointer on photon state in private memory
+  \brief copy the state of a photon from private to global memory, direction has to be converted back to global coordinate before
+*/
+inline void StorePhotonState(
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  GGint const particle_id,
+  GGEMSPhotonState const* photon
+)
+{
+  primary_particle->E_[particle_id] = photon->E_;
+  primary_particle->dx_[particle_id] = photon->direction_.x;
+  primary_particle->dy_[particle_id] = photon->direction_.y;
+  primary_particle->dz_[particle_id] = photon->direction_.z;
+  primary_particle->weight_[particle_id] = photon->weight_;
+  primary_particle->E_index_[particle_id] = photon->E_index_;
+  primary_particle->next_interaction_distance_[particle_id] = photon->next_interaction_distance_;
+  primary_particle->next_discrete_process_[particle_id] = photon->next_discrete_process_;
+  primary_particle->status_[particle_id] = photon->status_;
+  primary_particle->scatter_[particle_id] = photon->scatter_;
+
+  StoreRandomState(random, particle_id, &photon->random_);
+}
+
+#endif
+
+#endif // GUARD_GGEMS_PHYSICS_GGEMSPHOTONSTATE_HH
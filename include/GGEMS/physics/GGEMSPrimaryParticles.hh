@@ -34,6 +34,10 @@
 #include "GGEMS/global/GGEMSConfiguration.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
 
+#ifndef __OPENCL_C_VERSION__
+#include <cstddef>
+#endif
+
 /*!
   \struct GGEMSPrimaryParticles_t
   \brief Structure storing informations about primary particles
@@ -41,6 +45,8 @@
 typedef struct GGEMSPrimaryParticles_t
 {
   GGint particle_tracking_id; /*!< Particle id for tracking */
+  GGint number_of_active_particles_; /*!< Number of particles in active list */
+  GGint number_of_free_particles_; /*!< Number of dead particles in free list, decremented by particles claiming a slot for split copies */
 
   GGfloat E_[MAXIMUM_PARTICLES]; /*!< Energies of particles */
   GGfloat dx_[MAXIMUM_PARTICLES]; /*!< Direction of the particle in x */
@@ -49,6 +55,7 @@ typedef struct GGEMSPrimaryParticles_t
   GGfloat px_[MAXIMUM_PARTICLES]; /*!< Position of the particle in x */
   GGfloat py_[MAXIMUM_PARTICLES]; /*!< Position of the particle in y */
   GGfloat pz_[MAXIMUM_PARTICLES]; /*!< Position of the particle in z */
+  GGfloat weight_[MAXIMUM_PARTICLES]; /*!< Statistical weight of the particle, 1 for analog tracking */
   GGchar scatter_[MAXIMUM_PARTICLES]; /*!< Index of scattered photon */
 
   GGint E_index_[MAXIMUM_PARTICLES]; /*!< Energy index within CS and Mat tables */
@@ -61,6 +68,23 @@ typedef struct GGEMSPrimaryParticles_t
   GGchar status_[MAXIMUM_PARTICLES]; /*!< Status of the particle */
   GGchar level_[MAXIMUM_PARTICLES]; /*!< Level of the particle */
   GGchar pname_[MAXIMUM_PARTICLES]; /*!< particle name (photon, electron, etc) */
+
+  GGint active_index_[MAXIMUM_PARTICLES]; /*!< Index of alive particles, tracking kernels are launched over this list */
+  GGint free_index_[MAXIMUM_PARTICLES]; /*!< Index of dead particles, slots available for split copies */
 } GGEMSPrimaryParticles; /*!< Using C convention name of struct to C++ (_t deletion) */
 
+#ifndef __OPENCL_C_VERSION__
+/*!
+  \fn inline GGsize GetPrimaryParticlesSize(GGsize const& number_of_particles)
+  \param number_of_particles - number of particles in OpenCL buffer (multiple of 4)
+  \return size in bytes of primary particles buffer
+  \brief get the size of primary particles buffer, kernels are compiled with MAXIMUM_PARTICLES set to the batch size of device so the host structure is only a reference layout
+*/
+inline GGsize GetPrimaryParticlesSize(GGsize const& number_of_particles)
+{
+  GGsize header_size = offsetof(GGEMSPrimaryParticles, E_);
+  return header_size + (sizeof(GGEMSPrimaryParticles) - header_size) / MAXIMUM_PARTICLES * number_of_particles;
+}
+#endif
+
 #endif // GUARD_GGEMS_PHYSICS_GGEMSPRIMARYPARTICLESSTACK_HH
@@ -33,6 +33,8 @@
 
 #ifdef __OPENCL_C_VERSION__
 
+#include "GGEMS/physics/GGEMSPhotonState.hh"
+
 constant GGfloat FACTOR = 32526509815670243328.0f; // 0.5*HC*HC -> HC = cm/(H_PLANCK*C_LIGHT)
 
 constant GGfloat PP0[101] = { 0.0f, 
@@ -157,42 +159,37 @@ constant GGfloat PP8[101] = { 0.0f,
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline void KleinNishinaComptonSampleSecondaries(global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, GGshort const material_id, GGint const particle_id)
-  \param primary_particle - buffer of particles
-  \param random - pointer on random numbers
+  \fn inline void LivermoreRayleighSampleSecondaries(GGEMSPhotonState* photon, global GGEMSMaterialTables const* materials, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, GGuchar const material_id)
+  \param photon - pointer on photon state in private memory
   \param materials - buffer of materials
   \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param photon_cross_sections - pointer to packed photon cross sections
   \param material_id - index of the material
-  \param particle_id - index of the particle
   \brief Klein Nishina Compton model, Effects due to binding of atomic electrons are negliged.
 */
 inline void LivermoreRayleighSampleSecondaries(
-  global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
+  GGEMSPhotonState* photon,
   global GGEMSMaterialTables const* materials,
   global GGEMSParticleCrossSections const* particle_cross_sections,
-  GGuchar const material_id,
-  GGint const particle_id
+  global GGfloat const* photon_cross_sections,
+  GGuchar const material_id
 )
 {
-  GGfloat kE0 = 0.009952493733686183f; //primary_particle->E_[particle_id];
+  GGfloat kE0 = 0.009952493733686183f; //photon->E_;
 
   if (kE0 <= 250.0e-6f) { // 250 eV
-    primary_particle->status_[particle_id] = DEAD;
+    photon->status_ = DEAD;
     return;
   }
 
   // Current Direction
-  GGfloat3 kGammaDirection = {
-    primary_particle->dx_[particle_id],
-    primary_particle->dy_[particle_id],
-    primary_particle->dz_[particle_id]
-  };
+  GGfloat3 kGammaDirection = photon->direction_;
 
-  GGshort kNumberOfBins = particle_cross_sections->number_of_bins_;
+  GGsize kNumberOfBins = particle_cross_sections->number_of_bins_;
+  GGsize kNumberOfMaterials = particle_cross_sections->number_of_materials_;
   GGchar kNEltsMinusOne = materials->number_of_chemical_elements_[material_id]-1;
   GGshort kMixtureID = materials->index_of_chemical_elements_[material_id];
-  GGint kEnergyID = primary_particle->E_index_[particle_id];
+  GGint kEnergyID = photon->E_index_;
 
   // Get last atom
   GGchar selected_atomic_number_z = materials->atomic_number_Z_[kMixtureID+kNEltsMinusOne];
@@ -203,23 +200,23 @@ inline void LivermoreRayleighSampleSecondaries(
     // Get Cross Section of Livermore Rayleigh
     GGfloat kCS = LinearInterpolation(
       particle_cross_sections->energy_bins_[kEnergyID],
-      particle_cross_sections->photon_cross_sections_[RAYLEIGH_SCATTERING][kEnergyID + kNumberOfBins*material_id],
+      photon_cross_sections[PHOTON_CROSS_SECTION_INDEX(material_id, kEnergyID, RAYLEIGH_SCATTERING, kNumberOfBins)],
       particle_cross_sections->energy_bins_[kEnergyID+1],
-      particle_cross_sections->photon_cross_sections_[RAYLEIGH_SCATTERING][kEnergyID+1 + kNumberOfBins*material_id],
+      photon_cross_sections[PHOTON_CROSS_SECTION_INDEX(material_id, kEnergyID+1, RAYLEIGH_SCATTERING, kNumberOfBins)],
       kE0
     );
 
     // Get a random
-    GGfloat x = KissUniform(random, particle_id) * kCS;
+    GGfloat x = KissUniformState(&photon->random_) * kCS;
 
     GGfloat cross_section = 0.0f;
     while (i < kNEltsMinusOne) {
       GGuchar atomic_number_z = materials->atomic_number_Z_[kMixtureID+i];
       cross_section += materials->atomic_number_density_[kMixtureID+i] * LinearInterpolation(
         particle_cross_sections->energy_bins_[kEnergyID],
-        particle_cross_sections->photon_cross_sections_per_atom_[RAYLEIGH_SCATTERING][kEnergyID + kNumberOfBins*atomic_number_z],
+        photon_cross_sections[PHOTON_CROSS_SECTION_INDEX(kNumberOfMaterials+atomic_number_z, kEnergyID, RAYLEIGH_SCATTERING, kNumberOfBins)],
         particle_cross_sections->energy_bins_[kEnergyID+1],
-        particle_cross_sections->photon_cross_sections_per_atom_[RAYLEIGH_SCATTERING][kEnergyID+1 + kNumberOfBins*atomic_number_z],
+        photon_cross_sections[PHOTON_CROSS_SECTION_INDEX(kNumberOfMaterials+atomic_number_z, kEnergyID+1, RAYLEIGH_SCATTERING, kNumberOfBins)],
         kE0
       );
 
@@ -263,7 +260,7 @@ inline void LivermoreRayleighSampleSecondaries(
     GGfloat n = kN0;
     GGfloat b = kB0;
 
-    x = KissUniform(random, particle_id)*(kX0+kX1+kX2);
+    x = KissUniformState(&photon->random_)*(kX0+kX1+kX2);
     if (x > kX0) {
       x -= kX0;
       if (x <= kX1) {
@@ -280,7 +277,7 @@ inline void LivermoreRayleighSampleSecondaries(
     n = 1.0f/n;
 
     // sampling of angle
-    GGfloat y = KissUniform(random, particle_id)*w;
+    GGfloat y = KissUniformState(&photon->random_)*w;
     if (y < 0.02f) {
       x = y*n*(1.0f + 0.5f*(n + 1.0f)*y*(1.0f - (n + 2.0f)*y/3.0f));
     }
@@ -289,9 +286,9 @@ inline void LivermoreRayleighSampleSecondaries(
     }
 
     costheta = 1.0f - x/(b*kXX);
-  } while (2.0f*KissUniform(random, particle_id) > 1.0f + costheta*costheta || costheta < -1.0f);
+  } while (2.0f*KissUniformState(&photon->random_) > 1.0f + costheta*costheta || costheta < -1.0f);
 
-  GGfloat phi  = TWO_PI * KissUniform(random, particle_id);
+  GGfloat phi  = TWO_PI * KissUniformState(&photon->random_);
   GGfloat sintheta = sqrt((1.0f - costheta)*(1.0f + costheta));
 
   GGfloat3 gamma_direction = {sintheta*cos(phi), sintheta*sin(phi), costheta};
@@ -299,18 +296,16 @@ inline void LivermoreRayleighSampleSecondaries(
   gamma_direction = normalize(gamma_direction);
 
   // Update direction
-  primary_particle->dx_[particle_id] = gamma_direction.x;
-  primary_particle->dy_[particle_id] = gamma_direction.y;
-  primary_particle->dz_[particle_id] = gamma_direction.z;
+  photon->direction_ = gamma_direction;
 
   #ifdef GGEMS_TRACKING
-  if (particle_id == primary_particle->particle_tracking_id) {
+  if (photon->is_tracked_) {
     printf("\n");
     printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Photon energy: %e keV\n", kE0/keV);
     printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Photon direction: %e %e %e\n", kGammaDirection.x, kGammaDirection.y, kGammaDirection.z);
-    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Number of element in material %s: %d\n", particle_cross_sections->material_names_[material_id], materials->number_of_chemical_elements_[material_id]);
+    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Number of element in material %d: %d\n", material_id, materials->number_of_chemical_elements_[material_id]);
     printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Selected element: %u\n", selected_atomic_number_z);
-    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Scattered photon direction: %e %e %e\n", primary_particle->dx_[particle_id], primary_particle->dy_[particle_id], primary_particle->dz_[particle_id]);
+    printf("[GGEMS OpenCL function LivermoreRayleighSampleSecondaries]     Scattered photon direction: %e %e %e\n", photon->direction_.x, photon->direction_.y, photon->direction_.z);
   }
   #endif
 }
@@ -36,19 +36,147 @@
 #include "GGEMS/randoms/GGEMSRandom.hh"
 #include "GGEMS/global/GGEMSConstants.hh"
 
+#include "GGEMS/randoms/GGEMSPhiloxEngine.hh"
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 /*!
-  \fn inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
+  \fn inline void StartRandomStream(global GGEMSRandom* random, GGint const index, GGulong const particle_offset)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of thread
+  \param particle_offset - index of new particle from the first particle of source kernel
+  \brief attach the random stream of a new primary particle to its slot, nothing to do for JKISS where the state of slot is kept
+*/
+inline void StartRandomStream(global GGEMSRandom* random, GGint const index, GGulong const particle_offset)
+{
+  #ifdef PHILOX_RANDOM
+  random->particle_index_[index] = random->first_particle_index_ + particle_offset;
+  random->draw_counter_[index] = 0;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \struct GGEMSRandomState_t
+  \brief Random state of one particle in private memory, loaded once by a tracking kernel and stored back on exit
+*/
+typedef struct GGEMSRandomState_t
+{
+  #ifdef PHILOX_RANDOM
+  GGuint2 key_; /*!< Key of Philox engine: seed and index of source */
+  GGulong particle_index_; /*!< Global index of particle in source */
+  GGuint draw_counter_; /*!< Number of random numbers drawn by particle */
+  #else
+  GGuint prng_state_1_; /*!< State 1 of the prng */
+  GGuint prng_state_2_; /*!< State 2 of the prng */
+  GGuint prng_state_3_; /*!< State 3 of the prng */
+  GGuint prng_state_4_; /*!< State 4 of the prng */
+  GGuint prng_state_5_; /*!< State 5 of the prng */
+  #endif
+} GGEMSRandomState; /*!< Using C convention name of struct to C++ (_t deletion) */
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void LoadRandomState(global GGEMSRandom const* random, GGint const index, GGEMSRandomState* random_state)
   \param random - pointer on random buffer on OpenCL device
   \param index - index of thread
+  \param random_state - pointer on random state in private memory
+  \brief copy the random state of a slot from global to private memory
+*/
+inline void LoadRandomState(global GGEMSRandom const* random, GGint const index, GGEMSRandomState* random_state)
+{
+  #ifdef PHILOX_RANDOM
+  random_state->key_ = (GGuint2)(random->key_[0], random->key_[1]);
+  random_state->particle_index_ = random->particle_index_[index];
+  random_state->draw_counter_ = random->draw_counter_[index];
+  #else
+  random_state->prng_state_1_ = random->prng_state_1_[index];
+  random_state->prng_state_2_ = random->prng_state_2_[index];
+  random_state->prng_state_3_ = random->prng_state_3_[index];
+  random_state->prng_state_4_ = random->prng_state_4_[index];
+  random_state->prng_state_5_ = random->prng_state_5_[index];
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void StoreRandomState(global GGEMSRandom* random, GGint const index, GGEMSRandomState const* random_state)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of thread
+  \param random_state - pointer on random state in private memory
+  \brief copy the random state of a slot from private to global memory, key of Philox is shared and never written
+*/
+inline void StoreRandomState(global GGEMSRandom* random, GGint const index, GGEMSRandomState const* random_state)
+{
+  #ifdef PHILOX_RANDOM
+  random->draw_counter_[index] = random_state->draw_counter_;
+  #else
+  random->prng_state_1_[index] = random_state->prng_state_1_;
+  random->prng_state_2_[index] = random_state->prng_state_2_;
+  random->prng_state_3_[index] = random_state->prng_state_3_;
+  random->prng_state_4_[index] = random_state->prng_state_4_;
+  random->prng_state_5_[index] = random_state->prng_state_5_;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void StartCopyRandomStream(global GGEMSRandom* random, GGint const index, GGEMSRandomState const* parent_state, GGint const copy_ordinal)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of slot receiving the copy
+  \param parent_state - pointer on random state of split particle in private memory
+  \param copy_ordinal - index of copy in splitting, from 1
+  \brief attach to a copy of split particle a random stream derived from the stream of parent and the index of copy
+*/
+inline void StartCopyRandomStream(global GGEMSRandom* random, GGint const index, GGEMSRandomState const* parent_state, GGint const copy_ordinal)
+{
+  #ifdef PHILOX_RANDOM
+  // Draws of particles have a null second word of counter, upper bit keeps copies out of indices of sources
+  GGuint4 hash = Philox4x32((GGuint4)(parent_state->draw_counter_, (GGuint)copy_ordinal, (GGuint)(parent_state->particle_index_), (GGuint)(parent_state->particle_index_ >> 32)), parent_state->key_);
+  random->particle_index_[index] = ((GGulong)(hash.y | 0x80000000u) << 32) | (GGulong)hash.x;
+  random->draw_counter_[index] = 0;
+  #else
+  GGuint4 state = Philox4x32(
+    (GGuint4)(parent_state->prng_state_1_, parent_state->prng_state_2_, parent_state->prng_state_3_, parent_state->prng_state_4_),
+    (GGuint2)(parent_state->prng_state_5_, (GGuint)copy_ordinal)
+  );
+  random->prng_state_1_[index] = state.x;
+  random->prng_state_2_[index] = state.y == 0 ? 1 : state.y; // Xorshift state is locked on 0
+  random->prng_state_3_[index] = state.z;
+  random->prng_state_4_[index] = state.w;
+  random->prng_state_5_[index] = 0;
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat KissUniformState(GGEMSRandomState* random_state)
+  \param random_state - pointer on random state in private memory
   \return Uniform random float number
-  \brief JKISS 32-bit (period ~2^121=2.6x10^36), passes all of the Dieharder and the BigCrunch tests in TestU01
+  \brief JKISS 32-bit (period ~2^121=2.6x10^36), passes all of the Dieharder and the BigCrunch tests in TestU01. Philox4x32-10 counter-based engine if GGEMS is compiled with PHILOX_RANDOM
 */
-inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
+inline GGfloat KissUniformState(GGEMSRandomState* random_state)
 {
+  #ifdef PHILOX_RANDOM
+  return PhiloxUniform(random_state->key_, random_state->particle_index_, random_state->draw_counter_++);
+  #else
   // y ^= (y<<5);
   // y ^= (y>>7);
   // y ^= (y<<22);
@@ -58,20 +186,42 @@ inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
   // w = t & 2147483647;
   // x += 1411392427;
 
-  random->prng_state_2_[index] ^= (random->prng_state_2_[index] << 5);
-  random->prng_state_2_[index] ^= (random->prng_state_2_[index] >> 7);
-  random->prng_state_2_[index] ^= (random->prng_state_2_[index] << 22);
+  random_state->prng_state_2_ ^= (random_state->prng_state_2_ << 5);
+  random_state->prng_state_2_ ^= (random_state->prng_state_2_ >> 7);
+  random_state->prng_state_2_ ^= (random_state->prng_state_2_ << 22);
 
-  GGint t = random->prng_state_3_[index] + random->prng_state_4_[index] + random->prng_state_5_[index];
+  GGint t = random_state->prng_state_3_ + random_state->prng_state_4_ + random_state->prng_state_5_;
 
-  random->prng_state_3_[index] = random->prng_state_4_[index];
-  random->prng_state_5_[index] = t < 0;
-  random->prng_state_4_[index] = t & 2147483647;
-  random->prng_state_1_[index] += 1411392427;
+  random_state->prng_state_3_ = random_state->prng_state_4_;
+  random_state->prng_state_5_ = t < 0;
+  random_state->prng_state_4_ = t & 2147483647;
+  random_state->prng_state_1_ += 1411392427;
 
-  return ((GGfloat)(random->prng_state_1_[index] + random->prng_state_2_[index] + random->prng_state_4_[index])
+  return ((GGfloat)(random_state->prng_state_1_ + random_state->prng_state_2_ + random_state->prng_state_4_)
     //  UINT_MAX       1.0  - float32_precision
     / 4294967295.0) * (1.0f - 1.0f/(1<<23));
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
+  \param random - pointer on random buffer on OpenCL device
+  \param index - index of thread
+  \return Uniform random float number
+  \brief draw a random number from the state in global memory, kernels drawing many numbers should load the state once with LoadRandomState and use KissUniformState
+*/
+inline GGfloat KissUniform(global GGEMSRandom* random, GGint const index)
+{
+  GGEMSRandomState random_state;
+  LoadRandomState(random, index, &random_state);
+  GGfloat uniform = KissUniformState(&random_state);
+  StoreRandomState(random, index, &random_state);
+
+  return uniform;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
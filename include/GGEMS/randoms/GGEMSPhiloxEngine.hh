@@ -0,0 +1,96 @@
+#ifndef GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
+#define GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
+
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSPhiloxEngine.hh
+
+  \brief Functions for counter-based pseudo random number generator using Philox4x32-10 engine (Salmon et al., Parallel random numbers: as easy as 1, 2, 3, SC11). This functions can be used only by an OpenCL kernel
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#ifdef __OPENCL_C_VERSION__
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+
+#define PHILOX_M4x32_0 0xD2511F53 /*!< Multiplier of Philox round for word 0 */
+#define PHILOX_M4x32_1 0xCD9E8D57 /*!< Multiplier of Philox round for word 2 */
+#define PHILOX_W32_0 0x9E3779B9 /*!< Weyl increment of key word 0 (golden ratio) */
+#define PHILOX_W32_1 0xBB67AE85 /*!< Weyl increment of key word 1 (sqrt(3)-1) */
+
+/*!
+  \fn inline GGuint4 Philox4x32Round(GGuint4 const counter, GGuint2 const key)
+  \param counter - counter of Philox
+  \param key - key of Philox for this round
+  \return counter after one round
+  \brief one round of Philox4x32, 2 multiplications and xor of high parts with counter and key
+*/
+inline GGuint4 Philox4x32Round(GGuint4 const counter, GGuint2 const key)
+{
+  GGuint hi_0 = mul_hi((GGuint)PHILOX_M4x32_0, counter.x);
+  GGuint hi_1 = mul_hi((GGuint)PHILOX_M4x32_1, counter.z);
+  GGuint lo_0 = PHILOX_M4x32_0 * counter.x;
+  GGuint lo_1 = PHILOX_M4x32_1 * counter.z;
+
+  return (GGuint4)(hi_1^counter.y^key.x, lo_1, hi_0^counter.w^key.y, lo_0);
+}
+
+/*!
+  \fn inline GGuint4 Philox4x32(GGuint4 counter, GGuint2 key)
+  \param counter - counter of Philox
+  \param key - key of Philox
+  \return 4 random 32-bit words
+  \brief Philox4x32-10, passes all of the BigCrush tests in TestU01 with 10 rounds
+*/
+inline GGuint4 Philox4x32(GGuint4 counter, GGuint2 key)
+{
+  counter = Philox4x32Round(counter, key);
+  for (GGint i = 0; i < 9; ++i) {
+    key += (GGuint2)(PHILOX_W32_0, PHILOX_W32_1);
+    counter = Philox4x32Round(counter, key);
+  }
+
+  return counter;
+}
+
+/*!
+  \fn inline GGfloat PhiloxUniform(GGuint2 const key, GGulong const particle_index, GGuint const draw)
+  \param key - key of Philox, seed and index of source
+  \param particle_index - global index of particle in source
+  \param draw - number of previous draws of particle
+  \return Uniform random float number in ]0,1[
+  \brief random number from key (seed, source) and counter (draw, global index of particle), the only state of particle is its number of draws
+*/
+inline GGfloat PhiloxUniform(GGuint2 const key, GGulong const particle_index, GGuint const draw)
+{
+  GGuint4 counter = (GGuint4)(draw, 0, (GGuint)particle_index, (GGuint)(particle_index >> 32));
+
+  // 23 upper bits centered in bin, 0 and 1 are never returned
+  return ((GGfloat)(Philox4x32(counter, key).x >> 9) + 0.5f) * (1.0f/8388608.0f);
+}
+
+#endif
+
+#endif // End of GUARD_GGEMS_RANDOMS_GGEMSPHILOXENGINE_HH
@@ -94,6 +94,13 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     */
     void SetSeed(GGuint const& seed);
 
+    /*!
+      \fn void SetHostSeeding(bool const& is_host_seeding)
+      \param is_host_seeding - true to seed the JKISS states on host with a Mersenne Twister, as GGEMS 1.1
+      \brief seed the JKISS states on host instead of OpenCL device, slower but giving the same states as previous versions for a seed
+    */
+    void SetHostSeeding(bool const& is_host_seeding);
+
     /*!
       \fn void PrintInfos(void) const
       \brief printing infos about random
@@ -108,6 +115,15 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     */
     inline cl::Buffer* GetPseudoRandomNumbers(GGsize const& thread_index) const {return pseudo_random_numbers_[thread_index];};
 
+    /*!
+      \fn void SetParticleStream(GGsize const& thread_index, GGsize const& source_index, GGsize const& first_particle_index) const
+      \param thread_index - index of activated device (thread index)
+      \param source_index - index of the source
+      \param first_particle_index - global index in source of first particle generated by the next source kernel
+      \brief set the random streams of the next generated particles, a counter-based random number depends only on seed, source, global index of particle and number of draws. Nothing is done for JKISS
+    */
+    void SetParticleStream(GGsize const& thread_index, GGsize const& source_index, GGsize const& first_particle_index) const;
+
   private:
     /*!
       \fn void AllocateRandom(void)
@@ -121,6 +137,18 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     */
     void InitializeSeeds(void);
 
+    /*!
+      \fn void InitializeSeedsOnHost(void)
+      \brief Initialize seeds for random from a Mersenne Twister on host, states are written in mapped buffers
+    */
+    void InitializeSeedsOnHost(void);
+
+    /*!
+      \fn void InitializeSeedsOnDevice(void)
+      \brief Initialize seeds for random with a kernel, states of each slot are computed in parallel from seed, device and slot
+    */
+    void InitializeSeedsOnDevice(void);
+
     /*!
       \fn GGuint GenerateSeed(void) const
       \return the seed computed by GGEMS
@@ -132,6 +160,8 @@ class GGEMS_EXPORT GGEMSPseudoRandomGenerator
     cl::Buffer** pseudo_random_numbers_; /*!< Pointer storing the buffer about random numbers in activated device */
     GGsize number_activated_devices_; /*!< Number of activated device */
     GGuint seed_; /*!< Initial seed generating state of GGEMS random */
+    bool is_host_seeding_; /*!< Flag seeding JKISS states on host */
+    cl::Kernel** kernel_initialize_seeds_; /*!< Kernel seeding JKISS states on device */
 };
 
 #endif // End of GUARD_GGEMS_RANDOMS_PSEUDO_RANDOM_GENERATOR_HH
@@ -34,6 +34,23 @@
 #include "GGEMS/global/GGEMSConfiguration.hh"
 #include "GGEMS/tools/GGEMSTypes.hh"
 
+#ifndef __OPENCL_C_VERSION__
+#include <cstddef>
+#endif
+
+#ifdef PHILOX_RANDOM
+/*!
+  \struct GGEMSRandom_t
+  \brief Structure storing informations about counter-based random, a random number depends only on seed, source, global index of particle and number of previous draws of particle
+*/
+typedef struct GGEMSRandom_t
+{
+  GGulong first_particle_index_; /*!< Global index in source of first particle generated by the next source kernel */
+  GGuint key_[2]; /*!< Key of Philox engine: seed and index of source */
+  GGulong particle_index_[MAXIMUM_PARTICLES]; /*!< Global index of particle in source */
+  GGuint draw_counter_[MAXIMUM_PARTICLES]; /*!< Number of random numbers drawn by particle */
+} GGEMSRandom; /*!< Using C convention name of struct to C++ (_t deletion) */
+#else
 /*!
   \struct GGEMSRandom_t
   \brief Structure storing informations about random
@@ -46,5 +63,24 @@ typedef struct GGEMSRandom_t
   GGuint prng_state_4_[MAXIMUM_PARTICLES]; /*!< State 4 of the prng */
   GGuint prng_state_5_[MAXIMUM_PARTICLES]; /*!< State 5 of the prng */
 } GGEMSRandom; /*!< Using C convention name of struct to C++ (_t deletion) */
+#endif
+
+#ifndef __OPENCL_C_VERSION__
+/*!
+  \fn inline GGsize GetRandomSize(GGsize const& number_of_particles)
+  \param number_of_particles - number of particles in OpenCL buffer
+  \return size in bytes of random buffer
+  \brief get the size of random buffer for a batch size of device, arrays are stored one after the other
+*/
+inline GGsize GetRandomSize(GGsize const& number_of_particles)
+{
+  #ifdef PHILOX_RANDOM
+  GGsize header_size = offsetof(GGEMSRandom, particle_index_);
+  #else
+  GGsize header_size = 0;
+  #endif
+  return header_size + (sizeof(GGEMSRandom) - header_size) / MAXIMUM_PARTICLES * number_of_particles;
+}
+#endif
 
 #endif // End of GUARD_GGEMS_RANDOMS_GGEMSRANDOM_HH
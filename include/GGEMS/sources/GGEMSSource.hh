@@ -31,7 +31,10 @@
   \date Tuesday October 15, 2019
 */
 
+#include <atomic>
+
 #include "GGEMS/global/GGEMSOpenCLManager.hh"
+#include "GGEMS/maths/GGEMSMatrixTypes.hh"
 
 class GGEMSParticles;
 class GGEMSPseudoRandomGenerator;
@@ -90,6 +93,14 @@ class GGEMS_EXPORT GGEMSSource
     */
     inline std::string GetNameOfSource(void) const {return source_name_;}
 
+    /*!
+      \fn cl::Buffer* GetTransformationMatrix(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing the matrix of transformation of source
+      \brief get the matrix of transformation of source, position of source is the origin of its local frame
+    */
+    cl::Buffer* GetTransformationMatrix(GGsize const& thread_index) const;
+
     /*!
       \fn void SetPosition(GGfloat const& pos_x, GGfloat const& pos_y, GGfloat const& pos_z, std::string const& unit = "mm")
       \param pos_x - Position of the source in X
@@ -117,6 +128,13 @@ class GGEMS_EXPORT GGEMSSource
     */
     void SetRotation(GGfloat const& rx, GGfloat const& ry, GGfloat const& rz, std::string const& unit = "deg");
 
+    /*!
+      \fn void SetViewTransformation(GGfloat44 const& matrix_view)
+      \param matrix_view - rigid transformation of the view in global frame
+      \brief move the source for a view of a scan, on top of its position and rotation
+    */
+    void SetViewTransformation(GGfloat44 const& matrix_view);
+
     /*!
       \fn void SetNumberOfParticles(GGsize const& number_of_particles)
       \param number_of_particles - number of particles to simulate
@@ -147,6 +165,35 @@ class GGEMS_EXPORT GGEMSSource
     */
     inline GGsize GetNumberOfParticlesInBatch(GGsize const& device_index, GGsize const& batch_index) {return number_of_particles_in_batch_[device_index][batch_index];}
 
+    /*!
+      \fn GGsize ClaimParticles(GGsize const& number_of_particles, GGsize& first_particle_index)
+      \param number_of_particles - number of particles requested by device
+      \param first_particle_index - index of the first claimed particle in the whole simulation
+      \return the number of claimed particles, 0 if all particles are already claimed
+      \brief Claim a batch of particles in the shared counter of source, used by dynamic balancing between devices
+    */
+    GGsize ClaimParticles(GGsize const& number_of_particles, GGsize& first_particle_index);
+
+    /*!
+      \fn inline void ResetClaimedParticles(void)
+      \brief reset the shared counter of claimed particles before a new run
+    */
+    inline void ResetClaimedParticles(void) {number_of_claimed_particles_ = 0;}
+
+    /*!
+      \fn inline GGsize GetNumberOfParticles(void) const
+      \return the number of particles of source
+      \brief method returning the number of particles to simulate for the source
+    */
+    inline GGsize GetNumberOfParticles(void) const {return number_of_particles_;}
+
+    /*!
+      \fn inline GGsize GetNumberOfRemainingParticles(void) const
+      \return the number of particles not claimed by a device
+      \brief method returning the number of particles still to claim
+    */
+    inline GGsize GetNumberOfRemainingParticles(void) const {return number_of_particles_ - number_of_claimed_particles_.load();}
+
     /*!
       \fn void CheckParameters(void) const
       \brief Check mandatory parameters for a source
@@ -168,6 +215,30 @@ class GGEMS_EXPORT GGEMSSource
     */
     virtual void GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) = 0;
 
+    /*!
+      \fn void RefillPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) = 0
+      \param thread_index - index of activated device (thread index)
+      \param number_of_particles - number of particle slots in buffer
+      \brief Generate primary particles in slots of dead particles, as long as refill budget is not exhausted
+    */
+    virtual void RefillPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) = 0;
+
+    /*!
+      \fn void SetRefillBudget(GGsize const& thread_index, GGsize const& refill_budget)
+      \param thread_index - index of activated device (thread index)
+      \param refill_budget - number of primaries to generate by refill on device
+      \brief Set the number of primaries generated in slots of dead particles by RefillPrimaries
+    */
+    void SetRefillBudget(GGsize const& thread_index, GGsize const& refill_budget);
+
+    /*!
+      \fn GGsize GetRefillBudget(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return number of primaries not yet generated by refill on device
+      \brief Get the number of primaries still to generate in slots of dead particles
+    */
+    GGsize GetRefillBudget(GGsize const& thread_index) const;
+
     /*!
       \fn void PrintInfos(void) const = 0
       \brief Printing infos about the source
@@ -195,12 +266,15 @@ class GGEMS_EXPORT GGEMSSource
 
     GGsize** number_of_particles_in_batch_; /*!< Number of particles in batch for each device */
     GGsize* number_of_batchs_; /*!< Number of batchs for each device */
+    std::atomic<GGsize> number_of_claimed_particles_; /*!< Number of particles claimed by devices in dynamic balancing */
 
     GGchar particle_type_; /*!< Type of particle: photon, electron or positron */
     std::string tracking_kernel_option_; /*!< Preprocessor option for tracking */
     GGEMSGeometryTransformation* geometry_transformation_; /*!< Pointer storing the geometry transformation */
 
     cl::Kernel** kernel_get_primaries_; /*!< Kernel generating primaries on OpenCL device */
+    cl::Kernel** kernel_refill_primaries_; /*!< Kernel generating primaries in slots of dead particles on OpenCL device */
+    cl::Buffer** refill_budget_; /*!< Number of primaries to generate by refill on OpenCL device */
     GGsize number_activated_devices_; /*!< Number of activated device */
 };
 
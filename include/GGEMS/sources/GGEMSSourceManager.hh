@@ -38,8 +38,7 @@
 #include "GGEMS/sources/GGEMSSource.hh"
 
 #include "GGEMS/physics/GGEMSParticles.hh"
-
-class GGEMSPseudoRandomGenerator;
+#include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
 
 /*!
   \class GGEMSSourceManager
@@ -135,6 +134,24 @@ class GGEMS_EXPORT GGEMSSourceManager
     */
     inline std::string GetNameOfSource(GGsize const& source_index) const {return sources_[source_index]->GetNameOfSource();}
 
+    /*!
+      \fn inline GGEMSSource* GetSource(std::string const& source_name) const
+      \param source_name - name of the source
+      \return the source by the name
+      \brief get the source by the name
+    */
+    inline GGEMSSource* GetSource(std::string const& source_name) const
+    {
+      // Loop over the sources
+      for (GGsize i = 0; i < number_of_sources_; ++i) {
+        if (source_name == sources_[i]->GetNameOfSource()) {
+          return sources_[i];
+        }
+      }
+      GGEMSMisc::ThrowException("GGEMSSourceManager", "GetSource", "Name of the source unknown!!!");
+      return nullptr;
+    }
+
     /*!
       \fn inline GGsize GetNumberOfBatchs(GGsize const& source_index, GGsize const& thread_index) const
       \param source_index - index of the source
@@ -161,6 +178,45 @@ class GGEMS_EXPORT GGEMSSourceManager
     */
     inline GGsize GetNumberOfParticlesInBatch(GGsize const& source_index, GGsize const& thread_index, GGsize const& batch_index) {return sources_[source_index]->GetNumberOfParticlesInBatch(thread_index, batch_index);}
 
+    /*!
+      \fn GGsize ClaimParticles(GGsize const& source_index, GGsize const& number_of_particles, GGsize& first_particle_index) const
+      \param source_index - index of the source
+      \param number_of_particles - number of particles requested by device
+      \param first_particle_index - index of the first claimed particle
+      \return the number of claimed particles, 0 if all particles of source are claimed
+      \brief Claim a batch of particles of a specific source for dynamic balancing
+    */
+    inline GGsize ClaimParticles(GGsize const& source_index, GGsize const& number_of_particles, GGsize& first_particle_index) const {return sources_[source_index]->ClaimParticles(number_of_particles, first_particle_index);}
+
+    /*!
+      \fn void ResetClaimedParticles(void) const
+      \brief Reset the counters of claimed particles of all sources before a new run
+    */
+    inline void ResetClaimedParticles(void) const {for (GGsize i = 0; i < number_of_sources_; ++i) sources_[i]->ResetClaimedParticles();}
+
+    /*!
+      \fn void SetViewTransformation(GGfloat44 const& matrix_view) const
+      \param matrix_view - rigid transformation of the view in global frame
+      \brief Move all sources for a view of a scan
+    */
+    inline void SetViewTransformation(GGfloat44 const& matrix_view) const {for (GGsize i = 0; i < number_of_sources_; ++i) sources_[i]->SetViewTransformation(matrix_view);}
+
+    /*!
+      \fn GGsize GetNumberOfParticles(GGsize const& source_index) const
+      \param source_index - index of the source
+      \return the number of particles of source
+      \brief method returning the number of particles to simulate for a specific source
+    */
+    inline GGsize GetNumberOfParticles(GGsize const& source_index) const {return sources_[source_index]->GetNumberOfParticles();}
+
+    /*!
+      \fn GGsize GetNumberOfRemainingParticles(GGsize const& source_index) const
+      \param source_index - index of the source
+      \return the number of particles not claimed by a device
+      \brief method returning the number of particles of a specific source still to claim
+    */
+    inline GGsize GetNumberOfRemainingParticles(GGsize const& source_index) const {return sources_[source_index]->GetNumberOfRemainingParticles();}
+
     /*!
       \fn GGEMSParticles* GetParticles(void) const
       \return pointer on particle stack
@@ -176,18 +232,52 @@ class GGEMS_EXPORT GGEMSSourceManager
     inline GGEMSPseudoRandomGenerator* GetPseudoRandomGenerator(void) const {return pseudo_random_generator_;}
 
     /*!
-      \fn void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
+      \fn void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& first_particle_index) const
       \param source_index - index of the source
       \param thread_index - index of activated device (thread index)
       \param number_of_particles - number of particles to simulate
+      \param first_particle_index - global index in source of the first generated particle
       \brief Generate primary particles for a specific source
     */
-    inline void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
+    inline void GetPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles, GGsize const& first_particle_index) const
     {
       particles_->SetNumberOfParticles(thread_index, number_of_particles);
+      pseudo_random_generator_->SetParticleStream(thread_index, source_index, first_particle_index);
       sources_[source_index]->GetPrimaries(thread_index, number_of_particles);
     }
 
+    /*!
+      \fn void RefillPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const
+      \param source_index - index of the source
+      \param thread_index - index of activated device (thread index)
+      \param number_of_particles - number of particle slots in buffer
+      \brief Generate primary particles in slots of dead particles for a specific source
+    */
+    inline void RefillPrimaries(GGsize const& source_index, GGsize const& thread_index, GGsize const& number_of_particles) const {sources_[source_index]->RefillPrimaries(thread_index, number_of_particles);}
+
+    /*!
+      \fn void SetRefillBudget(GGsize const& source_index, GGsize const& thread_index, GGsize const& refill_budget, GGsize const& first_particle_index) const
+      \param source_index - index of the source
+      \param thread_index - index of activated device (thread index)
+      \param refill_budget - number of primaries to generate by refill
+      \param first_particle_index - global index in source of the first primary of budget
+      \brief Set the number of primaries generated in slots of dead particles for a specific source
+    */
+    inline void SetRefillBudget(GGsize const& source_index, GGsize const& thread_index, GGsize const& refill_budget, GGsize const& first_particle_index) const
+    {
+      pseudo_random_generator_->SetParticleStream(thread_index, source_index, first_particle_index);
+      sources_[source_index]->SetRefillBudget(thread_index, refill_budget);
+    }
+
+    /*!
+      \fn GGsize GetRefillBudget(GGsize const& source_index, GGsize const& thread_index) const
+      \param source_index - index of the source
+      \param thread_index - index of activated device (thread index)
+      \return number of primaries not yet generated by refill on device
+      \brief Get the number of primaries still to generate in slots of dead particles for a specific source
+    */
+    inline GGsize GetRefillBudget(GGsize const& source_index, GGsize const& thread_index) const {return sources_[source_index]->GetRefillBudget(thread_index);}
+
     /*!
       \fn bool IsAlive(GGsize const& thread_index) const
       \param thread_index - index of activated device (thread index)
@@ -196,6 +286,28 @@ class GGEMS_EXPORT GGEMSSourceManager
     */
     bool IsAlive(GGsize const& thread_index) const;
 
+    /*!
+      \fn void EnqueueIsAlive(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief enqueue an alive check in OpenCL particle buffer, result is read later with IsAliveDeferred
+    */
+    void EnqueueIsAlive(GGsize const& thread_index) const;
+
+    /*!
+      \fn bool IsAliveDeferred(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return true if source was still alive at the previous enqueued check, otherwize false
+      \brief check if some particles were alive at the previous enqueued check, without waiting for the last one
+    */
+    bool IsAliveDeferred(GGsize const& thread_index) const;
+
+    /*!
+      \fn void ResetAliveChecks(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \brief wait for pending alive checks at the end of a batch
+    */
+    void ResetAliveChecks(GGsize const& thread_index) const;
+
     /*!
       \fn void Clean(void)
       \brief clean OpenCL data
@@ -231,4 +343,12 @@ extern "C" GGEMS_EXPORT void initialize_source_manager(GGEMSSourceManager* sourc
 */
 extern "C" GGEMS_EXPORT void print_infos_source_manager(GGEMSSourceManager* source_manager);
 
+/*!
+  \fn void set_host_seeding_ggems_source_manager(GGEMSSourceManager* source_manager, bool const is_host_seeding)
+  \param source_manager - pointer on the singleton
+  \param is_host_seeding - true to seed the JKISS states on host with a Mersenne Twister, as GGEMS 1.1
+  \brief Seed the random states of sources on host instead of OpenCL device, must be set before initialization
+*/
+extern "C" GGEMS_EXPORT void set_host_seeding_ggems_source_manager(GGEMSSourceManager* source_manager, bool const is_host_seeding);
+
 #endif // End of GUARD_GGEMS_SOURCES_GGEMSSOURCEMANAGER
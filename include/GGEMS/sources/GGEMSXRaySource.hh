@@ -133,6 +133,51 @@ class GGEMS_EXPORT GGEMSXRaySource : public GGEMSSource
     */
     void GetPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) override;
 
+    /*!
+      \fn void RefillPrimaries(GGsize const& thread_index, GGsize const& number_of_particles)
+      \param thread_index - index of activated device (thread index)
+      \param number_of_particles - number of particle slots in buffer
+      \brief Generate primary particles in slots of dead particles, as long as refill budget is not exhausted
+    */
+    void RefillPrimaries(GGsize const& thread_index, GGsize const& number_of_particles) override;
+
+    /*!
+      \fn inline GGfloat GetBeamAperture(void) const
+      \return beam aperture in radian
+      \brief get the beam aperture of the x-ray source
+    */
+    inline GGfloat GetBeamAperture(void) const {return beam_aperture_;}
+
+    /*!
+      \fn inline GGfloat3 GetFocalSpotSize(void) const
+      \return focal spot size in mm
+      \brief get the focal spot size of the x-ray source
+    */
+    inline GGfloat3 GetFocalSpotSize(void) const {return focal_spot_size_;}
+
+    /*!
+      \fn inline GGsize GetNumberOfEnergyBins(void) const
+      \return number of energies in spectrum, 2 in monoenergy mode
+      \brief get the number of energies in spectrum
+    */
+    inline GGsize GetNumberOfEnergyBins(void) const {return number_of_energy_bins_;}
+
+    /*!
+      \fn inline cl::Buffer* GetEnergySpectrum(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing energies of spectrum
+      \brief get the buffer storing energies of spectrum
+    */
+    inline cl::Buffer* GetEnergySpectrum(GGsize const& thread_index) const {return energy_spectrum_[thread_index];}
+
+    /*!
+      \fn inline cl::Buffer* GetCDF(GGsize const& thread_index) const
+      \param thread_index - index of activated device (thread index)
+      \return OpenCL buffer storing cumulative distribution function of energies
+      \brief get the buffer storing cumulative distribution function of energies
+    */
+    inline cl::Buffer* GetCDF(GGsize const& thread_index) const {return cdf_[thread_index];}
+
   private:
     /*!
       \fn void InitializeKernel(void)
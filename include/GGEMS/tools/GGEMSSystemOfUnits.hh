@@ -416,6 +416,50 @@ inline T DensityUnit(T const& value, std::string const& unit)
   return new_value;
 }
 
+/*!
+  \fn inline T TimeUnit(T const& value, std::string const& unit)
+  \tparam T - type of the value to convert unit
+  \param value - value to check
+  \param unit - time unit
+  \brief Choose best time unit
+  \return value in the good unit
+*/
+template <typename T>
+inline T TimeUnit(T const& value, std::string const& unit)
+{
+  T new_value = static_cast<T>(0);
+  if (unit == "ns") {
+    new_value = static_cast<T>(value * ns);
+  }
+  else if (unit == "us") {
+    new_value = static_cast<T>(value * us);
+  }
+  else if (unit == "ms") {
+    new_value = static_cast<T>(value * ms);
+  }
+  else if (unit == "s") {
+    new_value = static_cast<T>(value * s);
+  }
+  else if (unit == "min") {
+    new_value = static_cast<T>(value * 60.0 * s);
+  }
+  else if (unit == "h") {
+    new_value = static_cast<T>(value * 3600.0 * s);
+  }
+  else {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Unknown unit!!! You have choice between:" << std::endl;
+    oss << "    - \"ns\": nanosecond" << std::endl;
+    oss << "    - \"us\": microsecond" << std::endl;
+    oss << "    - \"ms\": millisecond" << std::endl;
+    oss << "    - \"s\": second" << std::endl;
+    oss << "    - \"min\": minute" << std::endl;
+    oss << "    - \"h\": hour" << std::endl;
+    GGEMSMisc::ThrowException("", "TimeUnit", oss.str());
+  }
+  return new_value;
+}
+
 /*!
   \fn inline std::string BestDigitalUnit(GGulong const& value)
   \param value - value to convert to best unit
@@ -132,6 +132,34 @@
 #define GGDosiType GGfloat /*!< define GGDositype as a float, useful for dosimetry computation */
 #endif
 
+#ifdef DOSIMETRY_FIXED_POINT
+#define GGEdepType GGulong /*!< define GGEdepType as a 64-bit integer, energy deposit in units of 1/EDEP_FIXED_POINT_SCALE MeV */
+
+#if defined(cl_khr_int64_base_atomics)
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#else
+#error "Int64 atomic operation not available on your OpenCL device!!! Please recompile GGEMS setting DOSIMETRY_FIXED_POINT to OFF."
+#endif
+
+#else
+#define GGEdepType GGDosiType /*!< define GGEdepType as GGDosiType, energy deposit in MeV */
+#endif
+
+#define EDEP_FIXED_POINT_SCALE 4294967296.0f /*!< 2^32 integer units per MeV, a 64-bit tally overflows above 4.29e9 MeV */
+
+#ifdef ENERGY_INTEGRATING
+#define GGHistoType GGulong /*!< define GGHistoType as a 64-bit integer, energy deposited in detection element in units of 1/EDEP_FIXED_POINT_SCALE MeV */
+
+#if defined(cl_khr_int64_base_atomics)
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#else
+#error "Int64 atomic operation not available on your OpenCL device!!! Please use the 'counts' detector response."
+#endif
+
+#else
+#define GGHistoType GGint /*!< define GGHistoType as an integer, number of interactions in detection element */
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -186,6 +214,46 @@ inline void AtomicAddDouble(volatile global GGDosiType* address, GGdouble val)
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline void AtomicAddEdep(volatile global GGEdepType* address, GGDosiType val)
+  \param address - address of pointer where the value is added
+  \param val - energy value to add
+  \brief atomic addition of energy in tally, with DOSIMETRY_FIXED_POINT the value is rounded to a fixed-point integer and added with native atom_add, so the sum does not depend on the order of threads
+*/
+inline void AtomicAddEdep(volatile global GGEdepType* address, GGDosiType val)
+{
+  #ifdef DOSIMETRY_FIXED_POINT
+  atom_add(address, convert_ulong_rte(val * EDEP_FIXED_POINT_SCALE));
+  #elif defined(DOSIMETRY_DOUBLE_PRECISION)
+  AtomicAddDouble(address, val);
+  #else
+  AtomicAddFloat(address, val);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+/*!
+  \fn inline GGDosiType EdepToDosiType(GGEdepType const edep)
+  \param edep - energy stored in tally
+  \return energy in MeV
+  \brief converting energy from tally unit to MeV
+*/
+inline GGDosiType EdepToDosiType(GGEdepType const edep)
+{
+  #ifdef DOSIMETRY_FIXED_POINT
+  return (GGDosiType)edep / (GGDosiType)EDEP_FIXED_POINT_SCALE;
+  #else
+  return edep;
+  #endif
+}
+
 #else
 
 #ifdef __APPLE__
@@ -293,6 +361,14 @@ typedef struct GGsize3_t {
 #define GGDosiType GGfloat /*!< define GGDositype as a float, useful for dosimetry computation */
 #endif
 
+#ifdef DOSIMETRY_FIXED_POINT
+#define GGEdepType cl_ulong /*!< define GGEdepType as a 64-bit integer, energy deposit in units of 1/EDEP_FIXED_POINT_SCALE MeV */
+#else
+#define GGEdepType GGDosiType /*!< define GGEdepType as GGDosiType, energy deposit in MeV */
+#endif
+
+#define EDEP_FIXED_POINT_SCALE 4294967296.0f /*!< 2^32 integer units per MeV, a 64-bit tally overflows above 4.29e9 MeV */
+
 #endif
 
 #endif // End of GUARD_GGEMS_TOOLS_GGEMSTYPES_HH
@@ -21,7 +21,7 @@ from ggems_lib import *
 from ggems_opencl import GGEMSOpenCLManager
 from ggems_ram import GGEMSRAMManager
 from ggems_materials import GGEMSMaterialsDatabaseManager, GGEMSMaterials
-from ggems_systems import GGEMSCTSystem
+from ggems_systems import GGEMSCTSystem, GGEMSForcedDetection
 from ggems_phantoms import GGEMSVoxelizedPhantom, GGEMSWorld
 from ggems_sources import GGEMSXRaySource, GGEMSSourceManager
 from ggems_processes import GGEMSProcessesManager, GGEMSRangeCutsManager, GGEMSCrossSections
@@ -71,9 +71,33 @@ class GGEMS(object):
         ggems_lib.set_tracking_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int]
         ggems_lib.set_tracking_ggems.restype = ctypes.c_void_p
 
+        ggems_lib.set_asynchronous_mode_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_asynchronous_mode_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_stream_compaction_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_stream_compaction_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_persistent_pool_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_persistent_pool_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_dynamic_balancing_ggems.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_dynamic_balancing_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_maximum_simulation_time_ggems.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_char_p]
+        ggems_lib.set_maximum_simulation_time_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.set_uncertainty_check_period_ggems.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_char_p]
+        ggems_lib.set_uncertainty_check_period_ggems.restype = ctypes.c_void_p
+
         ggems_lib.run_ggems.argtypes = [ctypes.c_void_p]
         ggems_lib.run_ggems.restype = ctypes.c_void_p
 
+        ggems_lib.run_scan_ggems.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_float), ctypes.c_size_t]
+        ggems_lib.run_scan_ggems.restype = ctypes.c_void_p
+
+        ggems_lib.run_gantry_scan_ggems.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_float), ctypes.c_size_t, ctypes.c_char_p]
+        ggems_lib.run_gantry_scan_ggems.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems()
 
     def delete(self):
@@ -85,6 +109,13 @@ class GGEMS(object):
     def run(self):
         ggems_lib.run_ggems(self.obj)
 
+    def run_scan(self, view_transformations):
+        matrices = [element for matrix in view_transformations for row in matrix for element in row]
+        ggems_lib.run_scan_ggems(self.obj, (ctypes.c_float * len(matrices))(*matrices), len(view_transformations))
+
+    def run_gantry_scan(self, gantry_angles, unit='deg'):
+        ggems_lib.run_gantry_scan_ggems(self.obj, (ctypes.c_float * len(gantry_angles))(*gantry_angles), len(gantry_angles), unit.encode('ASCII'))
+
     def opencl_verbose(self, flag):
         ggems_lib.set_opencl_verbose_ggems(self.obj, flag)
 
@@ -114,3 +145,21 @@ class GGEMS(object):
 
     def tracking_verbose(self, flag, particle_id):
         ggems_lib.set_tracking_ggems(self.obj, flag, particle_id)
+
+    def asynchronous_mode(self, flag):
+        ggems_lib.set_asynchronous_mode_ggems(self.obj, flag)
+
+    def stream_compaction(self, flag):
+        ggems_lib.set_stream_compaction_ggems(self.obj, flag)
+
+    def persistent_pool(self, flag):
+        ggems_lib.set_persistent_pool_ggems(self.obj, flag)
+
+    def dynamic_balancing(self, flag):
+        ggems_lib.set_dynamic_balancing_ggems(self.obj, flag)
+
+    def maximum_simulation_time(self, time, unit='s'):
+        ggems_lib.set_maximum_simulation_time_ggems(self.obj, time, unit.encode('ASCII'))
+
+    def uncertainty_check_period(self, time, unit='s'):
+        ggems_lib.set_uncertainty_check_period_ggems(self.obj, time, unit.encode('ASCII'))
@@ -57,6 +57,15 @@ class GGEMSDosimetryCalculator(object):
         ggems_lib.water_reference_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_bool]
         ggems_lib.water_reference_dosimetry_calculator.restype = ctypes.c_void_p
 
+        ggems_lib.set_dose_replicas_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.set_dose_replicas_dosimetry_calculator.restype = ctypes.c_void_p
+
+        ggems_lib.set_uncertainty_target_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float]
+        ggems_lib.set_uncertainty_target_dosimetry_calculator.restype = ctypes.c_void_p
+
+        ggems_lib.set_uncertainty_roi_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        ggems_lib.set_uncertainty_roi_dosimetry_calculator.restype = ctypes.c_void_p
+
         ggems_lib.attach_to_navigator_dosimetry_calculator.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
         ggems_lib.attach_to_navigator_dosimetry_calculator.restype = ctypes.c_void_p
 
@@ -95,5 +104,14 @@ class GGEMSDosimetryCalculator(object):
     def minimum_density(self, density, unit):
         ggems_lib.minimum_density_dosimetry_calculator(self.obj, density, unit.encode('ASCII'))
 
+    def set_dose_replicas(self, number_of_replicas):
+        ggems_lib.set_dose_replicas_dosimetry_calculator(self.obj, number_of_replicas)
+
+    def set_uncertainty_target(self, uncertainty, dose_threshold=0.5):
+        ggems_lib.set_uncertainty_target_dosimetry_calculator(self.obj, uncertainty, dose_threshold)
+
+    def set_uncertainty_roi(self, x_min, y_min, z_min, x_max, y_max, z_max):
+        ggems_lib.set_uncertainty_roi_dosimetry_calculator(self.obj, x_min, y_min, z_min, x_max, y_max, z_max)
+
     def attach_to_navigator(self, name):
         ggems_lib.attach_to_navigator_dosimetry_calculator(self.obj, name.encode('ASCII'))
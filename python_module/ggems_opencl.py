@@ -39,6 +39,21 @@ class GGEMSOpenCLManager(object):
         ggems_lib.set_device_balancing_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
         ggems_lib.set_device_balancing_opencl_manager.restype = ctypes.c_void_p
 
+        ggems_lib.set_kernel_cache_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_kernel_cache_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_shared_context_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_shared_context_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_kernel_cache_directory_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        ggems_lib.set_kernel_cache_directory_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.clean_kernel_cache_opencl_manager.argtypes = [ctypes.c_void_p]
+        ggems_lib.clean_kernel_cache_opencl_manager.restype = ctypes.c_void_p
+
+        ggems_lib.set_particle_batch_size_opencl_manager.argtypes = [ctypes.c_void_p, ctypes.c_size_t]
+        ggems_lib.set_particle_batch_size_opencl_manager.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.get_instance_ggems_opencl_manager()
 
     def print_infos(self):
@@ -53,5 +68,20 @@ class GGEMSOpenCLManager(object):
     def set_device_balancing(self, device_balancing):
         ggems_lib.set_device_balancing_opencl_manager(self.obj, device_balancing.encode('ASCII'))
 
+    def set_shared_context(self, is_shared_context):
+        ggems_lib.set_shared_context_opencl_manager(self.obj, is_shared_context)
+
+    def set_kernel_cache(self, is_kernel_cache):
+        ggems_lib.set_kernel_cache_opencl_manager(self.obj, is_kernel_cache)
+
+    def set_kernel_cache_directory(self, directory):
+        ggems_lib.set_kernel_cache_directory_opencl_manager(self.obj, directory.encode('ASCII'))
+
+    def clean_kernel_cache(self):
+        ggems_lib.clean_kernel_cache_opencl_manager(self.obj)
+
+    def set_particle_batch_size(self, particle_batch_size):
+        ggems_lib.set_particle_batch_size_opencl_manager(self.obj, particle_batch_size)
+
     def clean(self):
         ggems_lib.clean_opencl_manager(self.obj)
\ No newline at end of file
@@ -33,6 +33,18 @@ class GGEMSVoxelizedPhantom(object):
         ggems_lib.set_rotation_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_float, ctypes.c_float, ctypes.c_float, ctypes.c_char_p]
         ggems_lib.set_rotation_ggems_voxelized_phantom.restype = ctypes.c_void_p
 
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
+        ggems_lib.set_dda_tracking_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_dda_tracking_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
+        ggems_lib.set_importance_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_float]
+        ggems_lib.set_importance_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
+        ggems_lib.set_importance_map_ggems_voxelized_phantom.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+        ggems_lib.set_importance_map_ggems_voxelized_phantom.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.create_ggems_voxelized_phantom(voxelized_phantom_name.encode('ASCII'))
 
     def set_phantom(self, phantom_filename, range_data_filename):
@@ -44,6 +56,18 @@ class GGEMSVoxelizedPhantom(object):
     def set_rotation(self, rx, ry, rz, unit):
         ggems_lib.set_rotation_ggems_voxelized_phantom(self.obj, rx, ry, rz, unit.encode('ASCII'))
 
+    def woodcock_tracking(self, is_woodcock_tracking):
+        ggems_lib.set_woodcock_tracking_ggems_voxelized_phantom(self.obj, is_woodcock_tracking)
+
+    def dda_tracking(self, is_dda_tracking):
+        ggems_lib.set_dda_tracking_ggems_voxelized_phantom(self.obj, is_dda_tracking)
+
+    def set_importance(self, importance):
+        ggems_lib.set_importance_ggems_voxelized_phantom(self.obj, importance)
+
+    def set_importance_map(self, importance_map_filename):
+        ggems_lib.set_importance_map_ggems_voxelized_phantom(self.obj, importance_map_filename.encode('ASCII'))
+
 
 class GGEMSWorld(object):
     """Class for world volume for GGEMS simulation
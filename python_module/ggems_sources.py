@@ -30,6 +30,9 @@ class GGEMSSourceManager(object):
         ggems_lib.print_infos_source_manager.argtypes = [ctypes.c_void_p]
         ggems_lib.print_infos_source_manager.restype = ctypes.c_void_p
 
+        ggems_lib.set_host_seeding_ggems_source_manager.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+        ggems_lib.set_host_seeding_ggems_source_manager.restype = ctypes.c_void_p
+
         self.obj = ggems_lib.get_instance_ggems_source_manager()
 
     def initialize(self, seed):
@@ -38,6 +41,9 @@ class GGEMSSourceManager(object):
     def print_infos(self):
         ggems_lib.print_infos_source_manager(self.obj)
 
+    def host_seeding(self, flag):
+        ggems_lib.set_host_seeding_ggems_source_manager(self.obj, flag)
+
     def clean(self):
         ggems_lib.clean_source_manager(self.obj)
 
@@ -57,6 +57,15 @@ class GGEMSCTSystem(object):
       ggems_lib.store_scatter_ggems_ct_system.argtypes = [ctypes.c_void_p, ctypes.c_bool]
       ggems_lib.store_scatter_ggems_ct_system.restype = ctypes.c_void_p
 
+      ggems_lib.set_fused_navigation_ggems_ct_system.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+      ggems_lib.set_fused_navigation_ggems_ct_system.restype = ctypes.c_void_p
+
+      ggems_lib.set_local_histogram_ggems_ct_system.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+      ggems_lib.set_local_histogram_ggems_ct_system.restype = ctypes.c_void_p
+
+      ggems_lib.set_detector_response_ggems_ct_system.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+      ggems_lib.set_detector_response_ggems_ct_system.restype = ctypes.c_void_p
+
       self.obj = ggems_lib.create_ggems_ct_system(ct_system_name.encode('ASCII'))
 
   def set_number_of_modules(self, module_x, module_y):
@@ -92,3 +101,61 @@ class GGEMSCTSystem(object):
   def store_scatter(self, flag):
       ggems_lib.store_scatter_ggems_ct_system(self.obj, flag)
 
+  def fused_navigation(self, flag):
+      ggems_lib.set_fused_navigation_ggems_ct_system(self.obj, flag)
+
+  def local_histogram(self, flag):
+      ggems_lib.set_local_histogram_ggems_ct_system(self.obj, flag)
+
+  def set_detector_response(self, detector_response):
+      ggems_lib.set_detector_response_ggems_ct_system(self.obj, detector_response.encode('ASCII'))
+
+class GGEMSForcedDetection(object):
+  """Class computing expected projections of a system by forced detection
+  """
+  def __init__(self):
+      ggems_lib.create_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.delete_ggems_forced_detection.argtypes = [ctypes.c_void_p]
+      ggems_lib.delete_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.attach_to_navigator_ggems_forced_detection.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+      ggems_lib.attach_to_navigator_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.set_detector_ggems_forced_detection.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+      ggems_lib.set_detector_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.set_source_ggems_forced_detection.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+      ggems_lib.set_source_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.set_output_ggems_forced_detection.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+      ggems_lib.set_output_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.set_primary_projection_ggems_forced_detection.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+      ggems_lib.set_primary_projection_ggems_forced_detection.restype = ctypes.c_void_p
+
+      ggems_lib.set_scatter_projection_ggems_forced_detection.argtypes = [ctypes.c_void_p, ctypes.c_bool]
+      ggems_lib.set_scatter_projection_ggems_forced_detection.restype = ctypes.c_void_p
+
+      self.obj = ggems_lib.create_ggems_forced_detection()
+
+  def delete(self):
+      ggems_lib.delete_ggems_forced_detection(self.obj)
+
+  def attach_to_navigator(self, name):
+      ggems_lib.attach_to_navigator_ggems_forced_detection(self.obj, name.encode('ASCII'))
+
+  def set_detector(self, name):
+      ggems_lib.set_detector_ggems_forced_detection(self.obj, name.encode('ASCII'))
+
+  def set_source(self, name):
+      ggems_lib.set_source_ggems_forced_detection(self.obj, name.encode('ASCII'))
+
+  def set_output_basename(self, output):
+      ggems_lib.set_output_ggems_forced_detection(self.obj, output.encode('ASCII'))
+
+  def primary_projection(self, activate):
+      ggems_lib.set_primary_projection_ggems_forced_detection(self.obj, activate)
+
+  def scatter_projection(self, activate):
+      ggems_lib.set_scatter_projection_ggems_forced_detection(self.obj, activate)
@@ -54,6 +54,7 @@ GGEMSSolid::GGEMSSolid(void)
 
   solid_data_ = new cl::Buffer*[number_activated_devices_];
   label_data_ = new cl::Buffer*[number_activated_devices_];
+  importance_map_ = nullptr;
 
   // Storing a kernel for each device
   kernel_particle_solid_distance_ = new cl::Kernel*[number_activated_devices_];
@@ -61,6 +62,7 @@ GGEMSSolid::GGEMSSolid(void)
   kernel_track_through_solid_ = new cl::Kernel*[number_activated_devices_];
 
   is_scatter_ = false;
+  local_histogram_size_ = 0;
 
   GGcout("GGEMSSolid", "GGEMSSolid", 3) << "GGEMSSolid created!!!" << GGendl;
 }
@@ -97,12 +99,20 @@ GGEMSSolid::~GGEMSSolid(void)
 
   if (label_data_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(label_data_[i], number_of_voxels_*sizeof(GGuchar), i);
+      if (opencl_manager.IsContextOwner(i)) opencl_manager.Deallocate(label_data_[i], number_of_voxels_*sizeof(GGuchar), i);
     }
     delete[] label_data_;
     label_data_ = nullptr;
   }
 
+  if (importance_map_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      if (opencl_manager.IsContextOwner(i)) opencl_manager.Deallocate(importance_map_[i], number_of_voxels_*sizeof(GGfloat), i);
+    }
+    delete[] importance_map_;
+    importance_map_ = nullptr;
+  }
+
   if (solid_data_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
       opencl_manager.Deallocate(solid_data_[i], sizeof(GGEMSSolidBoxData), i);
@@ -140,3 +150,13 @@ void GGEMSSolid::SetPosition(GGfloat3 const& position_xyz)
 {
   geometry_transformation_->SetTranslation(position_xyz);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSolid::SetViewTransformation(GGfloat44 const& matrix_view)
+{
+  geometry_transformation_->SetViewTransformation(matrix_view);
+  for (GGsize i = 0; i < number_activated_devices_; ++i) UpdateTransformationMatrix(i);
+}
@@ -83,22 +83,26 @@ GGEMSSolidBox::GGEMSSolidBox(GGsize const& virtual_element_number_x, GGsize cons
 
   // Solid box associated at hit collection
   data_reg_type_ = data_reg_type;
-  if (data_reg_type == "HISTOGRAM") {
+  if (data_reg_type == "HISTOGRAM" || data_reg_type == "ENERGY_HISTOGRAM") {
     histogram_.number_of_elements_ = virtual_element_number_x*virtual_element_number_y*virtual_element_number_z;
 
+    // Deposited energy is stored in 64-bit fixed-point
+    histogram_.element_size_ = data_reg_type == "ENERGY_HISTOGRAM" ? sizeof(GGulong) : sizeof(GGint);
+    if (data_reg_type == "ENERGY_HISTOGRAM") kernel_option_ += " -DENERGY_INTEGRATING";
+
     // Allocating memory storing data
     histogram_.histogram_ = new cl::Buffer*[number_activated_devices_];
     histogram_.scatter_ = new cl::Buffer*[number_activated_devices_];
 
     // Loop over number of device
     for (GGsize d = 0; d < number_activated_devices_; ++d) {
-      histogram_.histogram_[d] = opencl_manager.Allocate(nullptr, histogram_.number_of_elements_*sizeof(GGint), d, CL_MEM_READ_WRITE, "GGEMSSolidBox");
+      histogram_.histogram_[d] = opencl_manager.Allocate(nullptr, histogram_.number_of_elements_*histogram_.element_size_, d, CL_MEM_READ_WRITE, "GGEMSSolidBox");
       histogram_.scatter_[d] = nullptr;
 
       if (d == 0) kernel_option_ += " -DHISTOGRAM";
 
       // Initialize value to 0
-      opencl_manager.CleanBuffer(histogram_.histogram_[d], histogram_.number_of_elements_*sizeof(GGint), d);
+      opencl_manager.CleanBuffer(histogram_.histogram_[d], histogram_.number_of_elements_*histogram_.element_size_, d);
     }
   }
   else {
@@ -106,6 +110,7 @@ GGEMSSolidBox::GGEMSSolidBox(GGsize const& virtual_element_number_x, GGsize cons
     oss << "False registration type name!!!" << std::endl;
     oss << "Registration type is :" << std::endl;
     oss << "    - HISTOGRAM" << std::endl;
+    oss << "    - ENERGY_HISTOGRAM" << std::endl;
     //oss << "    - LISTMODE" << std::endl;
     //oss << "    - DOSIMETRY" << std::endl;
     GGEMSMisc::ThrowException("GGEMSSolidBox", "GGEMSSolidBox", oss.str());
@@ -125,10 +130,10 @@ GGEMSSolidBox::~GGEMSSolidBox(void)
   // Get the opencl manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
-  if (data_reg_type_ == "HISTOGRAM") {
+  if (data_reg_type_ == "HISTOGRAM" || data_reg_type_ == "ENERGY_HISTOGRAM") {
     if (histogram_.histogram_) {
       for (GGsize i = 0; i < number_activated_devices_; ++i) {
-        opencl_manager.Deallocate(histogram_.histogram_[i], histogram_.number_of_elements_*sizeof(GGint), i);
+        opencl_manager.Deallocate(histogram_.histogram_[i], histogram_.number_of_elements_*histogram_.element_size_, i);
       }
       delete[] histogram_.histogram_;
       histogram_.histogram_ = nullptr;
@@ -137,7 +142,7 @@ GGEMSSolidBox::~GGEMSSolidBox(void)
     if (is_scatter_) {
       if (histogram_.scatter_) {
         for (GGsize i = 0; i < number_activated_devices_; ++i) {
-          opencl_manager.Deallocate(histogram_.scatter_[i], histogram_.number_of_elements_*sizeof(GGint), i);
+          opencl_manager.Deallocate(histogram_.scatter_[i], histogram_.number_of_elements_*histogram_.element_size_, i);
         }
         delete[] histogram_.scatter_;
         histogram_.scatter_ = nullptr;
@@ -169,6 +174,22 @@ void GGEMSSolidBox::InitializeKernel(void)
   opencl_manager.CompileKernel(particle_solid_distance_filename, "particle_solid_distance_ggems_solid_box", kernel_particle_solid_distance_, nullptr, const_cast<char*>(kernel_option_.c_str()));
   opencl_manager.CompileKernel(project_to_filename, "project_to_ggems_solid_box", kernel_project_to_solid_, nullptr, const_cast<char*>(kernel_option_.c_str()));
   opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_solid_box", kernel_track_through_solid_, nullptr, const_cast<char*>(kernel_option_.c_str()));
+
+  // Local memory used by tracking kernel itself is known once compiled, histograms go back to global memory if they do not fit with it
+  if (local_histogram_size_ == 0) return;
+
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(d);
+    GGsize kernel_local_memory_size = opencl_manager.GetKernelLocalMemorySize(kernel_track_through_solid_[d], d);
+    if (local_histogram_size_ + kernel_local_memory_size > opencl_manager.GetLocalMemorySize(device_index)) {
+      GGcout("GGEMSSolidBox", "InitializeKernel", 1) << "Histograms of " << local_histogram_size_ << " bytes and " << kernel_local_memory_size << " bytes used by kernel do not fit in local memory of " << opencl_manager.GetDeviceName(device_index) << ", histograms are accumulated in global memory" << GGendl;
+
+      local_histogram_size_ = 0;
+      kernel_option_.erase(kernel_option_.find(" -DLOCAL_HISTOGRAM"), std::string(" -DLOCAL_HISTOGRAM").size());
+      opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_solid_box", kernel_track_through_solid_, nullptr, const_cast<char*>(kernel_option_.c_str()));
+      return;
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -196,10 +217,10 @@ void GGEMSSolidBox::EnableScatter(void)
 
   // Loop over number of device
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
-    histogram_.scatter_[d] = opencl_manager.Allocate(nullptr, histogram_.number_of_elements_*sizeof(GGint), d, CL_MEM_READ_WRITE, "GGEMSSolidBox");
+    histogram_.scatter_[d] = opencl_manager.Allocate(nullptr, histogram_.number_of_elements_*histogram_.element_size_, d, CL_MEM_READ_WRITE, "GGEMSSolidBox");
 
     // Initialize value to 0
-    opencl_manager.CleanBuffer(histogram_.scatter_[d], histogram_.number_of_elements_*sizeof(GGint), d);
+    opencl_manager.CleanBuffer(histogram_.scatter_[d], histogram_.number_of_elements_*histogram_.element_size_, d);
   }
 }
 
@@ -207,6 +228,32 @@ void GGEMSSolidBox::EnableScatter(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSSolidBox::EnableLocalHistogram(void)
+{
+  // Getting the OpenCLManager singleton
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Histogram followed by scatter histogram in local memory
+  GGsize local_histogram_size = histogram_.number_of_elements_*histogram_.element_size_;
+  if (is_scatter_) local_histogram_size *= 2;
+
+  // Same kernel options for all devices, histograms have to fit in local memory of each device
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(d);
+    if (local_histogram_size > opencl_manager.GetLocalMemorySize(device_index)) {
+      GGcout("GGEMSSolidBox", "EnableLocalHistogram", 1) << "Histograms of " << local_histogram_size << " bytes do not fit in local memory of " << opencl_manager.GetDeviceName(device_index) << ", histograms are accumulated in global memory" << GGendl;
+      return;
+    }
+  }
+
+  local_histogram_size_ = local_histogram_size;
+  kernel_option_ += " -DLOCAL_HISTOGRAM";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSSolidBox::PrintInfos(void) const
 {
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
@@ -95,6 +95,42 @@ GGEMSVoxelizedSolid::~GGEMSVoxelizedSolid(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSVoxelizedSolid::EnableWoodcockTracking(void)
+{
+  kernel_option_ += " -DWOODCOCK_TRACKING";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::EnableDDATracking(void)
+{
+  kernel_option_ += " -DDDA_TRACKING";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::EnableForcedDetection(void)
+{
+  kernel_option_ += " -DFORCED_DETECTION";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::EnableParticleSplitting(void)
+{
+  kernel_option_ += " -DPARTICLE_SPLITTING";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSVoxelizedSolid::InitializeKernel(void)
 {
   GGcout("GGEMSVoxelizedSolid", "InitializeKernel", 3) << "Initializing kernel for voxelized solid..." << GGendl;
@@ -276,3 +312,86 @@ void GGEMSVoxelizedSolid::LoadVolumeImage(GGEMSMaterials* materials)
     ConvertImageToLabel<GGfloat>(raw_filename, range_filename_, materials);
   }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedSolid::LoadImportanceMap(std::string const& importance_map_filename)
+{
+  GGcout("GGEMSVoxelizedSolid", "LoadImportanceMap", 3) << "Loading importance map from mhd file..." << GGendl;
+
+  // Get the OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  importance_map_ = new cl::Buffer*[number_activated_devices_];
+
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    // Importance map is shared by devices of the same context, loaded only once
+    if (!opencl_manager.IsContextOwner(d)) {
+      importance_map_[d] = importance_map_[opencl_manager.GetContextOwner(d)];
+      continue;
+    }
+
+    // Header of importance map is read in a temporary solid data
+    GGEMSMHDImage mhd_importance_map;
+    cl::Buffer* importance_map_data = opencl_manager.Allocate(nullptr, sizeof(GGEMSVoxelizedSolidData), d, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
+    mhd_importance_map.Read(importance_map_filename, importance_map_data, d);
+
+    // Checking dimensions of importance map with volume image
+    GGEMSVoxelizedSolidData* importance_map_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(importance_map_data, sizeof(GGEMSVoxelizedSolidData), d);
+    GGEMSVoxelizedSolidData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSVoxelizedSolidData>(solid_data_[d], sizeof(GGEMSVoxelizedSolidData), d);
+
+    bool is_same_dimensions =
+      importance_map_data_device->number_of_voxels_xyz_.x == solid_data_device->number_of_voxels_xyz_.x &&
+      importance_map_data_device->number_of_voxels_xyz_.y == solid_data_device->number_of_voxels_xyz_.y &&
+      importance_map_data_device->number_of_voxels_xyz_.z == solid_data_device->number_of_voxels_xyz_.z;
+
+    // Release the pointers
+    opencl_manager.ReleaseDeviceBuffer(importance_map_data, importance_map_data_device, d);
+    opencl_manager.ReleaseDeviceBuffer(solid_data_[d], solid_data_device, d);
+    opencl_manager.Deallocate(importance_map_data, sizeof(GGEMSVoxelizedSolidData), d);
+
+    if (!is_same_dimensions) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Dimensions of importance map " << importance_map_filename << " are different from dimensions of voxelized phantom!!!";
+      GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "LoadImportanceMap", oss.str());
+    }
+
+    if (mhd_importance_map.GetDataMHDType().compare("MET_FLOAT")) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Importance map " << importance_map_filename << " has to be stored in MET_FLOAT!!!";
+      GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "LoadImportanceMap", oss.str());
+    }
+
+    // Checking if file exists
+    std::string raw_filename = mhd_importance_map.GetOutputDirectory() + mhd_importance_map.GetRawMDHfilename();
+    std::ifstream in_raw_stream(raw_filename, std::ios::in | std::ios::binary);
+    GGEMSFileStream::CheckInputStream(in_raw_stream, raw_filename);
+
+    // Reading data directly in buffer on OpenCL device
+    importance_map_[d] = opencl_manager.Allocate(nullptr, number_of_voxels_ * sizeof(GGfloat), d, CL_MEM_READ_WRITE, "GGEMSVoxelizedSolid");
+    GGfloat* importance_map_device = opencl_manager.GetDeviceBuffer<GGfloat>(importance_map_[d], number_of_voxels_ * sizeof(GGfloat), d);
+
+    in_raw_stream.read(reinterpret_cast<char*>(importance_map_device), static_cast<std::streamsize>(number_of_voxels_ * sizeof(GGfloat)));
+    in_raw_stream.close();
+
+    // Importance is the inverse of weight of particles, it has to be strictly positive
+    bool is_positive_importance = true;
+    for (GGsize i = 0; i < number_of_voxels_; ++i) {
+      if (!(importance_map_device[i] > 0.0f)) {
+        is_positive_importance = false;
+        break;
+      }
+    }
+
+    // Release the pointer
+    opencl_manager.ReleaseDeviceBuffer(importance_map_[d], importance_map_device, d);
+
+    if (!is_positive_importance) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Values of importance map " << importance_map_filename << " have to be > 0!!!";
+      GGEMSMisc::ThrowException("GGEMSVoxelizedSolid", "LoadImportanceMap", oss.str());
+    }
+  }
+}
@@ -30,6 +30,9 @@
 
 #include <fcntl.h>
 #include <thread>
+#include <algorithm>
+#include <limits>
+#include <cmath>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -43,10 +46,12 @@
 #include "GGEMS/physics/GGEMSRangeCutsManager.hh"
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/navigators/GGEMSNavigatorManager.hh"
+#include "GGEMS/navigators/GGEMSSystem.hh"
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
 #include "GGEMS/tools/GGEMSProfilerManager.hh"
 #include "GGEMS/tools/GGEMSProgressBar.hh"
+#include "GGEMS/tools/GGEMSSystemOfUnits.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -63,7 +68,18 @@ GGEMS::GGEMS(void)
   is_random_verbose_(false),
   is_tracking_verbose_(false),
   is_profiling_verbose_(false),
-  particle_tracking_id_(0)
+  is_asynchronous_mode_(false),
+  is_stream_compaction_(false),
+  is_persistent_pool_(false),
+  is_dynamic_balancing_(false),
+  maximum_simulation_time_(0.0),
+  is_adaptive_stopping_(false),
+  is_stop_requested_(false),
+  number_of_simulated_particles_(0),
+  uncertainty_check_period_(1.0e9),
+  particle_tracking_id_(0),
+  view_index_(0),
+  progress_bar_(nullptr)
 {
   GGcout("GGEMS", "GGEMS", 3) << "GGEMS creating..." << GGendl;
 
@@ -176,6 +192,60 @@ void GGEMS::SetTrackingVerbose(bool const& is_tracking_verbose, GGint const& par
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMS::SetAsynchronousMode(bool const& is_asynchronous_mode)
+{
+  is_asynchronous_mode_ = is_asynchronous_mode;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetStreamCompaction(bool const& is_stream_compaction)
+{
+  is_stream_compaction_ = is_stream_compaction;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetPersistentPool(bool const& is_persistent_pool)
+{
+  is_persistent_pool_ = is_persistent_pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetDynamicBalancing(bool const& is_dynamic_balancing)
+{
+  is_dynamic_balancing_ = is_dynamic_balancing;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetMaximumSimulationTime(GGfloat const& time, std::string const& unit)
+{
+  maximum_simulation_time_ = TimeUnit(static_cast<GGdouble>(time), unit);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::SetUncertaintyCheckPeriod(GGfloat const& time, std::string const& unit)
+{
+  uncertainty_check_period_ = TimeUnit(static_cast<GGdouble>(time), unit);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMS::Initialize(GGuint const& seed)
 {
   GGcout("GGEMS", "Initialize", 1) << "Initialization of GGEMS Manager singleton..." << GGendl;
@@ -198,8 +268,34 @@ void GGEMS::Initialize(GGuint const& seed)
   // Checking if material manager is ready
   if (!material_database_manager.IsReady()) GGEMSMisc::ThrowException("GGEMS", "Initialize", "Materials are not loaded in GGEMS!!!");
 
+  // Stopping criteria are checked between batchs
+  is_adaptive_stopping_ = maximum_simulation_time_ > 0.0 || navigator_manager.IsUncertaintyTarget();
+
+  // Sources are run one after another, a simulation stopped early would only contain the first sources
+  if (is_adaptive_stopping_ && source_manager.GetNumberOfSources() > 1) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Adaptive stopping (maximum simulation time or target of uncertainty) is only available with one source, " << source_manager.GetNumberOfSources() << " sources are defined!!!";
+    GGEMSMisc::ThrowException("GGEMS", "Initialize", oss.str());
+  }
+
   // Initialization of the source
   source_manager.Initialize(seed, is_tracking_verbose_, particle_tracking_id_);
+  source_manager.GetParticles()->SetStreamCompaction(is_stream_compaction_);
+  if (is_dynamic_balancing_ && is_persistent_pool_) {
+    GGwarn("GGEMS", "Initialize", 0) << "Persistent particle pool is not compatible with dynamic balancing, pool is disabled!!!" << GGendl;
+    is_persistent_pool_ = false;
+  }
+  if (is_adaptive_stopping_ && is_persistent_pool_) {
+    GGwarn("GGEMS", "Initialize", 0) << "Persistent particle pool has no batch to check stopping criteria, pool is disabled!!!" << GGendl;
+    is_persistent_pool_ = false;
+  }
+  source_manager.GetParticles()->SetPersistentPool(is_persistent_pool_);
+
+  // Copies of split particles are written in slots of dead particles
+  source_manager.GetParticles()->SetParticleSplitting(navigator_manager.IsParticleSplitting());
+  if (is_persistent_pool_ && navigator_manager.IsParticleSplitting()) {
+    GGwarn("GGEMS", "Initialize", 0) << "Persistent particle pool refills dead slots first, particles are split only when pool is empty!!!" << GGendl;
+  }
 
   // Initialization of the navigators (phantom + system)
   navigator_manager.Initialize(is_tracking_verbose_);
@@ -210,6 +306,7 @@ void GGEMS::Initialize(GGuint const& seed)
     opencl_manager.PrintDeviceInfos();
     opencl_manager.PrintActivatedDevices();
     opencl_manager.PrintBuildOptions();
+    opencl_manager.PrintKernelCacheInfos();
   }
 
   // Printing infos about material database
@@ -243,78 +340,335 @@ void GGEMS::Initialize(GGuint const& seed)
 
   // Display the elapsed time in GGEMS
   GGEMSChrono::DisplayTime(end_time - start_time, "GGEMS initialization");
+  GGEMSChrono::DisplayTime(opencl_manager.GetKernelBuildTime(), "OpenCL kernel build");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMS::RunOnDevice(GGsize const& thread_index)
+GGsize GGEMS::ComputeDynamicBatchSize(GGsize const& source_index, GGsize const& thread_index) const
 {
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  GGsize number_of_remaining_particles = source_manager.GetNumberOfRemainingParticles(source_index);
+
+  // Particle buffers of device limit the size of batch
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGsize maximum_batch_size = opencl_manager.GetParticleBatchSize(thread_index);
+
+  // Minimum size of batch, a too small batch is dominated by kernel launch overhead
+  GGsize minimum_batch_size = std::max(maximum_batch_size / 64, static_cast<GGsize>(1));
+
+  mutex.lock();
+  GGdouble device_throughput = device_throughputs_[thread_index];
+  GGdouble total_throughput = 0.0;
+  GGsize number_of_measured_devices = 0;
+  for (GGsize i = 0; i < device_throughputs_.size(); ++i) {
+    if (device_throughputs_[i] > 0.0) {
+      total_throughput += device_throughputs_[i];
+      ++number_of_measured_devices;
+    }
+  }
+  mutex.unlock();
+
+  // First batch of device is small, only to measure throughput
+  if (device_throughput == 0.0) return std::max(maximum_batch_size / 8, minimum_batch_size);
+
+  // Devices not measured yet are estimated with the mean throughput
+  total_throughput += static_cast<GGdouble>(device_throughputs_.size() - number_of_measured_devices) * total_throughput / static_cast<GGdouble>(number_of_measured_devices);
+
+  // Half of the share of remaining particles for this device. The other half is claimed later with refined throughputs, so all devices finish at the same time
+  GGsize batch_size = static_cast<GGsize>(std::ceil(0.5 * static_cast<GGdouble>(number_of_remaining_particles) * device_throughput / total_throughput));
+
+  return std::min(std::max(batch_size, minimum_batch_size), maximum_batch_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMS::CheckStoppingCriteria(GGsize const& thread_index, GGsize const& number_of_particles)
+{
+  // Mean uncertainty of device from its own dose map, computed outside of mutex. Dose and reductions are computed at most once per period
   GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+  GGdouble uncertainty_ratio = 0.0;
+  bool is_uncertainty_measured = false;
+  if (navigator_manager.IsUncertaintyTarget()) {
+    ChronoTime now = GGEMSChrono::Now();
+    DurationNano time_since_measurement = now - device_uncertainty_check_times_[thread_index];
+    if (static_cast<GGdouble>(time_since_measurement.count()) >= uncertainty_check_period_) {
+      uncertainty_ratio = static_cast<GGdouble>(navigator_manager.ComputeUncertaintyRatio(thread_index));
+      device_uncertainty_check_times_[thread_index] = now;
+      is_uncertainty_measured = true;
+    }
+  }
 
-  // Printing progress bar
   mutex.lock();
-  static GGEMSProgressBar progress_bar(source_manager.GetTotalNumberOfBatchs());
+
+  number_of_simulated_particles_ += number_of_particles;
+
+  // Wall-clock budget
+  DurationNano elapsed_time = GGEMSChrono::Now() - run_start_time_;
+  if (maximum_simulation_time_ > 0.0 && static_cast<GGdouble>(elapsed_time.count()) >= maximum_simulation_time_) {
+    if (!is_stop_requested_) GGcout("GGEMS", "CheckStoppingCriteria", 0) << "Wall-clock budget of simulation is expired" << GGendl;
+    is_stop_requested_ = true;
+  }
+
+  // Uncertainty decreases as 1/sqrt(N), devices are independent estimates combined with inverse-variance weights
+  if (is_uncertainty_measured) {
+    device_uncertainty_ratios_[thread_index] = uncertainty_ratio;
+    GGdouble sum_inverse_variance = 0.0;
+    for (GGsize i = 0; i < device_uncertainty_ratios_.size(); ++i) {
+      if (device_uncertainty_ratios_[i] > 0.0) sum_inverse_variance += 1.0 / (device_uncertainty_ratios_[i] * device_uncertainty_ratios_[i]);
+    }
+
+    if (uncertainty_ratio == 0.0 || sum_inverse_variance >= 1.0) {
+      if (!is_stop_requested_) GGcout("GGEMS", "CheckStoppingCriteria", 0) << "Target of uncertainty is reached" << GGendl;
+      is_stop_requested_ = true;
+    }
+  }
+
+  bool is_stop_requested = is_stop_requested_;
+  mutex.unlock();
+
+  return is_stop_requested;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMS::IsStopRequested(void) const
+{
+  mutex.lock();
+  bool is_stop_requested = is_stop_requested_;
   mutex.unlock();
 
+  return is_stop_requested;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::TrackParticles(GGsize const& thread_index)
+{
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+
+  // Loop until ALL particles are dead
+  GGint loop_counter = 0, max_loop = 100; // Prevent infinite loop
+  if (is_asynchronous_mode_) {
+    // Kernels are chained in command queue, status of loop n is read by host while device computes loop n+1
+    bool is_alive = true;
+    do {
+      navigator_manager.FindSolid(thread_index);
+      navigator_manager.WorldTracking(thread_index);
+      navigator_manager.ProjectToSolid(thread_index);
+      navigator_manager.TrackThroughSolid(thread_index);
+      source_manager.EnqueueIsAlive(thread_index);
+
+      is_alive = source_manager.IsAliveDeferred(thread_index);
+      loop_counter++;
+    } while (is_alive && loop_counter < max_loop);
+
+    // Waiting for the last check, one loop computed on dead particles only
+    source_manager.ResetAliveChecks(thread_index);
+  }
+  else {
+    do {
+       // Step 2: Find closest navigator (phantom, detector) before projection and track operation
+      navigator_manager.FindSolid(thread_index);
+
+      // Optional step: World tracking
+      navigator_manager.WorldTracking(thread_index);
+
+      // Step 3: Project particles to solid
+      navigator_manager.ProjectToSolid(thread_index);
+
+      // Step 4: Track through step, particles are tracked in selected solid
+      navigator_manager.TrackThroughSolid(thread_index);
+
+      loop_counter++;
+    } while (source_manager.IsAlive(thread_index) && loop_counter < max_loop); // Step 5: Checking if all particles are dead, otherwize go back to step 2
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::RunOnDevice(GGsize const& thread_index)
+{
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+
   // Loop over sources
   for (GGsize i = 0; i < source_manager.GetNumberOfSources(); ++i) {
+    // Another device reached a stopping criterion
+    if (is_adaptive_stopping_ && IsStopRequested()) break;
+
     // Number of batch for a source
     GGsize number_of_batchs = source_manager.GetNumberOfBatchs(i, thread_index);
 
-    // Loop over batch
-    for (GGsize j = 0; j < number_of_batchs; ++j) {
-      GGsize number_of_particles = source_manager.GetNumberOfParticlesInBatch(i, thread_index, j);
+    // Particles of source are numbered device after device, batch after batch. The random stream of a particle follows this index, the numbering continues from a view of scan to the next
+    GGsize view_first_particle_index = view_index_*source_manager.GetNumberOfParticles(i);
+    GGsize first_particle_index = view_first_particle_index;
+    for (GGsize j = 0; j < thread_index; ++j) {
+      for (GGsize k = 0; k < source_manager.GetNumberOfBatchs(i, j); ++k) first_particle_index += source_manager.GetNumberOfParticlesInBatch(i, j, k);
+    }
+
+    if (is_dynamic_balancing_) {
+      // Number of batchs of source on all devices, progress bar is incremented as particles are claimed
+      GGsize number_of_source_batchs = 0;
+      for (GGsize j = 0; j < device_throughputs_.size(); ++j) number_of_source_batchs += source_manager.GetNumberOfBatchs(i, j);
+      GGsize number_of_source_particles = source_manager.GetNumberOfParticles(i);
 
-      // Generating particles
-      source_manager.GetPrimaries(i, thread_index, number_of_particles);
+      // Batchs are claimed in counter shared by devices until all particles of source are simulated
+      GGsize number_of_particles = 0;
+      while ((number_of_particles = source_manager.ClaimParticles(i, ComputeDynamicBatchSize(i, thread_index), first_particle_index)) > 0) {
+        ChronoTime start_time = GGEMSChrono::Now();
+
+        // Generating particles
+        source_manager.GetPrimaries(i, thread_index, number_of_particles, view_first_particle_index + first_particle_index);
+
+        // Loop until ALL particles are dead
+        TrackParticles(thread_index);
+
+        // Measuring throughput of device in particles per nanosecond, host is synchronized with device at the end of tracking
+        DurationNano elapsed_time = GGEMSChrono::Now() - start_time;
+        GGdouble throughput = static_cast<GGdouble>(number_of_particles) / std::max(static_cast<GGdouble>(elapsed_time.count()), 1.0);
+
+        mutex.lock();
+        device_throughputs_[thread_index] = (device_throughputs_[thread_index] == 0.0) ? throughput : 0.5 * (device_throughputs_[thread_index] + throughput);
+
+        // Incrementing progress bar
+        GGsize last_particle_index = first_particle_index + number_of_particles;
+        GGsize number_of_tics = last_particle_index * number_of_source_batchs / number_of_source_particles - first_particle_index * number_of_source_batchs / number_of_source_particles;
+        for (GGsize j = 0; j < number_of_tics; ++j) ++(*progress_bar_);
+        mutex.unlock();
+
+        // Other devices stop after their current batch
+        if (is_adaptive_stopping_ && CheckStoppingCriteria(thread_index, number_of_particles)) break;
+      }
+    }
+    else if (is_persistent_pool_) {
+      // Size of pool is the size of the first batch, the other particles of device are generated in slots of dead particles
+      GGsize pool_size = source_manager.GetNumberOfParticlesInBatch(i, thread_index, 0);
+      GGsize remaining_particles = 0;
+      for (GGsize j = 1; j < number_of_batchs; ++j) remaining_particles += source_manager.GetNumberOfParticlesInBatch(i, thread_index, j);
 
-      // Loop until ALL particles are dead
-      GGint loop_counter = 0, max_loop = 100; // Prevent infinite loop
+      // Generating particles
+      source_manager.GetPrimaries(i, thread_index, pool_size, first_particle_index);
+      first_particle_index += pool_size;
+
+      // Refill budget is stored on 32 bits on device, it is loaded by chunk
+      GGsize refill_budget = std::min(remaining_particles, static_cast<GGsize>(std::numeric_limits<GGint>::max()));
+      remaining_particles -= refill_budget;
+      source_manager.SetRefillBudget(i, thread_index, refill_budget, first_particle_index);
+      first_particle_index += refill_budget;
+
+      // Loop until ALL particles are dead and budget is exhausted
+      GGint loop_counter = 0, max_loop = 100 * static_cast<GGint>(number_of_batchs); // Prevent infinite loop
+      bool is_alive = true;
       do {
-         // Step 2: Find closest navigator (phantom, detector) before projection and track operation
         navigator_manager.FindSolid(thread_index);
-
-        // Optional step: World tracking
         navigator_manager.WorldTracking(thread_index);
-
-        // Step 3: Project particles to solid
         navigator_manager.ProjectToSolid(thread_index);
-
-        // Step 4: Track through step, particles are tracked in selected solid
         navigator_manager.TrackThroughSolid(thread_index);
 
+        // Dead particles are replaced by new primaries, before the alive check rebuilding list of active particles
+        source_manager.RefillPrimaries(i, thread_index, pool_size);
+
+        if (is_asynchronous_mode_) {
+          source_manager.EnqueueIsAlive(thread_index);
+          is_alive = source_manager.IsAliveDeferred(thread_index);
+        }
+        else {
+          is_alive = source_manager.IsAlive(thread_index);
+        }
+
+        // All particles are dead, so budget on device is exhausted. Loading the next chunk
+        if (!is_alive && remaining_particles > 0) {
+          if (is_asynchronous_mode_) source_manager.ResetAliveChecks(thread_index);
+          refill_budget = std::min(remaining_particles, static_cast<GGsize>(std::numeric_limits<GGint>::max()));
+          remaining_particles -= refill_budget;
+          source_manager.SetRefillBudget(i, thread_index, refill_budget, first_particle_index);
+          first_particle_index += refill_budget;
+          is_alive = true;
+        }
+
         loop_counter++;
-      } while (source_manager.IsAlive(thread_index) || loop_counter == max_loop); // Step 5: Checking if all particles are dead, otherwize go back to step 2
-    
-      // Incrementing progress bar
+      } while (is_alive && loop_counter < max_loop);
+
+      if (is_asynchronous_mode_) source_manager.ResetAliveChecks(thread_index);
+
+      // Loop stopped by maximum number of loops, primaries not generated yet are lost
+      if (is_alive) {
+        GGsize number_of_dropped_particles = remaining_particles + source_manager.GetRefillBudget(i, thread_index);
+        GGwarn("GGEMS", "RunOnDevice", 0) << "Maximum number of loops (" << max_loop << ") reached in particle pool of device " << thread_index << ", " << number_of_dropped_particles << " primaries are not simulated and particles still alive in pool are dropped!!!" << GGendl;
+      }
+
+      // Incrementing progress bar, all batchs are done
       mutex.lock();
-      ++progress_bar;
+      for (GGsize j = 0; j < number_of_batchs; ++j) ++(*progress_bar_);
       mutex.unlock();
     }
+    else {
+      // Loop over batch
+      for (GGsize j = 0; j < number_of_batchs; ++j) {
+        GGsize number_of_particles = source_manager.GetNumberOfParticlesInBatch(i, thread_index, j);
+
+        // Generating particles
+        source_manager.GetPrimaries(i, thread_index, number_of_particles, first_particle_index);
+        first_particle_index += number_of_particles;
+
+        // Loop until ALL particles are dead
+        TrackParticles(thread_index);
+
+        // Incrementing progress bar
+        mutex.lock();
+        ++(*progress_bar_);
+        mutex.unlock();
+
+        // Other devices stop after their current batch
+        if (is_adaptive_stopping_ && CheckStoppingCriteria(thread_index, number_of_particles)) break;
+      }
+    }
   }
 
-  // Computing dose
-  navigator_manager.ComputeDose(thread_index);
+  // Computing dose, after all devices when dose is scaled by the number of simulated particles
+  if (!is_adaptive_stopping_) navigator_manager.ComputeDose(thread_index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMS::Run()
+void GGEMS::RunView(void)
 {
-  GGcout("GGEMS", "Run", 0) << "GGEMS simulation started" << GGendl;
-
-  ChronoTime start_time = GGEMSChrono::Now();
-
   // Creating a thread for each OpenCL device
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   GGsize number_of_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
   std::thread* thread_device = new std::thread[number_of_activated_devices];
 
+  // Throughputs of devices are measured during the simulation for dynamic balancing
+  device_throughputs_.assign(number_of_activated_devices, 0.0);
+
+  // Stopping criteria
+  device_uncertainty_ratios_.assign(number_of_activated_devices, 0.0);
+  is_stop_requested_ = false;
+  number_of_simulated_particles_ = 0;
+  run_start_time_ = GGEMSChrono::Now();
+  device_uncertainty_check_times_.assign(number_of_activated_devices, run_start_time_);
+
+  // Particles of sources are claimed again from the first one
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  source_manager.ResetClaimedParticles();
+
+  // Printing progress bar
+  progress_bar_ = new GGEMSProgressBar(source_manager.GetTotalNumberOfBatchs());
+
   for (GGsize i = 0; i < number_of_activated_devices; ++i) {
     thread_device[i] = std::thread(&GGEMS::RunOnDevice, this, i);
   }
@@ -324,6 +678,35 @@ void GGEMS::Run()
   // Deleting threads
   delete[] thread_device;
 
+  delete progress_bar_;
+  progress_bar_ = nullptr;
+
+  // Dose of a simulation stopped early is scaled to the number of planned particles
+  if (is_adaptive_stopping_) {
+    GGsize number_of_planned_particles = 0;
+    for (GGsize i = 0; i < source_manager.GetNumberOfSources(); ++i) number_of_planned_particles += source_manager.GetNumberOfParticles(i);
+
+    GGfloat particle_scale_factor = static_cast<GGfloat>(static_cast<GGdouble>(number_of_planned_particles) / static_cast<GGdouble>(std::max(number_of_simulated_particles_, static_cast<GGsize>(1))));
+    GGcout("GGEMS", "RunView", 0) << "Simulated particles: " << number_of_simulated_particles_ << "/" << number_of_planned_particles << ", dose scale factor: " << particle_scale_factor << GGendl;
+
+    GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+    navigator_manager.SetParticleScaleFactor(particle_scale_factor);
+    for (GGsize i = 0; i < number_of_activated_devices; ++i) navigator_manager.ComputeDose(i);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::Run()
+{
+  GGcout("GGEMS", "Run", 0) << "GGEMS simulation started" << GGendl;
+
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  RunView();
+
   // End of simulation, storing output
   GGcout("GGEMS", "Run", 1) << "Saving results..." << GGendl;
   GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
@@ -346,6 +729,121 @@ void GGEMS::Run()
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMS::RunScan(std::vector<GGfloat44> const& view_transformations)
+{
+  GGsize number_of_views = view_transformations.size();
+
+  GGcout("GGEMS", "RunScan", 0) << "GGEMS scan of " << number_of_views << " views started" << GGendl;
+
+  if (number_of_views == 0) {
+    GGEMSMisc::ThrowException("GGEMS", "RunScan", "No view in scan!!!");
+  }
+
+  // Tallies are accumulated over views, a view stopped early could not be scaled on its own
+  if (is_adaptive_stopping_) {
+    GGEMSMisc::ThrowException("GGEMS", "RunScan", "Adaptive stopping (maximum simulation time or target of uncertainty) is not available in scan!!!");
+  }
+
+  ChronoTime start_time = GGEMSChrono::Now();
+
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+
+  // Systems are moved with sources and store a projection by view, other navigators (phantoms) stay in place
+  std::vector<GGEMSSystem*> systems;
+  GGEMSNavigator** navigators = navigator_manager.GetNavigators();
+  for (GGsize i = 0; i < navigator_manager.GetNumberOfNavigators(); ++i) {
+    GGEMSSystem* system = dynamic_cast<GGEMSSystem*>(navigators[i]);
+    if (system) systems.push_back(system);
+
+    // Detection elements are copied once at initialization, they do not follow the views
+    if (navigators[i]->IsForcedDetection()) {
+      GGEMSMisc::ThrowException("GGEMS", "RunScan", "Forced detection is not available in scan!!!");
+    }
+  }
+
+  if (systems.empty()) {
+    GGEMSMisc::ThrowException("GGEMS", "RunScan", "No system storing projections in scan!!!");
+  }
+
+  // Only matrices of transformation are updated between views, kernels and buffers are kept
+  for (GGsize v = 0; v < number_of_views; ++v) {
+    GGcout("GGEMS", "RunScan", 1) << "View " << v+1 << "/" << number_of_views << "..." << GGendl;
+
+    view_index_ = v;
+    source_manager.SetViewTransformation(view_transformations[v]);
+    for (auto&& system : systems) system->SetViewTransformation(view_transformations[v]);
+
+    RunView();
+
+    for (auto&& system : systems) system->StoreView(v, number_of_views);
+  }
+
+  // Geometry of initialization is restored
+  GGfloat44 identity =
+    {
+      {1.0f, 0.0f, 0.0f, 0.0f},
+      {0.0f, 1.0f, 0.0f, 0.0f},
+      {0.0f, 0.0f, 1.0f, 0.0f},
+      {0.0f, 0.0f, 0.0f, 1.0f}
+    };
+  view_index_ = 0;
+  source_manager.SetViewTransformation(identity);
+  for (auto&& system : systems) system->SetViewTransformation(identity);
+
+  // End of scan, storing stacked projections and results of other navigators accumulated over all views
+  GGcout("GGEMS", "RunScan", 1) << "Saving results..." << GGendl;
+  for (GGsize i = 0; i < navigator_manager.GetNumberOfNavigators(); ++i) {
+    GGEMSSystem* system = dynamic_cast<GGEMSSystem*>(navigators[i]);
+    if (system) system->SaveScanResults();
+    else navigators[i]->SaveResults();
+  }
+
+  // Printing elapsed time in kernels
+  if (is_profiling_verbose_) {
+    GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+    profiler_manager.PrintSummaryProfile();
+  }
+
+  ChronoTime end_time = GGEMSChrono::Now();
+
+  GGcout("GGEMS", "RunScan", 0) << "GGEMS scan succeeded" << GGendl;
+
+  GGEMSChrono::DisplayTime(end_time - start_time, "GGEMS scan");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMS::RunGantryScan(std::vector<GGfloat> const& gantry_angles, std::string const& unit)
+{
+  std::vector<GGfloat44> view_transformations;
+  view_transformations.reserve(gantry_angles.size());
+
+  // Rotation of gantry around Z axis of global frame
+  for (auto&& gantry_angle : gantry_angles) {
+    GGfloat angle = AngleUnit(gantry_angle, unit);
+    GGfloat cosinus = std::cos(angle);
+    GGfloat sinus = std::sin(angle);
+
+    GGfloat44 rotation_z =
+      {
+        {cosinus, -sinus, 0.0f, 0.0f},
+        {sinus, cosinus, 0.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 1.0f}
+      };
+    view_transformations.push_back(rotation_z);
+  }
+
+  RunScan(view_transformations);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMS::PrintBanner(void) const
 {
   std::cout << std::endl;
@@ -485,7 +983,89 @@ void set_tracking_ggems(GGEMS* ggems, bool const is_tracking_verbose, GGint cons
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void set_asynchronous_mode_ggems(GGEMS* ggems, bool const is_asynchronous_mode)
+{
+  ggems->SetAsynchronousMode(is_asynchronous_mode);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_stream_compaction_ggems(GGEMS* ggems, bool const is_stream_compaction)
+{
+  ggems->SetStreamCompaction(is_stream_compaction);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_persistent_pool_ggems(GGEMS* ggems, bool const is_persistent_pool)
+{
+  ggems->SetPersistentPool(is_persistent_pool);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_dynamic_balancing_ggems(GGEMS* ggems, bool const is_dynamic_balancing)
+{
+  ggems->SetDynamicBalancing(is_dynamic_balancing);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_maximum_simulation_time_ggems(GGEMS* ggems, GGfloat const time, char const* unit)
+{
+  ggems->SetMaximumSimulationTime(time, unit);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_uncertainty_check_period_ggems(GGEMS* ggems, GGfloat const time, char const* unit)
+{
+  ggems->SetUncertaintyCheckPeriod(time, unit);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void run_ggems(GGEMS* ggems)
 {
   ggems->Run();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void run_scan_ggems(GGEMS* ggems, GGfloat const* view_transformations, GGsize const number_of_views)
+{
+  std::vector<GGfloat44> views(number_of_views);
+  for (GGsize i = 0; i < number_of_views; ++i) {
+    GGfloat const* m = view_transformations + 16*i;
+    for (GGint j = 0; j < 4; ++j) {
+      views[i].m0_[j] = m[j];
+      views[i].m1_[j] = m[4+j];
+      views[i].m2_[j] = m[8+j];
+      views[i].m3_[j] = m[12+j];
+    }
+  }
+  ggems->RunScan(views);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void run_gantry_scan_ggems(GGEMS* ggems, GGfloat const* gantry_angles, GGsize const number_of_views, char const* unit)
+{
+  ggems->RunGantryScan(std::vector<GGfloat>(gantry_angles, gantry_angles + number_of_views), unit);
+}
@@ -19,7 +19,7 @@
 /*!
   \file GGEMSOpenCLManager.cc
 
-  \brief Singleton class storing all informations about OpenCL and managing GPU/CPU devices, contexts, kernels, command queues and events. In GGEMS the strategy is 1 context = 1 device.
+  \brief Singleton class storing all informations about OpenCL and managing GPU/CPU devices, contexts, kernels, command queues and events. In GGEMS the default strategy is 1 context = 1 device, a context can be shared by all activated devices of a platform.
 
   \author Julien BERT <julien.bert@univ-brest.fr>
   \author Didier BENOIT <didier.benoit@inserm.fr>
@@ -28,6 +28,10 @@
   \date Tuesday March 23, 2021
 */
 
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+
 #include "GGEMS/tools/GGEMSRAMManager.hh"
 #include "GGEMS/geometries/GGEMSVolumeCreatorManager.hh"
 #include "GGEMS/tools/GGEMSProfilerManager.hh"
@@ -36,6 +40,8 @@
 #include "GGEMS/physics/GGEMSRangeCutsManager.hh"
 #include "GGEMS/global/GGEMS.hh"
 #include "GGEMS/physics/GGEMSProcessesManager.hh"
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/randoms/GGEMSRandom.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -100,7 +106,10 @@ GGEMSOpenCLManager::GGEMSOpenCLManager(void)
     platforms_[i].getDevices(CL_DEVICE_TYPE_ALL, &all_devices);
 
     // Storing all devices from platform
-    for (auto& d : all_devices) devices_.emplace_back(new cl::Device(d));
+    for (auto& d : all_devices) {
+      devices_.emplace_back(new cl::Device(d));
+      device_platform_indices_.push_back(i);
+    }
   }
 
   // Getting infos about device
@@ -304,6 +313,9 @@ GGEMSOpenCLManager::GGEMSOpenCLManager(void)
   // Custom work group size, 64 seems a good trade-off
   work_group_size_ = 64;
 
+  // Particle batch size is computed for each device at activation
+  particle_batch_size_ = 0;
+
   // Define the compilation options by default for OpenCL
   build_options_ = "-cl-std=CL1.2 -w -Werror -cl-fast-relaxed-math";
 
@@ -312,6 +324,16 @@ GGEMSOpenCLManager::GGEMSOpenCLManager(void)
   build_options_ += " -DDOSIMETRY_DOUBLE_PRECISION";
   #endif
 
+  // Energy tallies as 64-bit fixed-point integers
+  #ifdef DOSIMETRY_FIXED_POINT
+  build_options_ += " -DDOSIMETRY_FIXED_POINT";
+  #endif
+
+  // Counter-based random engine
+  #ifdef PHILOX_RANDOM
+  build_options_ += " -DPHILOX_RANDOM";
+  #endif
+
   // Add auxiliary function path to OpenCL options
   #ifdef GGEMS_PATH
   build_options_ += " -I";
@@ -330,6 +352,29 @@ GGEMSOpenCLManager::GGEMSOpenCLManager(void)
   kernels_.clear();
   kernel_compilation_options_.clear();
 
+  // Kernel binary cache on disk, the directory can be changed by the user or by GGEMS_KERNEL_CACHE_PATH
+  #ifdef OPENCL_CACHE_KERNEL_COMPILATION
+  is_kernel_cache_ = true;
+  #else
+  is_kernel_cache_ = false;
+  #endif
+
+  #ifdef OPENCL_KERNEL_CACHE_PATH
+  kernel_cache_directory_ = OPENCL_KERNEL_CACHE_PATH;
+  #else
+  kernel_cache_directory_ = "kernel_cache";
+  #endif
+
+  char const* kernel_cache_path = std::getenv("GGEMS_KERNEL_CACHE_PATH");
+  if (kernel_cache_path) kernel_cache_directory_ = kernel_cache_path;
+
+  kernel_cache_hits_ = 0;
+  kernel_cache_misses_ = 0;
+  kernel_build_time_ = GGEMSChrono::Zero();
+
+  // By default, 1 context = 1 device
+  is_shared_context_ = false;
+
   GGcout("GGEMSOpenCLManager", "GGEMSOpenCLManager", 3) << "GGEMSOpenCLManager created!!!" << GGendl;
 }
 
@@ -374,6 +419,8 @@ void GGEMSOpenCLManager::Clean(void)
   for (auto d : devices_) delete d;
   devices_.clear();
   device_indices_.clear();
+  particle_batch_sizes_.clear();
+  device_platform_indices_.clear();
   device_type_.clear();
   device_name_.clear();
   device_vendor_.clear();
@@ -439,9 +486,12 @@ void GGEMSOpenCLManager::Clean(void)
   device_partition_max_sub_devices_.clear();
   device_profiling_timer_resolution_.clear();
 
-  // Freeing contexts, queues and events
-  for (auto c : contexts_) delete c;
+  // Freeing contexts, queues and events. A shared context is deleted only by its owner
+  for (GGsize i = 0; i < contexts_.size(); ++i) {
+    if (context_owners_[i] == i) delete contexts_[i];
+  }
   contexts_.clear();
+  context_owners_.clear();
   for (auto q : queues_) delete q;
   queues_.clear();
   for (auto e : events_) delete e;
@@ -652,6 +702,22 @@ void GGEMSOpenCLManager::PrintBuildOptions(void) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::PrintKernelCacheInfos(void) const
+{
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << "OpenCL kernel binary cache:" << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << "---------------------------" << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << "    + Activated: " << (is_kernel_cache_ ? "ON" : "OFF") << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << "    + Directory: " << kernel_cache_directory_ << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << "    + Programs loaded from cache: " << kernel_cache_hits_ << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << "    + Programs built from source: " << kernel_cache_misses_ << GGendl;
+  GGcout("GGEMSOpenCLManager", "PrintKernelCacheInfos", 0) << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSOpenCLManager::PrintActivatedDevices(void) const
 {
   // Checking if activated context
@@ -670,6 +736,7 @@ void GGEMSOpenCLManager::PrintActivatedDevices(void) const
       GGcout("GGEMSOpenCLManager", "PrintActivatedDevices", 0) << "    -> Type: CL_DEVICE_TYPE_CPU " << GGendl;
     else if (GetDeviceType(device_indices_[i]) == CL_DEVICE_TYPE_GPU)
       GGcout("GGEMSOpenCLManager", "PrintActivatedDevices", 0) << "    -> Type: CL_DEVICE_TYPE_GPU " << GGendl;
+    GGcout("GGEMSOpenCLManager", "PrintActivatedDevices", 0) << "    -> Particle batch size: " << particle_batch_sizes_[i] << GGendl;
   }
 
   GGcout("GGEMSOpenCLManager", "PrintActivatedDevice", 0) << GGendl;
@@ -760,6 +827,9 @@ void GGEMSOpenCLManager::DeviceToActivate(GGsize const& device_id)
   // Storing index of activated device
   device_indices_.push_back(device_id);
 
+  // Particle buffers are sized for the device, unless the user gave a batch size
+  particle_batch_sizes_.push_back(particle_batch_size_ ? particle_batch_size_ : ComputeParticleBatchSize(device_id));
+
   // Checking double precision for dosimetry
   #ifdef DOSIMETRY_DOUBLE_PRECISION
   if (!IsDoublePrecision(device_id)) {
@@ -772,9 +842,48 @@ void GGEMSOpenCLManager::DeviceToActivate(GGsize const& device_id)
   // Printing name of activated device
   GGcout("GGEMSOpenCLManager", "DeviceToActivate", 2) << "Activated device: " << GetDeviceName(device_id) << GGendl;
 
+  // In shared context mode, the first activated device of the platform owns the context
+  GGsize thread_index = device_indices_.size() - 1;
+  GGsize context_owner = thread_index;
+  if (is_shared_context_) {
+    for (GGsize i = 0; i < thread_index; ++i) {
+      if (device_platform_indices_[device_indices_[i]] == device_platform_indices_[device_id]) {
+        context_owner = context_owners_[i];
+        break;
+      }
+    }
+  }
+  context_owners_.push_back(context_owner);
+
   // Creating context, command queue and event
-  contexts_.push_back(new cl::Context(*devices_.at(device_id)));
-  queues_.push_back(new cl::CommandQueue(*contexts_.back(), *devices_.at(device_id), CL_QUEUE_PROFILING_ENABLE));
+  if (context_owner == thread_index) {
+    contexts_.push_back(new cl::Context(*devices_.at(device_id)));
+    queues_.push_back(new cl::CommandQueue(*contexts_.back(), *devices_.at(device_id), CL_QUEUE_PROFILING_ENABLE));
+  }
+  else {
+    // A context can not be extended, so it is rebuilt with all activated devices of platform
+    if (!kernels_.empty()) {
+      GGEMSMisc::ThrowException("GGEMSOpenCLManager", "DeviceToActivate", "Devices sharing a context must be activated before any OpenCL object is created!!!");
+    }
+
+    std::vector<cl::Device> platform_devices;
+    for (GGsize i = 0; i <= thread_index; ++i) {
+      if (context_owners_[i] == context_owner) platform_devices.push_back(*devices_.at(device_indices_[i]));
+    }
+
+    delete contexts_[context_owner];
+    cl::Context* context = new cl::Context(platform_devices);
+    contexts_.push_back(context);
+    queues_.push_back(nullptr);
+
+    // Command queues of platform are recreated in new context
+    for (GGsize i = 0; i <= thread_index; ++i) {
+      if (context_owners_[i] != context_owner) continue;
+      contexts_[i] = context;
+      delete queues_[i];
+      queues_[i] = new cl::CommandQueue(*context, *devices_.at(device_indices_[i]), CL_QUEUE_PROFILING_ENABLE);
+    }
+  }
   events_.push_back(new cl::Event());
 }
 
@@ -895,6 +1004,9 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
     }
   }
   else {
+    // Get the start time
+    ChronoTime start_time = GGEMSChrono::Now();
+
     // Check if the source kernel file exists
     std::ifstream source_file_stream(kernel_filename.c_str(), std::ios::in);
     GGEMSFileStream::CheckInputStream(source_file_stream, kernel_filename);
@@ -905,19 +1017,49 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
     // Creating an OpenCL program
     cl::Program::Sources program_source(1, std::make_pair(source_code.c_str(), source_code.length() + 1));
 
+    // Reading kernel and included GGEMS headers, any modification in this tree invalidates the cached binary
+    std::string source_tree("");
+    if (is_kernel_cache_) {
+      std::unordered_set<std::string> visited_files;
+      ReadKernelSourceTree(kernel_filename, source_tree, visited_files);
+    }
+
     // Loop over activated device
     for (GGsize i = 0; i < device_indices_.size(); ++i) {
-      // Make program from source code in context
-      cl::Program program = cl::Program(*contexts_[i], program_source);
+      // Program is built only for the device of thread, context can be shared by several devices
+      std::vector<cl::Device> device(1, *devices_[device_indices_[i]]);
+
+      // Particle buffers in kernel have the batch size of device
+      std::string device_compilation_option = std::string(kernel_compilation_option) + " -DMAXIMUM_PARTICLES=" + std::to_string(particle_batch_sizes_[i]);
+
+      // Make program from binary in cache if possible, otherwize from source code in context
+      cl::Program program;
+      std::string cache_filename("");
+      bool is_cached_binary = false;
+      if (is_kernel_cache_) {
+        cache_filename = GetKernelCacheFilename(kernel_name, source_tree, device_compilation_option, i);
+        is_cached_binary = LoadKernelBinary(cache_filename, program, i);
+      }
+
+      if (is_cached_binary) {
+        GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Load kernel '" << kernel_name << "' from cache: " << cache_filename << " on device: " << GetDeviceName(device_indices_[i]) << " with options: " << device_compilation_option << GGendl;
+      }
+      else {
+        program = cl::Program(*contexts_[i], program_source);
+        GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Compile a new kernel '" << kernel_name << "' from file: " << kernel_filename << " on device: " << GetDeviceName(device_indices_[i]) << " with options: " << device_compilation_option << GGendl;
+      }
 
-      // Get device associated to context, in our case 1 context = 1 device
-      std::vector<cl::Device> device;
-      CheckOpenCLError(contexts_[i]->getInfo(CL_CONTEXT_DEVICES, &device), "GGEMSOpenCLManager", "CompileKernel");
+      // Compile source code (or link binary) on device
+      GGint build_status = program.build(device, device_compilation_option.c_str());
 
-      GGcout("GGEMSOpenCLManager", "CompileKernel", 2) << "Compile a new kernel '" << kernel_name << "' from file: " << kernel_filename << " on device: " << GetDeviceName(device_indices_[i]) << " with options: " << kernel_compilation_option << GGendl;
+      // A binary rejected by the driver is rebuilt from source code and replaced in cache
+      if (build_status != CL_SUCCESS && is_cached_binary) {
+        GGwarn("GGEMSOpenCLManager", "CompileKernel", 0) << "Cached binary " << cache_filename << " rejected by device, kernel is compiled from source!!!" << GGendl;
+        is_cached_binary = false;
+        program = cl::Program(*contexts_[i], program_source);
+        build_status = program.build(device, device_compilation_option.c_str());
+      }
 
-      // Compile source code on device
-      GGint build_status = program.build(device, kernel_compilation_option);
       if (build_status != CL_SUCCESS) {
         std::ostringstream oss(std::ostringstream::out);
         std::string log;
@@ -927,6 +1069,15 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
         GGEMSMisc::ThrowException("GGEMSOpenCLManager", "CompileKernel", oss.str());
       }
 
+      // Storing the binary in cache for the next GGEMS execution
+      if (is_cached_binary) {
+        ++kernel_cache_hits_;
+      }
+      else {
+        ++kernel_cache_misses_;
+        if (is_kernel_cache_) SaveKernelBinary(cache_filename, program, i);
+      }
+
       // Storing the kernel in the singleton
       kernels_.push_back(new cl::Kernel(program, kernel_name.c_str(), &build_status));
       kernel_list[i] = kernels_.back();
@@ -935,6 +1086,10 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
       // Storing the compilation options
       kernel_compilation_options_.push_back(kernel_compilation_option);
     }
+
+    // Get the end time
+    ChronoTime end_time = GGEMSChrono::Now();
+    kernel_build_time_ += end_time - start_time;
   }
 }
 
@@ -942,6 +1097,196 @@ void GGEMSOpenCLManager::CompileKernel(std::string const& kernel_filename, std::
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::SetSharedContext(bool const& is_shared_context)
+{
+  // Contexts are created at device activation
+  if (!device_indices_.empty()) {
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "SetSharedContext", "Shared context must be set before device activation!!!");
+  }
+
+  is_shared_context_ = is_shared_context;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SetKernelCache(bool const& is_kernel_cache)
+{
+  is_kernel_cache_ = is_kernel_cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SetKernelCacheDirectory(std::string const& directory)
+{
+  if (directory.empty()) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Kernel cache directory can not be empty!!!";
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "SetKernelCacheDirectory", oss.str());
+  }
+
+  kernel_cache_directory_ = directory;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::CleanKernelCache(void)
+{
+  GGcout("GGEMSOpenCLManager", "CleanKernelCache", 1) << "Cleaning kernel cache in " << kernel_cache_directory_ << "..." << GGendl;
+
+  std::error_code error_code;
+  if (!std::filesystem::is_directory(kernel_cache_directory_, error_code)) return;
+
+  // Only GGEMS binaries are removed
+  for (auto const& entry : std::filesystem::directory_iterator(kernel_cache_directory_, error_code)) {
+    if (entry.path().extension() == ".bin") std::filesystem::remove(entry.path(), error_code);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::ReadKernelSourceTree(std::string const& filename, std::string& source_tree, std::unordered_set<std::string>& visited_files) const
+{
+  // Each file is read once
+  if (visited_files.find(filename) != visited_files.end()) return;
+  visited_files.insert(filename);
+
+  // Headers not found (host headers for instance) are ignored, OpenCL compiler will complain if necessary
+  std::ifstream file_stream(filename, std::ios::in);
+  if (!file_stream.is_open()) return;
+
+  std::string line("");
+  while (std::getline(file_stream, line)) {
+    source_tree += line;
+    source_tree += '\n';
+
+    // Following only GGEMS headers, '#include "GGEMS/..."'
+    GGsize first_char = line.find_first_not_of(" \t");
+    if (first_char == std::string::npos || line.compare(first_char, 8, "#include") != 0) continue;
+
+    GGsize first_quote = line.find('"', first_char);
+    GGsize last_quote = line.rfind('"');
+    if (first_quote == std::string::npos || last_quote == first_quote) continue;
+
+    std::string header_filename = std::string(GGEMS_PATH) + "/include/" + line.substr(first_quote + 1, last_quote - first_quote - 1);
+    ReadKernelSourceTree(header_filename, source_tree, visited_files);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string GGEMSOpenCLManager::GetKernelCacheFilename(std::string const& kernel_name, std::string const& source_tree, std::string const& compilation_options, GGsize const& thread_index) const
+{
+  // Key of the cache: source tree, options, device and driver
+  GGsize device_index = GetIndexOfActivatedDevice(thread_index);
+  std::string cache_key = source_tree;
+  cache_key += '\0' + compilation_options;
+  cache_key += '\0' + device_name_[device_index];
+  cache_key += '\0' + device_vendor_[device_index];
+  cache_key += '\0' + device_version_[device_index];
+  cache_key += '\0' + device_driver_version_[device_index];
+
+  // 64 bits FNV-1a hash
+  GGulong hash = 0xcbf29ce484222325ull;
+  for (auto c : cache_key) {
+    hash ^= static_cast<GGulong>(static_cast<GGuchar>(c));
+    hash *= 0x100000001b3ull;
+  }
+
+  std::ostringstream oss(std::ostringstream::out);
+  oss << kernel_cache_directory_ << "/" << kernel_name << "_" << std::hex << std::setfill('0') << std::setw(16) << hash << ".bin";
+  return oss.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSOpenCLManager::LoadKernelBinary(std::string const& cache_filename, cl::Program& program, GGsize const& thread_index) const
+{
+  GGcout("GGEMSOpenCLManager", "LoadKernelBinary", 3) << "Loading OpenCL program binary from " << cache_filename << "..." << GGendl;
+
+  // Missing file means kernel not in cache
+  std::ifstream binary_stream(cache_filename, std::ios::in | std::ios::binary);
+  if (!binary_stream.is_open()) return false;
+
+  std::vector<char> binary((std::istreambuf_iterator<char>(binary_stream)), std::istreambuf_iterator<char>());
+  if (binary.empty()) return false;
+
+  // Creating program from binary for the device of thread only
+  std::vector<cl::Device> device(1, *devices_[device_indices_[thread_index]]);
+  cl::Program::Binaries program_binary(1, std::make_pair(static_cast<void const*>(binary.data()), binary.size()));
+  std::vector<cl_int> binary_status(1, CL_SUCCESS);
+  GGint error = 0;
+  program = cl::Program(*contexts_[thread_index], device, program_binary, &binary_status, &error);
+
+  return error == CL_SUCCESS && binary_status[0] == CL_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSOpenCLManager::SaveKernelBinary(std::string const& cache_filename, cl::Program const& program, GGsize const& thread_index) const
+{
+  GGcout("GGEMSOpenCLManager", "SaveKernelBinary", 3) << "Saving OpenCL program binary in " << cache_filename << "..." << GGendl;
+
+  // Program is associated to all devices of context, but it is built only for the device of thread
+  GGuint number_of_devices = 0;
+  CheckOpenCLError(clGetProgramInfo(program(), CL_PROGRAM_NUM_DEVICES, sizeof(GGuint), &number_of_devices, nullptr), "GGEMSOpenCLManager", "SaveKernelBinary");
+  if (number_of_devices == 0) return;
+
+  std::vector<GGsize> binary_sizes(number_of_devices, 0);
+  CheckOpenCLError(clGetProgramInfo(program(), CL_PROGRAM_BINARY_SIZES, number_of_devices*sizeof(GGsize), binary_sizes.data(), nullptr), "GGEMSOpenCLManager", "SaveKernelBinary");
+
+  // Only the built device has a binary
+  GGsize device_position = 0;
+  while (device_position < number_of_devices && binary_sizes[device_position] == 0) ++device_position;
+  if (device_position == number_of_devices) return;
+  GGsize binary_size = binary_sizes[device_position];
+
+  std::vector<unsigned char> binary(binary_size);
+  std::vector<unsigned char*> binary_ptrs(number_of_devices, nullptr);
+  binary_ptrs[device_position] = binary.data();
+  CheckOpenCLError(clGetProgramInfo(program(), CL_PROGRAM_BINARIES, number_of_devices*sizeof(unsigned char*), binary_ptrs.data(), nullptr), "GGEMSOpenCLManager", "SaveKernelBinary");
+
+  GGcout("GGEMSOpenCLManager", "SaveKernelBinary", 3) << "Binary of " << binary_size << " bytes for device " << GetDeviceName(device_indices_[thread_index]) << GGendl;
+
+  // A cache not writable is not an error, kernel is compiled at each execution
+  std::error_code error_code;
+  std::filesystem::create_directories(kernel_cache_directory_, error_code);
+  if (error_code) {
+    GGwarn("GGEMSOpenCLManager", "SaveKernelBinary", 0) << "Kernel cache directory " << kernel_cache_directory_ << " can not be created: " << error_code.message() << GGendl;
+    return;
+  }
+
+  // Writing a temporary file then renaming it, several GGEMS processes can share the same cache
+  std::ostringstream oss(std::ostringstream::out);
+  oss << cache_filename << "." << std::hex << std::random_device()() << ".tmp";
+  std::string tmp_filename = oss.str();
+
+  std::ofstream binary_stream(tmp_filename, std::ios::out | std::ios::binary);
+  if (!binary_stream.is_open()) return;
+  binary_stream.write(reinterpret_cast<char*>(binary.data()), static_cast<std::streamsize>(binary_size));
+  binary_stream.close();
+
+  std::filesystem::rename(tmp_filename, cache_filename, error_code);
+  if (error_code) std::filesystem::remove(tmp_filename, error_code);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 cl::Buffer* GGEMSOpenCLManager::Allocate(void* host_ptr, GGsize const& size, GGsize const& thread_index, cl_mem_flags flags, std::string const& class_name)
 {
   GGcout("GGEMSOpenCLManager","Allocate", 3) << "Allocating memory on OpenCL device memory..." << GGendl;
@@ -1025,6 +1370,18 @@ bool GGEMSOpenCLManager::IsDoublePrecisionAtomicAddition(GGsize const& device_in
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+GGsize GGEMSOpenCLManager::GetKernelLocalMemorySize(cl::Kernel* kernel, GGsize const& thread_index) const
+{
+  cl_ulong kernel_local_mem_size = 0;
+  CheckOpenCLError(kernel->getWorkGroupInfo(*devices_[device_indices_[thread_index]], CL_KERNEL_LOCAL_MEM_SIZE, &kernel_local_mem_size), "GGEMSOpenCLManager", "GetKernelLocalMemorySize");
+
+  return static_cast<GGsize>(kernel_local_mem_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGsize GGEMSOpenCLManager::GetBestWorkItem(GGsize const& number_of_elements) const
 {
   if (number_of_elements%work_group_size_ == 0) {
@@ -1043,6 +1400,50 @@ GGsize GGEMSOpenCLManager::GetBestWorkItem(GGsize const& number_of_elements) con
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSOpenCLManager::SetParticleBatchSize(GGsize const& particle_batch_size)
+{
+  // Kernels and particle buffers are sized with batch size
+  if (!kernels_.empty()) {
+    GGEMSMisc::ThrowException("GGEMSOpenCLManager", "SetParticleBatchSize", "Particle batch size must be set before GGEMS initialization!!!");
+  }
+
+  // Batch size is a multiple of work group size, keeping arrays of particle buffers aligned
+  particle_batch_size_ = particle_batch_size == 0 ? 0 : GetBestWorkItem(particle_batch_size);
+
+  // Updating devices already activated
+  for (GGsize i = 0; i < device_indices_.size(); ++i) {
+    particle_batch_sizes_[i] = particle_batch_size_ ? particle_batch_size_ : ComputeParticleBatchSize(device_indices_[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGsize GGEMSOpenCLManager::ComputeParticleBatchSize(GGsize const& device_index) const
+{
+  // Bytes by particle in primary particle and random buffers
+  GGsize particle_size = GetPrimaryParticlesSize(1) - GetPrimaryParticlesSize(0) + GetRandomSize(1) - GetRandomSize(0);
+
+  // Enough particles in flight to hide memory latency, 32 work groups of maximum size by compute unit
+  GGsize batch_size = static_cast<GGsize>(device_max_compute_units_[device_index]) * device_max_work_group_size_[device_index] * 32;
+
+  // A quarter of global memory for particles, the remaining part is left to geometries, cross section tables and tallies
+  batch_size = std::min(batch_size, static_cast<GGsize>(device_global_mem_size_[device_index]) / 4 / particle_size);
+
+  // Primary particles are stored in one buffer
+  batch_size = std::min(batch_size, (static_cast<GGsize>(device_max_mem_alloc_size_[device_index]) - GetPrimaryParticlesSize(0)) / (GetPrimaryParticlesSize(1) - GetPrimaryParticlesSize(0)));
+
+  // Multiple of work group size
+  batch_size -= batch_size % work_group_size_;
+
+  return std::max(batch_size, work_group_size_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSOpenCLManager::CheckOpenCLError(GGint const& error, std::string const& class_name, std::string const& method_name) const
 {
   if (error != CL_SUCCESS) {
@@ -1483,3 +1884,48 @@ void set_device_balancing_opencl_manager(GGEMSOpenCLManager* opencl_manager, cha
 {
   opencl_manager->DeviceBalancing(device_balancing);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_shared_context_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_shared_context)
+{
+  opencl_manager->SetSharedContext(is_shared_context);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_kernel_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager, bool const is_kernel_cache)
+{
+  opencl_manager->SetKernelCache(is_kernel_cache);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_kernel_cache_directory_opencl_manager(GGEMSOpenCLManager* opencl_manager, char const* directory)
+{
+  opencl_manager->SetKernelCacheDirectory(directory);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void clean_kernel_cache_opencl_manager(GGEMSOpenCLManager* opencl_manager)
+{
+  opencl_manager->CleanKernelCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_particle_batch_size_opencl_manager(GGEMSOpenCLManager* opencl_manager, GGsize const particle_batch_size)
+{
+  opencl_manager->SetParticleBatchSize(particle_batch_size);
+}
@@ -0,0 +1,112 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file CompactParticles.cl
+
+  \brief OpenCL kernel building the list of alive particles (stream compaction)
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/physics/GGEMSPrimaryParticles.hh"
+#include "GGEMS/physics/GGEMSParticleConstants.hh"
+
+/*!
+  \fn kernel void compact_particles(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, local GGint* alive_scan)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer on primary particles
+  \param alive_scan - local buffer for prefix sum, one element by work-item
+  \brief build the list of alive particles. A prefix sum in work-group gives the position of each alive particle, and one atomic by work-group reserves a contiguous part of list. The number of active particles has to be set to 0 before
+*/
+kernel void compact_particles(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  local GGint* alive_scan
+)
+{
+  // Get the index of thread, no return before barriers
+  GGsize global_id = get_global_id(0);
+  GGint local_id = get_local_id(0);
+  GGint local_size = get_local_size(0);
+
+  GGint is_alive = (global_id < particle_id_limit && primary_particle->status_[global_id] == ALIVE) ? 1 : 0;
+  alive_scan[local_id] = is_alive;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Inclusive prefix sum in work-group (Hillis-Steele)
+  for (GGint offset = 1; offset < local_size; offset <<= 1) {
+    GGint value = (local_id >= offset) ? alive_scan[local_id - offset] : 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    alive_scan[local_id] += value;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  // Last work-item reserves the part of list for the work-group
+  local GGint group_offset;
+  if (local_id == local_size - 1) group_offset = atomic_add(&primary_particle->number_of_active_particles_, alive_scan[local_id]);
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Order of particles is kept inside work-group
+  if (is_alive) primary_particle->active_index_[group_offset + alive_scan[local_id] - 1] = global_id;
+}
+
+/*!
+  \fn kernel void list_free_particles(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, local GGint* dead_scan)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer on primary particles
+  \param dead_scan - local buffer for prefix sum, one element by work-item
+  \brief build the list of dead particles, their slots receive copies of split particles. Free slots are set out of solids, so a copy is not tracked again by the kernel creating it. The number of free particles has to be set to 0 before
+*/
+kernel void list_free_particles(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  local GGint* dead_scan
+)
+{
+  // Get the index of thread, no return before barriers
+  GGsize global_id = get_global_id(0);
+  GGint local_id = get_local_id(0);
+  GGint local_size = get_local_size(0);
+
+  GGint is_dead = (global_id < particle_id_limit && primary_particle->status_[global_id] == DEAD) ? 1 : 0;
+  dead_scan[local_id] = is_dead;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Inclusive prefix sum in work-group (Hillis-Steele)
+  for (GGint offset = 1; offset < local_size; offset <<= 1) {
+    GGint value = (local_id >= offset) ? dead_scan[local_id - offset] : 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    dead_scan[local_id] += value;
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  // Last work-item reserves the part of list for the work-group
+  local GGint group_offset;
+  if (local_id == local_size - 1) group_offset = atomic_add(&primary_particle->number_of_free_particles_, dead_scan[local_id]);
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  if (is_dead) {
+    primary_particle->free_index_[group_offset + dead_scan[local_id] - 1] = global_id;
+    primary_particle->solid_id_[global_id] = -1;
+  }
+}
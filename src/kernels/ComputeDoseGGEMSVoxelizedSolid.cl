@@ -34,7 +34,7 @@
 #include "GGEMS/geometries/GGEMSVoxelizedSolidData.hh"
 
 /*!
-  \fn kernel void compute_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGDosiType const* edep, global GGint const* hit, global GGDosiType const* edep_squared, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSMaterialTables const* materials, global GGfloat* dose, global GGfloat* uncertainty, GGfloat const scale_factor, GGchar const is_water_reference, GGfloat const minimum_density)
+  \fn kernel void compute_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGEdepType const* edep, global GGint const* hit, global GGEdepType const* edep_squared, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSMaterialTables const* materials, global GGfloat* dose, global GGfloat* uncertainty, GGfloat const scale_factor, GGchar const is_water_reference, GGfloat const minimum_density)
   \param dosel_id_limit - number total of dosels
   \param dose_params - params about dosemap
   \param edep - buffer storing energy deposit
@@ -53,9 +53,9 @@
 kernel void compute_dose_ggems_voxelized_solid(
   GGsize const dosel_id_limit,
   global GGEMSDoseParams const* dose_params,
-  global GGDosiType const* edep,
+  global GGEdepType const* edep,
   global GGint const* hit,
-  global GGDosiType const* edep_squared,
+  global GGEdepType const* edep_squared,
   global GGEMSVoxelizedSolidData const* voxelized_solid_data,
   global GGuchar const* label_data,
   global GGEMSMaterialTables const* materials,
@@ -96,8 +96,11 @@ kernel void compute_dose_ggems_voxelized_solid(
   // Get density
   GGfloat density = is_water_reference ? 1.0f * (g/cm3) : materials->density_of_material_[material_id];
 
+  // Energy in MeV, tallies may be stored as fixed-point integers
+  GGDosiType edep_dosel = EdepToDosiType(edep[global_id]);
+
   // Apply threshold on density and computing dose
-  dose[global_id] = density < minimum_density ? 0.0f : scale_factor * edep[global_id] / density / dosel_vol / Gy;
+  dose[global_id] = density < minimum_density ? 0.0f : scale_factor * edep_dosel / density / dosel_vol / Gy;
 
   // Relative statistical uncertainty (from Ma et al. PMB 47 2002 p1671)
   //              /                                    \ ^1/2
@@ -110,12 +113,157 @@ kernel void compute_dose_ggems_voxelized_solid(
 
   // Computing uncertainty
   if (uncertainty) {
-    if (hit[global_id] > 1 && edep[global_id] != 0.0) {
-      GGDosiType sum_edep_2 = edep[global_id] * edep[global_id];
-      uncertainty[global_id] = sqrt((hit[global_id]*edep_squared[global_id] - sum_edep_2) / ((hit[global_id]-1) * sum_edep_2));
+    if (hit[global_id] > 1 && edep_dosel != 0.0) {
+      GGDosiType sum_edep_2 = edep_dosel * edep_dosel;
+      uncertainty[global_id] = sqrt(fmax(hit[global_id]*EdepToDosiType(edep_squared[global_id]) - sum_edep_2, (GGDosiType)0) / ((hit[global_id]-1) * sum_edep_2));
     }
     else {
       uncertainty[global_id] = 1.0f;
     }
   }
 }
+
+/*!
+  \fn kernel void merge_dose_replicas_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGEdepType* edep, global GGint* hit, global GGEdepType* edep_squared)
+  \param dosel_id_limit - number total of dosels
+  \param dose_params - params about dosemap
+  \param edep - buffer storing energy deposit, one map per replica
+  \param hit - buffer storing hit, one map per replica
+  \param edep_squared - buffer storing edep squared, one map per replica
+  \brief summing replicated maps in the first map, other replicas are reset so merging twice does not count deposits twice
+*/
+kernel void merge_dose_replicas_ggems_voxelized_solid(
+  GGsize const dosel_id_limit,
+  global GGEMSDoseParams const* dose_params,
+  global GGEdepType* edep,
+  global GGint* hit,
+  global GGEdepType* edep_squared
+)
+{
+  // Getting index of thread
+  GGint global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= dosel_id_limit) return;
+
+  // Offset of replicas may exceed 32 bits
+  for (GGint r = 1; r < dose_params->number_of_replicas_; ++r) {
+    GGsize replica_id = (GGsize)global_id + (GGsize)r * (GGsize)dose_params->total_number_of_dosels_;
+
+    edep[global_id] += edep[replica_id];
+    edep[replica_id] = 0;
+
+    if (hit) {
+      hit[global_id] += hit[replica_id];
+      hit[replica_id] = 0;
+    }
+
+    if (edep_squared) {
+      edep_squared[global_id] += edep_squared[replica_id];
+      edep_squared[replica_id] = 0;
+    }
+  }
+}
+
+/*!
+  \fn inline GGchar IsInUncertaintyROI(GGint const global_id, global GGEMSDoseParams const* dose_params)
+  \param global_id - index of dosel
+  \param dose_params - params about dosemap
+  \return TRUE if dosel is in region of uncertainty computation, FALSE otherwise
+  \brief checking if dosel is in region where mean uncertainty is computed
+*/
+inline GGchar IsInUncertaintyROI(GGint const global_id, global GGEMSDoseParams const* dose_params)
+{
+  GGint3 dosel_id;
+  dosel_id.z = global_id/dose_params->slice_number_of_dosels_;
+  dosel_id.x = (global_id - dosel_id.z*dose_params->slice_number_of_dosels_)%dose_params->number_of_dosels_.x;
+  dosel_id.y = (global_id - dosel_id.z*dose_params->slice_number_of_dosels_)/dose_params->number_of_dosels_.x;
+
+  if (dosel_id.x < dose_params->roi_min_.x || dosel_id.x > dose_params->roi_max_.x) return FALSE;
+  if (dosel_id.y < dose_params->roi_min_.y || dosel_id.y > dose_params->roi_max_.y) return FALSE;
+  if (dosel_id.z < dose_params->roi_min_.z || dosel_id.z > dose_params->roi_max_.z) return FALSE;
+
+  return TRUE;
+}
+
+/*!
+  \fn kernel void reduce_maximum_dose_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGfloat const* dose, global GGfloat* group_maximum, local GGfloat* local_maximum)
+  \param dosel_id_limit - number total of dosels
+  \param dose_params - params about dosemap
+  \param dose - buffer storing dose
+  \param group_maximum - maximum dose in region for each work-group
+  \param local_maximum - local buffer for reduction, one element by work-item
+  \brief maximum of dose in region of uncertainty computation, reduced in work-group. Maximums of work-groups are reduced by host
+*/
+kernel void reduce_maximum_dose_ggems_voxelized_solid(
+  GGsize const dosel_id_limit,
+  global GGEMSDoseParams const* dose_params,
+  global GGfloat const* dose,
+  global GGfloat* group_maximum,
+  local GGfloat* local_maximum
+)
+{
+  // Getting index of thread, no return before barriers
+  GGint global_id = get_global_id(0);
+  GGint local_id = get_local_id(0);
+
+  local_maximum[local_id] = (global_id < dosel_id_limit && IsInUncertaintyROI(global_id, dose_params)) ? dose[global_id] : 0.0f;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Tree reduction, work-group size is a power of 2
+  for (GGint offset = get_local_size(0)/2; offset > 0; offset >>= 1) {
+    if (local_id < offset) local_maximum[local_id] = fmax(local_maximum[local_id], local_maximum[local_id + offset]);
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (local_id == 0) group_maximum[get_group_id(0)] = local_maximum[0];
+}
+
+/*!
+  \fn kernel void reduce_uncertainty_ggems_voxelized_solid(GGsize const dosel_id_limit, global GGEMSDoseParams const* dose_params, global GGfloat const* dose, global GGfloat const* uncertainty, GGfloat const dose_threshold, global GGfloat* group_uncertainty, global GGint* group_count, local GGfloat* local_uncertainty, local GGint* local_count)
+  \param dosel_id_limit - number total of dosels
+  \param dose_params - params about dosemap
+  \param dose - buffer storing dose
+  \param uncertainty - buffer storing dose uncertainty
+  \param dose_threshold - dosels with a dose lower or equal to this threshold are ignored
+  \param group_uncertainty - sum of uncertainties in region for each work-group
+  \param group_count - number of dosels summed for each work-group
+  \param local_uncertainty - local buffer for reduction of uncertainties, one element by work-item
+  \param local_count - local buffer for reduction of counts, one element by work-item
+  \brief sum of uncertainties in region of uncertainty computation above dose threshold, reduced in work-group. Sums of work-groups are reduced by host
+*/
+kernel void reduce_uncertainty_ggems_voxelized_solid(
+  GGsize const dosel_id_limit,
+  global GGEMSDoseParams const* dose_params,
+  global GGfloat const* dose,
+  global GGfloat const* uncertainty,
+  GGfloat const dose_threshold,
+  global GGfloat* group_uncertainty,
+  global GGint* group_count,
+  local GGfloat* local_uncertainty,
+  local GGint* local_count
+)
+{
+  // Getting index of thread, no return before barriers
+  GGint global_id = get_global_id(0);
+  GGint local_id = get_local_id(0);
+
+  GGchar is_selected = (global_id < dosel_id_limit && IsInUncertaintyROI(global_id, dose_params) && dose[global_id] > dose_threshold) ? TRUE : FALSE;
+  local_uncertainty[local_id] = is_selected ? uncertainty[global_id] : 0.0f;
+  local_count[local_id] = is_selected ? 1 : 0;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // Tree reduction, work-group size is a power of 2
+  for (GGint offset = get_local_size(0)/2; offset > 0; offset >>= 1) {
+    if (local_id < offset) {
+      local_uncertainty[local_id] += local_uncertainty[local_id + offset];
+      local_count[local_id] += local_count[local_id + offset];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (local_id == 0) {
+    group_uncertainty[get_group_id(0)] = local_uncertainty[0];
+    group_count[get_group_id(0)] = local_count[0];
+  }
+}
@@ -36,8 +36,8 @@
 #include "GGEMS/physics/GGEMSProcessConstants.hh"
 
 /*!
-  \fn kernel void get_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation)
-  \param particle_id_limit - particle id limit
+  \fn inline void GenerateXRayPrimary(GGsize const global_id, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation)
+  \param global_id - index of the particle slot
   \param primary_particle - buffer of primary particles
   \param random - buffer for random number
   \param particle_name - name of particle
@@ -47,10 +47,10 @@
   \param aperture - source aperture
   \param focal_spot_size - focal spot size of xray-source
   \param matrix_transformation - matrix storing information about axis
-  \brief Generate primaries for xray source
+  \brief Generate a new primary particle in a slot of particle buffer
 */
-kernel void get_primaries_ggems_xray_source(
-  GGsize const particle_id_limit,
+inline void GenerateXRayPrimary(
+  GGsize const global_id,
   global GGEMSPrimaryParticles* primary_particle,
   global GGEMSRandom* random,
   GGchar const particle_name,
@@ -62,12 +62,6 @@ kernel void get_primaries_ggems_xray_source(
   global GGfloat44 const* matrix_transformation
 )
 {
-  // Get the index of thread
-  GGsize global_id = get_global_id(0);
-
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
-
   // Get random angles
   GGdouble phi = KissUniform(random, global_id);
   GGdouble theta = KissUniform(random, global_id);
@@ -122,6 +116,8 @@ kernel void get_primaries_ggems_xray_source(
   primary_particle->dy_[global_id] = direction.y;
   primary_particle->dz_[global_id] = direction.z;
 
+  primary_particle->weight_[global_id] = 1.0f;
+
   primary_particle->scatter_[global_id] = FALSE;
 
   primary_particle->status_[global_id] = ALIVE;
@@ -147,3 +143,95 @@ kernel void get_primaries_ggems_xray_source(
   }
   #endif
 }
+
+/*!
+  \fn kernel void get_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - buffer of primary particles
+  \param random - buffer for random number
+  \param particle_name - name of particle
+  \param energy_spectrum - energy spectrum
+  \param cdf - cumulative derivative function
+  \param number_of_energy_bins - number of energy bins
+  \param aperture - source aperture
+  \param focal_spot_size - focal spot size of xray-source
+  \param matrix_transformation - matrix storing information about axis
+  \brief Generate primaries for xray source
+*/
+kernel void get_primaries_ggems_xray_source(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  GGchar const particle_name,
+  global GGfloat const* energy_spectrum,
+  global GGfloat const* cdf,
+  GGint const number_of_energy_bins,
+  GGfloat const aperture,
+  GGfloat3 const focal_spot_size,
+  global GGfloat44 const* matrix_transformation
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= particle_id_limit) return;
+
+  // All new particles are in active list
+  primary_particle->active_index_[global_id] = global_id;
+  if (global_id == 0) primary_particle->number_of_active_particles_ = particle_id_limit;
+
+  // Random stream of particle follows its index in source
+  StartRandomStream(random, global_id, global_id);
+
+  GenerateXRayPrimary(global_id, primary_particle, random, particle_name, energy_spectrum, cdf, number_of_energy_bins, aperture, focal_spot_size, matrix_transformation);
+}
+
+/*!
+  \fn kernel void refill_primaries_ggems_xray_source(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGint* refill_budget, GGchar const particle_name, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const aperture, GGfloat3 const focal_spot_size, global GGfloat44 const* matrix_transformation)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - buffer of primary particles
+  \param random - buffer for random number
+  \param refill_budget - number of primaries still to generate on device
+  \param particle_name - name of particle
+  \param energy_spectrum - energy spectrum
+  \param cdf - cumulative derivative function
+  \param number_of_energy_bins - number of energy bins
+  \param aperture - source aperture
+  \param focal_spot_size - focal spot size of xray-source
+  \param matrix_transformation - matrix storing information about axis
+  \brief Generate primaries for xray source in slots of dead particles, until the budget is exhausted. The list of active particles is not modified, it is rebuilt by the alive check
+*/
+kernel void refill_primaries_ggems_xray_source(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGint* refill_budget,
+  GGchar const particle_name,
+  global GGfloat const* energy_spectrum,
+  global GGfloat const* cdf,
+  GGint const number_of_energy_bins,
+  GGfloat const aperture,
+  GGfloat3 const focal_spot_size,
+  global GGfloat44 const* matrix_transformation
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= particle_id_limit) return;
+
+  // Only dead particles are replaced
+  if (primary_particle->status_[global_id] == ALIVE) return;
+
+  // Claiming a primary in budget, no atomic if budget is already exhausted
+  if (*refill_budget <= 0) return;
+  GGint budget = atomic_dec(refill_budget);
+  if (budget <= 0) return;
+
+  // Budget is claimed from the end, random stream of particle follows its index in refill chunk whatever the slot
+  StartRandomStream(random, global_id, (GGulong)(budget - 1));
+
+  GenerateXRayPrimary(global_id, primary_particle, random, particle_name, energy_spectrum, cdf, number_of_energy_bins, aperture, focal_spot_size, matrix_transformation);
+}
@@ -0,0 +1,67 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file InitializeSeeds.cl
+
+  \brief OpenCL kernel initializing the JKISS states of particle slots
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/randoms/GGEMSRandom.hh"
+#include "GGEMS/randoms/GGEMSPhiloxEngine.hh"
+
+#ifndef PHILOX_RANDOM
+
+/*!
+  \fn kernel void initialize_seeds(GGsize const particle_id_limit, global GGEMSRandom* random, GGuint const seed, GGuint const device_index)
+  \param particle_id_limit - particle id limit
+  \param random - buffer for random number
+  \param seed - seed of simulation
+  \param device_index - index of activated device
+  \brief initializing the JKISS states of each slot from a hash of (seed, device, slot), slots are seeded in parallel
+*/
+kernel void initialize_seeds(
+  GGsize const particle_id_limit,
+  global GGEMSRandom* random,
+  GGuint const seed,
+  GGuint const device_index
+)
+{
+  // Get the index of thread
+  GGsize global_id = get_global_id(0);
+
+  // Return if index > to particle limit
+  if (global_id >= particle_id_limit) return;
+
+  // Philox is a bijection of counter for a key, two slots or two devices never get the same states
+  GGuint4 state = Philox4x32((GGuint4)((GGuint)global_id, (GGuint)(global_id >> 32), device_index, 0), (GGuint2)(seed, 0));
+
+  random->prng_state_1_[global_id] = state.x;
+  random->prng_state_2_[global_id] = state.y == 0 ? 1 : state.y; // Xorshift state is locked on 0
+  random->prng_state_3_[global_id] = state.z;
+  random->prng_state_4_[global_id] = state.w;
+  random->prng_state_5_[global_id] = 0;
+}
+
+#endif
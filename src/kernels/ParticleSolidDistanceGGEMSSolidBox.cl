@@ -31,8 +31,58 @@
 #include "GGEMS/physics/GGEMSPrimaryParticles.hh"
 
 #include "GGEMS/geometries/GGEMSSolidBoxData.hh"
+#include "GGEMS/geometries/GGEMSBVHData.hh"
 #include "GGEMS/geometries/GGEMSRayTracing.hh"
 
+/*!
+  \fn inline GGchar ParticleSolidBoxDistance(GGsize const global_id, global GGEMSPrimaryParticles* primary_particle, GGfloat3 const* position, GGfloat3 const* direction, global GGEMSSolidBoxData const* solid_box_data)
+  \param global_id - index of particle
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param position - pointer on particle position
+  \param direction - pointer on particle direction
+  \param solid_box_data - pointer to solid box data
+  \return true if particle is inside solid box, false otherwise
+  \brief Compute distance between a solid box and a particle, and store it if it is the closest solid
+*/
+inline GGchar ParticleSolidBoxDistance(GGsize const global_id, global GGEMSPrimaryParticles* primary_particle, GGfloat3 const* position, GGfloat3 const* direction, global GGEMSSolidBoxData const* solid_box_data)
+{
+  // Check if particle inside voxelized navigator, if yes distance is 0.0 and not need to compute particle - solid distance
+  if (IsParticleInOBB(position, &solid_box_data->obb_geometry_)) {
+    #ifdef GGEMS_TRACKING
+    if (global_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] --------------------------------------------------------------------------------\n");
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Find a closest solid\n");
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle id: %d\n", global_id);
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle in voxelized solid, id: %d\n", solid_box_data->solid_id_);
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle solid distance: 0.0\n");
+    }
+    #endif
+    primary_particle->particle_solid_distance_[global_id] = 0.0f;
+    primary_particle->solid_id_[global_id] = solid_box_data->solid_id_;
+    return TRUE;
+  }
+
+  // Compute distance between particles and voxelized navigator
+  GGfloat distance = ComputeDistanceToOBB(position, direction, &solid_box_data->obb_geometry_);
+
+  // Check distance value with previous value. Store the minimum value
+  if (distance < primary_particle->particle_solid_distance_[global_id]) {
+    #ifdef GGEMS_TRACKING
+    if (global_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] --------------------------------------------------------------------------------\n");
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Find a closest solid\n");
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle id: %d\n", global_id);
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle in voxelized solid, id: %d\n", solid_box_data->solid_id_);
+      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle solid distance: %e mm\n", distance/mm);
+    }
+    #endif
+    primary_particle->particle_solid_distance_[global_id] = distance;
+    primary_particle->solid_id_[global_id] = solid_box_data->solid_id_;
+  }
+
+  return FALSE;
+}
+
 /*!
   \fn kernel void particle_solid_distance_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data)
   \param particle_id_limit - particle id limit
@@ -47,10 +97,13 @@ kernel void particle_solid_distance_ggems_solid_box(
 )
 {
   // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  GGsize thread_id = get_global_id(0);
+
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
 
   // Checking particle status. If DEAD, the particle is not track
   if (primary_particle->status_[global_id] == DEAD) return;
@@ -72,37 +125,75 @@ kernel void particle_solid_distance_ggems_solid_box(
     primary_particle->dz_[global_id]
   };
 
-  // Check if particle inside voxelized navigator, if yes distance is 0.0 and not need to compute particle - solid distance
-  if (IsParticleInOBB(&position, &solid_box_data->obb_geometry_)) {
-    #ifdef GGEMS_TRACKING
-    if (global_id == primary_particle->particle_tracking_id) {
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] --------------------------------------------------------------------------------\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Find a closest solid\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle id: %d\n", global_id);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle in voxelized solid, id: %d\n", solid_box_data->solid_id_);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle solid distance: 0.0\n");
-    }
-    #endif
-    primary_particle->particle_solid_distance_[global_id] = 0.0f;
-    primary_particle->solid_id_[global_id] = solid_box_data->solid_id_;
-    return;
-  }
+  ParticleSolidBoxDistance(global_id, primary_particle, &position, &direction, solid_box_data);
+}
 
-  // Compute distance between particles and voxelized navigator
-  GGfloat distance = ComputeDistanceToOBB(&position, &direction, &solid_box_data->obb_geometry_);
+/*!
+  \fn kernel void particle_solid_distance_ggems_solid_boxes(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data, global GGEMSBVHNode const* bvh_nodes)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param solid_box_data - pointer to array of solid box data, all solids of navigator
+  \param bvh_nodes - pointer to BVH nodes built over the solids, root is the first node
+  \brief OpenCL kernel computing distance between all solid boxes of a navigator and particles in a single launch
+*/
+kernel void particle_solid_distance_ggems_solid_boxes(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSSolidBoxData const* solid_box_data,
+  global GGEMSBVHNode const* bvh_nodes
+)
+{
+  // Getting index of thread
+  GGsize thread_id = get_global_id(0);
 
-  // Check distance value with previous value. Store the minimum value
-  if (distance < primary_particle->particle_solid_distance_[global_id]) {
-    #ifdef GGEMS_TRACKING
-    if (global_id == primary_particle->particle_tracking_id) {
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] --------------------------------------------------------------------------------\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Find a closest solid\n");
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle id: %d\n", global_id);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle in voxelized solid, id: %d\n", solid_box_data->solid_id_);
-      printf("[GGEMS OpenCL kernel particle_solid_distance_ggems_solid_box] Particle solid distance: %e mm\n", distance/mm);
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
+
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
+
+  // Checking particle status. If DEAD, the particle is not track
+  if (primary_particle->status_[global_id] == DEAD) return;
+
+  // Checking if the particle - solid is 0. If yes the particle is already in another navigator
+  if (primary_particle->particle_solid_distance_[global_id] == 0.0f) return;
+
+  // Position of particle
+  GGfloat3 position = {
+    primary_particle->px_[global_id],
+    primary_particle->py_[global_id],
+    primary_particle->pz_[global_id]
+  };
+
+  // Direction of particle
+  GGfloat3 direction = {
+    primary_particle->dx_[global_id],
+    primary_particle->dy_[global_id],
+    primary_particle->dz_[global_id]
+  };
+
+  // Traversal of BVH, starting from root
+  GGint node_stack[BVH_MAXIMUM_DEPTH];
+  GGint stack_size = 0;
+  node_stack[stack_size++] = 0;
+
+  while (stack_size > 0) {
+    global GGEMSBVHNode const* node = &bvh_nodes[node_stack[--stack_size]];
+
+    // Skipping node if not crossed, or if farther than the closest solid found
+    GGfloat node_distance = ComputeEntryDistanceToAABB(&position, &direction, node->border_min_xyz_, node->border_max_xyz_);
+    if (node_distance == OUT_OF_WORLD || node_distance >= primary_particle->particle_solid_distance_[global_id]) continue;
+
+    // Internal node
+    if (node->number_of_solids_ == 0) {
+      node_stack[stack_size++] = node->child_index_[1];
+      node_stack[stack_size++] = node->child_index_[0];
+      continue;
+    }
+
+    // Leaf, checking each solid. If particle is inside a solid, no other solid has to be checked
+    for (GGint i = 0; i < node->number_of_solids_; ++i) {
+      if (ParticleSolidBoxDistance(global_id, primary_particle, &position, &direction, &solid_box_data[node->solid_index_[i]])) return;
     }
-    #endif
-    primary_particle->particle_solid_distance_[global_id] = distance;
-    primary_particle->solid_id_[global_id] = solid_box_data->solid_id_;
   }
 }
@@ -47,10 +47,13 @@ kernel void particle_solid_distance_ggems_voxelized_solid(
 )
 {
   // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  GGsize thread_id = get_global_id(0);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
+
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
 
   // Checking particle status. If DEAD, the particle is not track
   if (primary_particle->status_[global_id] == DEAD) return;
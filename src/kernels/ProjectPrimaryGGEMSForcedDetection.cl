@@ -0,0 +1,136 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file ProjectPrimaryGGEMSForcedDetection.cl
+
+  \brief OpenCL kernel computing the expected primary projection of an X-ray source through a voxelized phantom
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/navigators/GGEMSForcedDetectionRecording.hh"
+
+/*!
+  \fn kernel void project_primary_ggems_forced_detection(global GGEMSForcedDetectionParams const* forced_detection_params, global GGEMSSolidBoxData const* detector_data, global GGEMSParticleCrossSections const* detector_particle_cross_sections, global GGfloat const* detector_photon_cross_sections, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, global GGfloat44 const* source_matrix_transformation, global GGfloat const* energy_spectrum, global GGfloat const* cdf, GGint const number_of_energy_bins, GGfloat const beam_aperture, GGfloat const number_of_particles, global GGDosiType* primary_projection)
+  \param forced_detection_params - layout of detection elements in projection
+  \param detector_data - data of all modules of system
+  \param detector_particle_cross_sections - pointer to cross sections activated in system
+  \param detector_photon_cross_sections - pointer to packed photon cross sections of system
+  \param voxelized_solid_data - pointer to voxelized solid data
+  \param label_data - pointer storing label of material
+  \param particle_cross_sections - pointer to cross sections activated in voxelized solid
+  \param photon_cross_sections - pointer to packed photon cross sections of voxelized solid
+  \param source_matrix_transformation - matrix of transformation of source
+  \param energy_spectrum - energies of source
+  \param cdf - cumulative distribution function of energies
+  \param number_of_energy_bins - number of energies in spectrum
+  \param beam_aperture - aperture of cone beam
+  \param number_of_particles - number of particles emitted by source
+  \param primary_projection - expected counts of primary photons in each detection element
+  \brief One work-item per detection element, photons emitted uniformly in the cone toward the isocenter are aimed at the center of element, attenuated by the phantom and detected
+*/
+kernel void project_primary_ggems_forced_detection(
+  global GGEMSForcedDetectionParams const* forced_detection_params,
+  global GGEMSSolidBoxData const* detector_data,
+  global GGEMSParticleCrossSections const* detector_particle_cross_sections,
+  global GGfloat const* detector_photon_cross_sections,
+  global GGEMSVoxelizedSolidData const* voxelized_solid_data,
+  global GGuchar const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  global GGfloat44 const* source_matrix_transformation,
+  global GGfloat const* energy_spectrum,
+  global GGfloat const* cdf,
+  GGint const number_of_energy_bins,
+  GGfloat const beam_aperture,
+  GGfloat const number_of_particles,
+  global GGDosiType* primary_projection
+)
+{
+  // Getting index of thread
+  GGint global_id = get_global_id(0);
+
+  // Return if index > to number of pixels
+  if (global_id >= forced_detection_params->number_of_pixels_) return;
+
+  // Module and element of pixel
+  GGint pixel_x = global_id % forced_detection_params->projection_dimension_x_;
+  GGint pixel_y = global_id / forced_detection_params->projection_dimension_x_;
+  GGint module_x = pixel_x / forced_detection_params->number_of_elements_x_;
+  GGint module_y = pixel_y / forced_detection_params->number_of_elements_y_;
+
+  global GGEMSSolidBoxData const* module_data = detector_data + module_x + module_y*forced_detection_params->number_of_modules_x_;
+
+  GGfloat3 element_border_min, element_border_max;
+  GetDetectionElementBorders(
+    module_data,
+    pixel_x - module_x*forced_detection_params->number_of_elements_x_,
+    pixel_y - module_y*forced_detection_params->number_of_elements_y_,
+    &element_border_min, &element_border_max
+  );
+
+  // Point source, cone axis from source to isocenter as in X-ray source
+  GGfloat3 source_position = {0.0f, 0.0f, 0.0f};
+  source_position = LocalToGlobalPosition(source_matrix_transformation, &source_position);
+  GGfloat3 beam_axis = normalize(-source_position);
+
+  GGfloat3 element_center = 0.5f*(element_border_min + element_border_max);
+  GGfloat3 global_element_center = LocalToGlobalPosition(&module_data->obb_geometry_.matrix_transformation_, &element_center);
+
+  // Pixel outside the cone, or pencil beam
+  GGfloat cos_aperture = cos(beam_aperture);
+  if (cos_aperture >= 1.0f || dot(normalize(global_element_center - source_position), beam_axis) < cos_aperture) {
+    primary_projection[global_id] = (GGDosiType)0.0f;
+    return;
+  }
+
+  // Density of directions per steradian
+  GGfloat direction_probability = 1.0f / (TWO_PI*(1.0f - cos_aperture));
+
+  GGfloat3 module_source_position = GlobalToLocalPosition(&module_data->obb_geometry_.matrix_transformation_, &source_position);
+  GGfloat3 local_source_position = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &source_position);
+  GGfloat3 local_element_center = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_element_center);
+
+  // Sum over energies of spectrum. As in X-ray source, energy is linearly interpolated between the two energies of an interval of cdf,
+  // the probability of the interval is taken at its midpoint. The probability below first value of cdf is taken at first energy
+  GGfloat expected_counts = 0.0f;
+  for (GGint k = 0; k < number_of_energy_bins; ++k) {
+    GGfloat energy_probability = (k > 0) ? cdf[k] - cdf[k-1] : cdf[0];
+    if (energy_probability <= 0.0f) continue;
+
+    GGfloat energy = (k > 0) ? 0.5f*(energy_spectrum[k-1] + energy_spectrum[k]) : energy_spectrum[0];
+
+    GGfloat contribution = ComputeDetectionElementContribution(
+      detector_particle_cross_sections, detector_photon_cross_sections, energy,
+      &module_source_position, &element_border_min, &element_border_max
+    );
+    if (contribution <= 0.0f) continue;
+
+    expected_counts += energy_probability*contribution*exp(-ComputeOpticalDepthInVoxelizedSolid(
+      voxelized_solid_data, label_data, particle_cross_sections, photon_cross_sections,
+      energy, &local_source_position, &local_element_center
+    ));
+  }
+
+  primary_projection[global_id] = (GGDosiType)(number_of_particles*direction_probability*expected_counts);
+}
@@ -38,33 +38,14 @@
 #include "GGEMS/maths/GGEMSMatrixOperations.hh"
 
 /*!
-  \fn kernel void project_to_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data)
-  \param particle_id_limit - particle id limit
+  \fn inline void ProjectToSolidBox(GGsize const global_id, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data)
+  \param global_id - index of particle
   \param primary_particle - pointer to primary particles on OpenCL memory
-  \param solid_box_data - pointer to solid box data
-  \brief OpenCL kernel moving particles to solid box
+  \param solid_box_data - pointer to selected solid box data
+  \brief Moving a particle to its selected solid box
 */
-kernel void project_to_ggems_solid_box(
-  GGsize const particle_id_limit,
-  global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSSolidBoxData const* solid_box_data
-)
+inline void ProjectToSolidBox(GGsize const global_id, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data)
 {
-  // Getting index of thread
-  GGsize global_id = get_global_id(0);
-
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
-
-  // No solid detected, consider particle as dead
-  if(primary_particle->solid_id_[global_id] == -1) primary_particle->status_[global_id] = DEAD;
-
-  // Checking if the current navigator is the selected navigator
-  if (primary_particle->solid_id_[global_id] != solid_box_data->solid_id_) return;
-
-  // Checking status of particle
-  if (primary_particle->status_[global_id] == DEAD) return;
-
   // Checking if distance to navigator is OUT_OF_WORLD after computation distance
   // If yes, the particle is OUT_OF_WORLD and DEAD, so no tracking
   if (primary_particle->particle_solid_distance_[global_id] == OUT_OF_WORLD) {
@@ -112,3 +93,76 @@ kernel void project_to_ggems_solid_box(
   }
   #endif
 }
+
+/*!
+  \fn kernel void project_to_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param solid_box_data - pointer to solid box data
+  \brief OpenCL kernel moving particles to solid box
+*/
+kernel void project_to_ggems_solid_box(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSSolidBoxData const* solid_box_data
+)
+{
+  // Getting index of thread
+  GGsize thread_id = get_global_id(0);
+
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
+
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
+
+  // No solid detected, consider particle as dead
+  if(primary_particle->solid_id_[global_id] == -1) primary_particle->status_[global_id] = DEAD;
+
+  // Checking if the current navigator is the selected navigator
+  if (primary_particle->solid_id_[global_id] != solid_box_data->solid_id_) return;
+
+  // Checking status of particle
+  if (primary_particle->status_[global_id] == DEAD) return;
+
+  ProjectToSolidBox(global_id, primary_particle, solid_box_data);
+}
+
+/*!
+  \fn kernel void project_to_ggems_solid_boxes(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSSolidBoxData const* solid_box_data, GGint const first_solid_id, GGint const number_of_solids)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param solid_box_data - pointer to array of solid box data, all solids of navigator
+  \param first_solid_id - solid id of the first solid in array
+  \param number_of_solids - number of solids in array
+  \brief OpenCL kernel moving particles to any solid box of a navigator in a single launch
+*/
+kernel void project_to_ggems_solid_boxes(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSSolidBoxData const* solid_box_data,
+  GGint const first_solid_id,
+  GGint const number_of_solids
+)
+{
+  // Getting index of thread
+  GGsize thread_id = get_global_id(0);
+
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
+
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
+
+  // No solid detected, consider particle as dead
+  if(primary_particle->solid_id_[global_id] == -1) primary_particle->status_[global_id] = DEAD;
+
+  // Checking if the selected solid belongs to this navigator, solid ids are contiguous
+  GGint solid_index = primary_particle->solid_id_[global_id] - first_solid_id;
+  if (solid_index < 0 || solid_index >= number_of_solids) return;
+
+  // Checking status of particle
+  if (primary_particle->status_[global_id] == DEAD) return;
+
+  ProjectToSolidBox(global_id, primary_particle, &solid_box_data[solid_index]);
+}
@@ -48,10 +48,13 @@ kernel void project_to_ggems_voxelized_solid(
 )
 {
   // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  GGsize thread_id = get_global_id(0);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
+
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
 
   // No solid detected, consider particle as dead
   if(primary_particle->solid_id_[global_id] == -1) primary_particle->status_[global_id] = DEAD;
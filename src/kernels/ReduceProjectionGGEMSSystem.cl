@@ -0,0 +1,94 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file ReduceProjectionGGEMSSystem.cl
+
+  \brief OpenCL kernels reducing histograms of modules and devices of a system in a 64-bit projection
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/tools/GGEMSTypes.hh"
+
+/*!
+  \fn kernel void gather_histograms_ggems_system(GGint const number_of_modules, GGint const first_module_id, GGint const number_of_modules_x, GGint const number_of_elements_x, GGint const number_of_elements_y, GGint const module_stride, global GGHistoType const* histogram, global GGulong* projection)
+  \param number_of_modules - number of modules stored one after the other in histogram
+  \param first_module_id - index of the first module of histogram in system
+  \param number_of_modules_x - number of modules in X of system
+  \param number_of_elements_x - number of detection elements in X in a module
+  \param number_of_elements_y - number of detection elements in Y in a module
+  \param module_stride - number of elements between histograms of two consecutive modules
+  \param histogram - histograms of modules, counts or energy with ENERGY_INTEGRATING
+  \param projection - projection of system
+  \brief One work-item per detection element, histograms of modules are copied at their place in projection. A detection element belongs to one module, no atomic is needed
+*/
+kernel void gather_histograms_ggems_system(
+  GGint const number_of_modules,
+  GGint const first_module_id,
+  GGint const number_of_modules_x,
+  GGint const number_of_elements_x,
+  GGint const number_of_elements_y,
+  GGint const module_stride,
+  global GGHistoType const* histogram,
+  global GGulong* projection
+)
+{
+  // Getting index of thread
+  GGint global_id = get_global_id(0);
+
+  // Return if index > to number of detection elements
+  GGint number_of_elements = number_of_elements_x*number_of_elements_y;
+  if (global_id >= number_of_modules*number_of_elements) return;
+
+  // Module and element of work-item
+  GGint module_index = global_id / number_of_elements;
+  GGint element_index = global_id - module_index*number_of_elements;
+  GGint module_id = first_module_id + module_index;
+
+  GGint pixel_x = (module_id % number_of_modules_x)*number_of_elements_x + element_index % number_of_elements_x;
+  GGint pixel_y = (module_id / number_of_modules_x)*number_of_elements_y + element_index / number_of_elements_x;
+
+  projection[pixel_x + pixel_y*number_of_modules_x*number_of_elements_x] = (GGulong)histogram[module_index*module_stride + element_index];
+}
+
+/*!
+  \fn kernel void add_projection_ggems_system(GGint const number_of_pixels, global GGulong const* device_projection, global GGulong* projection)
+  \param number_of_pixels - number of pixels in projection
+  \param device_projection - projection of another device
+  \param projection - projection of system, the projection of device is added
+  \brief Add the projection computed on another device
+*/
+kernel void add_projection_ggems_system(
+  GGint const number_of_pixels,
+  global GGulong const* device_projection,
+  global GGulong* projection
+)
+{
+  // Getting index of thread
+  GGint global_id = get_global_id(0);
+
+  // Return if index > to number of pixels
+  if (global_id >= number_of_pixels) return;
+
+  projection[global_id] += device_projection[global_id];
+}
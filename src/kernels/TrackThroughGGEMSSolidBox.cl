@@ -41,65 +41,145 @@
 #include "GGEMS/maths/GGEMSMatrixOperations.hh"
 #include "GGEMS/navigators/GGEMSPhotonNavigator.hh"
 
+#ifdef LOCAL_HISTOGRAM
+#define HISTOGRAM_ADDRESS_SPACE local /*!< Histograms are accumulated in local memory of work-group */
+#else
+#define HISTOGRAM_ADDRESS_SPACE global /*!< Histograms are accumulated in global memory */
+#endif
+
+#ifdef ENERGY_INTEGRATING
+#define HISTOGRAM_ATOMIC_ADD atom_add /*!< 64-bit atomic addition of energy */
+#else
+#define HISTOGRAM_ATOMIC_ADD atomic_add /*!< 32-bit atomic addition of counts */
+#endif
+
 /*!
-  \fn kernel void track_through_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, global GGint* histogram, global GGint* scatter_histogram)
+  \fn inline GGint SelectParticleInSolidBoxes(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, GGint const first_solid_id, GGint const number_of_solids, GGsize* global_id)
   \param particle_id_limit - particle id limit
   \param primary_particle - pointer to primary particles on OpenCL memory
-  \param random - pointer on random numbers
-  \param solid_box_data - pointer to solid box data
-  \param label_data - pointer storing label of material (empty buffer here, 1 material only)
-  \param particle_cross_sections - pointer to cross sections activated in navigator
-  \param materials - pointer on material in navigator
-  \param threshold - energy threshold
-  \param histogram - pointer to buffer storing histogram
-  \param scatter_histogram - pointer to buffer storing scatter histogram
-  \brief OpenCL kernel tracking particles within voxelized solid
+  \param first_solid_id - solid id of the first solid
+  \param number_of_solids - number of solids, solid ids are contiguous
+  \param global_id - index of particle in buffer of particles
+  \return index of solid where particle is tracked, -1 if particle is not tracked by this work-item
+  \brief Get the particle of the work-item and check if it is alive in one of the solids
 */
-kernel void track_through_ggems_solid_box(
+inline GGint SelectParticleInSolidBoxes(
   GGsize const particle_id_limit,
   global GGEMSPrimaryParticles* primary_particle,
-  global GGEMSRandom* random,
-  global GGEMSSolidBoxData const* solid_box_data,
-  global GGuchar const* label_data,
-  global GGEMSParticleCrossSections const* particle_cross_sections,
-  global GGEMSMaterialTables const* materials,
-  GGfloat const threshold
-  #ifdef HISTOGRAM
-  ,global GGint* histogram,
-  global GGint* scatter_histogram
-  #endif
+  GGint const first_solid_id,
+  GGint const number_of_solids,
+  GGsize* global_id
 )
 {
   // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  GGsize thread_id = get_global_id(0);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return -1;
 
-  // Checking if the current navigator is the selected navigator
-  if (primary_particle->solid_id_[global_id] != solid_box_data->solid_id_) return;
+  // Index of particle in active list
+  *global_id = primary_particle->active_index_[thread_id];
+
+  // Checking if the selected solid belongs to this navigator
+  GGint solid_index = primary_particle->solid_id_[*global_id] - first_solid_id;
+  if (solid_index < 0 || solid_index >= number_of_solids) return -1;
 
   // Checking status of particle
-  if (primary_particle->status_[global_id] == DEAD) {
+  if (primary_particle->status_[*global_id] == DEAD) {
     #ifdef GGEMS_TRACKING
-    if (global_id == primary_particle->particle_tracking_id) {
+    if (*global_id == primary_particle->particle_tracking_id) {
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] ################################################################################\n");
-      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] The particle id %d is dead!!!\n", global_id);
+      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] The particle id %d is dead!!!\n", *global_id);
     }
     #endif
-    return;
+    return -1;
   }
 
+  return solid_index;
+}
+
+#ifdef LOCAL_HISTOGRAM
+/*!
+  \fn inline void ClearLocalHistogram(local GGHistoType* local_histogram, GGsize const number_of_elements)
+  \param local_histogram - histogram in local memory
+  \param number_of_elements - number of elements in histogram
+  \brief Set histogram of work-group to 0, all work-items of work-group have to call it
+*/
+inline void ClearLocalHistogram(local GGHistoType* local_histogram, GGsize const number_of_elements)
+{
+  for (GGsize i = get_local_id(0); i < number_of_elements; i += get_local_size(0)) local_histogram[i] = 0;
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+}
+
+/*!
+  \fn inline void FlushLocalHistogram(local GGHistoType const* local_histogram, global GGHistoType* histogram, GGsize const number_of_elements)
+  \param local_histogram - histogram in local memory
+  \param histogram - histogram in global memory
+  \param number_of_elements - number of elements in histogram
+  \brief Add histogram of work-group to global histogram, one atomic per non-empty element and per work-group, all work-items of work-group have to call it
+*/
+inline void FlushLocalHistogram(local GGHistoType const* local_histogram, global GGHistoType* histogram, GGsize const number_of_elements)
+{
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (GGsize i = get_local_id(0); i < number_of_elements; i += get_local_size(0)) {
+    if (local_histogram[i] != 0) HISTOGRAM_ATOMIC_ADD(&histogram[i], local_histogram[i]);
+  }
+}
+#endif
+
+/*!
+  \fn inline GGint GetHistogramCounts(GGEMSPhotonState* photon)
+  \param photon - pointer on photon state
+  \return number of counts recorded in histogram
+  \brief Statistical weight of photon rounded to an integer number of counts, the fractional part is kept with its probability so histograms are unbiased. No random number is drawn for integer weights, analog tracking is unchanged
+*/
+inline GGint GetHistogramCounts(GGEMSPhotonState* photon)
+{
+  GGint counts = (GGint)photon->weight_;
+  GGfloat fraction = photon->weight_ - (GGfloat)counts;
+  if (fraction > 0.0f && KissUniformState(&photon->random_) < fraction) ++counts;
+  return counts;
+}
+
+/*!
+  \fn inline void TrackThroughSolidBox(GGsize const global_id, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, HISTOGRAM_ADDRESS_SPACE GGHistoType* histogram, HISTOGRAM_ADDRESS_SPACE GGHistoType* scatter_histogram)
+  \param global_id - index of particle
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random numbers
+  \param solid_box_data - pointer to selected solid box data
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param materials - pointer on material in navigator
+  \param threshold - energy threshold
+  \param histogram - pointer to histogram of selected solid box, in global or local memory, counts or energy with ENERGY_INTEGRATING
+  \param scatter_histogram - pointer to scatter histogram of selected solid box, in global or local memory
+  \brief Tracking a particle within a solid box until it leaves the solid or dies
+*/
+inline void TrackThroughSolidBox(
+  GGsize const global_id,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  GGfloat const threshold
+  #ifdef HISTOGRAM
+  ,HISTOGRAM_ADDRESS_SPACE GGHistoType* histogram,
+  HISTOGRAM_ADDRESS_SPACE GGHistoType* scatter_histogram
+  #endif
+)
+{
+  // Loading photon and random state in private memory, stored back once on exit
+  GGEMSPhotonState photon;
+  LoadPhotonState(primary_particle, random, global_id, &photon);
+
   // Get the position and direction in local OBB coordinate
   GGfloat3 global_position = {primary_particle->px_[global_id], primary_particle->py_[global_id], primary_particle->pz_[global_id]};
-  GGfloat3 global_direction = {primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]};
   GGfloat3 local_position = GlobalToLocalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &global_position);
-  GGfloat3 local_direction = GlobalToLocalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &global_direction);
-
-  // Storing local direction in particles 
-  primary_particle->dx_[global_id] = local_direction.x;
-  primary_particle->dy_[global_id] = local_direction.y;
-  primary_particle->dz_[global_id] = local_direction.z;
+  photon.direction_ = GlobalToLocalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &photon.direction_);
 
   // Get borders of OBB
   GGfloat3 border_min = solid_box_data->obb_geometry_.border_min_xyz_;
@@ -122,9 +202,9 @@ kernel void track_through_ggems_solid_box(
   // Track particle until out of solid
   do {
     // Find next discrete photon interaction
-    GetPhotonNextInteraction(primary_particle, random, particle_cross_sections, 0, global_id);
-    GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[global_id];
-    GGchar next_discrete_process = primary_particle->next_discrete_process_[global_id];
+    GetPhotonNextInteraction(&photon, particle_cross_sections, photon_cross_sections, 0);
+    GGfloat next_interaction_distance = photon.next_interaction_distance_;
+    GGchar next_discrete_process = photon.next_discrete_process_;
 
     // Get safety position of particle to be sure particle is inside voxel
     TransportGetSafetyInsideAABB(
@@ -137,7 +217,7 @@ kernel void track_through_ggems_solid_box(
 
     // Get the distance to next boundary
     GGfloat distance_to_next_boundary = ComputeDistanceToAABB(
-      &local_position, &local_direction,
+      &local_position, &photon.direction_,
       border_min.x, border_max.x,
       border_min.y, border_max.y,
       border_min.z, border_max.z,
@@ -159,14 +239,14 @@ kernel void track_through_ggems_solid_box(
       else if (primary_particle->pname_[global_id] == ELECTRON) printf("e-\n");
       else if (primary_particle->pname_[global_id] == POSITRON) printf("e+\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
-      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Energy: %e keV\n", primary_particle->E_[global_id]/keV);
+      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Local direction (x, y, z): %e %e %e\n", photon.direction_.x, photon.direction_.y, photon.direction_.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Energy: %e keV\n", photon.E_/keV);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Solid id: %u\n", solid_box_data->solid_id_);
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Solid X Borders: %e %e mm\n", border_min.x/mm, border_max.x/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Solid Y Borders: %e %e mm\n", border_min.y/mm, border_max.y/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Solid Z Borders: %e %e mm\n", border_min.z/mm, border_max.z/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Material in voxel: %s\n", particle_cross_sections->material_names_[0]);
+      printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Material in voxel: %d\n", 0);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_solid_box] Next process: ");
       if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
@@ -178,7 +258,7 @@ kernel void track_through_ggems_solid_box(
     #endif
 
     // Moving particle to next postion
-    local_position = local_position + local_direction*next_interaction_distance;
+    local_position = local_position + photon.direction_*next_interaction_distance;
 
     // Get safety position of particle to be sure particle is outside voxel
     TransportGetSafetyOutsideAABB(
@@ -196,37 +276,55 @@ kernel void track_through_ggems_solid_box(
       break;
     }
 
-    // Storing new position in local
-    primary_particle->px_[global_id] = local_position.x;
-    primary_particle->py_[global_id] = local_position.y;
-    primary_particle->pz_[global_id] = local_position.z;
-
     // Check thresold
-    if (primary_particle->E_[global_id] < threshold) primary_particle->status_[global_id] = DEAD;
+    if (photon.E_ < threshold) photon.status_ = DEAD;
+
+    #ifdef ENERGY_INTEGRATING
+    GGfloat edep = photon.E_;
+    #endif
 
     // Resolve process if different of TRANSPORTATION
     if (next_discrete_process != TRANSPORTATION) {
-      PhotonDiscreteProcess(primary_particle, random, materials, particle_cross_sections, 0, global_id);
+      PhotonDiscreteProcess(&photon, materials, particle_cross_sections, photon_cross_sections, 0);
 
-      local_direction.x = primary_particle->dx_[global_id];
-      local_direction.y = primary_particle->dy_[global_id];
-      local_direction.z = primary_particle->dz_[global_id];
-
-      #ifdef HISTOGRAM
+      #if defined(HISTOGRAM) && !defined(ENERGY_INTEGRATING)
       if (next_discrete_process == PHOTOELECTRIC_EFFECT || next_discrete_process == COMPTON_SCATTERING) {
         GGfloat3 element_size = box_size / convert_float3(virtual_element_number);
         GGint3 voxel_id = convert_int3((local_position - border_min) / element_size);
 
-        atomic_add(&histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], 1);
+        GGint counts = GetHistogramCounts(&photon);
+        if (counts > 0) {
+          HISTOGRAM_ATOMIC_ADD(&histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], counts);
+
+          // Storing scatter
+          if (scatter_histogram) {
+            if (photon.scatter_ == TRUE) HISTOGRAM_ATOMIC_ADD(&scatter_histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], counts);
+          }
+        }
+      }
+      #endif
+    }
+
+    #ifdef ENERGY_INTEGRATING
+    // Energy given to electrons is absorbed in element, a dead photon (photoelectric effect or threshold) is absorbed totally
+    if (photon.status_ == ALIVE) edep -= photon.E_;
+
+    if (edep > 0.0f) {
+      GGfloat3 element_size = box_size / convert_float3(virtual_element_number);
+      GGint3 voxel_id = convert_int3((local_position - border_min) / element_size);
+
+      GGHistoType signal = convert_ulong_rte(photon.weight_ * edep * EDEP_FIXED_POINT_SCALE);
+      if (signal > 0) {
+        HISTOGRAM_ATOMIC_ADD(&histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], signal);
 
         // Storing scatter
         if (scatter_histogram) {
-          if (primary_particle->scatter_[global_id] == TRUE) atomic_add(&scatter_histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], 1);
+          if (photon.scatter_ == TRUE) HISTOGRAM_ATOMIC_ADD(&scatter_histogram[voxel_id.x + voxel_id.y * virtual_element_number.x], signal);
         }
       }
-      #endif
     }
-  } while (primary_particle->status_[global_id] == ALIVE);
+    #endif
+  } while (photon.status_ == ALIVE);
 
   // Convert to global position
   global_position = LocalToGlobalPosition(&solid_box_data->obb_geometry_.matrix_transformation_, &local_position);
@@ -234,9 +332,145 @@ kernel void track_through_ggems_solid_box(
   primary_particle->py_[global_id] = global_position.y;
   primary_particle->pz_[global_id] = global_position.z;
 
-  // Convert to global direction
-  global_direction = LocalToGlobalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &local_direction);
-  primary_particle->dx_[global_id] = global_direction.x;
-  primary_particle->dy_[global_id] = global_direction.y;
-  primary_particle->dz_[global_id] = global_direction.z;
+  // Convert to global direction and store photon state
+  photon.direction_ = LocalToGlobalDirection(&solid_box_data->obb_geometry_.matrix_transformation_, &photon.direction_);
+  StorePhotonState(primary_particle, random, global_id, &photon);
+}
+
+/*!
+  \fn kernel void track_through_ggems_solid_box(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, global GGHistoType* histogram, global GGHistoType* scatter_histogram, local GGHistoType* local_histogram)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random numbers
+  \param solid_box_data - pointer to solid box data
+  \param label_data - pointer storing label of material (empty buffer here, 1 material only)
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param materials - pointer on material in navigator
+  \param threshold - energy threshold
+  \param histogram - pointer to buffer storing histogram, counts or energy with ENERGY_INTEGRATING
+  \param scatter_histogram - pointer to buffer storing scatter histogram
+  \param local_histogram - histogram of work-group followed by scatter histogram, only with LOCAL_HISTOGRAM
+  \brief OpenCL kernel tracking particles within voxelized solid
+*/
+kernel void track_through_ggems_solid_box(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  global GGuchar const* label_data,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  GGfloat const threshold
+  #ifdef HISTOGRAM
+  ,global GGHistoType* histogram,
+  global GGHistoType* scatter_histogram
+  #ifdef LOCAL_HISTOGRAM
+  ,local GGHistoType* local_histogram
+  #endif
+  #endif
+)
+{
+  GGsize global_id = 0;
+  GGint solid_index = SelectParticleInSolidBoxes(particle_id_limit, primary_particle, solid_box_data->solid_id_, 1, &global_id);
+
+  #ifdef LOCAL_HISTOGRAM
+  // Work-items do not return before the end, the histogram of work-group is flushed once
+  GGsize number_of_elements = solid_box_data->virtual_element_number_xyz_[0]*solid_box_data->virtual_element_number_xyz_[1]*solid_box_data->virtual_element_number_xyz_[2];
+  local GGHistoType* local_scatter_histogram = scatter_histogram ? local_histogram + number_of_elements : NULL;
+  ClearLocalHistogram(local_histogram, scatter_histogram ? 2*number_of_elements : number_of_elements);
+
+  if (solid_index >= 0) {
+    TrackThroughSolidBox(
+      global_id, primary_particle, random, solid_box_data, particle_cross_sections, photon_cross_sections, materials, threshold,
+      local_histogram, local_scatter_histogram
+    );
+  }
+
+  FlushLocalHistogram(local_histogram, histogram, number_of_elements);
+  if (scatter_histogram) FlushLocalHistogram(local_scatter_histogram, scatter_histogram, number_of_elements);
+  #else
+  if (solid_index < 0) return;
+
+  TrackThroughSolidBox(
+    global_id, primary_particle, random, solid_box_data, particle_cross_sections, photon_cross_sections, materials, threshold
+    #ifdef HISTOGRAM
+    ,histogram, scatter_histogram
+    #endif
+  );
+  #endif
+}
+
+/*!
+  \fn kernel void track_through_ggems_solid_boxes(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSSolidBoxData const* solid_box_data, GGint const first_solid_id, GGint const number_of_solids, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold, global GGHistoType* histogram, global GGHistoType* scatter_histogram, local GGHistoType* local_histogram)
+  \param particle_id_limit - particle id limit
+  \param primary_particle - pointer to primary particles on OpenCL memory
+  \param random - pointer on random numbers
+  \param solid_box_data - pointer to array of solid box data, all solids of navigator
+  \param first_solid_id - solid id of the first solid in array
+  \param number_of_solids - number of solids in array
+  \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param photon_cross_sections - pointer to packed photon cross sections
+  \param materials - pointer on material in navigator
+  \param threshold - energy threshold
+  \param histogram - pointer to buffer storing histograms of all solids, one after the other, counts or energy with ENERGY_INTEGRATING
+  \param scatter_histogram - pointer to buffer storing scatter histograms of all solids, one after the other
+  \param local_histogram - histograms of all solids for work-group followed by scatter histograms, only with LOCAL_HISTOGRAM
+  \brief OpenCL kernel tracking particles within any solid box of a navigator in a single launch
+*/
+kernel void track_through_ggems_solid_boxes(
+  GGsize const particle_id_limit,
+  global GGEMSPrimaryParticles* primary_particle,
+  global GGEMSRandom* random,
+  global GGEMSSolidBoxData const* solid_box_data,
+  GGint const first_solid_id,
+  GGint const number_of_solids,
+  global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
+  global GGEMSMaterialTables const* materials,
+  GGfloat const threshold
+  #ifdef HISTOGRAM
+  ,global GGHistoType* histogram,
+  global GGHistoType* scatter_histogram
+  #ifdef LOCAL_HISTOGRAM
+  ,local GGHistoType* local_histogram
+  #endif
+  #endif
+)
+{
+  GGsize global_id = 0;
+  GGint solid_index = SelectParticleInSolidBoxes(particle_id_limit, primary_particle, first_solid_id, number_of_solids, &global_id);
+
+  #ifdef HISTOGRAM
+  // Offset of histogram of selected solid, all solids have the same number of elements
+  GGsize number_of_elements = solid_box_data->virtual_element_number_xyz_[0]*solid_box_data->virtual_element_number_xyz_[1]*solid_box_data->virtual_element_number_xyz_[2];
+  GGsize histogram_offset = solid_index >= 0 ? solid_index*number_of_elements : 0;
+  #endif
+
+  #ifdef LOCAL_HISTOGRAM
+  // Work-items do not return before the end, the histograms of work-group are flushed once
+  GGsize number_of_histogram_elements = number_of_solids*number_of_elements;
+  local GGHistoType* local_scatter_histogram = scatter_histogram ? local_histogram + number_of_histogram_elements : NULL;
+  ClearLocalHistogram(local_histogram, scatter_histogram ? 2*number_of_histogram_elements : number_of_histogram_elements);
+
+  if (solid_index >= 0) {
+    TrackThroughSolidBox(
+      global_id, primary_particle, random, &solid_box_data[solid_index], particle_cross_sections, photon_cross_sections, materials, threshold,
+      local_histogram + histogram_offset, local_scatter_histogram ? local_scatter_histogram + histogram_offset : NULL
+    );
+  }
+
+  FlushLocalHistogram(local_histogram, histogram, number_of_histogram_elements);
+  if (scatter_histogram) FlushLocalHistogram(local_scatter_histogram, scatter_histogram, number_of_histogram_elements);
+  #else
+  if (solid_index < 0) return;
+
+  TrackThroughSolidBox(
+    global_id, primary_particle, random, &solid_box_data[solid_index], particle_cross_sections, photon_cross_sections, materials, threshold
+    #ifdef HISTOGRAM
+    ,histogram + histogram_offset, scatter_histogram ? scatter_histogram + histogram_offset : NULL
+    #endif
+  );
+  #endif
 }
@@ -45,16 +45,27 @@
 #include "GGEMS/navigators/GGEMSDoseRecording.hh"
 #endif
 
+#ifdef FORCED_DETECTION
+#include "GGEMS/navigators/GGEMSForcedDetectionRecording.hh"
+#endif
+
+#ifdef PARTICLE_SPLITTING
+#include "GGEMS/navigators/GGEMSParticleSplitting.hh"
+#endif
+
 /*!
-  \fn kernel void track_through_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold)
+  \fn kernel void track_through_ggems_voxelized_solid(GGsize const particle_id_limit, global GGEMSPrimaryParticles* primary_particle, global GGEMSRandom* random, global GGEMSVoxelizedSolidData const* voxelized_solid_data, global GGuchar const* label_data, global GGEMSParticleCrossSections const* particle_cross_sections, global GGfloat const* photon_cross_sections, global GGEMSMaterialTables const* materials, GGfloat const threshold)
   \param particle_id_limit - particle id limit
   \param primary_particle - pointer to primary particles on OpenCL memory
   \param random - pointer on random numbers
   \param voxelized_solid_data - pointer to voxelized solid data
   \param label_data - pointer storing label of material
   \param particle_cross_sections - pointer to cross sections activated in navigator
+  \param photon_cross_sections - pointer to packed photon cross sections
   \param materials - pointer on material in navigator
   \param threshold - energy threshold
+  \param importance - importance of navigator, only with PARTICLE_SPLITTING
+  \param importance_map - importance of each voxel relative to navigator, NULL if no map, only with PARTICLE_SPLITTING
   \brief OpenCL kernel tracking particles within voxelized solid
 */
 kernel void track_through_ggems_voxelized_solid(
@@ -64,22 +75,37 @@ kernel void track_through_ggems_voxelized_solid(
   global GGEMSVoxelizedSolidData const* voxelized_solid_data,
   global GGuchar const* label_data,
   global GGEMSParticleCrossSections const* particle_cross_sections,
+  global GGfloat const* photon_cross_sections,
   global GGEMSMaterialTables const* materials,
   GGfloat const threshold
   #ifdef DOSIMETRY
   ,global GGEMSDoseParams* dose_params,
-  global GGDosiType* edep_tracking,
-  global GGDosiType* edep_squared_tracking,
+  global GGEdepType* edep_tracking,
+  global GGEdepType* edep_squared_tracking,
   global GGint* hit_tracking,
   global GGint* photon_tracking
   #endif
+  #ifdef FORCED_DETECTION
+  ,global GGEMSForcedDetectionParams const* forced_detection_params,
+  global GGEMSSolidBoxData const* detector_data,
+  global GGEMSParticleCrossSections const* detector_particle_cross_sections,
+  global GGfloat const* detector_photon_cross_sections,
+  global GGDosiType* forced_scatter_projection
+  #endif
+  #ifdef PARTICLE_SPLITTING
+  ,GGfloat const importance,
+  global GGfloat const* importance_map
+  #endif
 )
 {
   // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  GGsize thread_id = get_global_id(0);
+
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
 
   // Checking if the current navigator is the selected navigator
   if (primary_particle->solid_id_[global_id] != voxelized_solid_data->solid_id_) return;
@@ -95,16 +121,14 @@ kernel void track_through_ggems_voxelized_solid(
     return;
   }
 
+  // Loading photon and random state in private memory, stored back once on exit
+  GGEMSPhotonState photon;
+  LoadPhotonState(primary_particle, random, global_id, &photon);
+
   // Get the position and direction in local OBB coordinate
   GGfloat3 global_position = {primary_particle->px_[global_id], primary_particle->py_[global_id], primary_particle->pz_[global_id]};
-  GGfloat3 global_direction = {primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]};
   GGfloat3 local_position = GlobalToLocalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_position);
-  GGfloat3 local_direction = GlobalToLocalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &global_direction);
-
-  // Storing local direction in particles 
-  primary_particle->dx_[global_id] = local_direction.x;
-  primary_particle->dy_[global_id] = local_direction.y;
-  primary_particle->dz_[global_id] = local_direction.z;
+  photon.direction_ = GlobalToLocalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &photon.direction_);
 
   // Get borders of OBB
   GGfloat3 border_min = voxelized_solid_data->obb_geometry_.border_min_xyz_;
@@ -113,6 +137,315 @@ kernel void track_through_ggems_voxelized_solid(
   GGfloat3 voxel_size = voxelized_solid_data->voxel_sizes_xyz_;
   GGint3 number_of_voxels = voxelized_solid_data->number_of_voxels_xyz_;
 
+  #ifdef WOODCOCK_TRACKING
+  #ifdef PARTICLE_SPLITTING
+  // Weight window at entry in navigator
+  TransportGetSafetyInsideAABB(
+    &local_position,
+    border_min.x, border_max.x,
+    border_min.y, border_max.y,
+    border_min.z, border_max.z,
+    GEOMETRY_TOLERANCE
+  );
+  GGint3 entry_voxel_id = clamp(convert_int3((local_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - 1);
+  ApplyWeightWindow(
+    primary_particle, random, global_id, &voxelized_solid_data->obb_geometry_.matrix_transformation_,
+    GetImportance(importance, importance_map, entry_voxel_id, number_of_voxels), &local_position, &photon
+  );
+  #endif
+
+  // Woodcock tracking: steps sampled with the majorant cross section of all materials, voxel borders are ignored
+  while (photon.status_ == ALIVE) {
+    // Get safety position of particle to be sure particle is inside solid
+    TransportGetSafetyInsideAABB(
+      &local_position,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    // Step to next tentative interaction
+    GGfloat weight = 0.0f;
+    GGint energy_id = GetPhotonEnergyBin(particle_cross_sections, photon.E_, &weight);
+    GGfloat majorant_cross_section = fmax(particle_cross_sections->majorant_cross_sections_[energy_id], particle_cross_sections->majorant_cross_sections_[energy_id+1]);
+    GGfloat next_interaction_distance = -log(KissUniformState(&photon.random_))/majorant_cross_section;
+
+    // Get the distance to solid boundary
+    GGfloat distance_to_boundary = ComputeDistanceToAABB(
+      &local_position, &photon.direction_,
+      border_min.x, border_max.x,
+      border_min.y, border_max.y,
+      border_min.z, border_max.z,
+      GEOMETRY_TOLERANCE
+    );
+
+    // Particle leaves the solid before the tentative interaction
+    if (distance_to_boundary <= next_interaction_distance) {
+      local_position = local_position + photon.direction_*(distance_to_boundary + GEOMETRY_TOLERANCE);
+      primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD; // Reset to initiale value
+      primary_particle->solid_id_[global_id] = -1; // Out of world
+      break;
+    }
+
+    // Moving particle to tentative interaction
+    local_position = local_position + photon.direction_*next_interaction_distance;
+
+    // Get index of voxelized phantom, x, y, z
+    GGint3 voxel_id = clamp(convert_int3((local_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - 1);
+
+    // Get the material at tentative interaction
+    GGuchar material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
+
+    #ifdef DOSIMETRY
+    if (photon_tracking) dose_photon_tracking(dose_params, photon_tracking, &local_position);
+    #endif
+
+    // Accept or reject the interaction
+    GGchar next_discrete_process = SelectPhotonWoodcockInteraction(
+      &photon, particle_cross_sections, photon_cross_sections,
+      energy_id, weight, majorant_cross_section, material_id
+    );
+
+    #ifdef GGEMS_TRACKING
+    if (global_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] ################################################################################\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Particle id: %d\n", global_id);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Energy: %e keV\n", photon.E_/keV);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Index of current voxel (x, y, z): %d %d %d\n", voxel_id.x, voxel_id.y, voxel_id.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Material in voxel: %d\n", material_id);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Woodcock step: %e mm, majorant cross section: %e mm-1\n", next_interaction_distance/mm, majorant_cross_section*mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Next process: ");
+      if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
+      if (next_discrete_process == PHOTOELECTRIC_EFFECT) printf("PHOTOELECTRIC_EFFECT\n");
+      if (next_discrete_process == RAYLEIGH_SCATTERING) printf("RAYLEIGH_SCATTERING\n");
+      if (next_discrete_process == NO_PROCESS) printf("VIRTUAL\n");
+    }
+    #endif
+
+    // Virtual interaction, particle continues in the same direction
+    if (next_discrete_process == NO_PROCESS) continue;
+
+    #ifdef FORCED_DETECTION
+    if (next_discrete_process == COMPTON_SCATTERING) {
+      ForceComptonDetection(
+        forced_detection_params, detector_data, detector_particle_cross_sections, detector_photon_cross_sections, forced_scatter_projection,
+        voxelized_solid_data, label_data, particle_cross_sections, photon_cross_sections, &local_position, &photon
+      );
+    }
+    #endif
+
+    #ifdef DOSIMETRY
+    GGfloat edep = photon.E_;
+    #endif
+
+    PhotonDiscreteProcess(&photon, materials, particle_cross_sections, photon_cross_sections, material_id);
+
+    // If process is COMPTON_SCATTERING or RAYLEIGH_SCATTERING scatter order is incremented
+    if (next_discrete_process == COMPTON_SCATTERING || next_discrete_process == RAYLEIGH_SCATTERING)
+    {
+      photon.scatter_ = TRUE;
+    }
+
+    #ifdef DOSIMETRY
+    edep -= photon.E_;
+    dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, photon.weight_*edep, &local_position);
+    #endif
+
+    // Apply threshold
+    if (photon.E_ <= materials->photon_energy_cut_[material_id]) {
+      #ifdef DOSIMETRY
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, photon.weight_*photon.E_, &local_position);
+      #endif
+      photon.status_ = DEAD;
+    }
+
+    #ifdef PARTICLE_SPLITTING
+    // Weight window at interaction point, importance changes inside navigator only with an importance map
+    if (importance_map && photon.status_ == ALIVE) {
+      ApplyWeightWindow(
+        primary_particle, random, global_id, &voxelized_solid_data->obb_geometry_.matrix_transformation_,
+        GetImportance(importance, importance_map, voxel_id, number_of_voxels), &local_position, &photon
+      );
+    }
+    #endif
+  }
+  #elif defined(DDA_TRACKING)
+  // Incremental voxel traversal (3D-DDA): voxel index is stepped along the ray, free path is carried across voxels as an optical depth
+  TransportGetSafetyInsideAABB(
+    &local_position,
+    border_min.x, border_max.x,
+    border_min.y, border_max.y,
+    border_min.z, border_max.z,
+    GEOMETRY_TOLERANCE
+  );
+
+  // Voxel index is computed only once, then stepped
+  GGint3 voxel_id = clamp(convert_int3((local_position - border_min) / voxel_size), (GGint3)(0), number_of_voxels - 1);
+
+  #ifdef PARTICLE_SPLITTING
+  // Weight window at entry in navigator
+  ApplyWeightWindow(
+    primary_particle, random, global_id, &voxelized_solid_data->obb_geometry_.matrix_transformation_,
+    GetImportance(importance, importance_map, voxel_id, number_of_voxels), &local_position, &photon
+  );
+  #endif
+
+  // Optical depth to next interaction, exponential sample in number of mean free paths
+  GGfloat optical_depth = -log(KissUniformState(&photon.random_));
+
+  // Energy bin is the same until next interaction
+  GGfloat weight = 0.0f;
+  GGint energy_id = GetPhotonEnergyBin(particle_cross_sections, photon.E_, &weight);
+
+  // Ray from current position, distances along ray to next voxel border on each axis
+  GGfloat3 ray_origin = local_position;
+  GGint3 step;
+  GGfloat3 t_delta;
+  GGfloat3 t_max;
+  GGfloat t_current = 0.0f;
+
+  // Direction changes only at interaction, DDA parameters are initialized from new ray
+  GGchar is_new_ray = TRUE;
+
+  while (photon.status_ == ALIVE) {
+    if (is_new_ray) {
+      step = (GGint3)(photon.direction_.x > 0.0f ? 1 : -1, photon.direction_.y > 0.0f ? 1 : -1, photon.direction_.z > 0.0f ? 1 : -1);
+
+      GGfloat3 next_border = border_min + convert_float3(voxel_id + (GGint3)(step.x > 0, step.y > 0, step.z > 0))*voxel_size;
+
+      t_delta.x = photon.direction_.x != 0.0f ? voxel_size.x/fabs(photon.direction_.x) : FLT_MAX;
+      t_delta.y = photon.direction_.y != 0.0f ? voxel_size.y/fabs(photon.direction_.y) : FLT_MAX;
+      t_delta.z = photon.direction_.z != 0.0f ? voxel_size.z/fabs(photon.direction_.z) : FLT_MAX;
+
+      t_max.x = photon.direction_.x != 0.0f ? (next_border.x - ray_origin.x)/photon.direction_.x : FLT_MAX;
+      t_max.y = photon.direction_.y != 0.0f ? (next_border.y - ray_origin.y)/photon.direction_.y : FLT_MAX;
+      t_max.z = photon.direction_.z != 0.0f ? (next_border.z - ray_origin.z)/photon.direction_.z : FLT_MAX;
+
+      t_current = 0.0f;
+      is_new_ray = FALSE;
+    }
+
+    // Get the material that compose this voxel
+    GGuchar material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
+    GGfloat total_cross_section = GetPhotonTotalCrossSection(particle_cross_sections, photon_cross_sections, energy_id, weight, material_id);
+
+    // Length of ray in voxel, may be slightly negative after an interaction on a voxel border
+    GGfloat t_exit = fmin(t_max.x, fmin(t_max.y, t_max.z));
+    GGfloat voxel_length = fmax(t_exit - t_current, 0.0f);
+    GGfloat voxel_optical_depth = total_cross_section*voxel_length;
+
+    #ifdef GGEMS_TRACKING
+    if (global_id == primary_particle->particle_tracking_id) {
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] ################################################################################\n");
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Particle id: %d\n", global_id);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Ray origin (x, y, z): %e %e %e mm\n", ray_origin.x/mm, ray_origin.y/mm, ray_origin.z/mm);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local direction (x, y, z): %e %e %e\n", photon.direction_.x, photon.direction_.y, photon.direction_.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Energy: %e keV\n", photon.E_/keV);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Index of current voxel (x, y, z): %d %d %d\n", voxel_id.x, voxel_id.y, voxel_id.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Material in voxel: %d\n", material_id);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Length in voxel: %e mm, remaining optical depth: %e\n", voxel_length/mm, optical_depth);
+    }
+    #endif
+
+    // Particle crosses the voxel without interaction
+    if (optical_depth >= voxel_optical_depth) {
+      optical_depth -= voxel_optical_depth;
+
+      #ifdef DOSIMETRY
+      if (photon_tracking) {
+        GGfloat3 voxel_center_position = ray_origin + photon.direction_*(0.5f*(t_current + t_exit));
+        dose_photon_tracking(dose_params, photon_tracking, &voxel_center_position);
+      }
+      #endif
+
+      t_current = t_exit;
+
+      // Crossing the nearest voxel border
+      if (t_max.x < t_max.y && t_max.x < t_max.z) {
+        t_max.x += t_delta.x;
+        voxel_id.x += step.x;
+      }
+      else if (t_max.y < t_max.z) {
+        t_max.y += t_delta.y;
+        voxel_id.y += step.y;
+      }
+      else {
+        t_max.z += t_delta.z;
+        voxel_id.z += step.z;
+      }
+
+      // Particle leaves the solid, pushed outside to not be tracked again in this solid
+      if (voxel_id.x < 0 || voxel_id.x >= number_of_voxels.x || voxel_id.y < 0 || voxel_id.y >= number_of_voxels.y || voxel_id.z < 0 || voxel_id.z >= number_of_voxels.z) {
+        local_position = ray_origin + photon.direction_*(t_current + GEOMETRY_TOLERANCE);
+        primary_particle->particle_solid_distance_[global_id] = OUT_OF_WORLD; // Reset to initiale value
+        primary_particle->solid_id_[global_id] = -1; // Out of world
+        break;
+      }
+
+      #ifdef PARTICLE_SPLITTING
+      // Weight window at voxel border, importance changes inside navigator only with an importance map
+      if (importance_map) {
+        local_position = ray_origin + photon.direction_*t_current;
+        ApplyWeightWindow(
+          primary_particle, random, global_id, &voxelized_solid_data->obb_geometry_.matrix_transformation_,
+          GetImportance(importance, importance_map, voxel_id, number_of_voxels), &local_position, &photon
+        );
+      }
+      #endif
+
+      continue;
+    }
+
+    // Moving particle to interaction in current voxel, no tolerance needed because voxel index is known
+    t_current += optical_depth/total_cross_section;
+    local_position = ray_origin + photon.direction_*t_current;
+
+    GGchar next_discrete_process = SelectPhotonInteraction(&photon, particle_cross_sections, photon_cross_sections, energy_id, weight, total_cross_section, material_id);
+
+    #ifdef FORCED_DETECTION
+    if (next_discrete_process == COMPTON_SCATTERING) {
+      ForceComptonDetection(
+        forced_detection_params, detector_data, detector_particle_cross_sections, detector_photon_cross_sections, forced_scatter_projection,
+        voxelized_solid_data, label_data, particle_cross_sections, photon_cross_sections, &local_position, &photon
+      );
+    }
+    #endif
+
+    #ifdef DOSIMETRY
+    GGfloat edep = photon.E_;
+    #endif
+
+    PhotonDiscreteProcess(&photon, materials, particle_cross_sections, photon_cross_sections, material_id);
+
+    // If process is COMPTON_SCATTERING or RAYLEIGH_SCATTERING scatter order is incremented
+    if (next_discrete_process == COMPTON_SCATTERING || next_discrete_process == RAYLEIGH_SCATTERING)
+    {
+      photon.scatter_ = TRUE;
+    }
+
+    #ifdef DOSIMETRY
+    edep -= photon.E_;
+    dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, photon.weight_*edep, &local_position);
+    #endif
+
+    // Apply threshold
+    if (photon.E_ <= materials->photon_energy_cut_[material_id]) {
+      #ifdef DOSIMETRY
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, photon.weight_*photon.E_, &local_position);
+      #endif
+      photon.status_ = DEAD;
+      break;
+    }
+
+    // New ray from interaction point, new free path and energy bin
+    ray_origin = local_position;
+    is_new_ray = TRUE;
+    optical_depth = -log(KissUniformState(&photon.random_));
+    energy_id = GetPhotonEnergyBin(particle_cross_sections, photon.E_, &weight);
+  }
+  #else
   // Track particle until out of solid
   do {
     // Get index of voxelized phantom, x, y, z
@@ -124,13 +457,22 @@ kernel void track_through_ggems_voxelized_solid(
       break;
     }
 
+    #ifdef PARTICLE_SPLITTING
+    // Weight window at entry in navigator and at each voxel step
+    ApplyWeightWindow(
+      primary_particle, random, global_id, &voxelized_solid_data->obb_geometry_.matrix_transformation_,
+      GetImportance(importance, importance_map, voxel_id, number_of_voxels), &local_position, &photon
+    );
+    if (photon.status_ == DEAD) break;
+    #endif
+
     // Get the material that compose this volume
     GGuchar material_id = label_data[voxel_id.x + voxel_id.y * number_of_voxels.x + voxel_id.z * number_of_voxels.x * number_of_voxels.y];
 
     // Find next discrete photon interaction
-    GetPhotonNextInteraction(primary_particle, random, particle_cross_sections, material_id, global_id);
-    GGfloat next_interaction_distance = primary_particle->next_interaction_distance_[global_id];
-    GGchar next_discrete_process = primary_particle->next_discrete_process_[global_id];
+    GetPhotonNextInteraction(&photon, particle_cross_sections, photon_cross_sections, material_id);
+    GGfloat next_interaction_distance = photon.next_interaction_distance_;
+    GGchar next_discrete_process = photon.next_discrete_process_;
 
     // Get the borders of the current voxel
     GGfloat3 voxel_border_min = border_min +  convert_float3(voxel_id)*voxel_size;
@@ -147,7 +489,7 @@ kernel void track_through_ggems_voxelized_solid(
 
     // Get the distance to next boundary
     GGfloat distance_to_next_boundary = ComputeDistanceToAABB(
-      &local_position, &local_direction,
+      &local_position, &photon.direction_,
       voxel_border_min.x, voxel_border_max.x,
       voxel_border_min.y, voxel_border_max.y,
       voxel_border_min.z, voxel_border_max.z,
@@ -172,8 +514,8 @@ kernel void track_through_ggems_voxelized_solid(
       else if (primary_particle->pname_[global_id] == ELECTRON) printf("e-\n");
       else if (primary_particle->pname_[global_id] == POSITRON) printf("e+\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local position (x, y, z): %e %e %e mm\n", local_position.x/mm, local_position.y/mm, local_position.z/mm);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local direction (x, y, z): %e %e %e\n", local_direction.x, local_direction.y, local_direction.z);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Energy: %e keV\n", primary_particle->E_[global_id]/keV);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Local direction (x, y, z): %e %e %e\n", photon.direction_.x, photon.direction_.y, photon.direction_.z);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Energy: %e keV\n", photon.E_/keV);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Solid id: %u\n", voxelized_solid_data->solid_id_);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Nb voxels: %u %u %u\n", number_of_voxels.x, number_of_voxels.y, number_of_voxels.z);
@@ -185,7 +527,7 @@ kernel void track_through_ggems_voxelized_solid(
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Voxel Y Borders: %e %e mm\n", voxel_border_min.y/mm, voxel_border_max.y/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Voxel Z Borders: %e %e mm\n", voxel_border_min.z/mm, voxel_border_max.z/mm);
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Index of current voxel (x, y, z): %d %d %d\n", voxel_id.x, voxel_id.y, voxel_id.z);
-      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Material in voxel: %s\n", particle_cross_sections->material_names_[material_id]);
+      printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Material in voxel: %d\n", material_id);
       printf("\n");
       printf("[GGEMS OpenCL kernel track_through_ggems_voxelized_solid] Next process: ");
       if (next_discrete_process == COMPTON_SCATTERING) printf("COMPTON_SCATTERING\n");
@@ -197,7 +539,7 @@ kernel void track_through_ggems_voxelized_solid(
     #endif
 
     // Moving particle to next position
-    local_position = local_position + local_direction*next_interaction_distance;
+    local_position = local_position + photon.direction_*next_interaction_distance;
 
     // Get safety position of particle to be sure particle is outside voxel
     TransportGetSafetyOutsideAABB(
@@ -215,43 +557,44 @@ kernel void track_through_ggems_voxelized_solid(
       break;
     }
 
-    // Storing new position in local
-    primary_particle->px_[global_id] = local_position.x;
-    primary_particle->py_[global_id] = local_position.y;
-    primary_particle->pz_[global_id] = local_position.z;
-
     // Resolve process if different of TRANSPORTATION
     if (next_discrete_process != TRANSPORTATION) {
+      #ifdef FORCED_DETECTION
+      if (next_discrete_process == COMPTON_SCATTERING) {
+        ForceComptonDetection(
+          forced_detection_params, detector_data, detector_particle_cross_sections, detector_photon_cross_sections, forced_scatter_projection,
+          voxelized_solid_data, label_data, particle_cross_sections, photon_cross_sections, &local_position, &photon
+        );
+      }
+      #endif
+
       #ifdef DOSIMETRY
-      GGfloat edep = primary_particle->E_[global_id];
+      GGfloat edep = photon.E_;
       #endif
 
-      PhotonDiscreteProcess(primary_particle, random, materials, particle_cross_sections, material_id, global_id);
+      PhotonDiscreteProcess(&photon, materials, particle_cross_sections, photon_cross_sections, material_id);
 
       // If process is COMPTON_SCATTERING or RAYLEIGH_SCATTERING scatter order is incremented
       if (next_discrete_process == COMPTON_SCATTERING || next_discrete_process == RAYLEIGH_SCATTERING)
       {
-        primary_particle->scatter_[global_id] = TRUE;
+        photon.scatter_ = TRUE;
       }
 
       #ifdef DOSIMETRY
-      edep -= primary_particle->E_[global_id];
-      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, edep, &local_position);
+      edep -= photon.E_;
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, photon.weight_*edep, &local_position);
       #endif
-
-      local_direction.x = primary_particle->dx_[global_id];
-      local_direction.y = primary_particle->dy_[global_id];
-      local_direction.z = primary_particle->dz_[global_id];
     }
 
     // Apply threshold
-    if (primary_particle->E_[global_id] <= materials->photon_energy_cut_[material_id]) {
+    if (photon.E_ <= materials->photon_energy_cut_[material_id]) {
       #ifdef DOSIMETRY
-      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, primary_particle->E_[global_id], &local_position);
+      dose_record_standard(dose_params, edep_tracking, edep_squared_tracking, hit_tracking, photon.weight_*photon.E_, &local_position);
       #endif
-      primary_particle->status_[global_id] = DEAD;
+      photon.status_ = DEAD;
     }
-  } while (primary_particle->status_[global_id] == ALIVE);
+  } while (photon.status_ == ALIVE);
+  #endif
 
   // Convert to global position
   global_position = LocalToGlobalPosition(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_position);
@@ -259,9 +602,7 @@ kernel void track_through_ggems_voxelized_solid(
   primary_particle->py_[global_id] = global_position.y;
   primary_particle->pz_[global_id] = global_position.z;
 
-  // Convert to global direction
-  global_direction = LocalToGlobalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &local_direction);
-  primary_particle->dx_[global_id] = global_direction.x;
-  primary_particle->dy_[global_id] = global_direction.y;
-  primary_particle->dz_[global_id] = global_direction.z;
+  // Convert to global direction and store photon state
+  photon.direction_ = LocalToGlobalDirection(&voxelized_solid_data->obb_geometry_.matrix_transformation_, &photon.direction_);
+  StorePhotonState(primary_particle, random, global_id, &photon);
 }
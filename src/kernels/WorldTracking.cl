@@ -69,14 +69,17 @@ kernel void world_tracking(
 )
 {
   // Getting index of thread
-  GGsize global_id = get_global_id(0);
+  GGsize thread_id = get_global_id(0);
 
-  // Return if index > to particle limit
-  if (global_id >= particle_id_limit) return;
+  // Return if index > to number of active particles
+  if (thread_id >= particle_id_limit || thread_id >= (GGsize)primary_particle->number_of_active_particles_) return;
+
+  // Index of particle in active list
+  GGsize global_id = primary_particle->active_index_[thread_id];
 
   if (primary_particle->status_[global_id] == DEAD) return;
 
-  // In world, the particles is tracked using a DDA algorithm
+  // In world, the particles is tracked using an exact incremental 3D-DDA (Amanatides and Woo)
   // Get direction of particle
   GGfloat3 direction = {primary_particle->dx_[global_id], primary_particle->dy_[global_id], primary_particle->dz_[global_id]};
   // Get point x1, y1 and z1
@@ -84,68 +87,127 @@ kernel void world_tracking(
   // Get voxel size
   GGfloat3 size = {size_x, size_y, size_z};
 
-  // Computing point x2, y2, z2
-  GGfloat distance = primary_particle->particle_solid_distance_[global_id] == OUT_OF_WORLD ? 10000.0f : primary_particle->particle_solid_distance_[global_id];
+  // Segment to next solid, segment out of world is limited by world borders
+  GGfloat distance = primary_particle->particle_solid_distance_[global_id];
 
   if (distance <= GEOMETRY_TOLERANCE) return;
 
-  GGfloat3 p2 = p1 + distance*direction;
-
-  // Start index
+  // World grid is centered on origin
   GGint3 dim = {width, height, depth};
-  GGint3 index = convert_int3((p1 - (size*convert_float3(dim)*-0.5f))/size);
-
-  // Computing difference between p1 and p2 and length for each axis
-  GGfloat3 diff_p1_p2 = p2 - p1;
-  GGfloat3 len_p1_p2 = fabs(diff_p1_p2);
-
-  // Getting main direction and size
-  GGfloat length = len_p1_p2.x;
-  GGfloat main_size = size.x;
-  if (len_p1_p2.y > length) {
-    length = len_p1_p2.y;
-    main_size = size.y;
-  }
-  else if (len_p1_p2.z > length) {
-    length = len_p1_p2.z;
-    main_size = size.z;
+  GGfloat3 half_world = size*convert_float3(dim)*0.5f;
+
+  // Clipping segment to world grid, slab method
+  GGfloat t_in = 0.0f;
+  GGfloat t_out = distance;
+
+  GGfloat3 inv_direction = {
+    direction.x != 0.0f ? 1.0f/direction.x : 0.0f,
+    direction.y != 0.0f ? 1.0f/direction.y : 0.0f,
+    direction.z != 0.0f ? 1.0f/direction.z : 0.0f
+  };
+
+  GGfloat3 t_lower = (-half_world - p1)*inv_direction;
+  GGfloat3 t_upper = (half_world - p1)*inv_direction;
+
+  if (direction.x != 0.0f) {
+    t_in = fmax(t_in, fmin(t_lower.x, t_upper.x));
+    t_out = fmin(t_out, fmax(t_lower.x, t_upper.x));
   }
+  else if (p1.x < -half_world.x || p1.x > half_world.x) return;
 
-  GGfloat inv_length = 1.0f / length;
+  if (direction.y != 0.0f) {
+    t_in = fmax(t_in, fmin(t_lower.y, t_upper.y));
+    t_out = fmin(t_out, fmax(t_lower.y, t_upper.y));
+  }
+  else if (p1.y < -half_world.y || p1.y > half_world.y) return;
 
-  // Computing incrementation
-  GGfloat3 increment = inv_length*diff_p1_p2;
+  if (direction.z != 0.0f) {
+    t_in = fmax(t_in, fmin(t_lower.z, t_upper.z));
+    t_out = fmin(t_out, fmax(t_lower.z, t_upper.z));
+  }
+  else if (p1.z < -half_world.z || p1.z > half_world.z) return;
+
+  if (t_out - t_in <= GEOMETRY_TOLERANCE) return;
+
+  // First voxel, entry point is on world border or inside world
+  GGfloat3 entry = p1 + t_in*direction;
+  GGint3 index = convert_int3(floor((entry + half_world)/size));
+  index = clamp(index, (GGint3)(0, 0, 0), dim - (GGint3)(1, 1, 1));
+
+  // Step on each axis, and distance along ray to cross one voxel on each axis
+  GGint3 step = {
+    direction.x > 0.0f ? 1 : -1,
+    direction.y > 0.0f ? 1 : -1,
+    direction.z > 0.0f ? 1 : -1
+  };
+
+  GGfloat3 t_delta = {
+    direction.x != 0.0f ? size.x*fabs(inv_direction.x) : FLT_MAX,
+    direction.y != 0.0f ? size.y*fabs(inv_direction.y) : FLT_MAX,
+    direction.z != 0.0f ? size.z*fabs(inv_direction.z) : FLT_MAX
+  };
+
+  // Distance along ray to the next voxel border on each axis
+  GGfloat3 next_border = -half_world + convert_float3(index + (GGint3)(step.x > 0, step.y > 0, step.z > 0))*size;
+  GGfloat3 t_max = {
+    direction.x != 0.0f ? (next_border.x - p1.x)*inv_direction.x : FLT_MAX,
+    direction.y != 0.0f ? (next_border.y - p1.y)*inv_direction.y : FLT_MAX,
+    direction.z != 0.0f ? (next_border.z - p1.z)*inv_direction.z : FLT_MAX
+  };
+
+  // Quantities recorded in each crossed voxel are the same, read only once. Energy and momentum are weighted by the statistical weight of particle
+  GGDosiType weight = (GGDosiType)primary_particle->weight_[global_id];
+  GGDosiType energy = weight*(GGDosiType)primary_particle->E_[global_id];
+  GGDosiType energy_squared = energy*energy;
+  GGDosiType momentum_along_x = weight*(GGDosiType)direction.x;
+  GGDosiType momentum_along_y = weight*(GGDosiType)direction.y;
+  GGDosiType momentum_along_z = weight*(GGDosiType)direction.z;
 
-  // Computing number of step
-  GGint step = (GGint)(1.0f + (length/main_size));
   GGint global_index_world = 0;
+  GGfloat t_current = t_in;
 
-  for (GGint i = 0; i < step; ++i) {
-    // Checking index
-    if (index.x < 0 || index.x >= dim.x || index.y < 0 || index.y >= dim.y || index.z < 0 || index.z >= dim.z) {
-      break;
-    }
-
+  // Each voxel crossed by segment is visited once
+  while (t_current < t_out) {
     global_index_world = index.x + index.y * dim.x + index.z * dim.x * dim.y;
 
     if (photon_tracking) atomic_add(&photon_tracking[global_index_world], 1);
 
     #ifdef DOSIMETRY_DOUBLE_PRECISION
-    if (edep_tracking) AtomicAddDouble(&edep_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]);
-    if (edep_squared_tracking) AtomicAddDouble(&edep_squared_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]*(GGDosiType)primary_particle->E_[global_id]);
-    if (momentum_x) AtomicAddDouble(&momentum_x[global_index_world], (GGDosiType)primary_particle->dx_[global_id]);
-    if (momentum_y) AtomicAddDouble(&momentum_y[global_index_world], (GGDosiType)primary_particle->dy_[global_id]);
-    if (momentum_z) AtomicAddDouble(&momentum_z[global_index_world], (GGDosiType)primary_particle->dz_[global_id]);
+    if (edep_tracking) AtomicAddDouble(&edep_tracking[global_index_world], energy);
+    if (edep_squared_tracking) AtomicAddDouble(&edep_squared_tracking[global_index_world], energy_squared);
+    if (momentum_x) AtomicAddDouble(&momentum_x[global_index_world], momentum_along_x);
+    if (momentum_y) AtomicAddDouble(&momentum_y[global_index_world], momentum_along_y);
+    if (momentum_z) AtomicAddDouble(&momentum_z[global_index_world], momentum_along_z);
     #else
-    if (edep_tracking) AtomicAddFloat(&edep_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]);
-    if (edep_squared_tracking) AtomicAddFloat(&edep_squared_tracking[global_index_world], (GGDosiType)primary_particle->E_[global_id]*(GGDosiType)primary_particle->E_[global_id]);
-    if (momentum_x) AtomicAddFloat(&momentum_x[global_index_world], (GGDosiType)primary_particle->dx_[global_id]);
-    if (momentum_y) AtomicAddFloat(&momentum_y[global_index_world], (GGDosiType)primary_particle->dy_[global_id]);
-    if (momentum_z) AtomicAddFloat(&momentum_z[global_index_world], (GGDosiType)primary_particle->dz_[global_id]);
+    if (edep_tracking) AtomicAddFloat(&edep_tracking[global_index_world], energy);
+    if (edep_squared_tracking) AtomicAddFloat(&edep_squared_tracking[global_index_world], energy_squared);
+    if (momentum_x) AtomicAddFloat(&momentum_x[global_index_world], momentum_along_x);
+    if (momentum_y) AtomicAddFloat(&momentum_y[global_index_world], momentum_along_y);
+    if (momentum_z) AtomicAddFloat(&momentum_z[global_index_world], momentum_along_z);
     #endif
 
-    p1 += increment*main_size;
-    index = convert_int3((p1 - (size*convert_float3(dim)*-0.5f))/size);
+    // Crossing the nearest voxel border
+    if (t_max.x < t_max.y && t_max.x < t_max.z) {
+      t_current = t_max.x;
+      t_max.x += t_delta.x;
+      index.x += step.x;
+    }
+    else if (t_max.y < t_max.z) {
+      t_current = t_max.y;
+      t_max.y += t_delta.y;
+      index.y += step.y;
+    }
+    else {
+      t_current = t_max.z;
+      t_max.z += t_delta.z;
+      index.z += step.z;
+    }
+
+    // Segment ending on a voxel border does not enter the next voxel
+    if (t_out - t_current <= GEOMETRY_TOLERANCE) break;
+
+    // Checking index, rounding at world border
+    if (index.x < 0 || index.x >= dim.x || index.y < 0 || index.y >= dim.y || index.z < 0 || index.z >= dim.z) break;
   }
 
   #ifdef GGEMS_TRACKING
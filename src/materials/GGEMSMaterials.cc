@@ -86,7 +86,7 @@ void GGEMSMaterials::Clean(void)
 
   if (material_tables_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(material_tables_[i], sizeof(GGEMSMaterialTables), i);
+      if (opencl_manager.IsContextOwner(i)) opencl_manager.Deallocate(material_tables_[i], sizeof(GGEMSMaterialTables), i);
     }
     delete[] material_tables_;
     material_tables_ = nullptr;
@@ -219,6 +219,12 @@ void GGEMSMaterials::BuildMaterialTables(void)
 
   // Loop over activated device and allocate particle buffer on each device
   for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    // Material tables are shared by devices of the same context, built only once
+    if (!opencl_manager.IsContextOwner(d)) {
+      material_tables_[d] = material_tables_[opencl_manager.GetContextOwner(d)];
+      continue;
+    }
+
     // Allocating memory for material tables in OpenCL device
     material_tables_[d] = opencl_manager.Allocate(nullptr, sizeof(GGEMSMaterialTables), d, CL_MEM_READ_WRITE, "GGEMSMaterials");
 
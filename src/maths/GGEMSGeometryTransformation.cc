@@ -86,6 +86,8 @@ GGEMSGeometryTransformation::GGEMSGeometryTransformation(void)
       {0.0f, 0.0f, 0.0f, 1.0f}
     };
 
+  is_reference_ = false;
+
   // Get OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
@@ -334,3 +336,35 @@ void GGEMSGeometryTransformation::SetAxisTransformation(GGfloat33 const& axis)
     opencl_manager.ReleaseDeviceBuffer(matrix_transformation_[i], matrix_transformation_device, i);
   }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSGeometryTransformation::SetViewTransformation(GGfloat44 const& matrix_view)
+{
+  // Get OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Transformation matrix is the same on each device, the reference is read on the first one
+  if (!is_reference_) {
+    GGfloat44* matrix_transformation_device = opencl_manager.GetDeviceBuffer<GGfloat44>(matrix_transformation_[0], sizeof(GGfloat44), 0);
+    matrix_reference_ = *matrix_transformation_device;
+    opencl_manager.ReleaseDeviceBuffer(matrix_transformation_[0], matrix_transformation_device, 0);
+    is_reference_ = true;
+  }
+
+  // View is applied in global frame, after the reference transformation
+  GGfloat44 matrix_tmp = GGfloat44MultGGfloat44(&matrix_view, &matrix_reference_);
+
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    // Get the pointer on device
+    GGfloat44* matrix_transformation_device = opencl_manager.GetDeviceBuffer<GGfloat44>(matrix_transformation_[i], sizeof(GGfloat44), i);
+
+    // Copy step
+    *matrix_transformation_device = matrix_tmp;
+
+    // Release the pointer, mandatory step!!!
+    opencl_manager.ReleaseDeviceBuffer(matrix_transformation_[i], matrix_transformation_device, i);
+  }
+}
@@ -225,7 +225,7 @@ void GGEMSCTSystem::Initialize(void)
   // Allocation of memory for solid
   solids_ = new GGEMSSolid*[number_of_solids_];
 
-  for (GGsize i = 0; i < number_of_solids_; ++i) { // In CT system only "HISTOGRAM"
+  for (GGsize i = 0; i < number_of_solids_; ++i) { // In CT system only "HISTOGRAM" or "ENERGY_HISTOGRAM"
     solids_[i] = new GGEMSSolidBox(
       number_of_detection_elements_inside_module_xyz_.x_,
       number_of_detection_elements_inside_module_xyz_.y_,
@@ -233,12 +233,15 @@ void GGEMSCTSystem::Initialize(void)
       static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.x_) * size_of_detection_elements_xyz_.x,
       static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.y_) * size_of_detection_elements_xyz_.y,
       static_cast<GGfloat>(number_of_detection_elements_inside_module_xyz_.z_) * size_of_detection_elements_xyz_.z,
-      "HISTOGRAM"
+      GetHistogramType()
     );
 
     // Enabling scatter if necessary
     if (is_scatter_) solids_[i]->EnableScatter();
 
+    // Histograms in local memory of work-groups if they fit
+    if (is_local_histogram_) static_cast<GGEMSSolidBox*>(solids_[i])->EnableLocalHistogram();
+
     // Enabling tracking if necessary
     if (is_tracking_) solids_[i]->EnableTracking();
 
@@ -270,6 +273,12 @@ void GGEMSCTSystem::Initialize(void)
     }
   }
 
+  // All modules in a single buffer, navigation with one kernel per step
+  if (is_fused_navigation_) InitializeFusedNavigation(number_of_registered_solids);
+
+  // Histograms of modules and devices reduced on device
+  InitializeProjection();
+
   // Initialize parent class
   GGEMSNavigator::Initialize();
 }
@@ -381,3 +390,30 @@ void store_scatter_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_scatt
 {
   ct_system->StoreScatter(is_scatter);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_fused_navigation_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_fused_navigation)
+{
+  ct_system->SetFusedNavigation(is_fused_navigation);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_local_histogram_ggems_ct_system(GGEMSCTSystem* ct_system, bool const is_local_histogram)
+{
+  ct_system->SetLocalHistogram(is_local_histogram);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_detector_response_ggems_ct_system(GGEMSCTSystem* ct_system, char const* detector_response)
+{
+  ct_system->SetDetectorResponse(detector_response);
+}
@@ -27,6 +27,8 @@
   \date Wednesday January 13, 2021
 */
 
+#include <cmath>
+
 #include "GGEMS/navigators/GGEMSDosimetryCalculator.hh"
 #include "GGEMS/navigators/GGEMSDoseParams.hh"
 #include "GGEMS/geometries/GGEMSVoxelizedSolid.hh"
@@ -48,7 +50,18 @@ GGEMSDosimetryCalculator::GGEMSDosimetryCalculator(void)
   scale_factor_(1.0f),
   is_water_reference_(FALSE),
   minimum_density_(0.0f),
-  kernel_compute_dose_(nullptr)
+  number_of_dose_replicas_(1),
+  uncertainty_target_(0.0f),
+  uncertainty_dose_threshold_(0.5f),
+  particle_scale_factor_(1.0f),
+  number_of_uncertainty_groups_(0),
+  uncertainty_group_maximum_(nullptr),
+  uncertainty_group_sum_(nullptr),
+  uncertainty_group_count_(nullptr),
+  kernel_compute_dose_(nullptr),
+  kernel_merge_dose_replicas_(nullptr),
+  kernel_reduce_maximum_dose_(nullptr),
+  kernel_reduce_uncertainty_(nullptr)
 {
   GGcout("GGEMSDosimetryCalculator", "GGEMSDosimetryCalculator", 3) << "GGEMSDosimetryCalculator creating..." << GGendl;
 
@@ -56,6 +69,14 @@ GGEMSDosimetryCalculator::GGEMSDosimetryCalculator(void)
   dosel_sizes_.y = -1.0f;
   dosel_sizes_.z = -1.0f;
 
+  // Whole dose map for mean uncertainty by default
+  uncertainty_roi_min_.x = 0;
+  uncertainty_roi_min_.y = 0;
+  uncertainty_roi_min_.z = 0;
+  uncertainty_roi_max_.x = -1;
+  uncertainty_roi_max_.y = -1;
+  uncertainty_roi_max_.z = -1;
+
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
   // Get the number of activated device
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
@@ -74,6 +95,19 @@ GGEMSDosimetryCalculator::GGEMSDosimetryCalculator(void)
   }
   #endif
 
+  // Checking int64 atomic for fixed-point energy tallies
+  #ifdef DOSIMETRY_FIXED_POINT
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+    if (!opencl_manager.IsDoublePrecisionAtomicAddition(device_index)) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Your OpenCL device: " << opencl_manager.GetDeviceName(device_index) << ", does not support 64-bit integer atomic operation!!!" << std::endl;
+      oss << "Please, recompile with DOSIMETRY_FIXED_POINT to OFF." << std::endl;
+      GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "GGEMSDosimetryCalculator", oss.str());
+    }
+  }
+  #endif
+
   // Allocating buffer on each OpenCL device for dose params
   dose_params_ = new cl::Buffer*[number_activated_devices_];
   dose_recording_.edep_ = new cl::Buffer*[number_activated_devices_];
@@ -106,7 +140,7 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
 
   if (dose_recording_.edep_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(dose_recording_.edep_[i], total_number_of_dosels_*sizeof(GGDosiType), i);
+      opencl_manager.Deallocate(dose_recording_.edep_[i], number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGEdepType), i);
     }
     delete[] dose_recording_.edep_;
     dose_recording_.edep_ = nullptr;
@@ -133,7 +167,7 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
   if (dose_recording_.edep_squared_) {
     if (is_edep_squared_||is_uncertainty_) {
       for (GGsize i = 0; i < number_activated_devices_; ++i) {
-        opencl_manager.Deallocate(dose_recording_.edep_squared_[i], total_number_of_dosels_*sizeof(GGDosiType), i);
+        opencl_manager.Deallocate(dose_recording_.edep_squared_[i], number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGEdepType), i);
       }
     }
     delete[] dose_recording_.edep_squared_;
@@ -143,7 +177,7 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
   if (dose_recording_.hit_) {
     if (is_hit_tracking_||is_uncertainty_) {
       for (GGsize i = 0; i < number_activated_devices_; ++i) {
-        opencl_manager.Deallocate(dose_recording_.hit_[i], total_number_of_dosels_*sizeof(GGint), i);
+        opencl_manager.Deallocate(dose_recording_.hit_[i], number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGint), i);
       }
     }
     delete[] dose_recording_.hit_;
@@ -165,6 +199,35 @@ GGEMSDosimetryCalculator::~GGEMSDosimetryCalculator(void)
     kernel_compute_dose_ = nullptr;
   }
 
+  if (kernel_merge_dose_replicas_) {
+    delete[] kernel_merge_dose_replicas_;
+    kernel_merge_dose_replicas_ = nullptr;
+  }
+
+  if (uncertainty_group_maximum_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(uncertainty_group_maximum_[i], number_of_uncertainty_groups_*sizeof(GGfloat), i);
+      opencl_manager.Deallocate(uncertainty_group_sum_[i], number_of_uncertainty_groups_*sizeof(GGfloat), i);
+      opencl_manager.Deallocate(uncertainty_group_count_[i], number_of_uncertainty_groups_*sizeof(GGint), i);
+    }
+    delete[] uncertainty_group_maximum_;
+    uncertainty_group_maximum_ = nullptr;
+    delete[] uncertainty_group_sum_;
+    uncertainty_group_sum_ = nullptr;
+    delete[] uncertainty_group_count_;
+    uncertainty_group_count_ = nullptr;
+  }
+
+  if (kernel_reduce_maximum_dose_) {
+    delete[] kernel_reduce_maximum_dose_;
+    kernel_reduce_maximum_dose_ = nullptr;
+  }
+
+  if (kernel_reduce_uncertainty_) {
+    delete[] kernel_reduce_uncertainty_;
+    kernel_reduce_uncertainty_ = nullptr;
+  }
+
   GGcout("GGEMSDosimetryCalculator", "~GGEMSDosimetryCalculator", 3) << "GGEMSSourceManager erased!!!" << GGendl;
 }
 
@@ -278,6 +341,79 @@ void GGEMSDosimetryCalculator::SetMinimumDensity(float const& minimum_density, s
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSDosimetryCalculator::SetNumberOfDoseReplicas(GGsize const& number_of_replicas)
+{
+  if (number_of_replicas == 0) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Number of dose replicas has to be at least 1!!!";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetNumberOfDoseReplicas", oss.str());
+  }
+
+  // Number of replicas is stored on 32 bits on device
+  if (number_of_replicas > static_cast<GGsize>(std::numeric_limits<GGint>::max())) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Number of dose replicas " << number_of_replicas << " is too high, maximum is " << std::numeric_limits<GGint>::max() << "!!!";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetNumberOfDoseReplicas", oss.str());
+  }
+
+  number_of_dose_replicas_ = number_of_replicas;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::SetUncertaintyTarget(GGfloat const& uncertainty, GGfloat const& dose_threshold)
+{
+  if (uncertainty <= 0.0f) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Target of uncertainty has to be positive!!!";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetUncertaintyTarget", oss.str());
+  }
+
+  if (dose_threshold < 0.0f || dose_threshold >= 1.0f) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Dose threshold is a fraction of the maximum dose, it has to be in [0, 1[!!!";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetUncertaintyTarget", oss.str());
+  }
+
+  uncertainty_target_ = uncertainty;
+  uncertainty_dose_threshold_ = dose_threshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::SetUncertaintyROI(GGint const& x_min, GGint const& y_min, GGint const& z_min, GGint const& x_max, GGint const& y_max, GGint const& z_max)
+{
+  if (x_min < 0 || y_min < 0 || z_min < 0 || x_max < x_min || y_max < y_min || z_max < z_min) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Region of uncertainty is not valid, bounds are dosel indices and min <= max!!!";
+    GGEMSMisc::ThrowException("GGEMSDosimetryCalculator", "SetUncertaintyROI", oss.str());
+  }
+
+  uncertainty_roi_min_.x = x_min;
+  uncertainty_roi_min_.y = y_min;
+  uncertainty_roi_min_.z = z_min;
+  uncertainty_roi_max_.x = x_max;
+  uncertainty_roi_max_.y = y_max;
+  uncertainty_roi_max_.z = z_max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+{
+  particle_scale_factor_ = particle_scale_factor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSDosimetryCalculator::CheckParameters(void) const
 {
   if (!navigator_) {
@@ -307,6 +443,63 @@ void GGEMSDosimetryCalculator::InitializeKernel(void)
 
   // Compiling the kernels
   opencl_manager.CompileKernel(compute_dose_filename, "compute_dose_ggems_voxelized_solid", kernel_compute_dose_, nullptr, nullptr);
+
+  // Merging kernel only for replicated maps
+  if (number_of_dose_replicas_ > 1) {
+    kernel_merge_dose_replicas_ = new cl::Kernel*[number_activated_devices_];
+    opencl_manager.CompileKernel(compute_dose_filename, "merge_dose_replicas_ggems_voxelized_solid", kernel_merge_dose_replicas_, nullptr, nullptr);
+  }
+
+  // Reduction kernels only for target of uncertainty
+  if (IsUncertaintyTarget()) {
+    kernel_reduce_maximum_dose_ = new cl::Kernel*[number_activated_devices_];
+    opencl_manager.CompileKernel(compute_dose_filename, "reduce_maximum_dose_ggems_voxelized_solid", kernel_reduce_maximum_dose_, nullptr, nullptr);
+    kernel_reduce_uncertainty_ = new cl::Kernel*[number_activated_devices_];
+    opencl_manager.CompileKernel(compute_dose_filename, "reduce_uncertainty_ggems_voxelized_solid", kernel_reduce_uncertainty_, nullptr, nullptr);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSDosimetryCalculator::MergeDoseReplicas(GGsize const& thread_index)
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSDosimetryCalculator::MergeDoseReplicas in " << device_name << ", index " << device_index;
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(total_number_of_dosels_);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  kernel_merge_dose_replicas_[thread_index]->setArg(0, total_number_of_dosels_);
+  kernel_merge_dose_replicas_[thread_index]->setArg(1, *dose_params_[thread_index]);
+  kernel_merge_dose_replicas_[thread_index]->setArg(2, *dose_recording_.edep_[thread_index]);
+  if (!dose_recording_.hit_[thread_index]) kernel_merge_dose_replicas_[thread_index]->setArg(3, sizeof(cl_mem), NULL);
+  else kernel_merge_dose_replicas_[thread_index]->setArg(3, *dose_recording_.hit_[thread_index]);
+  if (!dose_recording_.edep_squared_[thread_index]) kernel_merge_dose_replicas_[thread_index]->setArg(4, sizeof(cl_mem), NULL);
+  else kernel_merge_dose_replicas_[thread_index]->setArg(4, *dose_recording_.edep_squared_[thread_index]);
+
+  // Launching kernel
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_merge_dose_replicas_[thread_index], 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSDosimetryCalculator", "MergeDoseReplicas");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -326,6 +519,9 @@ void GGEMSDosimetryCalculator::ComputeDose(GGsize const& thread_index)
   std::ostringstream oss(std::ostringstream::out);
   oss << "GGEMSDosimetryCalculator::ComputeDose in " << device_name << ", index " << device_index;
 
+  // Replicated maps are summed in the first map, read by dose computation and outputs
+  if (number_of_dose_replicas_ > 1) MergeDoseReplicas(thread_index);
+
   // Get pointer on OpenCL device for dose parameters
   GGEMSDoseParams* dose_params_device = opencl_manager.GetDeviceBuffer<GGEMSDoseParams>(dose_params_[thread_index], sizeof(GGEMSDoseParams), thread_index);
 
@@ -356,7 +552,7 @@ void GGEMSDosimetryCalculator::ComputeDose(GGsize const& thread_index)
   kernel_compute_dose_[thread_index]->setArg(8, *dose_recording_.dose_[thread_index]);
   if (!dose_recording_.uncertainty_dose_[thread_index]) kernel_compute_dose_[thread_index]->setArg(9, sizeof(cl_mem), NULL);
   else kernel_compute_dose_[thread_index]->setArg(9, *dose_recording_.uncertainty_dose_[thread_index]);
-  kernel_compute_dose_[thread_index]->setArg(10, scale_factor_);
+  kernel_compute_dose_[thread_index]->setArg(10, scale_factor_*particle_scale_factor_);
   kernel_compute_dose_[thread_index]->setArg(11, is_water_reference_);
   kernel_compute_dose_[thread_index]->setArg(12, minimum_density_);
 
@@ -374,12 +570,96 @@ void GGEMSDosimetryCalculator::ComputeDose(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+GGfloat GGEMSDosimetryCalculator::ComputeUncertaintyRatio(GGsize const& thread_index)
+{
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSDosimetryCalculator::ComputeUncertaintyRatio in " << device_name << ", index " << device_index;
+
+  // Dose and uncertainty from deposits recorded so far, dose is computed again at the end of simulation
+  ComputeDose(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = number_of_uncertainty_groups_ * work_group_size;
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Maximum of dose in region
+  kernel_reduce_maximum_dose_[thread_index]->setArg(0, total_number_of_dosels_);
+  kernel_reduce_maximum_dose_[thread_index]->setArg(1, *dose_params_[thread_index]);
+  kernel_reduce_maximum_dose_[thread_index]->setArg(2, *dose_recording_.dose_[thread_index]);
+  kernel_reduce_maximum_dose_[thread_index]->setArg(3, *uncertainty_group_maximum_[thread_index]);
+  kernel_reduce_maximum_dose_[thread_index]->setArg(4, cl::Local(work_group_size*sizeof(GGfloat)));
+
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_reduce_maximum_dose_[thread_index], 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSDosimetryCalculator", "ComputeUncertaintyRatio");
+
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
+
+  GGfloat* group_maximum_device = opencl_manager.GetDeviceBuffer<GGfloat>(uncertainty_group_maximum_[thread_index], number_of_uncertainty_groups_*sizeof(GGfloat), thread_index);
+  GGfloat maximum_dose = 0.0f;
+  for (GGsize i = 0; i < number_of_uncertainty_groups_; ++i) maximum_dose = std::max(maximum_dose, group_maximum_device[i]);
+  opencl_manager.ReleaseDeviceBuffer(uncertainty_group_maximum_[thread_index], group_maximum_device, thread_index);
+
+  // Sum of uncertainties in region above dose threshold
+  kernel_reduce_uncertainty_[thread_index]->setArg(0, total_number_of_dosels_);
+  kernel_reduce_uncertainty_[thread_index]->setArg(1, *dose_params_[thread_index]);
+  kernel_reduce_uncertainty_[thread_index]->setArg(2, *dose_recording_.dose_[thread_index]);
+  kernel_reduce_uncertainty_[thread_index]->setArg(3, *dose_recording_.uncertainty_dose_[thread_index]);
+  kernel_reduce_uncertainty_[thread_index]->setArg(4, uncertainty_dose_threshold_*maximum_dose);
+  kernel_reduce_uncertainty_[thread_index]->setArg(5, *uncertainty_group_sum_[thread_index]);
+  kernel_reduce_uncertainty_[thread_index]->setArg(6, *uncertainty_group_count_[thread_index]);
+  kernel_reduce_uncertainty_[thread_index]->setArg(7, cl::Local(work_group_size*sizeof(GGfloat)));
+  kernel_reduce_uncertainty_[thread_index]->setArg(8, cl::Local(work_group_size*sizeof(GGint)));
+
+  kernel_status = queue->enqueueNDRangeKernel(*kernel_reduce_uncertainty_[thread_index], 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSDosimetryCalculator", "ComputeUncertaintyRatio");
+
+  profiler_manager.HandleEvent(*event, oss.str());
+
+  GGfloat* group_sum_device = opencl_manager.GetDeviceBuffer<GGfloat>(uncertainty_group_sum_[thread_index], number_of_uncertainty_groups_*sizeof(GGfloat), thread_index);
+  GGint* group_count_device = opencl_manager.GetDeviceBuffer<GGint>(uncertainty_group_count_[thread_index], number_of_uncertainty_groups_*sizeof(GGint), thread_index);
+  GGdouble sum_uncertainty = 0.0;
+  GGsize number_of_selected_dosels = 0;
+  for (GGsize i = 0; i < number_of_uncertainty_groups_; ++i) {
+    sum_uncertainty += static_cast<GGdouble>(group_sum_device[i]);
+    number_of_selected_dosels += static_cast<GGsize>(group_count_device[i]);
+  }
+  opencl_manager.ReleaseDeviceBuffer(uncertainty_group_sum_[thread_index], group_sum_device, thread_index);
+  opencl_manager.ReleaseDeviceBuffer(uncertainty_group_count_[thread_index], group_count_device, thread_index);
+
+  // No dose in region yet, uncertainty is 100%
+  GGdouble mean_uncertainty = number_of_selected_dosels > 0 ? sum_uncertainty / static_cast<GGdouble>(number_of_selected_dosels) : 1.0;
+
+  GGcout("GGEMSDosimetryCalculator", "ComputeUncertaintyRatio", 2) << "Mean uncertainty in " << device_name << ": " << mean_uncertainty*100.0 << "% over " << number_of_selected_dosels << " dosels" << GGendl;
+
+  return static_cast<GGfloat>(mean_uncertainty / static_cast<GGdouble>(uncertainty_target_));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSDosimetryCalculator::Initialize(void)
 {
   GGcout("GGEMSDosimetryCalculator", "Initialize", 3) << "Initializing dosimetry calculator..." << GGendl;
 
   CheckParameters();
 
+  // Uncertainty map is needed by target of uncertainty
+  if (IsUncertaintyTarget()) is_uncertainty_ = true;
+
   // Get the OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
@@ -440,31 +720,51 @@ void GGEMSDosimetryCalculator::Initialize(void)
     dose_params_device->slice_number_of_dosels_ = static_cast<GGint>(number_of_dosels.x_ * number_of_dosels.y_);
     total_number_of_dosels_ = number_of_dosels.x_ * number_of_dosels.y_ * number_of_dosels.z_;
     dose_params_device->total_number_of_dosels_ = static_cast<GGint>(total_number_of_dosels_);
+    dose_params_device->number_of_replicas_ = static_cast<GGint>(number_of_dose_replicas_);
+
+    // Region of mean uncertainty, clamped to dose map
+    dose_params_device->roi_min_ = uncertainty_roi_min_;
+    dose_params_device->roi_max_.x = uncertainty_roi_max_.x < 0 ? dose_params_device->number_of_dosels_.x - 1 : std::min(uncertainty_roi_max_.x, dose_params_device->number_of_dosels_.x - 1);
+    dose_params_device->roi_max_.y = uncertainty_roi_max_.y < 0 ? dose_params_device->number_of_dosels_.y - 1 : std::min(uncertainty_roi_max_.y, dose_params_device->number_of_dosels_.y - 1);
+    dose_params_device->roi_max_.z = uncertainty_roi_max_.z < 0 ? dose_params_device->number_of_dosels_.z - 1 : std::min(uncertainty_roi_max_.z, dose_params_device->number_of_dosels_.z - 1);
 
     // Release the pointer
     opencl_manager.ReleaseDeviceBuffer(dose_params_[j], dose_params_device, j);
 
     // Allocated buffers storing dose on OpenCL device
-    dose_recording_.edep_[j] = opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGDosiType), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+    dose_recording_.edep_[j] = opencl_manager.Allocate(nullptr, number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGEdepType), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
     dose_recording_.dose_[j] = opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
 
     dose_recording_.uncertainty_dose_[j] = is_uncertainty_ ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
-    dose_recording_.edep_squared_[j] = (is_edep_squared_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGDosiType), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
-    dose_recording_.hit_[j] = (is_hit_tracking_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
+    dose_recording_.edep_squared_[j] = (is_edep_squared_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGEdepType), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
+    dose_recording_.hit_[j] = (is_hit_tracking_||is_uncertainty_) ? opencl_manager.Allocate(nullptr, number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
 
     dose_recording_.photon_tracking_[j] = is_photon_tracking_ ? opencl_manager.Allocate(nullptr, total_number_of_dosels_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator") : nullptr;
 
     // Set buffer to zero
-    opencl_manager.CleanBuffer(dose_recording_.edep_[j], total_number_of_dosels_*sizeof(GGDosiType), j);
+    opencl_manager.CleanBuffer(dose_recording_.edep_[j], number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGEdepType), j);
     opencl_manager.CleanBuffer(dose_recording_.dose_[j], total_number_of_dosels_*sizeof(GGfloat), j);
 
     if (is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.uncertainty_dose_[j], total_number_of_dosels_*sizeof(GGfloat), j);
-    if (is_edep_squared_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.edep_squared_[j], total_number_of_dosels_*sizeof(GGDosiType), j);
-    if (is_hit_tracking_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.hit_[j], total_number_of_dosels_*sizeof(GGint), j);
+    if (is_edep_squared_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.edep_squared_[j], number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGEdepType), j);
+    if (is_hit_tracking_||is_uncertainty_) opencl_manager.CleanBuffer(dose_recording_.hit_[j], number_of_dose_replicas_*total_number_of_dosels_*sizeof(GGint), j);
 
     if (is_photon_tracking_) opencl_manager.CleanBuffer(dose_recording_.photon_tracking_[j], total_number_of_dosels_*sizeof(GGint), j);
   }
 
+  // Buffers storing reduction of work-groups for mean uncertainty
+  if (IsUncertaintyTarget()) {
+    number_of_uncertainty_groups_ = opencl_manager.GetBestWorkItem(total_number_of_dosels_) / opencl_manager.GetWorkGroupSize();
+    uncertainty_group_maximum_ = new cl::Buffer*[number_activated_devices_];
+    uncertainty_group_sum_ = new cl::Buffer*[number_activated_devices_];
+    uncertainty_group_count_ = new cl::Buffer*[number_activated_devices_];
+    for (GGsize j = 0; j < number_activated_devices_; ++j) {
+      uncertainty_group_maximum_[j] = opencl_manager.Allocate(nullptr, number_of_uncertainty_groups_*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+      uncertainty_group_sum_[j] = opencl_manager.Allocate(nullptr, number_of_uncertainty_groups_*sizeof(GGfloat), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+      uncertainty_group_count_[j] = opencl_manager.Allocate(nullptr, number_of_uncertainty_groups_*sizeof(GGint), j, CL_MEM_READ_WRITE, "GGEMSDosimetryCalculator");
+    }
+  }
+
   InitializeKernel();
 }
 
@@ -559,7 +859,8 @@ void GGEMSDosimetryCalculator::SaveHit(void) const
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
     GGint* hit_device = opencl_manager.GetDeviceBuffer<GGint>(dose_recording_.hit_[j], total_number_of_dosels*sizeof(GGint), j);
 
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) hit_tracking[i] = hit_device[i];
+    // Number of hits extrapolated to planned particles if simulation is stopped before the end
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) hit_tracking[i] = static_cast<GGint>(std::lround(static_cast<GGdouble>(hit_device[i])*particle_scale_factor_));
 
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.hit_[j], hit_device, j);
   }
@@ -602,9 +903,13 @@ void GGEMSDosimetryCalculator::SaveEdep(void) const
 
   // Loop over all activated device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGDosiType* edep_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_[j], total_number_of_dosels*sizeof(GGDosiType), j);
+    GGEdepType* edep_device = opencl_manager.GetDeviceBuffer<GGEdepType>(dose_recording_.edep_[j], total_number_of_dosels*sizeof(GGEdepType), j);
 
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] = edep_device[i];
+    #ifdef DOSIMETRY_FIXED_POINT
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] = static_cast<GGDosiType>(edep_device[i]) * static_cast<GGDosiType>(particle_scale_factor_) / static_cast<GGDosiType>(EDEP_FIXED_POINT_SCALE);
+    #else
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_tracking[i] = edep_device[i] * static_cast<GGDosiType>(particle_scale_factor_);
+    #endif
 
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_[j], edep_device, j);
   }
@@ -647,9 +952,13 @@ void GGEMSDosimetryCalculator::SaveEdepSquared(void) const
 
   // Loop over all activated device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
-    GGDosiType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGDosiType>(dose_recording_.edep_squared_[j], total_number_of_dosels*sizeof(GGDosiType), j);
+    GGEdepType* edep_squared_device = opencl_manager.GetDeviceBuffer<GGEdepType>(dose_recording_.edep_squared_[j], total_number_of_dosels*sizeof(GGEdepType), j);
 
-    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] = edep_squared_device[i];
+    #ifdef DOSIMETRY_FIXED_POINT
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] = static_cast<GGDosiType>(edep_squared_device[i]) * static_cast<GGDosiType>(particle_scale_factor_) / static_cast<GGDosiType>(EDEP_FIXED_POINT_SCALE);
+    #else
+    for (GGsize i = 0; i < total_number_of_dosels; ++i) edep_squared_tracking[i] = edep_squared_device[i] * static_cast<GGDosiType>(particle_scale_factor_);
+    #endif
 
     opencl_manager.ReleaseDeviceBuffer(dose_recording_.edep_squared_[j], edep_squared_device, j);
   }
@@ -862,6 +1171,33 @@ void minimum_density_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calcula
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void set_dose_replicas_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGsize const number_of_replicas)
+{
+  dose_calculator->SetNumberOfDoseReplicas(number_of_replicas);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_uncertainty_target_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGfloat const uncertainty, GGfloat const dose_threshold)
+{
+  dose_calculator->SetUncertaintyTarget(uncertainty, dose_threshold);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_uncertainty_roi_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, GGint const x_min, GGint const y_min, GGint const z_min, GGint const x_max, GGint const y_max, GGint const z_max)
+{
+  dose_calculator->SetUncertaintyROI(x_min, y_min, z_min, x_max, y_max, z_max);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void attach_to_navigator_dosimetry_calculator(GGEMSDosimetryCalculator* dose_calculator, char const* navigator)
 {
   dose_calculator->AttachToNavigator(navigator);
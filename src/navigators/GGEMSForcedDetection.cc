@@ -0,0 +1,595 @@
+// ************************************************************************
+// * This file is part of GGEMS.                                          *
+// *                                                                      *
+// * GGEMS is free software: you can redistribute it and/or modify        *
+// * it under the terms of the GNU General Public License as published by *
+// * the Free Software Foundation, either version 3 of the License, or    *
+// * (at your option) any later version.                                  *
+// *                                                                      *
+// * GGEMS is distributed in the hope that it will be useful,             *
+// * but WITHOUT ANY WARRANTY; without even the implied warranty of       *
+// * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        *
+// * GNU General Public License for more details.                         *
+// *                                                                      *
+// * You should have received a copy of the GNU General Public License    *
+// * along with GGEMS.  If not, see <https://www.gnu.org/licenses/>.      *
+// *                                                                      *
+// ************************************************************************
+
+/*!
+  \file GGEMSForcedDetection.cc
+
+  \brief Class computing the expected projections of a system by forced detection, primary projection by ray tracing and scatter projection at each Compton scattering in phantom
+
+  \author Julien BERT <julien.bert@univ-brest.fr>
+  \author Didier BENOIT <didier.benoit@inserm.fr>
+  \author LaTIM, INSERM - U1101, Brest, FRANCE
+  \version 1.0
+  \date Friday October 16, 2026
+*/
+
+#include "GGEMS/navigators/GGEMSForcedDetection.hh"
+#include "GGEMS/navigators/GGEMSForcedDetectionParams.hh"
+#include "GGEMS/navigators/GGEMSNavigatorManager.hh"
+#include "GGEMS/navigators/GGEMSVoxelizedPhantom.hh"
+#include "GGEMS/navigators/GGEMSSystem.hh"
+#include "GGEMS/geometries/GGEMSSolid.hh"
+#include "GGEMS/geometries/GGEMSSolidBoxData.hh"
+#include "GGEMS/physics/GGEMSCrossSections.hh"
+#include "GGEMS/sources/GGEMSSourceManager.hh"
+#include "GGEMS/sources/GGEMSXRaySource.hh"
+#include "GGEMS/io/GGEMSMHDImage.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSForcedDetection::GGEMSForcedDetection(void)
+: forced_detection_output_filename_("forced_detection"),
+  navigator_(nullptr),
+  detector_name_(""),
+  detector_(nullptr),
+  source_name_(""),
+  source_(nullptr),
+  is_primary_projection_(true),
+  is_scatter_projection_(true),
+  particle_scale_factor_(1.0f),
+  number_of_modules_(0),
+  number_of_pixels_(0),
+  forced_detection_params_(nullptr),
+  detector_data_(nullptr),
+  scatter_projection_(nullptr),
+  primary_projection_(nullptr),
+  kernel_project_primary_(nullptr)
+{
+  GGcout("GGEMSForcedDetection", "GGEMSForcedDetection", 3) << "GGEMSForcedDetection creating..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  // Get the number of activated device
+  number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
+
+  // Checking double precision computation, projections are accumulated as dosimetry
+  #ifdef DOSIMETRY_DOUBLE_PRECISION
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+    if (!opencl_manager.IsDoublePrecisionAtomicAddition(device_index)) {
+      std::ostringstream oss(std::ostringstream::out);
+      oss << "Your OpenCL device: " << opencl_manager.GetDeviceName(device_index) << ", does not support double precision for atomic operation!!!" << std::endl;
+      oss << "Please, recompile with DOSIMETRY_DOUBLE_PRECISION to OFF. Precision will be lost only for dosimetry and forced detection" << std::endl;
+      GGEMSMisc::ThrowException("GGEMSForcedDetection", "GGEMSForcedDetection", oss.str());
+    }
+  }
+  #endif
+
+  GGcout("GGEMSForcedDetection", "GGEMSForcedDetection", 3) << "GGEMSForcedDetection created!!!" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSForcedDetection::~GGEMSForcedDetection(void)
+{
+  GGcout("GGEMSForcedDetection", "~GGEMSForcedDetection", 3) << "GGEMSForcedDetection erasing..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  if (forced_detection_params_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(forced_detection_params_[i], sizeof(GGEMSForcedDetectionParams), i);
+    }
+    delete[] forced_detection_params_;
+    forced_detection_params_ = nullptr;
+  }
+
+  if (detector_data_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(detector_data_[i], number_of_modules_*sizeof(GGEMSSolidBoxData), i);
+    }
+    delete[] detector_data_;
+    detector_data_ = nullptr;
+  }
+
+  if (scatter_projection_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(scatter_projection_[i], number_of_pixels_*sizeof(GGDosiType), i);
+    }
+    delete[] scatter_projection_;
+    scatter_projection_ = nullptr;
+  }
+
+  if (primary_projection_) {
+    opencl_manager.Deallocate(primary_projection_, number_of_pixels_*sizeof(GGDosiType), 0);
+    primary_projection_ = nullptr;
+  }
+
+  if (kernel_project_primary_) {
+    delete[] kernel_project_primary_;
+    kernel_project_primary_ = nullptr;
+  }
+
+  GGcout("GGEMSForcedDetection", "~GGEMSForcedDetection", 3) << "GGEMSForcedDetection erased!!!" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::AttachToNavigator(std::string const& navigator_name)
+{
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+  navigator_ = navigator_manager.GetNavigator(navigator_name);
+
+  // Only Compton scatterings in a voxelized phantom are forced
+  if (!dynamic_cast<GGEMSVoxelizedPhantom*>(navigator_)) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Forced detection has to be attached to a voxelized phantom, " << navigator_name << " is not a voxelized phantom!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "AttachToNavigator", oss.str());
+  }
+
+  // Activate forced detection mode in navigator
+  navigator_->SetForcedDetection(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SetDetector(std::string const& system_name)
+{
+  detector_name_ = system_name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SetSource(std::string const& source_name)
+{
+  source_name_ = source_name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SetOutputForcedDetectionBasename(std::string const& output_filename)
+{
+  forced_detection_output_filename_ = output_filename;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SetPrimaryProjection(bool const& is_activated)
+{
+  is_primary_projection_ = is_activated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SetScatterProjection(bool const& is_activated)
+{
+  is_scatter_projection_ = is_activated;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+{
+  particle_scale_factor_ = particle_scale_factor;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::CheckParameters(void) const
+{
+  if (!navigator_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "A voxelized phantom has to be associated to GGEMSForcedDetection!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "CheckParameters", oss.str());
+  }
+
+  if (detector_name_.empty()) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "A system has to be associated to GGEMSForcedDetection!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "CheckParameters", oss.str());
+  }
+
+  if (is_primary_projection_ && source_name_.empty()) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "An X-ray source has to be associated to GGEMSForcedDetection for primary projection!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "CheckParameters", oss.str());
+  }
+
+  if (!is_primary_projection_ && !is_scatter_projection_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Primary projection or scatter projection has to be activated in GGEMSForcedDetection!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "CheckParameters", oss.str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::InitializeDetectorAndSource(void)
+{
+  GGEMSNavigatorManager& navigator_manager = GGEMSNavigatorManager::GetInstance();
+  detector_ = dynamic_cast<GGEMSSystem*>(navigator_manager.GetNavigator(detector_name_));
+
+  if (!detector_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Detector of forced detection has to be a system, " << detector_name_ << " is not a system!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "InitializeDetectorAndSource", oss.str());
+  }
+
+  if (!is_primary_projection_) return;
+
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  source_ = dynamic_cast<GGEMSXRaySource*>(source_manager.GetSource(source_name_));
+
+  if (!source_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Source of forced detection has to be an X-ray source, " << source_name_ << " is not an X-ray source!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "InitializeDetectorAndSource", oss.str());
+  }
+
+  // Primary projection is traced from a point source to detection elements through the cone of source
+  GGfloat3 focal_spot_size = source_->GetFocalSpotSize();
+  if (focal_spot_size.s[0] != 0.0f || focal_spot_size.s[1] != 0.0f || focal_spot_size.s[2] != 0.0f) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Primary projection of forced detection is only available with a point source, focal spot size of " << source_name_ << " has to be 0!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "InitializeDetectorAndSource", oss.str());
+  }
+
+  if (source_->GetBeamAperture() <= 0.0f) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Primary projection of forced detection is not available with a pencil beam, beam aperture of " << source_name_ << " has to be > 0!!!";
+    GGEMSMisc::ThrowException("GGEMSForcedDetection", "InitializeDetectorAndSource", oss.str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::Initialize(void)
+{
+  GGcout("GGEMSForcedDetection", "Initialize", 3) << "Initializing forced detection..." << GGendl;
+
+  CheckParameters();
+  InitializeDetectorAndSource();
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Layout of detection elements, modules side by side in projection as in system output
+  GGsize2 number_of_modules = detector_->GetNumberOfModules();
+  GGsize3 number_of_elements = detector_->GetNumberOfDetectionElementsInsideModule();
+  number_of_modules_ = detector_->GetNumberOfSolids();
+  number_of_pixels_ = number_of_modules.x_*number_of_elements.x_*number_of_modules.y_*number_of_elements.y_;
+
+  forced_detection_params_ = new cl::Buffer*[number_activated_devices_];
+  detector_data_ = new cl::Buffer*[number_activated_devices_];
+
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    forced_detection_params_[j] = opencl_manager.Allocate(nullptr, sizeof(GGEMSForcedDetectionParams), j, CL_MEM_READ_WRITE, "GGEMSForcedDetection");
+
+    GGEMSForcedDetectionParams* forced_detection_params_device = opencl_manager.GetDeviceBuffer<GGEMSForcedDetectionParams>(forced_detection_params_[j], sizeof(GGEMSForcedDetectionParams), j);
+
+    forced_detection_params_device->number_of_modules_ = static_cast<GGint>(number_of_modules_);
+    forced_detection_params_device->number_of_modules_x_ = static_cast<GGint>(number_of_modules.x_);
+    forced_detection_params_device->number_of_elements_x_ = static_cast<GGint>(number_of_elements.x_);
+    forced_detection_params_device->number_of_elements_y_ = static_cast<GGint>(number_of_elements.y_);
+    forced_detection_params_device->projection_dimension_x_ = static_cast<GGint>(number_of_modules.x_*number_of_elements.x_);
+    forced_detection_params_device->number_of_pixels_ = static_cast<GGint>(number_of_pixels_);
+
+    opencl_manager.ReleaseDeviceBuffer(forced_detection_params_[j], forced_detection_params_device, j);
+
+    // Copy of all module data in a single buffer, modules are static during simulation
+    detector_data_[j] = opencl_manager.Allocate(nullptr, number_of_modules_*sizeof(GGEMSSolidBoxData), j, CL_MEM_READ_WRITE, "GGEMSForcedDetection");
+
+    GGEMSSolidBoxData* detector_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(detector_data_[j], number_of_modules_*sizeof(GGEMSSolidBoxData), j);
+
+    for (GGsize i = 0; i < number_of_modules_; ++i) {
+      GGEMSSolidBoxData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(detector_->GetSolids(i)->GetSolidData(j), sizeof(GGEMSSolidBoxData), j);
+      detector_data_device[i] = *solid_data_device;
+      opencl_manager.ReleaseDeviceBuffer(detector_->GetSolids(i)->GetSolidData(j), solid_data_device, j);
+    }
+
+    opencl_manager.ReleaseDeviceBuffer(detector_data_[j], detector_data_device, j);
+  }
+
+  // Scatter projection on each device, summed at the end of simulation
+  if (is_scatter_projection_) {
+    scatter_projection_ = new cl::Buffer*[number_activated_devices_];
+    for (GGsize j = 0; j < number_activated_devices_; ++j) {
+      scatter_projection_[j] = opencl_manager.Allocate(nullptr, number_of_pixels_*sizeof(GGDosiType), j, CL_MEM_READ_WRITE, "GGEMSForcedDetection");
+      opencl_manager.CleanBuffer(scatter_projection_[j], number_of_pixels_*sizeof(GGDosiType), j);
+    }
+  }
+
+  // Primary projection is deterministic, computed only on first device
+  if (is_primary_projection_) {
+    primary_projection_ = opencl_manager.Allocate(nullptr, number_of_pixels_*sizeof(GGDosiType), 0, CL_MEM_READ_WRITE, "GGEMSForcedDetection");
+    InitializeKernel();
+  }
+
+  GGcout("GGEMSForcedDetection", "Initialize", 2) << "Forced detection: " << number_of_modules_ << " modules, " << number_of_pixels_ << " detection elements" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::InitializeKernel(void)
+{
+  GGcout("GGEMSForcedDetection", "InitializeKernel", 3) << "Initializing kernel for primary projection..." << GGendl;
+
+  // Getting OpenCL manager
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Getting the path to kernel
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string project_primary_filename = openCL_kernel_path + "/ProjectPrimaryGGEMSForcedDetection.cl";
+
+  // Storing a kernel for each device
+  kernel_project_primary_ = new cl::Kernel*[number_activated_devices_];
+
+  // Compiling the kernels
+  opencl_manager.CompileKernel(project_primary_filename, "project_primary_ggems_forced_detection", kernel_project_primary_, nullptr, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+cl::Buffer* GGEMSForcedDetection::GetDetectorCrossSections(GGsize const& thread_index) const
+{
+  return detector_->GetCrossSections()->GetCrossSections(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+cl::Buffer* GGEMSForcedDetection::GetDetectorPhotonCrossSections(GGsize const& thread_index) const
+{
+  return detector_->GetCrossSections()->GetPhotonCrossSections(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::ComputePrimaryProjection(void)
+{
+  // Getting the OpenCL manager and infos for work-item launching, first device only
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(0);
+  cl::Event* event = opencl_manager.GetEvent(0);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(0);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSForcedDetection::ComputePrimaryProjection in " << device_name << ", index " << device_index;
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_pixels_);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  cl::Kernel* kernel = kernel_project_primary_[0];
+  kernel->setArg(0, *forced_detection_params_[0]);
+  kernel->setArg(1, *detector_data_[0]);
+  kernel->setArg(2, *GetDetectorCrossSections(0));
+  kernel->setArg(3, *GetDetectorPhotonCrossSections(0));
+  kernel->setArg(4, *navigator_->GetSolids(0)->GetSolidData(0)); // 1 solid in voxelized phantom
+  kernel->setArg(5, *navigator_->GetSolids(0)->GetLabelData(0));
+  kernel->setArg(6, *navigator_->GetCrossSections()->GetCrossSections(0));
+  kernel->setArg(7, *navigator_->GetCrossSections()->GetPhotonCrossSections(0));
+  kernel->setArg(8, *source_->GetTransformationMatrix(0));
+  kernel->setArg(9, *source_->GetEnergySpectrum(0));
+  kernel->setArg(10, *source_->GetCDF(0));
+  kernel->setArg(11, static_cast<GGint>(source_->GetNumberOfEnergyBins()));
+  kernel->setArg(12, source_->GetBeamAperture());
+  kernel->setArg(13, static_cast<GGfloat>(source_->GetNumberOfParticles()));
+  kernel->setArg(14, *primary_projection_);
+
+  // Launching kernel
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSForcedDetection", "ComputePrimaryProjection");
+  queue->finish();
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SaveResults(void)
+{
+  if (is_primary_projection_) {
+    ComputePrimaryProjection();
+    SavePrimaryProjection();
+  }
+
+  if (is_scatter_projection_) SaveScatterProjection();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SaveProjection(std::string const& suffix, GGDosiType* projection) const
+{
+  GGsize2 number_of_modules = detector_->GetNumberOfModules();
+  GGsize3 number_of_elements = detector_->GetNumberOfDetectionElementsInsideModule();
+
+  GGsize3 dimensions;
+  dimensions.x_ = number_of_modules.x_*number_of_elements.x_;
+  dimensions.y_ = number_of_modules.y_*number_of_elements.y_;
+  dimensions.z_ = 1;
+
+  GGEMSMHDImage mhdImage;
+  mhdImage.SetOutputFileName(forced_detection_output_filename_ + suffix + ".mhd");
+  if (sizeof(GGDosiType) == 4) mhdImage.SetDataType("MET_FLOAT");
+  else if (sizeof(GGDosiType) == 8) mhdImage.SetDataType("MET_DOUBLE");
+  mhdImage.SetDimensions(dimensions);
+  mhdImage.SetElementSizes(detector_->GetSizeOfDetectionElements());
+  mhdImage.Write<GGDosiType>(projection);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SavePrimaryProjection(void) const
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGDosiType* primary = new GGDosiType[number_of_pixels_];
+
+  GGDosiType* primary_device = opencl_manager.GetDeviceBuffer<GGDosiType>(primary_projection_, number_of_pixels_*sizeof(GGDosiType), 0);
+  for (GGsize i = 0; i < number_of_pixels_; ++i) primary[i] = primary_device[i];
+  opencl_manager.ReleaseDeviceBuffer(primary_projection_, primary_device, 0);
+
+  SaveProjection("_primary", primary);
+  delete[] primary;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSForcedDetection::SaveScatterProjection(void) const
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGDosiType* scatter = new GGDosiType[number_of_pixels_];
+  std::memset(scatter, 0, number_of_pixels_*sizeof(GGDosiType));
+
+  // Loop over all activated device
+  for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    GGDosiType* scatter_device = opencl_manager.GetDeviceBuffer<GGDosiType>(scatter_projection_[j], number_of_pixels_*sizeof(GGDosiType), j);
+    for (GGsize i = 0; i < number_of_pixels_; ++i) scatter[i] += scatter_device[i];
+    opencl_manager.ReleaseDeviceBuffer(scatter_projection_[j], scatter_device, j);
+  }
+
+  // Simulation stopped before all particles are simulated
+  for (GGsize i = 0; i < number_of_pixels_; ++i) scatter[i] *= static_cast<GGDosiType>(particle_scale_factor_);
+
+  SaveProjection("_scatter", scatter);
+  delete[] scatter;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGEMSForcedDetection* create_ggems_forced_detection(void)
+{
+  return new(std::nothrow) GGEMSForcedDetection();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void delete_ggems_forced_detection(GGEMSForcedDetection* forced_detection)
+{
+  if (forced_detection) {
+    delete forced_detection;
+    forced_detection = nullptr;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void attach_to_navigator_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* navigator)
+{
+  forced_detection->AttachToNavigator(navigator);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_detector_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* system)
+{
+  forced_detection->SetDetector(system);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_source_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* source)
+{
+  forced_detection->SetSource(source);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_output_ggems_forced_detection(GGEMSForcedDetection* forced_detection, char const* output_filename)
+{
+  forced_detection->SetOutputForcedDetectionBasename(output_filename);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_primary_projection_ggems_forced_detection(GGEMSForcedDetection* forced_detection, bool const is_activated)
+{
+  forced_detection->SetPrimaryProjection(is_activated);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_scatter_projection_ggems_forced_detection(GGEMSForcedDetection* forced_detection, bool const is_activated)
+{
+  forced_detection->SetScatterProjection(is_activated);
+}
@@ -33,6 +33,7 @@
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 #include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
 #include "GGEMS/navigators/GGEMSDosimetryCalculator.hh"
+#include "GGEMS/navigators/GGEMSForcedDetection.hh"
 #include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,7 +50,12 @@ GGEMSNavigator::GGEMSNavigator(std::string const& navigator_name)
   solids_(nullptr),
   number_of_solids_(0),
   dose_calculator_(nullptr),
-  is_dosimetry_mode_(false)
+  is_dosimetry_mode_(false),
+  forced_detection_(nullptr),
+  is_forced_detection_mode_(false),
+  importance_(1.0f),
+  importance_map_filename_(""),
+  is_particle_splitting_(false)
 {
   GGcout("GGEMSNavigator", "GGEMSNavigator", 3) << "GGEMSNavigator creating..." << GGendl;
 
@@ -121,6 +127,25 @@ void GGEMSNavigator::SetDosimetryCalculator(GGEMSDosimetryCalculator* dosimetry_
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSNavigator::SetForcedDetection(GGEMSForcedDetection* forced_detection)
+{
+  forced_detection_ = forced_detection;
+  is_forced_detection_mode_ = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigator::InitializeForcedDetection(void)
+{
+  if (is_forced_detection_mode_) forced_detection_->Initialize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSNavigator::SetPosition(GGfloat const& position_x, GGfloat const& position_y, GGfloat const& position_z, std::string const& unit)
 {
   is_update_pos_ = true;
@@ -235,10 +260,10 @@ void GGEMSNavigator::ParticleSolidDistance(GGsize const& thread_index)
   std::ostringstream oss(std::ostringstream::out);
   oss << "GGEMSNavigator::ParticleSolidDistance on " << device_name << ", index " << device_index;
 
-  // Pointer to primary particles, and number to particles in buffer
+  // Pointer to primary particles, and number of active particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -262,7 +287,6 @@ void GGEMSNavigator::ParticleSolidDistance(GGsize const& thread_index)
     // Launching kernel
     GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ParticleSolidDistance");
-    queue->finish();
 
     // GGEMS Profiling
     GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
@@ -287,10 +311,10 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
   std::ostringstream oss(std::ostringstream::out);
   oss << "GGEMSNavigator::ProjectToSolid on " << device_name << ", index " << device_index;
 
-  // Pointer to primary particles, and number to particles in buffer
+  // Pointer to primary particles, and number of active particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -314,7 +338,6 @@ void GGEMSNavigator::ProjectToSolid(GGsize const& thread_index)
     // Launching kernel
     GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
     opencl_manager.CheckOpenCLError(kernel_status, "GGEMSNavigator", "ProjectToSolid");
-    queue->finish();
 
     // GGEMS Profiling
     GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
@@ -339,16 +362,17 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
   std::ostringstream oss(std::ostringstream::out);
   oss << "GGEMSNavigator::TrackThroughSolid on " << device_name << ", index " << device_index;
 
-  // Pointer to primary particles, and number to particles in buffer
+  // Pointer to primary particles, and number of active particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
 
   // Getting OpenCL pointer to random number
   cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
 
   // Getting OpenCL buffer for cross section
   cl::Buffer* cross_sections = cross_sections_->GetCrossSections(thread_index);
+  cl::Buffer* photon_cross_sections = cross_sections_->GetPhotonCrossSections(thread_index);
 
   // Getting OpenCL buffer for materials
   cl::Buffer* materials = materials_->GetMaterialTables(thread_index);
@@ -380,7 +404,7 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
     cl::Buffer* edep_tracking_dosimetry = nullptr;
     cl::Buffer* edep_squared_tracking_dosimetry = nullptr;
     cl::Buffer* dosimetry_params = nullptr;
-    if (data_reg_type == "HISTOGRAM") {
+    if (data_reg_type == "HISTOGRAM" || data_reg_type == "ENERGY_HISTOGRAM") {
       histogram = solids_[s]->GetHistogram(thread_index);
       scatter_histogram = solids_[s]->GetScatterHistogram(thread_index);
     }
@@ -401,24 +425,43 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
     if (!label_data) kernel->setArg(4, sizeof(cl_mem), NULL);
     else kernel->setArg(4, *label_data); // Useful only for GGEMSVoxelizedSolid
     kernel->setArg(5, *cross_sections);
-    kernel->setArg(6, *materials);
-    kernel->setArg(7, threshold_);
-    if (data_reg_type == "HISTOGRAM") {
-      kernel->setArg(8, *histogram);
-      if (!scatter_histogram) kernel->setArg(9, sizeof(cl_mem), NULL);
-      else kernel->setArg(9, *scatter_histogram);
+    kernel->setArg(6, *photon_cross_sections);
+    kernel->setArg(7, *materials);
+    kernel->setArg(8, threshold_);
+    if (data_reg_type == "HISTOGRAM" || data_reg_type == "ENERGY_HISTOGRAM") {
+      kernel->setArg(9, *histogram);
+      if (!scatter_histogram) kernel->setArg(10, sizeof(cl_mem), NULL);
+      else kernel->setArg(10, *scatter_histogram);
+      if (solids_[s]->GetLocalHistogramSize() > 0) kernel->setArg(11, cl::Local(solids_[s]->GetLocalHistogramSize()));
     }
     else if (data_reg_type == "DOSIMETRY") {
-      kernel->setArg(8, *dosimetry_params);
-      kernel->setArg(9, *edep_tracking_dosimetry);
+      kernel->setArg(9, *dosimetry_params);
+      kernel->setArg(10, *edep_tracking_dosimetry);
+
+      if (!edep_squared_tracking_dosimetry) kernel->setArg(11, sizeof(cl_mem), NULL);
+      else kernel->setArg(11, *edep_squared_tracking_dosimetry);
 
-      if (!edep_squared_tracking_dosimetry) kernel->setArg(10, sizeof(cl_mem), NULL);
-      else kernel->setArg(10, *edep_squared_tracking_dosimetry);
+      if (!hit_tracking_dosimetry) kernel->setArg(12, sizeof(cl_mem), NULL);
+      else kernel->setArg(12, *hit_tracking_dosimetry);
+      if (!photon_tracking_dosimetry) kernel->setArg(13, sizeof(cl_mem), NULL);
+      else kernel->setArg(13, *photon_tracking_dosimetry);
+    }
+
+    // Forced detection arguments follow arguments of dosimetry, then particle splitting arguments
+    cl_uint arg_index = (data_reg_type == "DOSIMETRY") ? 14 : 9;
+    if (is_forced_detection_mode_ && forced_detection_->IsScatterProjection()) {
+      kernel->setArg(arg_index++, *forced_detection_->GetForcedDetectionParams(thread_index));
+      kernel->setArg(arg_index++, *forced_detection_->GetDetectorData(thread_index));
+      kernel->setArg(arg_index++, *forced_detection_->GetDetectorCrossSections(thread_index));
+      kernel->setArg(arg_index++, *forced_detection_->GetDetectorPhotonCrossSections(thread_index));
+      kernel->setArg(arg_index++, *forced_detection_->GetScatterProjection(thread_index));
+    }
 
-      if (!hit_tracking_dosimetry) kernel->setArg(11, sizeof(cl_mem), NULL);
-      else kernel->setArg(11, *hit_tracking_dosimetry);
-      if (!photon_tracking_dosimetry) kernel->setArg(12, sizeof(cl_mem), NULL);
-      else kernel->setArg(12, *photon_tracking_dosimetry);
+    if (is_particle_splitting_) {
+      kernel->setArg(arg_index++, importance_);
+      cl::Buffer* importance_map = solids_[s]->GetImportanceMap(thread_index);
+      if (!importance_map) kernel->setArg(arg_index, sizeof(cl_mem), NULL);
+      else kernel->setArg(arg_index, *importance_map);
     }
 
     // Launching kernel
@@ -428,7 +471,6 @@ void GGEMSNavigator::TrackThroughSolid(GGsize const& thread_index)
     // GGEMS Profiling
     GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
     profiler_manager.HandleEvent(*event, oss.str());
-    queue->finish();
   }
 }
 
@@ -445,6 +487,34 @@ void GGEMSNavigator::ComputeDose(GGsize const& thread_index)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+bool GGEMSNavigator::IsUncertaintyTarget(void) const
+{
+  return is_dosimetry_mode_ && dose_calculator_->IsUncertaintyTarget();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGfloat GGEMSNavigator::ComputeUncertaintyRatio(GGsize const& thread_index)
+{
+  return IsUncertaintyTarget() ? dose_calculator_->ComputeUncertaintyRatio(thread_index) : 0.0f;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigator::SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+{
+  if (is_dosimetry_mode_) dose_calculator_->SetParticleScaleFactor(particle_scale_factor);
+  if (is_forced_detection_mode_) forced_detection_->SetParticleScaleFactor(particle_scale_factor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSNavigator::PrintInfos(void) const
 {
   GGcout("GGEMSNavigator", "PrintInfos", 0) << GGendl;
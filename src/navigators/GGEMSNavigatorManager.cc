@@ -153,6 +153,9 @@ void GGEMSNavigatorManager::Initialize(bool const& is_tracking) const
     if (is_tracking) navigators_[i]->EnableTracking();
     navigators_[i]->Initialize();
   }
+
+  // Forced detection needs the phantom and the system initialized
+  for (GGsize i = 0; i < number_of_navigators_; ++i) navigators_[i]->InitializeForcedDetection();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -197,6 +200,9 @@ void GGEMSNavigatorManager::ProjectToSolid(GGsize const& thread_index) const
 
 void GGEMSNavigatorManager::TrackThroughSolid(GGsize const& thread_index) const
 {
+  // Dead particles receiving copies of split particles, nothing is done without particle splitting
+  GGEMSSourceManager::GetInstance().GetParticles()->ListFreeParticles(thread_index);
+
   for (GGsize i = 0; i < number_of_navigators_; ++i) {
     navigators_[i]->TrackThroughSolid(thread_index);
   }
@@ -222,3 +228,39 @@ void GGEMSNavigatorManager::ComputeDose(GGsize const& thread_index)
     navigators_[i]->ComputeDose(thread_index);
   }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSNavigatorManager::IsUncertaintyTarget(void) const
+{
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    if (navigators_[i]->IsUncertaintyTarget()) return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGfloat GGEMSNavigatorManager::ComputeUncertaintyRatio(GGsize const& thread_index)
+{
+  GGfloat uncertainty_ratio = 0.0f;
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    uncertainty_ratio = std::max(uncertainty_ratio, navigators_[i]->ComputeUncertaintyRatio(thread_index));
+  }
+  return uncertainty_ratio;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSNavigatorManager::SetParticleScaleFactor(GGfloat const& particle_scale_factor)
+{
+  for (GGsize i = 0; i < number_of_navigators_; ++i) {
+    navigators_[i]->SetParticleScaleFactor(particle_scale_factor);
+  }
+}
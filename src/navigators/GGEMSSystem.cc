@@ -29,14 +29,36 @@
 
 #include "GGEMS/navigators/GGEMSSystem.hh"
 #include "GGEMS/geometries/GGEMSSolid.hh"
+#include "GGEMS/geometries/GGEMSSolidBoxData.hh"
 #include "GGEMS/io/GGEMSMHDImage.hh"
+#include "GGEMS/physics/GGEMSCrossSections.hh"
+#include "GGEMS/sources/GGEMSSourceManager.hh"
+#include "GGEMS/randoms/GGEMSPseudoRandomGenerator.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
 GGEMSSystem::GGEMSSystem(std::string const& system_name)
-: GGEMSNavigator(system_name)
+: GGEMSNavigator(system_name),
+  is_local_histogram_(false),
+  detector_response_("counts"),
+  projection_(nullptr),
+  device_projection_(nullptr),
+  kernel_gather_histograms_(nullptr),
+  kernel_add_projection_(nullptr),
+  is_fused_navigation_(false),
+  first_solid_id_(0),
+  fused_solid_data_(nullptr),
+  bvh_nodes_(nullptr),
+  number_of_bvh_nodes_(0),
+  fused_histogram_(nullptr),
+  fused_scatter_histogram_(nullptr),
+  fused_local_histogram_size_(0),
+  kernel_fused_particle_solid_distance_(nullptr),
+  kernel_fused_project_to_solid_(nullptr),
+  kernel_fused_track_through_solid_(nullptr)
 {
   GGcout("GGEMSSystem", "GGEMSSystem", 3) << "GGEMSSystem creating..." << GGendl;
 
@@ -64,6 +86,82 @@ GGEMSSystem::~GGEMSSystem(void)
 {
   GGcout("GGEMSSystem", "~GGEMSSystem", 3) << "GGEMSSystem erasing..." << GGendl;
 
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGsize number_of_elements = number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+
+  if (fused_solid_data_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(fused_solid_data_[i], number_of_solids_*sizeof(GGEMSSolidBoxData), i);
+    }
+    delete[] fused_solid_data_;
+    fused_solid_data_ = nullptr;
+  }
+
+  if (bvh_nodes_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(bvh_nodes_[i], number_of_bvh_nodes_*sizeof(GGEMSBVHNode), i);
+    }
+    delete[] bvh_nodes_;
+    bvh_nodes_ = nullptr;
+  }
+
+  if (fused_histogram_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(fused_histogram_[i], number_of_solids_*number_of_elements*GetHistogramElementSize(), i);
+    }
+    delete[] fused_histogram_;
+    fused_histogram_ = nullptr;
+  }
+
+  if (fused_scatter_histogram_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      if (fused_scatter_histogram_[i]) opencl_manager.Deallocate(fused_scatter_histogram_[i], number_of_solids_*number_of_elements*GetHistogramElementSize(), i);
+    }
+    delete[] fused_scatter_histogram_;
+    fused_scatter_histogram_ = nullptr;
+  }
+
+  GGsize number_of_pixels = number_of_modules_xy_.x_*number_of_modules_xy_.y_*number_of_elements;
+
+  if (projection_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(projection_[i], number_of_pixels*sizeof(GGulong), i);
+    }
+    delete[] projection_;
+    projection_ = nullptr;
+  }
+
+  if (device_projection_) {
+    opencl_manager.Deallocate(device_projection_, number_of_pixels*sizeof(GGulong), 0);
+    device_projection_ = nullptr;
+  }
+
+  if (kernel_gather_histograms_) {
+    delete[] kernel_gather_histograms_;
+    kernel_gather_histograms_ = nullptr;
+  }
+
+  if (kernel_add_projection_) {
+    delete[] kernel_add_projection_;
+    kernel_add_projection_ = nullptr;
+  }
+
+  if (kernel_fused_particle_solid_distance_) {
+    delete[] kernel_fused_particle_solid_distance_;
+    kernel_fused_particle_solid_distance_ = nullptr;
+  }
+
+  if (kernel_fused_project_to_solid_) {
+    delete[] kernel_fused_project_to_solid_;
+    kernel_fused_project_to_solid_ = nullptr;
+  }
+
+  if (kernel_fused_track_through_solid_) {
+    delete[] kernel_fused_track_through_solid_;
+    kernel_fused_track_through_solid_ = nullptr;
+  }
+
   GGcout("GGEMSSystem", "~GGEMSSystem", 3) << "GGEMSSystem erased!!!" << GGendl;
 }
 
@@ -121,6 +219,43 @@ void GGEMSSystem::StoreScatter(bool const& is_scatter)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSSystem::SetFusedNavigation(bool const& is_fused_navigation)
+{
+  is_fused_navigation_ = is_fused_navigation;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::SetLocalHistogram(bool const& is_local_histogram)
+{
+  is_local_histogram_ = is_local_histogram;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::SetDetectorResponse(std::string const& detector_response)
+{
+  detector_response_ = detector_response;
+
+  // Transform string to low letter
+  std::transform(detector_response_.begin(), detector_response_.end(), detector_response_.begin(), ::tolower);
+
+  // Checking the detector response
+  if (detector_response_ != "counts" && detector_response_ != "energy") {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Available detector responses: 'counts' or 'energy'";
+    GGEMSMisc::ThrowException("GGEMSSystem", "SetDetectorResponse", oss.str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSSystem::CheckParameters(void) const
 {
   GGcout("GGEMSSystem", "CheckParameters", 3) << "Checking the mandatory parameters..." << GGendl;
@@ -149,6 +284,20 @@ void GGEMSSystem::CheckParameters(void) const
     GGEMSMisc::ThrowException("GGEMSSystem", "CheckParameters", oss.str());
   }
 
+  // Deposited energy is accumulated with int64 atomic operations
+  if (detector_response_ == "energy") {
+    GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+      if (!opencl_manager.IsDoublePrecisionAtomicAddition(device_index)) {
+        std::ostringstream oss(std::ostringstream::out);
+        oss << "Your OpenCL device: " << opencl_manager.GetDeviceName(device_index) << ", does not support int64 atomic operation!!!" << std::endl;
+        oss << "Please, use the 'counts' detector response.";
+        GGEMSMisc::ThrowException("GGEMSSystem", "CheckParameters", oss.str());
+      }
+    }
+  }
+
   GGEMSNavigator::CheckParameters();
 }
 
@@ -160,49 +309,154 @@ void GGEMSSystem::SaveResults(void)
 {
   GGcout("GGEMSSystem", "SaveResults", 2) << "Saving results in MHD format..." << GGendl;
 
-  GGsize3 total_dim;
-  total_dim.x_ = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_;
-  total_dim.y_ = number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_;
-  total_dim.z_ = number_of_detection_elements_inside_module_xyz_.z_;
+  GGsize number_of_pixels = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_*number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+
+  GGulong* output = new GGulong[number_of_pixels];
+  ReduceProjection(output, false);
+
+  GGulong* scatter_output = nullptr;
+  if (is_scatter_) {
+    scatter_output = new GGulong[number_of_pixels];
+    ReduceProjection(scatter_output, true);
+  }
+
+  WriteProjections(output, scatter_output, 1);
 
+  delete[] output;
+  if (scatter_output) delete[] scatter_output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::ReduceProjection(GGulong* output, bool const& is_scatter)
+{
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
-  GGint* output = new GGint[total_dim.x_*total_dim.y_*total_dim.z_];
-  std::memset(output, 0, total_dim.x_*total_dim.y_*total_dim.z_*sizeof(GGint));
 
-  GGEMSMHDImage mhdImage;
-  mhdImage.SetOutputFileName(output_basename_);
-  mhdImage.SetDataType("MET_INT");
-  mhdImage.SetDimensions(total_dim);
-  mhdImage.SetElementSizes(size_of_detection_elements_xyz_);
+  GGsize number_of_pixels = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_*number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+  GGsize number_of_elements = number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+  GGsize number_of_elements_xy = number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_;
 
-  // Getting all the counts from solid from all OpenCL devices
-  for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    for (GGsize jj = 0; jj < number_of_modules_xy_.y_; ++jj) {
-      for (GGsize ii = 0; ii < number_of_modules_xy_.x_; ++ii) {
-        cl::Buffer* histogram = solids_[ii + jj* number_of_modules_xy_.x_]->GetHistogram(i);
+  // In fused navigation, histograms of all modules are stored in a single buffer and gathered in one launch
+  GGsize number_of_launches = is_fused_navigation_ ? 1 : number_of_solids_;
+  GGsize number_of_modules_by_launch = is_fused_navigation_ ? number_of_solids_ : 1;
 
-        GGint* histogram_device = opencl_manager.GetDeviceBuffer<GGint>(histogram, number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*sizeof(GGint), i);
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
 
-        // Storing data on host
-        for (GGsize jjj = 0; jjj < number_of_detection_elements_inside_module_xyz_.y_; ++jjj) {
-          for (GGsize iii = 0; iii < number_of_detection_elements_inside_module_xyz_.x_; ++iii) {
-            output[(iii+ii*number_of_detection_elements_inside_module_xyz_.x_) + (jjj+jj*number_of_detection_elements_inside_module_xyz_.y_)*total_dim.x_] +=
-              histogram_device[iii + jjj*number_of_detection_elements_inside_module_xyz_.x_];
-          }
-        }
+  // Histograms of modules gathered in projection of each device
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(d);
+    cl::Event* event = opencl_manager.GetEvent(d);
+
+    // Get Device name and storing methode name + device
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(d);
+    std::string device_name = opencl_manager.GetDeviceName(device_index);
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "GGEMSSystem::ReduceProjection on " << device_name << ", index " << device_index;
+
+    // Parameters for work-item in kernel
+    GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_modules_by_launch*number_of_elements_xy);
+    cl::NDRange global_wi(number_of_work_items);
+    cl::NDRange local_wi(work_group_size);
+
+    cl::Kernel* kernel = kernel_gather_histograms_[d];
+    kernel->setArg(0, static_cast<GGint>(number_of_modules_by_launch));
+    kernel->setArg(2, static_cast<GGint>(number_of_modules_xy_.x_));
+    kernel->setArg(3, static_cast<GGint>(number_of_detection_elements_inside_module_xyz_.x_));
+    kernel->setArg(4, static_cast<GGint>(number_of_detection_elements_inside_module_xyz_.y_));
+    kernel->setArg(5, static_cast<GGint>(number_of_elements));
+    kernel->setArg(7, *projection_[d]);
+
+    for (GGsize i = 0; i < number_of_launches; ++i) {
+      cl::Buffer* histogram = nullptr;
+      if (is_fused_navigation_) histogram = is_scatter ? fused_scatter_histogram_[d] : fused_histogram_[d];
+      else histogram = is_scatter ? solids_[i]->GetScatterHistogram(d) : solids_[i]->GetHistogram(d);
+
+      kernel->setArg(1, static_cast<GGint>(i));
+      kernel->setArg(6, *histogram);
+
+      // Launching kernel
+      GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
+      opencl_manager.CheckOpenCLError(kernel_status, "GGEMSSystem", "ReduceProjection");
+
+      // GGEMS Profiling
+      profiler_manager.HandleEvent(*event, oss.str());
+    }
+  }
+
+  // Projections of other devices are copied on the first device and added there. The copy stays on devices if they share the context of first device, otherwise it is staged on host
+  if (number_activated_devices_ > 1) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(0);
+    cl::Event* event = opencl_manager.GetEvent(0);
+
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(0);
+    std::string device_name = opencl_manager.GetDeviceName(device_index);
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "GGEMSSystem::ReduceProjection on " << device_name << ", index " << device_index;
+
+    GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_pixels);
+    cl::NDRange global_wi(number_of_work_items);
+    cl::NDRange local_wi(work_group_size);
+
+    cl::Kernel* kernel = kernel_add_projection_[0];
+    kernel->setArg(0, static_cast<GGint>(number_of_pixels));
+    kernel->setArg(1, *device_projection_);
+    kernel->setArg(2, *projection_[0]);
+
+    for (GGsize d = 1; d < number_activated_devices_; ++d) {
+      if (opencl_manager.GetContextOwner(d) == opencl_manager.GetContextOwner(0)) {
+        // Projection of device has to be gathered before the copy on queue of first device
+        opencl_manager.GetCommandQueue(d)->finish();
+
+        GGint copy_status = queue->enqueueCopyBuffer(*projection_[d], *device_projection_, 0, 0, number_of_pixels*sizeof(GGulong), nullptr, event);
+        opencl_manager.CheckOpenCLError(copy_status, "GGEMSSystem", "ReduceProjection");
+
+        // GGEMS Profiling
+        profiler_manager.HandleEvent(*event, oss.str());
+      }
+      else {
+        GGulong* projection_device = opencl_manager.GetDeviceBuffer<GGulong>(projection_[d], number_of_pixels*sizeof(GGulong), d);
+        GGulong* device_projection_device = opencl_manager.GetDeviceBuffer<GGulong>(device_projection_, number_of_pixels*sizeof(GGulong), 0);
 
-        opencl_manager.ReleaseDeviceBuffer(histogram, histogram_device, i);
+        std::memcpy(device_projection_device, projection_device, number_of_pixels*sizeof(GGulong));
+
+        opencl_manager.ReleaseDeviceBuffer(device_projection_, device_projection_device, 0);
+        opencl_manager.ReleaseDeviceBuffer(projection_[d], projection_device, d);
       }
+
+      // Launching kernel
+      GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
+      opencl_manager.CheckOpenCLError(kernel_status, "GGEMSSystem", "ReduceProjection");
+
+      // GGEMS Profiling
+      profiler_manager.HandleEvent(*event, oss.str());
     }
   }
 
-  mhdImage.Write<GGint>(output);
+  // Reading projection of system
+  GGulong* projection_device = opencl_manager.GetDeviceBuffer<GGulong>(projection_[0], number_of_pixels*sizeof(GGulong), 0);
+  std::memcpy(output, projection_device, number_of_pixels*sizeof(GGulong));
+  opencl_manager.ReleaseDeviceBuffer(projection_[0], projection_device, 0);
+}
 
-  // Cleaning output buffer
-  std::memset(output, 0, total_dim.x_*total_dim.y_*total_dim.z_*sizeof(GGint));
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::WriteProjections(GGulong const* output, GGulong const* scatter_output, GGsize const& number_of_views) const
+{
+  // Projections of views are stacked along Z
+  GGsize3 total_dim;
+  total_dim.x_ = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_;
+  total_dim.y_ = number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_;
+  total_dim.z_ = number_of_detection_elements_inside_module_xyz_.z_*number_of_views;
+
+  WriteProjection(output_basename_, output, total_dim);
 
   // If scatter output if necessary
-  if (is_scatter_) {
+  if (scatter_output) {
     // From output file add '-scatter' extension
     std::string scatter_output_filename = output_basename_;
 
@@ -216,35 +470,577 @@ void GGEMSSystem::SaveResults(void)
       scatter_output_filename = scatter_output_filename.substr(0, found_mhd) + "-scatter.mhd";
     }
 
-    GGEMSMHDImage mhdImageScatter;
-    mhdImageScatter.SetOutputFileName(scatter_output_filename);
-    mhdImageScatter.SetDataType("MET_INT");
-    mhdImageScatter.SetDimensions(total_dim);
-    mhdImageScatter.SetElementSizes(size_of_detection_elements_xyz_);
+    WriteProjection(scatter_output_filename, scatter_output, total_dim);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-    // Getting all the counts from solid from all OpenCL devices
-    for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      for (GGsize jj = 0; jj < number_of_modules_xy_.y_; ++jj) {
-        for (GGsize ii = 0; ii < number_of_modules_xy_.x_; ++ii) {
-          cl::Buffer* scatter_histogram = solids_[ii + jj* number_of_modules_xy_.x_]->GetScatterHistogram(i);
-
-          GGint* scatter_histogram_device = opencl_manager.GetDeviceBuffer<GGint>(scatter_histogram, number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*sizeof(GGint), i);
-
-          // Storing data on host
-          for (GGsize jjj = 0; jjj < number_of_detection_elements_inside_module_xyz_.y_; ++jjj) {
-            for (GGsize iii = 0; iii < number_of_detection_elements_inside_module_xyz_.x_; ++iii) {
-              output[(iii+ii*number_of_detection_elements_inside_module_xyz_.x_) + (jjj+jj*number_of_detection_elements_inside_module_xyz_.y_)*total_dim.x_] +=
-                scatter_histogram_device[iii + jjj*number_of_detection_elements_inside_module_xyz_.x_];
-            }
+void GGEMSSystem::WriteProjection(std::string const& filename, GGulong const* projection, GGsize3 const& dimensions) const
+{
+  GGsize number_of_pixels = dimensions.x_*dimensions.y_*dimensions.z_;
+
+  GGEMSMHDImage mhdImage;
+  mhdImage.SetOutputFileName(filename);
+  mhdImage.SetDimensions(dimensions);
+  mhdImage.SetElementSizes(size_of_detection_elements_xyz_);
+
+  if (detector_response_ == "energy") { // Deposited energy in MeV
+    GGfloat* energy = new GGfloat[number_of_pixels];
+    for (GGsize i = 0; i < number_of_pixels; ++i) energy[i] = static_cast<GGfloat>(static_cast<GGdouble>(projection[i]) / static_cast<GGdouble>(EDEP_FIXED_POINT_SCALE));
+
+    mhdImage.SetDataType("MET_FLOAT");
+    mhdImage.Write<GGfloat>(energy);
+    delete[] energy;
+  }
+  else { // Number of interactions
+    GGulong maximum_count = *std::max_element(projection, projection + number_of_pixels);
+
+    if (maximum_count > static_cast<GGulong>(std::numeric_limits<GGint>::max())) { // Counts above 32 bits are exact in double precision up to 2^53
+      GGwarn("GGEMSSystem", "WriteProjection", 0) << "Maximum count " << maximum_count << " of " << filename << " is higher than " << std::numeric_limits<GGint>::max() << ", projection is written in MET_DOUBLE!!!" << GGendl;
+
+      GGdouble* counts = new GGdouble[number_of_pixels];
+      for (GGsize i = 0; i < number_of_pixels; ++i) counts[i] = static_cast<GGdouble>(projection[i]);
+
+      mhdImage.SetDataType("MET_DOUBLE");
+      mhdImage.Write<GGdouble>(counts);
+      delete[] counts;
+    }
+    else {
+      GGint* counts = new GGint[number_of_pixels];
+      for (GGsize i = 0; i < number_of_pixels; ++i) counts[i] = static_cast<GGint>(projection[i]);
+
+      mhdImage.SetDataType("MET_INT");
+      mhdImage.Write<GGint>(counts);
+      delete[] counts;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::SetViewTransformation(GGfloat44 const& matrix_view)
+{
+  for (GGsize i = 0; i < number_of_solids_; ++i) solids_[i]->SetViewTransformation(matrix_view);
+
+  // Modules moved, copy of module data and BVH are rebuilt
+  if (is_fused_navigation_) UpdateFusedNavigation();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::StoreView(GGsize const& view_index, GGsize const& number_of_views)
+{
+  GGcout("GGEMSSystem", "StoreView", 2) << "Storing projection of view " << view_index << "/" << number_of_views << "..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGsize number_of_pixels = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_*number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+
+  // Stacked projections are allocated at the first view
+  if (view_index == 0) {
+    scan_projections_.assign(number_of_pixels*number_of_views, 0);
+    if (is_scatter_) scan_scatter_projections_.assign(number_of_pixels*number_of_views, 0);
+  }
+
+  ReduceProjection(&scan_projections_[view_index*number_of_pixels], false);
+  if (is_scatter_) ReduceProjection(&scan_scatter_projections_[view_index*number_of_pixels], true);
+
+  // Histograms are cleared for the next view
+  GGsize number_of_elements = number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    for (GGsize i = 0; i < number_of_solids_; ++i) {
+      opencl_manager.CleanBuffer(solids_[i]->GetHistogram(d), number_of_elements*GetHistogramElementSize(), d);
+      if (is_scatter_) opencl_manager.CleanBuffer(solids_[i]->GetScatterHistogram(d), number_of_elements*GetHistogramElementSize(), d);
+    }
+
+    if (is_fused_navigation_) {
+      opencl_manager.CleanBuffer(fused_histogram_[d], number_of_solids_*number_of_elements*GetHistogramElementSize(), d);
+      if (fused_scatter_histogram_[d]) opencl_manager.CleanBuffer(fused_scatter_histogram_[d], number_of_solids_*number_of_elements*GetHistogramElementSize(), d);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::SaveScanResults(void)
+{
+  GGcout("GGEMSSystem", "SaveScanResults", 2) << "Saving stacked projections in MHD format..." << GGendl;
+
+  GGsize number_of_pixels = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_*number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+
+  if (scan_projections_.empty()) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "No projection stored for system '" << navigator_name_ << "'!!!";
+    GGEMSMisc::ThrowException("GGEMSSystem", "SaveScanResults", oss.str());
+  }
+
+  WriteProjections(scan_projections_.data(), is_scatter_ ? scan_scatter_projections_.data() : nullptr, scan_projections_.size()/number_of_pixels);
+
+  // Memory of stacked projections is released
+  std::vector<GGulong>().swap(scan_projections_);
+  std::vector<GGulong>().swap(scan_scatter_projections_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::ParticleSolidDistance(GGsize const& thread_index)
+{
+  if (!is_fused_navigation_) {
+    GGEMSNavigator::ParticleSolidDistance(thread_index);
+    return;
+  }
+
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSSystem::ParticleSolidDistance on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number of active particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  cl::Kernel* kernel = kernel_fused_particle_solid_distance_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  kernel->setArg(1, *primary_particles);
+  kernel->setArg(2, *fused_solid_data_[thread_index]);
+  kernel->setArg(3, *bvh_nodes_[thread_index]);
+
+  // Launching kernel
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSSystem", "ParticleSolidDistance");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::ProjectToSolid(GGsize const& thread_index)
+{
+  if (!is_fused_navigation_) {
+    GGEMSNavigator::ProjectToSolid(thread_index);
+    return;
+  }
+
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSSystem::ProjectToSolid on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number of active particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  cl::Kernel* kernel = kernel_fused_project_to_solid_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  kernel->setArg(1, *primary_particles);
+  kernel->setArg(2, *fused_solid_data_[thread_index]);
+  kernel->setArg(3, first_solid_id_);
+  kernel->setArg(4, static_cast<GGint>(number_of_solids_));
+
+  // Launching kernel
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSSystem", "ProjectToSolid");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::TrackThroughSolid(GGsize const& thread_index)
+{
+  if (!is_fused_navigation_) {
+    GGEMSNavigator::TrackThroughSolid(thread_index);
+    return;
+  }
+
+  // Getting the OpenCL manager and infos for work-item launching
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSSystem::TrackThroughSolid on " << device_name << ", index " << device_index;
+
+  // Pointer to primary particles, and number of active particles in buffer
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
+
+  // Getting OpenCL pointer to random number
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
+
+  // Getting OpenCL buffer for cross section
+  cl::Buffer* cross_sections = cross_sections_->GetCrossSections(thread_index);
+  cl::Buffer* photon_cross_sections = cross_sections_->GetPhotonCrossSections(thread_index);
+
+  // Getting OpenCL buffer for materials
+  cl::Buffer* materials = materials_->GetMaterialTables(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Getting kernel, and setting parameters
+  cl::Kernel* kernel = kernel_fused_track_through_solid_[thread_index];
+  kernel->setArg(0, number_of_particles);
+  kernel->setArg(1, *primary_particles);
+  kernel->setArg(2, *randoms);
+  kernel->setArg(3, *fused_solid_data_[thread_index]);
+  kernel->setArg(4, first_solid_id_);
+  kernel->setArg(5, static_cast<GGint>(number_of_solids_));
+  kernel->setArg(6, *cross_sections);
+  kernel->setArg(7, *photon_cross_sections);
+  kernel->setArg(8, *materials);
+  kernel->setArg(9, threshold_);
+  kernel->setArg(10, *fused_histogram_[thread_index]);
+  if (!fused_scatter_histogram_[thread_index]) kernel->setArg(11, sizeof(cl_mem), NULL);
+  else kernel->setArg(11, *fused_scatter_histogram_[thread_index]);
+  if (fused_local_histogram_size_ > 0) kernel->setArg(12, cl::Local(fused_local_histogram_size_));
+
+  // Launching kernel
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel, 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSSystem", "TrackThroughSolid");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGint GGEMSSystem::BuildBVHNode(std::vector<GGEMSBVHNode>& bvh_nodes, GGint* solid_index, GGsize const& first, GGsize const& last, GGfloat3 const* solid_border_min, GGfloat3 const* solid_border_max, GGsize const& depth)
+{
+  if (depth >= BVH_MAXIMUM_DEPTH) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Maximum depth of BVH reached: " << BVH_MAXIMUM_DEPTH << "!!!";
+    GGEMSMisc::ThrowException("GGEMSSystem", "BuildBVHNode", oss.str());
+  }
+
+  GGint node_index = static_cast<GGint>(bvh_nodes.size());
+  bvh_nodes.push_back(GGEMSBVHNode());
+
+  // Bounding box of node and bounding box of solid centers
+  GGEMSBVHNode node;
+  GGfloat3 center_min, center_max;
+  for (GGint a = 0; a < 3; ++a) {
+    node.border_min_xyz_.s[a] = OUT_OF_WORLD;
+    node.border_max_xyz_.s[a] = -OUT_OF_WORLD;
+    center_min.s[a] = OUT_OF_WORLD;
+    center_max.s[a] = -OUT_OF_WORLD;
+  }
+
+  for (GGsize i = first; i < last; ++i) {
+    GGint s = solid_index[i];
+    for (GGint a = 0; a < 3; ++a) {
+      node.border_min_xyz_.s[a] = std::min(node.border_min_xyz_.s[a], solid_border_min[s].s[a]);
+      node.border_max_xyz_.s[a] = std::max(node.border_max_xyz_.s[a], solid_border_max[s].s[a]);
+      GGfloat center = 0.5f*(solid_border_min[s].s[a]+solid_border_max[s].s[a]);
+      center_min.s[a] = std::min(center_min.s[a], center);
+      center_max.s[a] = std::max(center_max.s[a], center);
+    }
+  }
+
+  // Leaf
+  if (last - first <= BVH_MAXIMUM_SOLIDS_PER_LEAF) {
+    node.child_index_[0] = -1;
+    node.child_index_[1] = -1;
+    node.number_of_solids_ = static_cast<GGint>(last - first);
+    for (GGint i = 0; i < BVH_MAXIMUM_SOLIDS_PER_LEAF; ++i) {
+      node.solid_index_[i] = (i < node.number_of_solids_) ? solid_index[first+static_cast<GGsize>(i)] : -1;
+    }
+    bvh_nodes[static_cast<GGsize>(node_index)] = node;
+    return node_index;
+  }
+
+  // Splitting at median along largest axis of centers
+  GGint axis = 0;
+  GGfloat largest_extent = center_max.s[0] - center_min.s[0];
+  for (GGint a = 1; a < 3; ++a) {
+    if (center_max.s[a] - center_min.s[a] > largest_extent) {
+      largest_extent = center_max.s[a] - center_min.s[a];
+      axis = a;
+    }
+  }
+
+  GGsize middle = (first + last) / 2;
+  std::nth_element(solid_index + first, solid_index + middle, solid_index + last,
+    [&](GGint const& s0, GGint const& s1) {
+      return solid_border_min[s0].s[axis]+solid_border_max[s0].s[axis] < solid_border_min[s1].s[axis]+solid_border_max[s1].s[axis];
+    }
+  );
+
+  node.number_of_solids_ = 0;
+  for (GGint i = 0; i < BVH_MAXIMUM_SOLIDS_PER_LEAF; ++i) node.solid_index_[i] = -1;
+  node.child_index_[0] = BuildBVHNode(bvh_nodes, solid_index, first, middle, solid_border_min, solid_border_max, depth+1);
+  node.child_index_[1] = BuildBVHNode(bvh_nodes, solid_index, middle, last, solid_border_min, solid_border_max, depth+1);
+  bvh_nodes[static_cast<GGsize>(node_index)] = node;
+
+  return node_index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::InitializeFusedNavigation(GGsize const& first_solid_id)
+{
+  GGcout("GGEMSSystem", "InitializeFusedNavigation", 3) << "Initializing fused navigation for " << number_of_solids_ << " modules..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  first_solid_id_ = static_cast<GGint>(first_solid_id);
+
+  // Copy of module data and BVH over modules
+  UpdateFusedNavigation();
+
+  // Allocating fused histograms on each device
+  GGsize number_of_elements = number_of_detection_elements_inside_module_xyz_.x_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+  fused_histogram_ = new cl::Buffer*[number_activated_devices_];
+  fused_scatter_histogram_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    fused_histogram_[d] = opencl_manager.Allocate(nullptr, number_of_solids_*number_of_elements*GetHistogramElementSize(), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+    opencl_manager.CleanBuffer(fused_histogram_[d], number_of_solids_*number_of_elements*GetHistogramElementSize(), d);
+
+    fused_scatter_histogram_[d] = nullptr;
+    if (is_scatter_) {
+      fused_scatter_histogram_[d] = opencl_manager.Allocate(nullptr, number_of_solids_*number_of_elements*GetHistogramElementSize(), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+      opencl_manager.CleanBuffer(fused_scatter_histogram_[d], number_of_solids_*number_of_elements*GetHistogramElementSize(), d);
+    }
+  }
+
+  // Compiling fused kernels
+  kernel_fused_particle_solid_distance_ = new cl::Kernel*[number_activated_devices_];
+  kernel_fused_project_to_solid_ = new cl::Kernel*[number_activated_devices_];
+  kernel_fused_track_through_solid_ = new cl::Kernel*[number_activated_devices_];
+
+  std::string kernel_option = " -DHISTOGRAM";
+  if (detector_response_ == "energy") kernel_option += " -DENERGY_INTEGRATING";
+  if (is_tracking_) kernel_option += " -DGGEMS_TRACKING";
+
+  // Histograms of all modules in local memory, only for small systems
+  if (is_local_histogram_) {
+    GGsize local_histogram_size = number_of_solids_*number_of_elements*GetHistogramElementSize();
+    if (is_scatter_) local_histogram_size *= 2;
+
+    bool is_local_histogram_fit = true;
+    for (GGsize d = 0; d < number_activated_devices_; ++d) {
+      if (local_histogram_size > opencl_manager.GetLocalMemorySize(opencl_manager.GetIndexOfActivatedDevice(d))) is_local_histogram_fit = false;
+    }
+
+    if (is_local_histogram_fit) {
+      fused_local_histogram_size_ = local_histogram_size;
+      kernel_option += " -DLOCAL_HISTOGRAM";
+    }
+    else {
+      GGcout("GGEMSSystem", "InitializeFusedNavigation", 1) << "Histograms of all modules (" << local_histogram_size << " bytes) do not fit in local memory, histograms are accumulated in global memory" << GGendl;
+    }
+  }
+
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string particle_solid_distance_filename = openCL_kernel_path + "/ParticleSolidDistanceGGEMSSolidBox.cl";
+  std::string project_to_filename = openCL_kernel_path + "/ProjectToGGEMSSolidBox.cl";
+  std::string track_through_filename = openCL_kernel_path + "/TrackThroughGGEMSSolidBox.cl";
+
+  opencl_manager.CompileKernel(particle_solid_distance_filename, "particle_solid_distance_ggems_solid_boxes", kernel_fused_particle_solid_distance_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  opencl_manager.CompileKernel(project_to_filename, "project_to_ggems_solid_boxes", kernel_fused_project_to_solid_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_solid_boxes", kernel_fused_track_through_solid_, nullptr, const_cast<char*>(kernel_option.c_str()));
+
+  // Local memory used by tracking kernel itself is known once compiled, histograms go back to global memory if they do not fit with it
+  if (fused_local_histogram_size_ > 0) {
+    for (GGsize d = 0; d < number_activated_devices_; ++d) {
+      GGsize kernel_local_memory_size = opencl_manager.GetKernelLocalMemorySize(kernel_fused_track_through_solid_[d], d);
+      if (fused_local_histogram_size_ + kernel_local_memory_size > opencl_manager.GetLocalMemorySize(opencl_manager.GetIndexOfActivatedDevice(d))) {
+        GGcout("GGEMSSystem", "InitializeFusedNavigation", 1) << "Histograms of all modules (" << fused_local_histogram_size_ << " bytes) and " << kernel_local_memory_size << " bytes used by kernel do not fit in local memory, histograms are accumulated in global memory" << GGendl;
+
+        fused_local_histogram_size_ = 0;
+        kernel_option.erase(kernel_option.find(" -DLOCAL_HISTOGRAM"), std::string(" -DLOCAL_HISTOGRAM").size());
+        opencl_manager.CompileKernel(track_through_filename, "track_through_ggems_solid_boxes", kernel_fused_track_through_solid_, nullptr, const_cast<char*>(kernel_option.c_str()));
+        break;
+      }
+    }
+  }
+
+  GGcout("GGEMSSystem", "InitializeFusedNavigation", 2) << "Fused navigation: " << number_of_solids_ << " modules, " << number_of_bvh_nodes_ << " BVH nodes" << GGendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::InitializeProjection(void)
+{
+  GGcout("GGEMSSystem", "InitializeProjection", 3) << "Initializing reduction of histograms..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGsize number_of_pixels = number_of_modules_xy_.x_*number_of_detection_elements_inside_module_xyz_.x_*number_of_modules_xy_.y_*number_of_detection_elements_inside_module_xyz_.y_*number_of_detection_elements_inside_module_xyz_.z_;
+
+  // 64-bit projection on each device, all pixels are written at each reduction
+  projection_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    projection_[d] = opencl_manager.Allocate(nullptr, number_of_pixels*sizeof(GGulong), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+    opencl_manager.CleanBuffer(projection_[d], number_of_pixels*sizeof(GGulong), d);
+  }
+
+  // Projection of another device added on the first device
+  if (number_activated_devices_ > 1) device_projection_ = opencl_manager.Allocate(nullptr, number_of_pixels*sizeof(GGulong), 0, CL_MEM_READ_WRITE, "GGEMSSystem");
+
+  // Compiling kernels, type of histograms depends on detector response
+  kernel_gather_histograms_ = new cl::Kernel*[number_activated_devices_];
+  kernel_add_projection_ = new cl::Kernel*[number_activated_devices_];
+
+  std::string kernel_option = detector_response_ == "energy" ? " -DENERGY_INTEGRATING" : "";
+
+  std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+  std::string reduce_projection_filename = openCL_kernel_path + "/ReduceProjectionGGEMSSystem.cl";
+
+  opencl_manager.CompileKernel(reduce_projection_filename, "gather_histograms_ggems_system", kernel_gather_histograms_, nullptr, const_cast<char*>(kernel_option.c_str()));
+  opencl_manager.CompileKernel(reduce_projection_filename, "add_projection_ggems_system", kernel_add_projection_, nullptr, const_cast<char*>(kernel_option.c_str()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSystem::UpdateFusedNavigation(void)
+{
+  GGcout("GGEMSSystem", "UpdateFusedNavigation", 3) << "Updating data and BVH of " << number_of_solids_ << " modules..." << GGendl;
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // AABB in global frame of each module, computed from the 8 corners of OBB
+  GGfloat3* solid_border_min = new GGfloat3[number_of_solids_];
+  GGfloat3* solid_border_max = new GGfloat3[number_of_solids_];
+  GGint* solid_index = new GGint[number_of_solids_];
+
+  // Copy of all solid data in a single buffer, allocated at the first update
+  if (!fused_solid_data_) {
+    fused_solid_data_ = new cl::Buffer*[number_activated_devices_];
+    for (GGsize d = 0; d < number_activated_devices_; ++d) fused_solid_data_[d] = opencl_manager.Allocate(nullptr, number_of_solids_*sizeof(GGEMSSolidBoxData), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+  }
+
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    GGEMSSolidBoxData* fused_solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(fused_solid_data_[d], number_of_solids_*sizeof(GGEMSSolidBoxData), d);
+
+    for (GGsize i = 0; i < number_of_solids_; ++i) {
+      GGEMSSolidBoxData* solid_data_device = opencl_manager.GetDeviceBuffer<GGEMSSolidBoxData>(solids_[i]->GetSolidData(d), sizeof(GGEMSSolidBoxData), d);
+      fused_solid_data_device[i] = *solid_data_device;
+
+      if (d == 0) {
+        GGEMSOBB const& obb = solid_data_device->obb_geometry_;
+        GGfloat44 const& m = obb.matrix_transformation_;
+        for (GGint a = 0; a < 3; ++a) {
+          solid_border_min[i].s[a] = OUT_OF_WORLD;
+          solid_border_max[i].s[a] = -OUT_OF_WORLD;
+        }
+
+        for (GGint c = 0; c < 8; ++c) {
+          GGfloat x = (c & 1) ? obb.border_max_xyz_.x : obb.border_min_xyz_.x;
+          GGfloat y = (c & 2) ? obb.border_max_xyz_.y : obb.border_min_xyz_.y;
+          GGfloat z = (c & 4) ? obb.border_max_xyz_.z : obb.border_min_xyz_.z;
+          GGfloat3 corner;
+          corner.x = m.m0_[0]*x + m.m0_[1]*y + m.m0_[2]*z + m.m0_[3];
+          corner.y = m.m1_[0]*x + m.m1_[1]*y + m.m1_[2]*z + m.m1_[3];
+          corner.z = m.m2_[0]*x + m.m2_[1]*y + m.m2_[2]*z + m.m2_[3];
+          for (GGint a = 0; a < 3; ++a) {
+            solid_border_min[i].s[a] = std::min(solid_border_min[i].s[a], corner.s[a]);
+            solid_border_max[i].s[a] = std::max(solid_border_max[i].s[a], corner.s[a]);
           }
+        }
 
-          opencl_manager.ReleaseDeviceBuffer(scatter_histogram, scatter_histogram_device, i);
+        // Enlarging AABB with geometry tolerance, culling has to be conservative
+        for (GGint a = 0; a < 3; ++a) {
+          solid_border_min[i].s[a] -= 2.0f*GEOMETRY_TOLERANCE;
+          solid_border_max[i].s[a] += 2.0f*GEOMETRY_TOLERANCE;
         }
+
+        solid_index[i] = static_cast<GGint>(i);
       }
+
+      opencl_manager.ReleaseDeviceBuffer(solids_[i]->GetSolidData(d), solid_data_device, d);
     }
 
-    mhdImageScatter.Write<GGint>(output);
+    opencl_manager.ReleaseDeviceBuffer(fused_solid_data_[d], fused_solid_data_device, d);
   }
 
-  delete[] output;
+  // Building BVH on host, root is the first node
+  std::vector<GGEMSBVHNode> bvh_nodes;
+  BuildBVHNode(bvh_nodes, solid_index, 0, number_of_solids_, solid_border_min, solid_border_max, 0);
+  number_of_bvh_nodes_ = bvh_nodes.size();
+
+  delete[] solid_border_min;
+  delete[] solid_border_max;
+  delete[] solid_index;
+
+  // Copy BVH on each device, number of nodes depends only on number of modules
+  if (!bvh_nodes_) {
+    bvh_nodes_ = new cl::Buffer*[number_activated_devices_];
+    for (GGsize d = 0; d < number_activated_devices_; ++d) bvh_nodes_[d] = opencl_manager.Allocate(nullptr, number_of_bvh_nodes_*sizeof(GGEMSBVHNode), d, CL_MEM_READ_WRITE, "GGEMSSystem");
+  }
+
+  for (GGsize d = 0; d < number_activated_devices_; ++d) {
+    GGEMSBVHNode* bvh_nodes_device = opencl_manager.GetDeviceBuffer<GGEMSBVHNode>(bvh_nodes_[d], number_of_bvh_nodes_*sizeof(GGEMSBVHNode), d);
+    for (GGsize i = 0; i < number_of_bvh_nodes_; ++i) bvh_nodes_device[i] = bvh_nodes[i];
+    opencl_manager.ReleaseDeviceBuffer(bvh_nodes_[d], bvh_nodes_device, d);
+  }
 }
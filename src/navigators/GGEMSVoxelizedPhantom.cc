@@ -30,6 +30,7 @@
 #include "GGEMS/navigators/GGEMSVoxelizedPhantom.hh"
 #include "GGEMS/navigators/GGEMSDosimetryCalculator.hh"
 #include "GGEMS/navigators/GGEMSDoseParams.hh"
+#include "GGEMS/navigators/GGEMSForcedDetection.hh"
 #include "GGEMS/geometries/GGEMSVoxelizedSolid.hh"
 #include "GGEMS/io/GGEMSMHDImage.hh"
 
@@ -40,7 +41,9 @@
 GGEMSVoxelizedPhantom::GGEMSVoxelizedPhantom(std::string const& voxelized_phantom_name)
 : GGEMSNavigator(voxelized_phantom_name),
   voxelized_phantom_filename_(""),
-  range_data_filename_("")
+  range_data_filename_(""),
+  is_woodcock_tracking_(false),
+  is_dda_tracking_(false)
 {
   GGcout("GGEMSVoxelizedPhantom", "GGEMSVoxelizedPhantom", 3) << "GGEMSVoxelizedPhantom creating..." << GGendl;
 
@@ -79,6 +82,20 @@ void GGEMSVoxelizedPhantom::CheckParameters(void) const
     oss << "You have to set a file with the range to material data!!!";
     GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "CheckParameters", oss.str());
   }
+
+  // Checking tracking mode
+  if (is_woodcock_tracking_ && is_dda_tracking_) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Woodcock tracking and DDA tracking can not be activated together!!!";
+    GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "CheckParameters", oss.str());
+  }
+
+  // Checking importance
+  if (importance_ <= 0.0f) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Importance of voxelized phantom has to be > 0!!!";
+    GGEMSMisc::ThrowException("GGEMSVoxelizedPhantom", "CheckParameters", oss.str());
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,9 +129,24 @@ void GGEMSVoxelizedPhantom::Initialize(void)
   // Enabling tracking if necessary
   if (is_tracking_) solids_[0]->EnableTracking();
 
+  // Woodcock tracking replaces voxel by voxel tracking
+  if (is_woodcock_tracking_) static_cast<GGEMSVoxelizedSolid*>(solids_[0])->EnableWoodcockTracking();
+
+  // Incremental voxel traversal replaces voxel by voxel tracking
+  if (is_dda_tracking_) static_cast<GGEMSVoxelizedSolid*>(solids_[0])->EnableDDATracking();
+
+  // Compton scatterings are forced to the detector
+  if (is_forced_detection_mode_ && forced_detection_->IsScatterProjection()) static_cast<GGEMSVoxelizedSolid*>(solids_[0])->EnableForcedDetection();
+
+  // Weight of photons is kept in a window given by importance
+  if (is_particle_splitting_) static_cast<GGEMSVoxelizedSolid*>(solids_[0])->EnableParticleSplitting();
+
   // Load voxelized phantom from MHD file and storing materials
   solids_[0]->Initialize(materials_);
 
+  // Load importance map after phantom, dimensions are compared
+  if (!importance_map_filename_.empty()) static_cast<GGEMSVoxelizedSolid*>(solids_[0])->LoadImportanceMap(importance_map_filename_);
+
   // Perform rotation before position
   if (is_update_rot_) solids_[0]->SetRotation(rotation_xyz_);
   if (is_update_pos_) solids_[0]->SetPosition(position_xyz_);
@@ -144,6 +176,13 @@ void GGEMSVoxelizedPhantom::SaveResults(void)
     // Compute dose and save results
     dose_calculator_->SaveResults();
   }
+
+  if (is_forced_detection_mode_) {
+    GGcout("GGEMSVoxelizedPhantom", "SaveResults", 2) << "Saving forced detection projections in MHD format..." << GGendl;
+
+    // Compute primary projection and save projections
+    forced_detection_->SaveResults();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -160,6 +199,44 @@ void GGEMSVoxelizedPhantom::SetPhantomFile(std::string const& voxelized_phantom_
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSVoxelizedPhantom::SetWoodcockTracking(bool const& is_woodcock_tracking)
+{
+  is_woodcock_tracking_ = is_woodcock_tracking;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedPhantom::SetDDATracking(bool const& is_dda_tracking)
+{
+  is_dda_tracking_ = is_dda_tracking;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedPhantom::SetImportance(GGfloat const& importance)
+{
+  importance_ = importance;
+  is_particle_splitting_ = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSVoxelizedPhantom::SetImportanceMap(std::string const& importance_map_filename)
+{
+  importance_map_filename_ = importance_map_filename;
+  is_particle_splitting_ = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGEMSVoxelizedPhantom* create_ggems_voxelized_phantom(char const* voxelized_phantom_name)
 {
   return new(std::nothrow) GGEMSVoxelizedPhantom(voxelized_phantom_name);
@@ -191,3 +268,39 @@ void set_rotation_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phant
 {
   voxelized_phantom->SetRotation(rx, ry, rz, unit);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_woodcock_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_woodcock_tracking)
+{
+  voxelized_phantom->SetWoodcockTracking(is_woodcock_tracking);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_dda_tracking_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, bool const is_dda_tracking)
+{
+  voxelized_phantom->SetDDATracking(is_dda_tracking);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_importance_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, GGfloat const importance)
+{
+  voxelized_phantom->SetImportance(importance);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_importance_map_ggems_voxelized_phantom(GGEMSVoxelizedPhantom* voxelized_phantom, char const* importance_map_filename)
+{
+  voxelized_phantom->SetImportanceMap(importance_map_filename);
+}
@@ -327,10 +327,10 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
   std::ostringstream oss(std::ostringstream::out);
   oss << "GGEMSWorld::Tracking in " << device_name << ", index " << device_index;
 
-  // Pointer to primary particles, and number to particles in buffer
+  // Pointer to primary particles, and number of active particles in buffer
   GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
   cl::Buffer* primary_particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
-  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfParticles(thread_index);
+  GGsize number_of_particles = source_manager.GetParticles()->GetNumberOfActiveParticles(thread_index);
 
   // Getting work group size, and work-item number
   GGsize work_group_size = opencl_manager.GetWorkGroupSize();
@@ -379,7 +379,6 @@ void GGEMSWorld::Tracking(GGsize const& thread_index)
   // GGEMS Profiling
   GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
   profiler_manager.HandleEvent(*event, oss.str());
-  queue->finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
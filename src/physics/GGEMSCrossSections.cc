@@ -28,6 +28,8 @@
   \date Tuesday March 31, 2020
 */
 
+#include <cstring>
+
 #include "GGEMS/physics/GGEMSCrossSections.hh"
 #include "GGEMS/physics/GGEMSComptonScattering.hh"
 #include "GGEMS/physics/GGEMSPhotoElectricEffect.hh"
@@ -58,12 +60,22 @@ GGEMSCrossSections::GGEMSCrossSections(void)
   // Allocating memory for cross section tables on host and device
   particle_cross_sections_ = new cl::Buffer*[number_activated_devices_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    particle_cross_sections_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSParticleCrossSections), i, CL_MEM_READ_WRITE, "GGEMSCrossSections");
+    // Tables are shared by devices of the same context
+    if (opencl_manager.IsContextOwner(i)) {
+      particle_cross_sections_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSParticleCrossSections), i, CL_MEM_READ_WRITE, "GGEMSCrossSections");
+    }
+    else {
+      particle_cross_sections_[i] = particle_cross_sections_[opencl_manager.GetContextOwner(i)];
+    }
   }
 
   // Useful to avoid memory transfer between host and OpenCL
   particle_cross_sections_host_ = new GGEMSParticleCrossSections();
 
+  // Packed photon cross sections are allocated when the number of materials is known
+  photon_cross_sections_ = nullptr;
+  photon_cross_sections_size_ = 0;
+
   GGcout("GGEMSCrossSections", "GGEMSCrossSections", 3) << "GGEMSCrossSections created!!!" << GGendl;
 }
 
@@ -104,12 +116,20 @@ void GGEMSCrossSections::Clean(void)
 
   if (particle_cross_sections_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(particle_cross_sections_[i], sizeof(GGEMSParticleCrossSections), i);
+      if (opencl_manager.IsContextOwner(i)) opencl_manager.Deallocate(particle_cross_sections_[i], sizeof(GGEMSParticleCrossSections), i);
     }
     delete[] particle_cross_sections_;
     particle_cross_sections_ = nullptr;
   }
 
+  if (photon_cross_sections_) {
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      if (opencl_manager.IsContextOwner(i)) opencl_manager.Deallocate(photon_cross_sections_[i], photon_cross_sections_size_, i);
+    }
+    delete[] photon_cross_sections_;
+    photon_cross_sections_ = nullptr;
+  }
+
   GGcout("GGEMSCrossSections", "Clean", 3) << "GGEMSCrossSections cleaned!!!" << GGendl;
 }
 
@@ -180,24 +200,38 @@ void GGEMSCrossSections::Initialize(GGEMSMaterials const* materials)
   GGsize number_of_bins = process_manager.GetCrossSectionTableNumberOfBins();
   GGfloat min_energy = process_manager.GetCrossSectionTableMinEnergy();
   GGfloat max_energy = process_manager.GetCrossSectionTableMaxEnergy();
+  GGsize number_of_materials = materials->GetNumberOfMaterials();
+
+  // Storing name of materials on host
+  material_names_.clear();
+  for (GGsize i = 0; i < number_of_materials; ++i) material_names_.push_back(materials->GetMaterialName(i));
+
+  // Packed photon cross sections sized for the activated materials and bins only
+  photon_cross_sections_size_ = (number_of_materials+NUMBER_OF_CHEMICAL_ELEMENT_ROWS)*number_of_bins*PHOTON_CROSS_SECTION_STRIDE*sizeof(GGfloat);
+  photon_cross_sections_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    // Tables are shared by devices of the same context
+    if (opencl_manager.IsContextOwner(i)) {
+      photon_cross_sections_[i] = opencl_manager.Allocate(nullptr, photon_cross_sections_size_, i, CL_MEM_READ_ONLY, "GGEMSCrossSections");
+    }
+    else {
+      photon_cross_sections_[i] = photon_cross_sections_[opencl_manager.GetContextOwner(i)];
+    }
+  }
 
   // Initialize physics on each device
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    // Shared tables are built only once by context
+    if (!opencl_manager.IsContextOwner(j)) continue;
+
     GGEMSParticleCrossSections* particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[j], sizeof(GGEMSParticleCrossSections), j);
 
     particle_cross_sections_device->number_of_bins_ = number_of_bins;
     particle_cross_sections_device->min_energy_ = min_energy;
     particle_cross_sections_device->max_energy_ = max_energy;
-    for (GGsize i = 0; i < materials->GetNumberOfMaterials(); ++i) {
-      #ifdef _WIN32
-      strcpy_s(reinterpret_cast<char*>(particle_cross_sections_device->material_names_[i]), 32, (materials->GetMaterialName(i)).c_str());
-      #else
-      strcpy(reinterpret_cast<char*>(particle_cross_sections_device->material_names_[i]), (materials->GetMaterialName(i)).c_str());
-      #endif
-    }
 
     // Storing information from materials
-    particle_cross_sections_device->number_of_materials_ = static_cast<GGuchar>(materials->GetNumberOfMaterials());
+    particle_cross_sections_device->number_of_materials_ = number_of_materials;
 
     // Filling energy table with log scale
     GGfloat slope = logf(max_energy/min_energy);
@@ -205,12 +239,47 @@ void GGEMSCrossSections::Initialize(GGEMSMaterials const* materials)
       particle_cross_sections_device->energy_bins_[i] = min_energy * expf(slope * (static_cast<float>(i) / (static_cast<GGfloat>(number_of_bins)-1.0f))) * MeV;
     }
 
+    // Direct index of energy only if stored bins are log-uniform, otherwise binary search
+    GGfloat* energy_bins = particle_cross_sections_device->energy_bins_;
+    GGfloat log_step = logf(energy_bins[1]/energy_bins[0]);
+    particle_cross_sections_device->inverse_log_energy_range_ = 1.0f / logf(energy_bins[number_of_bins-1]/energy_bins[0]);
+    particle_cross_sections_device->is_log_energy_bins_ = 1;
+    for (GGsize i = 1; i < number_of_bins-1; ++i) {
+      if (fabsf(logf(energy_bins[i+1]/energy_bins[i]) - log_step) > 1.0e-3f*log_step) {
+        particle_cross_sections_device->is_log_energy_bins_ = 0;
+        break;
+      }
+    }
+
     // Release pointer
     opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[j], particle_cross_sections_device, j);
 
+    // Non activated processes and chemical elements keep a null cross section
+    GGfloat* photon_cross_sections_device = opencl_manager.GetDeviceBuffer<GGfloat>(photon_cross_sections_[j], photon_cross_sections_size_, j);
+    std::memset(photon_cross_sections_device, 0, photon_cross_sections_size_);
+    opencl_manager.ReleaseDeviceBuffer(photon_cross_sections_[j], photon_cross_sections_device, j);
+
     // Loop over the activated physic processes and building tables
     for (GGsize i = 0; i < number_of_activated_processes_; ++i)
-      em_processes_list_[i]->BuildCrossSectionTables(particle_cross_sections_[j], materials->GetMaterialTables(j), j);
+      em_processes_list_[i]->BuildCrossSectionTables(particle_cross_sections_[j], photon_cross_sections_[j], materials, j);
+
+    // Total cross section of each material, a photon step is sampled once from the total, and majorant over materials used by Woodcock tracking
+    particle_cross_sections_device = opencl_manager.GetDeviceBuffer<GGEMSParticleCrossSections>(particle_cross_sections_[j], sizeof(GGEMSParticleCrossSections), j);
+    photon_cross_sections_device = opencl_manager.GetDeviceBuffer<GGfloat>(photon_cross_sections_[j], photon_cross_sections_size_, j);
+
+    for (GGsize i = 0; i < number_of_bins; ++i) {
+      GGfloat majorant_cross_section = 0.0f;
+      for (GGsize k = 0; k < number_of_materials; ++k) {
+        GGfloat total_cross_section = 0.0f;
+        for (GGsize p = 0; p < NUMBER_PHOTON_PROCESSES; ++p) total_cross_section += photon_cross_sections_device[PHOTON_CROSS_SECTION_INDEX(k, i, p, number_of_bins)];
+        photon_cross_sections_device[PHOTON_CROSS_SECTION_INDEX(k, i, PHOTON_TOTAL_CROSS_SECTION, number_of_bins)] = total_cross_section;
+        majorant_cross_section = std::max(majorant_cross_section, total_cross_section);
+      }
+      particle_cross_sections_device->majorant_cross_sections_[i] = majorant_cross_section;
+    }
+
+    opencl_manager.ReleaseDeviceBuffer(photon_cross_sections_[j], photon_cross_sections_device, j);
+    opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[j], particle_cross_sections_device, j);
   }
 
   // Copy data from device to RAM memory (optimization for python users)
@@ -234,15 +303,12 @@ void GGEMSCrossSections::LoadPhysicTablesOnHost(void)
   particle_cross_sections_host_->number_of_materials_ = particle_cross_sections_device->number_of_materials_;
   particle_cross_sections_host_->min_energy_ = particle_cross_sections_device->min_energy_;
   particle_cross_sections_host_->max_energy_ = particle_cross_sections_device->max_energy_;
-
-  for(GGuchar i = 0; i < particle_cross_sections_host_->number_of_materials_; ++i) {
-    for(GGuchar j = 0; j < 32; ++j) {
-      particle_cross_sections_host_->material_names_[i][j] = particle_cross_sections_device->material_names_[i][j];
-    }
-  }
+  particle_cross_sections_host_->inverse_log_energy_range_ = particle_cross_sections_device->inverse_log_energy_range_;
+  particle_cross_sections_host_->is_log_energy_bins_ = particle_cross_sections_device->is_log_energy_bins_;
 
   for(GGushort i = 0; i < particle_cross_sections_host_->number_of_bins_; ++i) {
     particle_cross_sections_host_->energy_bins_[i] = particle_cross_sections_device->energy_bins_[i];
+    particle_cross_sections_host_->majorant_cross_sections_[i] = particle_cross_sections_device->majorant_cross_sections_[i];
   }
 
   particle_cross_sections_host_->number_of_activated_photon_processes_ = particle_cross_sections_device->number_of_activated_photon_processes_;
@@ -251,20 +317,15 @@ void GGEMSCrossSections::LoadPhysicTablesOnHost(void)
     particle_cross_sections_host_->photon_cs_id_[i] = particle_cross_sections_device->photon_cs_id_[i];
   }
 
-  for(GGuchar j = 0; j < NUMBER_PHOTON_PROCESSES; ++j) {
-    for(GGuint i = 0; i < 256*MAX_CROSS_SECTION_TABLE_NUMBER_BINS; ++i) {
-      particle_cross_sections_host_->photon_cross_sections_[j][i] = particle_cross_sections_device->photon_cross_sections_[j][i];
-    }
-  }
-
-  for(GGuchar j = 0; j < NUMBER_PHOTON_PROCESSES; ++j) {
-    for(GGuint i = 0; i < 101*MAX_CROSS_SECTION_TABLE_NUMBER_BINS; ++i) {
-      particle_cross_sections_host_->photon_cross_sections_per_atom_[j][i] = particle_cross_sections_device->photon_cross_sections_per_atom_[j][i];
-    }
-  }
-
   // Release pointer
   opencl_manager.ReleaseDeviceBuffer(particle_cross_sections_[0], particle_cross_sections_device, 0);
+
+  // Packed photon cross sections
+  GGfloat* photon_cross_sections_device = opencl_manager.GetDeviceBuffer<GGfloat>(photon_cross_sections_[0], photon_cross_sections_size_, 0);
+
+  photon_cross_sections_host_.assign(photon_cross_sections_device, photon_cross_sections_device + photon_cross_sections_size_/sizeof(GGfloat));
+
+  opencl_manager.ReleaseDeviceBuffer(photon_cross_sections_[0], photon_cross_sections_device, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -311,7 +372,7 @@ GGfloat GGEMSCrossSections::GetPhotonCrossSection(std::string const& process_nam
   // Get id of material
   GGsize mat_id = 0;
   for (GGsize i = 0; i < number_of_materials; ++i) {
-    if (strcmp(material_name.c_str(), reinterpret_cast<char*>(particle_cross_sections_host_->material_names_[i])) == 0) {
+    if (material_name == material_names_.at(i)) {
       mat_id = i;
       break;
     }
@@ -322,13 +383,15 @@ GGfloat GGEMSCrossSections::GetPhotonCrossSection(std::string const& process_nam
   GGfloat density = material_database_manager.GetMaterial(material_name).density_;
 
   // Computing the energy bin
-  GGsize energy_bin = static_cast<GGsize>(BinarySearchLeft(e_MeV, particle_cross_sections_host_->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
+  GGsize energy_bin = particle_cross_sections_host_->is_log_energy_bins_ ?
+    static_cast<GGsize>(LogUniformBinIndex(e_MeV, particle_cross_sections_host_->energy_bins_, static_cast<GGint>(number_of_bins), particle_cross_sections_host_->inverse_log_energy_range_)) :
+    static_cast<GGsize>(BinarySearchLeft(e_MeV, particle_cross_sections_host_->energy_bins_, static_cast<GGint>(number_of_bins), 0, 0));
 
   // Compute cross section using linear interpolation
   GGfloat energy_a = particle_cross_sections_host_->energy_bins_[energy_bin];
   GGfloat energy_b = particle_cross_sections_host_->energy_bins_[energy_bin+1];
-  GGfloat cross_section_a = particle_cross_sections_host_->photon_cross_sections_[process_id][energy_bin + number_of_bins*mat_id];
-  GGfloat cross_section_b = particle_cross_sections_host_->photon_cross_sections_[process_id][energy_bin+1 + number_of_bins*mat_id];
+  GGfloat cross_section_a = photon_cross_sections_host_.at(PHOTON_CROSS_SECTION_INDEX(mat_id, energy_bin, process_id, number_of_bins));
+  GGfloat cross_section_b = photon_cross_sections_host_.at(PHOTON_CROSS_SECTION_INDEX(mat_id, energy_bin+1, process_id, number_of_bins));
 
   GGfloat cross_section = LinearInterpolation(energy_a, cross_section_a, energy_b, cross_section_b, e_MeV);
 
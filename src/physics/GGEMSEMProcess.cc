@@ -30,6 +30,7 @@
 
 #include "GGEMS/physics/GGEMSProcessesManager.hh"
 #include "GGEMS/physics/GGEMSEMProcess.hh"
+#include "GGEMS/materials/GGEMSMaterials.hh"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -62,7 +63,7 @@ GGEMSEMProcess::~GGEMSEMProcess(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* material_tables, GGsize const& thread_index)
+void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections, cl::Buffer* photon_cross_sections, GGEMSMaterials const* materials, GGsize const& thread_index)
 {
   // Getting OpenCL manager
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
@@ -79,16 +80,21 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
   // Increment number of activated photon process
   cross_section_device->number_of_activated_photon_processes_ += 1;
 
+  // Get the packed photon cross sections
+  GGsize number_of_bins = cross_section_device->number_of_bins_;
+  GGsize number_of_materials = cross_section_device->number_of_materials_;
+  GGsize photon_cross_sections_size = (number_of_materials+NUMBER_OF_CHEMICAL_ELEMENT_ROWS)*number_of_bins*PHOTON_CROSS_SECTION_STRIDE*sizeof(GGfloat);
+  GGfloat* photon_cross_sections_device = opencl_manager.GetDeviceBuffer<GGfloat>(photon_cross_sections, photon_cross_sections_size, thread_index);
+
   // Get the material tables
+  cl::Buffer* material_tables = materials->GetMaterialTables(thread_index);
   GGEMSMaterialTables* materials_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_tables, sizeof(GGEMSMaterialTables), thread_index);
 
-  // Compute Compton cross section par material
-  GGsize number_of_bins = cross_section_device->number_of_bins_;
   // Loop over the materials
   for (GGsize j = 0; j < materials_device->number_of_materials_; ++j) {
     // Loop over the number of bins
     for (GGsize i = 0; i < number_of_bins; ++i) {
-      cross_section_device->photon_cross_sections_[process_id_][i + j*number_of_bins] = ComputeCrossSectionPerMaterial(cross_section_device, materials_device, j, i);
+      photon_cross_sections_device[PHOTON_CROSS_SECTION_INDEX(j, i, process_id_, number_of_bins)] = ComputeCrossSectionPerMaterial(cross_section_device, photon_cross_sections_device, materials_device, j, i);
     }
   }
 
@@ -100,18 +106,18 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
     // Loop over material
     for (GGsize j = 0; j < materials_device->number_of_materials_; ++j) {
       GGsize id_elt = materials_device->index_of_chemical_elements_[j];
-      GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "    - Material: " << cross_section_device->material_names_[j]
+      GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "    - Material: " << materials->GetMaterialName(j)
         << ", density: " << materials_device->density_of_material_[j]/(g/cm3) << " g.cm-3" << GGendl;
       // Loop over number of bins (energy)
       for (GGsize i = 0; i < number_of_bins; ++i) {
         GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "        + Energy: " << cross_section_device->energy_bins_[i]/keV << " keV, cross section: "
-          << (cross_section_device->photon_cross_sections_[process_id_][i + j*number_of_bins]/materials_device->density_of_material_[j])/(cm2/g) << " cm2.g-1" << GGendl;
+          << (photon_cross_sections_device[PHOTON_CROSS_SECTION_INDEX(j, i, process_id_, number_of_bins)]/materials_device->density_of_material_[j])/(cm2/g) << " cm2.g-1" << GGendl;
         // Loop over elements
         for (GGsize k = 0; k < materials_device->number_of_chemical_elements_[j]; ++k) {
           GGuchar atomic_number = materials_device->atomic_number_Z_[k+id_elt];
           GGcout("GGEMSEMProcess", "BuildCrossSectionTables", 0) << "            # Element (Z): " << atomic_number
             << ", atomic number density: " << materials_device->atomic_number_density_[k+id_elt]/(1/cm3) << " atom/cm3, cross section per atom: "
-            << cross_section_device->photon_cross_sections_per_atom_[process_id_][i + atomic_number*number_of_bins]/(cm2)<< " cm2" << GGendl;
+            << photon_cross_sections_device[PHOTON_CROSS_SECTION_INDEX(number_of_materials+atomic_number, i, process_id_, number_of_bins)]/(cm2)<< " cm2" << GGendl;
         }
       }
     }
@@ -119,6 +125,7 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
 
   // Release pointer
   opencl_manager.ReleaseDeviceBuffer(material_tables, materials_device, thread_index);
+  opencl_manager.ReleaseDeviceBuffer(photon_cross_sections, photon_cross_sections_device, thread_index);
   opencl_manager.ReleaseDeviceBuffer(particle_cross_sections, cross_section_device, thread_index);
 }
 
@@ -126,7 +133,7 @@ void GGEMSEMProcess::BuildCrossSectionTables(cl::Buffer* particle_cross_sections
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-GGfloat GGEMSEMProcess::ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections* cross_section_device, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index)
+GGfloat GGEMSEMProcess::ComputeCrossSectionPerMaterial(GGEMSParticleCrossSections const* cross_section_device, GGfloat* photon_cross_sections, GGEMSMaterialTables const* material_tables, GGsize const& material_index, GGsize const& energy_index)
 {
   GGfloat energy = cross_section_device->energy_bins_[energy_index];
   GGfloat cross_section_material = 0.0f;
@@ -136,7 +143,7 @@ GGfloat GGEMSEMProcess::ComputeCrossSectionPerMaterial(GGEMSParticleCrossSection
   for (GGsize i = 0; i < material_tables->number_of_chemical_elements_[material_index]; ++i) {
     GGuchar atomic_number = material_tables->atomic_number_Z_[i+index_of_offset];
     GGfloat cross_section_per_atom = ComputeCrossSectionPerAtom(energy, atomic_number);
-    cross_section_device->photon_cross_sections_per_atom_[process_id_][energy_index + atomic_number*cross_section_device->number_of_bins_] = cross_section_per_atom;
+    photon_cross_sections[PHOTON_CROSS_SECTION_INDEX(cross_section_device->number_of_materials_+atomic_number, energy_index, process_id_, cross_section_device->number_of_bins_)] = cross_section_per_atom;
     cross_section_material += material_tables->atomic_number_density_[i+index_of_offset] * cross_section_per_atom;
   }
   return cross_section_material;
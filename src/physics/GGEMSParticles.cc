@@ -40,7 +40,16 @@
 GGEMSParticles::GGEMSParticles(void)
 : number_of_particles_(nullptr),
   primary_particles_(nullptr),
-  kernel_alive_(nullptr)
+  kernel_alive_(nullptr),
+  is_stream_compaction_(false),
+  kernel_compact_(nullptr),
+  is_particle_splitting_(false),
+  kernel_free_(nullptr),
+  is_persistent_pool_(false),
+  number_of_active_particles_(nullptr),
+  status_host_(nullptr),
+  status_events_(nullptr),
+  number_of_alive_checks_(nullptr)
 {
   GGcout("GGEMSParticles", "GGEMSParticles", 3) << "GGEMSParticles creating..." << GGendl;
 
@@ -64,7 +73,7 @@ GGEMSParticles::~GGEMSParticles(void)
 
   if (primary_particles_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(primary_particles_[i], sizeof(GGEMSPrimaryParticles), i);
+      opencl_manager.Deallocate(primary_particles_[i], GetPrimaryParticlesSize(opencl_manager.GetParticleBatchSize(i)), i);
       opencl_manager.Deallocate(status_[i], sizeof(GGint), i);
     }
     delete[] primary_particles_;
@@ -78,6 +87,36 @@ GGEMSParticles::~GGEMSParticles(void)
     kernel_alive_ = nullptr;
   }
 
+  if (kernel_compact_) {
+    delete[] kernel_compact_;
+    kernel_compact_ = nullptr;
+  }
+
+  if (kernel_free_) {
+    delete[] kernel_free_;
+    kernel_free_ = nullptr;
+  }
+
+  if (number_of_active_particles_) {
+    delete[] number_of_active_particles_;
+    number_of_active_particles_ = nullptr;
+  }
+
+  if (status_host_) {
+    delete[] status_host_;
+    status_host_ = nullptr;
+  }
+
+  if (status_events_) {
+    delete[] status_events_;
+    status_events_ = nullptr;
+  }
+
+  if (number_of_alive_checks_) {
+    delete[] number_of_alive_checks_;
+    number_of_alive_checks_ = nullptr;
+  }
+
   GGcout("GGEMSParticles", "~GGEMSParticles", 3) << "GGEMSParticles erased!!!" << GGendl;
 }
 
@@ -88,6 +127,34 @@ GGEMSParticles::~GGEMSParticles(void)
 void GGEMSParticles::SetNumberOfParticles(GGsize const& thread_index, GGsize const& number_of_particles)
 {
   number_of_particles_[thread_index] = number_of_particles;
+  number_of_active_particles_[thread_index] = number_of_particles;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SetStreamCompaction(bool const& is_stream_compaction)
+{
+  is_stream_compaction_ = is_stream_compaction;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SetPersistentPool(bool const& is_persistent_pool)
+{
+  is_persistent_pool_ = is_persistent_pool;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::SetParticleSplitting(bool const& is_particle_splitting)
+{
+  is_particle_splitting_ = is_particle_splitting;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -101,16 +168,20 @@ void GGEMSParticles::InitializeKernel(void)
   // Getting the path to kernel
   std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
   std::string filename = openCL_kernel_path + "/IsAlive.cl";
-
+  std::string compact_filename = openCL_kernel_path + "/CompactParticles.cl";
 
   // Storing a kernel for each device
   kernel_alive_ = new cl::Kernel*[number_activated_devices_];
+  kernel_compact_ = new cl::Kernel*[number_activated_devices_];
+  kernel_free_ = new cl::Kernel*[number_activated_devices_];
 
   // Compiling the kernel
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   // Compiling kernel on each device
   opencl_manager.CompileKernel(filename, "is_alive", kernel_alive_, nullptr, nullptr);
+  opencl_manager.CompileKernel(compact_filename, "compact_particles", kernel_compact_, nullptr, nullptr);
+  opencl_manager.CompileKernel(compact_filename, "list_free_particles", kernel_free_, nullptr, nullptr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,6 +198,13 @@ void GGEMSParticles::Initialize(void)
   number_activated_devices_ = opencl_manager.GetNumberOfActivatedDevice();
 
   number_of_particles_ = new GGsize[number_activated_devices_];
+  number_of_active_particles_ = new GGsize[number_activated_devices_];
+
+  // Readback of alive checks, 2 slots by device: one read by host while the other is computed by device
+  status_host_ = new GGint[2*number_activated_devices_];
+  status_events_ = new cl::Event[2*number_activated_devices_];
+  number_of_alive_checks_ = new GGsize[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) number_of_alive_checks_[i] = 0;
 
   // Allocation of the PrimaryParticle structure
   AllocatePrimaryParticles();
@@ -139,7 +217,21 @@ void GGEMSParticles::Initialize(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
+bool GGEMSParticles::IsAlive(GGsize const& thread_index)
+{
+  // Enqueue a check and wait for it
+  EnqueueIsAlive(thread_index);
+  bool is_alive = ReadAliveCheck(thread_index, number_of_alive_checks_[thread_index] - 1);
+  number_of_alive_checks_[thread_index] = 0;
+
+  return is_alive;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::EnqueueIsAlive(GGsize const& thread_index)
 {
   // Get command queue and event
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
@@ -164,32 +256,148 @@ bool GGEMSParticles::IsAlive(GGsize const& thread_index) const
   cl::NDRange global_wi(number_of_work_items);
   cl::NDRange local_wi(work_group_size);
 
+  GGsize slot = 2*thread_index + number_of_alive_checks_[thread_index]%2;
+  GGint read_status = CL_SUCCESS;
+  if (is_stream_compaction_) {
+    // Cleaning number of active particles, list is rebuilt by compaction, commands are executed in order in queue
+    GGint zero = 0;
+    GGint fill_status = queue->enqueueFillBuffer(*particles, zero, offsetof(GGEMSPrimaryParticles, number_of_active_particles_), sizeof(GGint), nullptr, nullptr);
+    opencl_manager.CheckOpenCLError(fill_status, "GGEMSParticles", "EnqueueIsAlive");
+
+    // Set parameters for kernel
+    kernel_compact_[thread_index]->setArg(0, number_of_particles_[thread_index]);
+    kernel_compact_[thread_index]->setArg(1, *particles);
+    kernel_compact_[thread_index]->setArg(2, cl::Local(work_group_size*sizeof(GGint)));
+
+    // Launching kernel
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_compact_[thread_index], 0, global_wi, local_wi, nullptr, event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "EnqueueIsAlive");
+
+    // Non-blocking readback of number of active particles in the free slot
+    read_status = queue->enqueueReadBuffer(*particles, CL_FALSE, offsetof(GGEMSPrimaryParticles, number_of_active_particles_), sizeof(GGint), &status_host_[slot], nullptr, &status_events_[slot]);
+  }
+  else {
+    // Cleaning counter of dead particles, commands are executed in order in queue
+    opencl_manager.CleanBuffer(status, sizeof(GGint), thread_index);
+
+    // Set parameters for kernel
+    kernel_alive_[thread_index]->setArg(0, number_of_particles_[thread_index]);
+    kernel_alive_[thread_index]->setArg(1, *particles);
+    kernel_alive_[thread_index]->setArg(2, *status);
+
+    // Launching kernel
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_alive_[thread_index], 0, global_wi, local_wi, nullptr, event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "EnqueueIsAlive");
+
+    // Non-blocking readback of number of dead particles in the free slot
+    read_status = queue->enqueueReadBuffer(*status, CL_FALSE, 0, sizeof(GGint), &status_host_[slot], nullptr, &status_events_[slot]);
+  }
+  opencl_manager.CheckOpenCLError(read_status, "GGEMSParticles", "EnqueueIsAlive");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
+
+  // Submitting commands to device without waiting
+  queue->flush();
+
+  number_of_alive_checks_[thread_index] += 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSParticles::ListFreeParticles(GGsize const& thread_index)
+{
+  if (!is_particle_splitting_) return;
+
+  // Get command queue and event
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSParticles::ListFreeParticles on " << device_name << ", index " << device_index;
+
+  // Get the OpenCL buffers
+  cl::Buffer* particles = primary_particles_[thread_index];
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles_[thread_index]);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Cleaning number of free particles, list is rebuilt before each tracking step, commands are executed in order in queue
+  GGint zero = 0;
+  GGint fill_status = queue->enqueueFillBuffer(*particles, zero, offsetof(GGEMSPrimaryParticles, number_of_free_particles_), sizeof(GGint), nullptr, nullptr);
+  opencl_manager.CheckOpenCLError(fill_status, "GGEMSParticles", "ListFreeParticles");
+
   // Set parameters for kernel
-  kernel_alive_[thread_index]->setArg(0, number_of_particles_[thread_index]);
-  kernel_alive_[thread_index]->setArg(1, *particles);
-  kernel_alive_[thread_index]->setArg(2, *status);
+  kernel_free_[thread_index]->setArg(0, number_of_particles_[thread_index]);
+  kernel_free_[thread_index]->setArg(1, *particles);
+  kernel_free_[thread_index]->setArg(2, cl::Local(work_group_size*sizeof(GGint)));
 
   // Launching kernel
-  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_alive_[thread_index], 0, global_wi, local_wi, nullptr, event);
-  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "IsAlive");
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_free_[thread_index], 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSParticles", "ListFreeParticles");
 
   // GGEMS Profiling
   GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
   profiler_manager.HandleEvent(*event, oss.str());
-  queue->finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  // Get status from OpenCL device
-  GGint* status_device = opencl_manager.GetDeviceBuffer<GGint>(status_[thread_index], sizeof(GGint), thread_index);
+bool GGEMSParticles::IsAliveDeferred(GGsize const& thread_index)
+{
+  // The last check is still running on device, reading the previous one
+  if (number_of_alive_checks_[thread_index] < 2) return true;
 
-  GGint status_from_device = status_device[0];
+  return ReadAliveCheck(thread_index, number_of_alive_checks_[thread_index] - 2);
+}
 
-  // Release the pointer
-  opencl_manager.ReleaseDeviceBuffer(status_[thread_index], status_device, thread_index);
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
-  // Cleaning buffer
-  opencl_manager.CleanBuffer(status_[thread_index], sizeof(GGint), thread_index);
+void GGEMSParticles::ResetAliveChecks(GGsize const& thread_index)
+{
+  // Waiting for the last pending readback, host memory slot can be reused after
+  if (number_of_alive_checks_[thread_index] > 0) {
+    ReadAliveCheck(thread_index, number_of_alive_checks_[thread_index] - 1);
+  }
+
+  number_of_alive_checks_[thread_index] = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSParticles::ReadAliveCheck(GGsize const& thread_index, GGsize const& check_index)
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  GGsize slot = 2*thread_index + check_index%2;
+  opencl_manager.CheckOpenCLError(status_events_[slot].wait(), "GGEMSParticles", "ReadAliveCheck");
+
+  // With compaction, the number of active particles is read. Particles can not come back to life, so it is an upper bound for next launches.
+  // In persistent pool, dead slots are refilled after this check, and with particle splitting dead slots receive copies, all slots are kept
+  if (is_stream_compaction_) {
+    if (!is_persistent_pool_ && !is_particle_splitting_) number_of_active_particles_[thread_index] = std::min(number_of_active_particles_[thread_index], static_cast<GGsize>(status_host_[slot]));
+    return status_host_[slot] > 0;
+  }
 
-  if (status_from_device == static_cast<GGint>(number_of_particles_[thread_index])) return false;
+  if (status_host_[slot] == static_cast<GGint>(number_of_particles_[thread_index])) return false;
   else return true;
 }
 
@@ -209,7 +417,7 @@ void GGEMSParticles::AllocatePrimaryParticles(void)
 
   // Loop over activated device and allocate particle buffer on each device
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    primary_particles_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSPrimaryParticles), i, CL_MEM_READ_WRITE, "GGEMSParticles");
+    primary_particles_[i] = opencl_manager.Allocate(nullptr, GetPrimaryParticlesSize(opencl_manager.GetParticleBatchSize(i)), i, CL_MEM_READ_WRITE, "GGEMSParticles");
     status_[i] = opencl_manager.Allocate(nullptr, sizeof(GGint), i, CL_MEM_READ_WRITE, "GGEMSParticles");
     opencl_manager.CleanBuffer(status_[i], sizeof(GGint), i);
   }
@@ -600,6 +600,9 @@ void GGEMSRangeCuts::ConvertCutsFromDistanceToEnergy(GGEMSMaterials* materials)
   GGsize number_activated_devices = opencl_manager.GetNumberOfActivatedDevice();
 
   for (GGsize j = 0; j < number_activated_devices; ++j) {
+    // Material tables shared by a context are read only once
+    if (!opencl_manager.IsContextOwner(j)) continue;
+
     cl::Buffer* material_table = materials->GetMaterialTables(j);
     GGEMSMaterialTables* material_table_device = opencl_manager.GetDeviceBuffer<GGEMSMaterialTables>(material_table, sizeof(GGEMSMaterialTables), j);
 
@@ -34,6 +34,7 @@
 #include "GGEMS/randoms/GGEMSRandom.hh"
 
 #include "GGEMS/tools/GGEMSRAMManager.hh"
+#include "GGEMS/tools/GGEMSProfilerManager.hh"
 
 #include "GGEMS/sources/GGEMSSourceManager.hh"
 
@@ -50,7 +51,9 @@
 
 GGEMSPseudoRandomGenerator::GGEMSPseudoRandomGenerator(void)
 : pseudo_random_numbers_(nullptr),
-  seed_(0)
+  seed_(0),
+  is_host_seeding_(false),
+  kernel_initialize_seeds_(nullptr)
 {
   GGcout("GGEMSPseudoRandomGenerator", "GGEMSPseudoRandomGenerator", 3) << "GGEMSPseudoRandomGenerator creating..." << GGendl;
 
@@ -69,12 +72,17 @@ GGEMSPseudoRandomGenerator::~GGEMSPseudoRandomGenerator(void)
 
   if (pseudo_random_numbers_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
-      opencl_manager.Deallocate(pseudo_random_numbers_[i], sizeof(GGEMSRandom), i);
+      opencl_manager.Deallocate(pseudo_random_numbers_[i], GetRandomSize(opencl_manager.GetParticleBatchSize(i)), i);
     }
     delete[] pseudo_random_numbers_;
     pseudo_random_numbers_ = nullptr;
   }
 
+  if (kernel_initialize_seeds_) {
+    delete[] kernel_initialize_seeds_;
+    kernel_initialize_seeds_ = nullptr;
+  }
+
   GGcout("GGEMSPseudoRandomGenerator", "~GGEMSPseudoRandomGenerator", 3) << "GGEMSPseudoRandomGenerator erased!!!" << GGendl;
 }
 
@@ -137,10 +145,34 @@ void GGEMSPseudoRandomGenerator::Initialize(GGuint const& seed)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSPseudoRandomGenerator::SetHostSeeding(bool const& is_host_seeding)
+{
+  is_host_seeding_ = is_host_seeding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSPseudoRandomGenerator::InitializeSeeds(void)
 {
   GGcout("GGEMSPseudoRandomGenerator", "InitializeSeeds", 1) << "Initialization of seeds for each particles..." << GGendl;
 
+  // Counter-based engine, no state to initialize, streams are set by source before generating particles
+  #ifdef PHILOX_RANDOM
+  for (GGsize i = 0; i < number_activated_devices_; ++i) SetParticleStream(i, 0, 0);
+  #else
+  if (is_host_seeding_) InitializeSeedsOnHost();
+  else InitializeSeedsOnDevice();
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSPseudoRandomGenerator::InitializeSeedsOnHost(void)
+{
   // Initialize the Mersenne Twister engine
   std::mt19937 mt_gen(seed_);
 
@@ -149,16 +181,17 @@ void GGEMSPseudoRandomGenerator::InitializeSeeds(void)
 
   // Loop over activated device
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    // Get the pointer on device
-    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], sizeof(GGEMSRandom), i);
+    // Get the pointer on device, states of prng are stored one after the other for the batch size of device
+    GGsize batch_size = opencl_manager.GetParticleBatchSize(i);
+    GGuint* random_device = opencl_manager.GetDeviceBuffer<GGuint>(pseudo_random_numbers_[i], GetRandomSize(batch_size), i);
 
     // For each particle a seed is generated
-    for (GGsize i = 0; i < MAXIMUM_PARTICLES; ++i) {
-      random_device->prng_state_1_[i] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_2_[i] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_3_[i] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_4_[i] = static_cast<GGuint>(mt_gen());
-      random_device->prng_state_5_[i] = 0;
+    for (GGsize j = 0; j < batch_size; ++j) {
+      random_device[j] = static_cast<GGuint>(mt_gen());
+      random_device[j+batch_size] = static_cast<GGuint>(mt_gen());
+      random_device[j+2*batch_size] = static_cast<GGuint>(mt_gen());
+      random_device[j+3*batch_size] = static_cast<GGuint>(mt_gen());
+      random_device[j+4*batch_size] = 0;
     }
 
     // Release the pointer, mandatory step!!!
@@ -170,6 +203,83 @@ void GGEMSPseudoRandomGenerator::InitializeSeeds(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSPseudoRandomGenerator::InitializeSeedsOnDevice(void)
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Compiling kernel on each device
+  if (!kernel_initialize_seeds_) {
+    std::string openCL_kernel_path = OPENCL_KERNEL_PATH;
+    std::string filename = openCL_kernel_path + "/InitializeSeeds.cl";
+    kernel_initialize_seeds_ = new cl::Kernel*[number_activated_devices_];
+    opencl_manager.CompileKernel(filename, "initialize_seeds", kernel_initialize_seeds_, nullptr, nullptr);
+  }
+
+  // Getting work group size
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+
+  // Loop over activated device, kernels are only enqueued, source kernels follow them in command queue
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    cl::CommandQueue* queue = opencl_manager.GetCommandQueue(i);
+    cl::Event* event = opencl_manager.GetEvent(i);
+
+    // Get Device name and storing methode name + device
+    GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
+    std::string device_name = opencl_manager.GetDeviceName(device_index);
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "GGEMSPseudoRandomGenerator::InitializeSeedsOnDevice on " << device_name << ", index " << device_index;
+
+    // Parameters for work-item in kernel
+    GGsize batch_size = opencl_manager.GetParticleBatchSize(i);
+    cl::NDRange global_wi(opencl_manager.GetBestWorkItem(batch_size));
+    cl::NDRange local_wi(work_group_size);
+
+    // Set parameters for kernel
+    kernel_initialize_seeds_[i]->setArg(0, batch_size);
+    kernel_initialize_seeds_[i]->setArg(1, *pseudo_random_numbers_[i]);
+    kernel_initialize_seeds_[i]->setArg(2, seed_);
+    kernel_initialize_seeds_[i]->setArg(3, static_cast<GGuint>(i));
+
+    // Launching kernel
+    GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_initialize_seeds_[i], 0, global_wi, local_wi, nullptr, event);
+    opencl_manager.CheckOpenCLError(kernel_status, "GGEMSPseudoRandomGenerator", "InitializeSeedsOnDevice");
+
+    // GGEMS Profiling
+    GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+    profiler_manager.HandleEvent(*event, oss.str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSPseudoRandomGenerator::SetParticleStream(GGsize const& thread_index, GGsize const& source_index, GGsize const& first_particle_index) const
+{
+  #ifdef PHILOX_RANDOM
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+
+  // Header of random buffer: first particle index and key
+  GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[thread_index], offsetof(GGEMSRandom, particle_index_), thread_index);
+
+  random_device->first_particle_index_ = static_cast<GGulong>(first_particle_index);
+  random_device->key_[0] = seed_;
+  random_device->key_[1] = static_cast<GGuint>(source_index);
+
+  // Release the pointer, mandatory step!!!
+  opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[thread_index], random_device, thread_index);
+  #else
+  // Streams of JKISS are kept in slots of particles
+  static_cast<void>(thread_index);
+  static_cast<void>(source_index);
+  static_cast<void>(first_particle_index);
+  #endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSPseudoRandomGenerator::AllocateRandom(void)
 {
   GGcout("GGEMSPseudoRandomGenerator", "AllocateRandom", 1) << "Allocation of random numbers..." << GGendl;
@@ -183,7 +293,7 @@ void GGEMSPseudoRandomGenerator::AllocateRandom(void)
   // Allocation of memory on OpenCL device
   pseudo_random_numbers_ = new cl::Buffer*[number_activated_devices_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    pseudo_random_numbers_[i] = opencl_manager.Allocate(nullptr, sizeof(GGEMSRandom), i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
+    pseudo_random_numbers_[i] = opencl_manager.Allocate(nullptr, GetRandomSize(opencl_manager.GetParticleBatchSize(i)), i, CL_MEM_READ_WRITE, "GGEMSPseudoRandomGenerator");
   }
 }
 
@@ -203,22 +313,39 @@ void GGEMSPseudoRandomGenerator::PrintInfos(void) const
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
     GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(i);
 
-    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], sizeof(GGEMSRandom), i);
+    GGsize batch_size = opencl_manager.GetParticleBatchSize(i);
+
+    #ifdef PHILOX_RANDOM
+    GGEMSRandom* random_device = opencl_manager.GetDeviceBuffer<GGEMSRandom>(pseudo_random_numbers_[i], GetRandomSize(batch_size), i);
+
+    GGulong first_particle_index = random_device->first_particle_index_;
+    GGuint key[2] = {random_device->key_[0], random_device->key_[1]};
+
+    // Release the pointer, mandatory step!!!
+    opencl_manager.ReleaseDeviceBuffer(pseudo_random_numbers_[i], random_device, i);
+
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Device: " << opencl_manager.GetDeviceName(device_index) << GGendl;
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "-------" << GGendl;
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "Counter-based Philox4x32-10 engine:" << GGendl;
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * key: " << key[0] << " " << key[1] << GGendl;
+    GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * first particle index: " << first_particle_index << GGendl;
+    #else
+    GGuint* random_device = opencl_manager.GetDeviceBuffer<GGuint>(pseudo_random_numbers_[i], GetRandomSize(batch_size), i);
 
     GGuint state[2][5] = {
       {
-        random_device->prng_state_1_[0],
-        random_device->prng_state_2_[0],
-        random_device->prng_state_3_[0],
-        random_device->prng_state_4_[0],
-        random_device->prng_state_5_[0]
+        random_device[0],
+        random_device[batch_size],
+        random_device[2*batch_size],
+        random_device[3*batch_size],
+        random_device[4*batch_size]
       },
       {
-        random_device->prng_state_1_[1],
-        random_device->prng_state_2_[1],
-        random_device->prng_state_3_[1],
-        random_device->prng_state_4_[1],
-        random_device->prng_state_5_[1]
+        random_device[1],
+        random_device[1+batch_size],
+        random_device[1+2*batch_size],
+        random_device[1+3*batch_size],
+        random_device[1+4*batch_size]
       }
     };
 
@@ -233,5 +360,6 @@ void GGEMSPseudoRandomGenerator::PrintInfos(void) const
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 2: " << state[0][2] << " " << state[1][2] << GGendl;
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 3: " << state[0][3] << " " << state[1][3] << GGendl;
     GGcout("GGEMSPseudoRandomGenerator", "PrintInfos", 0) << "    * state 4: " << state[0][4] << " " << state[1][4] << GGendl;
+    #endif
   }
 }
@@ -44,8 +44,10 @@ GGEMSSource::GGEMSSource(std::string const& source_name)
   number_of_particles_by_device_(nullptr),
   number_of_particles_in_batch_(nullptr),
   number_of_batchs_(nullptr),
+  number_of_claimed_particles_(0),
   particle_type_(99),
-  tracking_kernel_option_("")
+  tracking_kernel_option_(""),
+  refill_budget_(nullptr)
 {
   GGcout("GGEMSSource", "GGEMSSource", 3) << "GGEMSSource creating..." << GGendl;
 
@@ -58,6 +60,7 @@ GGEMSSource::GGEMSSource(std::string const& source_name)
 
   // Storing a kernel for each device
   kernel_get_primaries_ = new cl::Kernel*[number_activated_devices_];
+  kernel_refill_primaries_ = new cl::Kernel*[number_activated_devices_];
 
   // Store the source in source manager
   GGEMSSourceManager::GetInstance().Store(this);
@@ -93,6 +96,20 @@ GGEMSSource::~GGEMSSource(void)
     kernel_get_primaries_ = nullptr;
   }
 
+  if (kernel_refill_primaries_) {
+    delete[] kernel_refill_primaries_;
+    kernel_refill_primaries_ = nullptr;
+  }
+
+  if (refill_budget_) {
+    GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+    for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      opencl_manager.Deallocate(refill_budget_[i], sizeof(GGint), i);
+    }
+    delete[] refill_budget_;
+    refill_budget_ = nullptr;
+  }
+
   if (number_of_particles_in_batch_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
       delete number_of_particles_in_batch_[i];
@@ -174,6 +191,24 @@ void GGEMSSource::SetRotation(GGfloat const& rx, GGfloat const& ry, GGfloat cons
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSSource::SetViewTransformation(GGfloat44 const& matrix_view)
+{
+  geometry_transformation_->SetViewTransformation(matrix_view);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+cl::Buffer* GGEMSSource::GetTransformationMatrix(GGsize const& thread_index) const
+{
+  return geometry_transformation_->GetTransformationMatrix(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSSource::CheckParameters(void) const
 {
   GGcout("GGEMSSource", "CheckParameters", 3) << "Checking the mandatory parameters..." << GGendl;
@@ -259,7 +294,7 @@ void GGEMSSource::OrganizeParticlesInBatch(void)
   number_of_particles_in_batch_ = new GGsize*[number_activated_devices_];
   number_of_batchs_ = new GGsize[number_activated_devices_];
   for (GGsize i = 0; i < number_activated_devices_; ++i) {
-    number_of_batchs_[i] = static_cast<GGsize>(std::ceil(static_cast<GGfloat>(number_of_particles_by_device_[i]) / MAXIMUM_PARTICLES));
+    number_of_batchs_[i] = static_cast<GGsize>(std::ceil(static_cast<GGfloat>(number_of_particles_by_device_[i]) / static_cast<GGfloat>(opencl_manager.GetParticleBatchSize(i))));
 
     number_of_particles_in_batch_[i] = new GGsize[number_of_batchs_[i]];
 
@@ -284,6 +319,60 @@ void GGEMSSource::OrganizeParticlesInBatch(void)
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+GGsize GGEMSSource::ClaimParticles(GGsize const& number_of_particles, GGsize& first_particle_index)
+{
+  GGsize number_of_claimed_particles = number_of_claimed_particles_.load();
+  GGsize claimed = 0;
+
+  // Reserving particles in counter shared by all devices, retry if another device claims particles in the meantime
+  do {
+    if (number_of_claimed_particles >= number_of_particles_) return 0;
+    claimed = std::min(number_of_particles, number_of_particles_ - number_of_claimed_particles);
+  } while (!number_of_claimed_particles_.compare_exchange_weak(number_of_claimed_particles, number_of_claimed_particles + claimed));
+
+  first_particle_index = number_of_claimed_particles;
+  return claimed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSource::SetRefillBudget(GGsize const& thread_index, GGsize const& refill_budget)
+{
+  // Budget is decremented on device by atomic operation, so stored in 32 bits
+  if (refill_budget > static_cast<GGsize>(std::numeric_limits<GGint>::max())) {
+    std::ostringstream oss(std::ostringstream::out);
+    oss << "Refill budget " << refill_budget << " is too high, maximum is " << std::numeric_limits<GGint>::max() << "!!!";
+    GGEMSMisc::ThrowException("GGEMSSource", "SetRefillBudget", oss.str());
+  }
+
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGint* refill_budget_device = opencl_manager.GetDeviceBuffer<GGint>(refill_budget_[thread_index], sizeof(GGint), thread_index);
+  *refill_budget_device = static_cast<GGint>(refill_budget);
+  opencl_manager.ReleaseDeviceBuffer(refill_budget_[thread_index], refill_budget_device, thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GGsize GGEMSSource::GetRefillBudget(GGsize const& thread_index) const
+{
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  GGint* refill_budget_device = opencl_manager.GetDeviceBuffer<GGint>(refill_budget_[thread_index], sizeof(GGint), thread_index);
+
+  // Budget is decremented below 0 by work-items finding it exhausted
+  GGsize refill_budget = *refill_budget_device > 0 ? static_cast<GGsize>(*refill_budget_device) : 0;
+  opencl_manager.ReleaseDeviceBuffer(refill_budget_[thread_index], refill_budget_device, thread_index);
+
+  return refill_budget;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 void GGEMSSource::Initialize(bool const& is_tracking)
 {
   GGcout("GGEMSSource", "Initialize", 3) << "Initializing the a GGEMS source..." << GGendl;
@@ -293,9 +382,18 @@ void GGEMSSource::Initialize(bool const& is_tracking)
 
   // Organize the particles in batch
   OrganizeParticlesInBatch();
+  number_of_claimed_particles_ = 0;
 
   // Enable tracking
   if (is_tracking) EnableTracking();
 
+  // Allocating refill budget on each device, used only by persistent particle pool
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  refill_budget_ = new cl::Buffer*[number_activated_devices_];
+  for (GGsize i = 0; i < number_activated_devices_; ++i) {
+    refill_budget_[i] = opencl_manager.Allocate(nullptr, sizeof(GGint), i, CL_MEM_READ_WRITE, "GGEMSSource");
+    SetRefillBudget(i, 0);
+  }
+
   GGcout("GGEMSSource", "Initialize", 0) << "Particles arranged in batch OK" << GGendl;
 }
@@ -176,7 +176,7 @@ void GGEMSSourceManager::Initialize(GGuint const& seed, bool const& is_tracking,
     // Loop over activated device
     for (GGsize i = 0; i < opencl_manager.GetNumberOfActivatedDevice(); ++i) {
       // Get pointer on OpenCL device for particles
-      GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(particles_->GetPrimaryParticles(i), sizeof(GGEMSPrimaryParticles), i);
+      GGEMSPrimaryParticles* primary_particles_device = opencl_manager.GetDeviceBuffer<GGEMSPrimaryParticles>(particles_->GetPrimaryParticles(i), offsetof(GGEMSPrimaryParticles, E_), i);
 
       primary_particles_device->particle_tracking_id = particle_tracking_id;
 
@@ -200,6 +200,33 @@ bool GGEMSSourceManager::IsAlive(GGsize const& thread_index) const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+void GGEMSSourceManager::EnqueueIsAlive(GGsize const& thread_index) const
+{
+  particles_->EnqueueIsAlive(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool GGEMSSourceManager::IsAliveDeferred(GGsize const& thread_index) const
+{
+  return particles_->IsAliveDeferred(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSSourceManager::ResetAliveChecks(GGsize const& thread_index) const
+{
+  particles_->ResetAliveChecks(thread_index);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 GGEMSSourceManager* get_instance_ggems_source_manager(void)
 {
   return &GGEMSSourceManager::GetInstance();
@@ -222,3 +249,12 @@ void print_infos_source_manager(GGEMSSourceManager* source_manager)
 {
   source_manager->PrintInfos();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void set_host_seeding_ggems_source_manager(GGEMSSourceManager* source_manager, bool const is_host_seeding)
+{
+  source_manager->GetPseudoRandomGenerator()->SetHostSeeding(is_host_seeding);
+}
@@ -86,6 +86,7 @@ GGEMSXRaySource::~GGEMSXRaySource(void)
 
   if (energy_spectrum_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      if (!opencl_manager.IsContextOwner(i)) continue;
       if (is_monoenergy_mode_) {
         opencl_manager.Deallocate(energy_spectrum_[i], 2*sizeof(GGfloat), i);
       }
@@ -99,6 +100,7 @@ GGEMSXRaySource::~GGEMSXRaySource(void)
 
   if (cdf_) {
     for (GGsize i = 0; i < number_activated_devices_; ++i) {
+      if (!opencl_manager.IsContextOwner(i)) continue;
       if (is_monoenergy_mode_) {
         opencl_manager.Deallocate(cdf_[i], 2*sizeof(GGfloat), i);
       }
@@ -130,6 +132,7 @@ void GGEMSXRaySource::InitializeKernel(void)
 
   // Compiling kernel on each device
   opencl_manager.CompileKernel(filename, "get_primaries_ggems_xray_source", kernel_get_primaries_, nullptr, const_cast<char*>(tracking_kernel_option_.c_str()));
+  opencl_manager.CompileKernel(filename, "refill_primaries_ggems_xray_source", kernel_refill_primaries_, nullptr, const_cast<char*>(tracking_kernel_option_.c_str()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -182,7 +185,59 @@ void GGEMSXRaySource::GetPrimaries(GGsize const& thread_index, GGsize const& num
   // GGEMS Profiling
   GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
   profiler_manager.HandleEvent(*event, oss.str());
-  queue->finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void GGEMSXRaySource::RefillPrimaries(GGsize const& thread_index, GGsize const& number_of_particles)
+{
+  // Get command queue and event
+  GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
+  cl::CommandQueue* queue = opencl_manager.GetCommandQueue(thread_index);
+  cl::Event* event = opencl_manager.GetEvent(thread_index);
+
+  // Get Device name and storing methode name + device
+  GGsize device_index = opencl_manager.GetIndexOfActivatedDevice(thread_index);
+  std::string device_name = opencl_manager.GetDeviceName(device_index);
+  std::ostringstream oss(std::ostringstream::out);
+  oss << "GGEMSXRaySource::RefillPrimaries on " << device_name << ", index " << device_index;
+
+  // Get the OpenCL buffers
+  GGEMSSourceManager& source_manager = GGEMSSourceManager::GetInstance();
+  cl::Buffer* particles = source_manager.GetParticles()->GetPrimaryParticles(thread_index);
+  cl::Buffer* randoms = source_manager.GetPseudoRandomGenerator()->GetPseudoRandomNumbers(thread_index);
+  cl::Buffer* matrix_transformation = geometry_transformation_->GetTransformationMatrix(thread_index);
+
+  // Getting work group size, and work-item number
+  GGsize work_group_size = opencl_manager.GetWorkGroupSize();
+  GGsize number_of_work_items = opencl_manager.GetBestWorkItem(number_of_particles);
+
+  // Parameters for work-item in kernel
+  cl::NDRange global_wi(number_of_work_items);
+  cl::NDRange local_wi(work_group_size);
+
+  // Set parameters for kernel
+  kernel_refill_primaries_[thread_index]->setArg(0, number_of_particles);
+  kernel_refill_primaries_[thread_index]->setArg(1, *particles);
+  kernel_refill_primaries_[thread_index]->setArg(2, *randoms);
+  kernel_refill_primaries_[thread_index]->setArg(3, *refill_budget_[thread_index]);
+  kernel_refill_primaries_[thread_index]->setArg(4, particle_type_);
+  kernel_refill_primaries_[thread_index]->setArg(5, *energy_spectrum_[thread_index]);
+  kernel_refill_primaries_[thread_index]->setArg(6, *cdf_[thread_index]);
+  kernel_refill_primaries_[thread_index]->setArg(7, static_cast<GGint>(number_of_energy_bins_));
+  kernel_refill_primaries_[thread_index]->setArg(8, beam_aperture_);
+  kernel_refill_primaries_[thread_index]->setArg(9, focal_spot_size_);
+  kernel_refill_primaries_[thread_index]->setArg(10, *matrix_transformation);
+
+  // Launching kernel
+  GGint kernel_status = queue->enqueueNDRangeKernel(*kernel_refill_primaries_[thread_index], 0, global_wi, local_wi, nullptr, event);
+  opencl_manager.CheckOpenCLError(kernel_status, "GGEMSXRaySource", "RefillPrimaries");
+
+  // GGEMS Profiling
+  GGEMSProfilerManager& profiler_manager = GGEMSProfilerManager::GetInstance();
+  profiler_manager.HandleEvent(*event, oss.str());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -334,6 +389,13 @@ void GGEMSXRaySource::FillEnergy(void)
   GGEMSOpenCLManager& opencl_manager = GGEMSOpenCLManager::GetInstance();
 
   for (GGsize j = 0; j < number_activated_devices_; ++j) {
+    // Spectrum is shared by devices of the same context, filled only once
+    if (!opencl_manager.IsContextOwner(j)) {
+      energy_spectrum_[j] = energy_spectrum_[opencl_manager.GetContextOwner(j)];
+      cdf_[j] = cdf_[opencl_manager.GetContextOwner(j)];
+      continue;
+    }
+
     // Monoenergy mode
     if (is_monoenergy_mode_) {
       number_of_energy_bins_ = 2;